@@ -1,50 +1,85 @@
 // Include .h files
 #include "AABB.h"
+#include "Fixed64.h"
 
 // Other includes
 #include <Gizmos.h>
 
 // Typedefs
 
+// Draw Box, filled in 2D and 3D
+static void drawBox(const glm::vec2& centre, const glm::vec2& extents, const glm::vec4& colour)
+{
+	aie::Gizmos::add2DAABBFilled(centre, extents, colour, nullptr);
+}
+static void drawBox(const glm::vec3& centre, const glm::vec3& extents, const glm::vec4& colour)
+{
+	aie::Gizmos::addAABBFilled(centre, extents, colour, nullptr);
+}
+
 //============================================================================================================================================
 // Constructors
 
 // Constructor
-AABB::AABB(glm::vec2 position, glm::vec2 velocity, glm::vec2 acceleration, glm::vec2 extents, float mass, float radius, glm::vec4 color) : Rigidbody(AABB_, position, velocity, acceleration, 0, mass, radius)
+template <class Scalar, int Dimensions>
+BasicAABB<Scalar, Dimensions>::BasicAABB(Vector position, Vector velocity, Vector acceleration, Vector extents, Scalar mass, float radius, glm::vec4 color) : Body(AABB_, position, velocity, acceleration, 0, mass, radius)
 {
 	m_extents = extents;
-	m_color = color;
+	this->setColor(color);
 	//m_minX = (-(getExtents().x));	// Left
 	//m_maxX = (getExtents().x);		// Right
 	//m_minY = (-(getExtents().y));	// Bottom
 	//m_maxY = (getExtents().y);		// Top
 
-	m_min = m_position - m_extents;
-	m_max = m_extents + m_position;
+	m_min = this->m_position - m_extents;
+	m_max = m_extents + this->m_position;
 }
 
-void AABB::fixedUpdate(glm::vec2 gravity, float timeStep)
+// Fixed Update
+template <class Scalar, int Dimensions>
+void BasicAABB<Scalar, Dimensions>::fixedUpdate(Vector gravity, Scalar timeStep)
 {
-	Rigidbody::fixedUpdate(gravity, timeStep);
+	Body::fixedUpdate(gravity, timeStep);
 
-	m_min = m_position - m_extents;
-	m_max = m_extents + m_position;
+	m_min = this->m_position - m_extents;
+	m_max = m_extents + this->m_position;
+}
+
+// Set Position
+template <class Scalar, int Dimensions>
+void BasicAABB<Scalar, Dimensions>::setPosition(Vector position)
+{
+	Body::setPosition(position);
+
+	// Keep the bounds in step with the position, static AABBs are never integrated so fixedUpdate won't do it
+	m_min = this->m_position - m_extents;
+	m_max = m_extents + this->m_position;
 }
 
 //============================================================================================================================================
 // Gizmo Functions
 
 // Make Gizmo
-void AABB::makeGizmo()
+template <class Scalar, int Dimensions>
+void BasicAABB<Scalar, Dimensions>::makeGizmo()
 {
-	aie::Gizmos::add2DAABBFilled(getPosition(), m_extents, m_color, nullptr);
+	drawBox(Body::VMath::toFloat(this->getPosition()), Body::VMath::toFloat(m_extents), this->getColor());
 }
 
 //============================================================================================================================================
 // Collision Functions
 
 // Check Collision
-bool AABB::checkCollision(PhysicsObject * pOther)
+template <class Scalar, int Dimensions>
+bool BasicAABB<Scalar, Dimensions>::checkCollision(Object * pOther)
 {
 	return false;
-}
\ No newline at end of file
+}
+
+//============================================================================================================================================
+// Instantiations
+
+template class BasicAABB<float, 2>;
+template class BasicAABB<double, 2>;
+template class BasicAABB<Fixed64, 2>;
+template class BasicAABB<float, 3>;
\ No newline at end of file
@@ -7,43 +7,46 @@
 
 // Typedefs
 
-class AABB : public Rigidbody
+template <class Scalar, int Dimensions>
+class BasicAABB : public BasicRigidbody<Scalar, Dimensions>
 {
 
 public:
+	typedef BasicRigidbody<Scalar, Dimensions> Body;
+	typedef typename Body::Object Object;
+	typedef typename Body::Vector Vector;
 
 	//============================================================================================================================================
 	// Constructors
 
-	AABB(glm::vec2 position, glm::vec2 velocity, glm::vec2 acceleration, glm::vec2 extents, float mass, float radius, glm::vec4 color);
-	//~AABB();
+	BasicAABB(Vector position, Vector velocity, Vector acceleration, Vector extents, Scalar mass, float radius, glm::vec4 color);
+	//~BasicAABB();
 
-	virtual void fixedUpdate(glm::vec2 gravity, float timeStep);
+	virtual void fixedUpdate(Vector gravity, Scalar timeStep);
+	virtual void setPosition(Vector position);
 
 	//============================================================================================================================================
 	// Getters And Setters
 
-	glm::vec2 getExtents() { return m_extents; } // Get Extents
-	glm::vec4 getColor() { return m_color; } // Get Color
+	Vector getExtents() { return m_extents; } // Get Extents
 
 	//============================================================================================================================================
 	// Misc
 
 	virtual void makeGizmo();
-	virtual bool checkCollision(PhysicsObject* pOther);
+	virtual bool checkCollision(Object* pOther);
 	//float m_minX;
 	//float m_maxX;
 	//float m_minY;
 	//float m_maxY;
 	
 	// Max pos of aabb
-	glm::vec2 m_max;
+	Vector m_max;
 	// Min pos of aabb
-	glm::vec2 m_min;
+	Vector m_min;
 
 
 protected:
-	glm::vec2 m_extents;
-	glm::vec4 m_color;
+	Vector m_extents;
 };
 
@@ -0,0 +1,359 @@
+// Include .h files
+#include "AdaptiveIntegrator.h"
+#include "RigidBody.h"
+
+// Other includes
+#include <cfloat>
+#include <climits>
+#include <cmath>
+
+// Typedefs
+
+// Dormand-Prince 5(4) tableau. The last row of A is also the 5th order weights, so the final stage is the new state and
+// its slope is the first stage of the next step
+static const int STAGE_COUNT = 7;
+static const double STAGE_TIME[STAGE_COUNT] = { 0.0, 1.0 / 5.0, 3.0 / 10.0, 4.0 / 5.0, 8.0 / 9.0, 1.0, 1.0 };
+static const double STAGE_WEIGHT[STAGE_COUNT][STAGE_COUNT - 1] =
+{
+	{ 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 },
+	{ 1.0 / 5.0, 0.0, 0.0, 0.0, 0.0, 0.0 },
+	{ 3.0 / 40.0, 9.0 / 40.0, 0.0, 0.0, 0.0, 0.0 },
+	{ 44.0 / 45.0, -56.0 / 15.0, 32.0 / 9.0, 0.0, 0.0, 0.0 },
+	{ 19372.0 / 6561.0, -25360.0 / 2187.0, 64448.0 / 6561.0, -212.0 / 729.0, 0.0, 0.0 },
+	{ 9017.0 / 3168.0, -355.0 / 33.0, 46732.0 / 5247.0, 49.0 / 176.0, -5103.0 / 18656.0, 0.0 },
+	{ 35.0 / 384.0, 0.0, 500.0 / 1113.0, 125.0 / 192.0, -2187.0 / 6784.0, 11.0 / 84.0 }
+};
+// 5th order weights minus the embedded 4th order ones
+static const double ERROR_WEIGHT[STAGE_COUNT] = { 71.0 / 57600.0, 0.0, -71.0 / 16695.0, 71.0 / 1920.0, -17253.0 / 339200.0, 22.0 / 525.0, -1.0 / 40.0 };
+
+// Step size control, the usual safety factor and the most a failed step is cut by in one go
+static const double STEP_SAFETY = 0.9;
+static const double MIN_STEP_SCALE = 0.1;
+
+// Smallest relative tolerance, a few float roundings of the positions the forces are worked out from
+static const float MIN_RELATIVE_TOLERANCE = 1e-6f;
+
+//============================================================================================================================================
+// Constructors
+
+// Constructor
+AdaptiveIntegrator::AdaptiveIntegrator()
+{
+	m_relativeTolerance = 1e-5f;
+	m_absoluteTolerance = 1e-5f;
+	m_maxLevel = 12;
+	m_interval = 0.0;
+	m_gravity = glm::vec2(0, 0);
+	m_forcePasses = 0;
+	m_bodyEvaluations = 0;
+	m_acceptedSteps = 0;
+	m_rejectedSteps = 0;
+	m_generators = nullptr;
+	m_fields = nullptr;
+	m_hasForceSources = false;
+}
+
+//============================================================================================================================================
+// Getters and Setters
+
+// Set Tolerance
+void AdaptiveIntegrator::setTolerance(float relative, float absolute)
+{
+	m_relativeTolerance = glm::max(relative, MIN_RELATIVE_TOLERANCE);
+	m_absoluteTolerance = glm::max(absolute, 0.0f);
+}
+
+//============================================================================================================================================
+// Integration
+
+// Advance, brings every body from the start of the interval to its end
+void AdaptiveIntegrator::advance(float interval, glm::vec2 gravity, const std::vector<PhysicsObject*>& actors, const std::vector<PhysicsObject*>& bodies,
+								 const std::vector<ForceGenerator*>& generators, ForceGenerator* fields)
+{
+	m_interval = interval;
+	m_gravity = gravity;
+	m_actors = &actors;
+	m_generators = &generators;
+	m_fields = fields;
+	m_hasForceSources = !generators.empty() || fields != nullptr;
+
+	// Forces applied before the update are picked up with the bodies and held for the interval, then cleared so the
+	// generators start from nothing
+	gatherBodies(bodies);
+	clearAccelerations();
+
+	int bodyCount = m_bodies.size();
+	int totalTicks = 1 << m_maxLevel;
+
+	// One force pass for everybody at the start, the first stage of every first step and what the predictions start from
+	m_block.resize(bodyCount);
+	m_blockTargets.resize(bodyCount);
+	m_inBlock.assign(bodyCount, 1);
+	for (int i = 0; i < bodyCount; i++)
+	{
+		m_block[i] = i;
+		m_blockTargets[i] = m_actorIndex[i];
+		m_stagePositionX[i] = m_positionX[i];
+		m_stagePositionY[i] = m_positionY[i];
+		m_stageVelocityX[i] = m_velocityX[i];
+		m_stageVelocityY[i] = m_velocityY[i];
+	}
+	evaluate(0.0);
+	m_accelerationX = m_stageAccelerationX;
+	m_accelerationY = m_stageAccelerationY;
+	m_inBlock.assign(bodyCount, 0);
+
+	while (true)
+	{
+		// The next time any body finishes a step, every block finishing then is stepped finest first
+		int endTick = INT_MAX;
+		for (int i = 0; i < bodyCount; i++)
+		{
+			if (m_tick[i] < totalTicks)
+			{
+				endTick = glm::min(endTick, m_tick[i] + (1 << (m_maxLevel - m_levels[i])));
+			}
+		}
+		if (endTick == INT_MAX)
+		{
+			break;
+		}
+
+		for (int level = m_maxLevel; level >= 0; level--)
+		{
+			stepBlock(level, endTick);
+		}
+	}
+
+	scatterBodies((float)m_interval);
+
+	m_actors = nullptr;
+	m_generators = nullptr;
+	m_fields = nullptr;
+}
+
+// Step Block, one Dormand-Prince step for the bodies on this level that finish a step at endTick
+void AdaptiveIntegrator::stepBlock(int level, int endTick)
+{
+	int bodyCount = m_bodies.size();
+	int stepTicks = 1 << (m_maxLevel - level);
+
+	m_block.clear();
+	m_blockTargets.clear();
+	for (int i = 0; i < bodyCount; i++)
+	{
+		if (m_levels[i] == level && m_tick[i] + stepTicks == endTick)
+		{
+			m_block.push_back(i);
+			m_blockTargets.push_back(m_actorIndex[i]);
+			m_inBlock[i] = 1;
+		}
+	}
+
+	int blockSize = m_block.size();
+	if (blockSize == 0)
+	{
+		return;
+	}
+
+	double tickTime = m_interval / (double)(1 << m_maxLevel);
+	double startTime = (endTick - stepTicks) * tickTime;
+	double h = stepTicks * tickTime;
+
+	m_slopePositionX.resize(STAGE_COUNT * blockSize);
+	m_slopePositionY.resize(STAGE_COUNT * blockSize);
+	m_slopeVelocityX.resize(STAGE_COUNT * blockSize);
+	m_slopeVelocityY.resize(STAGE_COUNT * blockSize);
+
+	// The first slope is the state at the end of the last step
+	for (int b = 0; b < blockSize; b++)
+	{
+		int i = m_block[b];
+		m_slopePositionX[b] = m_velocityX[i];
+		m_slopePositionY[b] = m_velocityY[i];
+		m_slopeVelocityX[b] = m_accelerationX[i];
+		m_slopeVelocityY[b] = m_accelerationY[i];
+	}
+
+	for (int stage = 1; stage < STAGE_COUNT; stage++)
+	{
+		for (int b = 0; b < blockSize; b++)
+		{
+			int i = m_block[b];
+			double positionX = 0.0;
+			double positionY = 0.0;
+			double velocityX = 0.0;
+			double velocityY = 0.0;
+			for (int previous = 0; previous < stage; previous++)
+			{
+				double weight = STAGE_WEIGHT[stage][previous];
+				int slope = (previous * blockSize) + b;
+				positionX += m_slopePositionX[slope] * weight;
+				positionY += m_slopePositionY[slope] * weight;
+				velocityX += m_slopeVelocityX[slope] * weight;
+				velocityY += m_slopeVelocityY[slope] * weight;
+			}
+			m_stagePositionX[i] = m_positionX[i] + (positionX * h);
+			m_stagePositionY[i] = m_positionY[i] + (positionY * h);
+			m_stageVelocityX[i] = m_velocityX[i] + (velocityX * h);
+			m_stageVelocityY[i] = m_velocityY[i] + (velocityY * h);
+		}
+
+		evaluate(startTime + (STAGE_TIME[stage] * h));
+
+		for (int b = 0; b < blockSize; b++)
+		{
+			int i = m_block[b];
+			int slope = (stage * blockSize) + b;
+			m_slopePositionX[slope] = m_stageVelocityX[i];
+			m_slopePositionY[slope] = m_stageVelocityY[i];
+			m_slopeVelocityX[slope] = m_stageAccelerationX[i];
+			m_slopeVelocityY[slope] = m_stageAccelerationY[i];
+		}
+	}
+
+	for (int b = 0; b < blockSize; b++)
+	{
+		int i = m_block[b];
+		m_inBlock[i] = 0;
+
+		// Difference between the 5th and 4th order solutions
+		double errorPositionX = 0.0;
+		double errorPositionY = 0.0;
+		double errorVelocityX = 0.0;
+		double errorVelocityY = 0.0;
+		for (int stage = 0; stage < STAGE_COUNT; stage++)
+		{
+			int slope = (stage * blockSize) + b;
+			errorPositionX += m_slopePositionX[slope] * ERROR_WEIGHT[stage];
+			errorPositionY += m_slopePositionY[slope] * ERROR_WEIGHT[stage];
+			errorVelocityX += m_slopeVelocityX[slope] * ERROR_WEIGHT[stage];
+			errorVelocityY += m_slopeVelocityY[slope] * ERROR_WEIGHT[stage];
+		}
+
+		// Each against what it's allowed, the absolute tolerance plus the relative tolerance of the larger of the old and
+		// new values, so far out bodies aren't held to a precision their positions can't hold
+		double error = 0.0;
+		error = glm::max(error, getScaledError(errorPositionX * h, m_positionX[i], m_stagePositionX[i]));
+		error = glm::max(error, getScaledError(errorPositionY * h, m_positionY[i], m_stagePositionY[i]));
+		error = glm::max(error, getScaledError(errorVelocityX * h, m_velocityX[i], m_stageVelocityX[i]));
+		error = glm::max(error, getScaledError(errorVelocityY * h, m_velocityY[i], m_stageVelocityY[i]));
+
+		// How much the step could grow or has to shrink, error goes as the 5th power of the step
+		double scale = (error > 0.0) ? STEP_SAFETY * std::pow(error, -0.2) : 2.0;
+
+		if (error <= 1.0 || level == m_maxLevel)
+		{
+			// The last stage is the new state
+			m_positionX[i] = m_stagePositionX[i];
+			m_positionY[i] = m_stagePositionY[i];
+			m_velocityX[i] = m_stageVelocityX[i];
+			m_velocityY[i] = m_stageVelocityY[i];
+			m_accelerationX[i] = m_stageAccelerationX[i];
+			m_accelerationY[i] = m_stageAccelerationY[i];
+			m_tick[i] = endTick;
+			m_acceptedSteps++;
+
+			// Doubling is only allowed where the double step lines up with the level above
+			if (scale >= 2.0 && level > 0 && (endTick % (stepTicks * 2)) == 0)
+			{
+				m_levels[i] = level - 1;
+			}
+		}
+		else
+		{
+			// Stays where it was and tries again with a step cut by enough halvings
+			int halvings = (int)std::ceil(-std::log2(glm::max(scale, MIN_STEP_SCALE)));
+			m_levels[i] = glm::min(level + glm::max(halvings, 1), m_maxLevel);
+			m_rejectedSteps++;
+		}
+	}
+}
+
+// Get Scaled Error, one value's error over what the mixed tolerance allows it, more than 1 fails the step
+double AdaptiveIntegrator::getScaledError(double error, double before, double after) const
+{
+	double allowed = m_absoluteTolerance + (m_relativeTolerance * glm::max(std::abs(before), std::abs(after)));
+	return std::abs(error) / glm::max(allowed, DBL_MIN);
+}
+
+// Evaluate, accelerations for the block at the stage state, with everybody else predicted to the stage time
+void AdaptiveIntegrator::evaluate(double time)
+{
+	int bodyCount = m_bodies.size();
+	int blockSize = m_block.size();
+	double tickTime = m_interval / (double)(1 << m_maxLevel);
+	m_forcePasses++;
+	m_bodyEvaluations += blockSize;
+
+	if (m_hasForceSources)
+	{
+		for (int i = 0; i < bodyCount; i++)
+		{
+			if (m_inBlock[i])
+			{
+				m_bodies[i]->setPosition(glm::vec2(m_stagePositionX[i], m_stagePositionY[i]));
+				m_bodies[i]->setVelocity(glm::vec2(m_stageVelocityX[i], m_stageVelocityY[i]));
+				continue;
+			}
+
+			// Bodies between steps follow a parabola from the end of their last one
+			double dt = time - (m_tick[i] * tickTime);
+			glm::dvec2 velocity(m_velocityX[i], m_velocityY[i]);
+			glm::dvec2 acceleration(m_accelerationX[i], m_accelerationY[i]);
+			m_bodies[i]->setPosition(glm::vec2(glm::dvec2(m_positionX[i], m_positionY[i]) + (velocity * dt) + (acceleration * (0.5 * dt * dt))));
+			m_bodies[i]->setVelocity(glm::vec2(velocity + (acceleration * dt)));
+		}
+
+		for (auto pGenerator : *m_generators)
+		{
+			pGenerator->applyForcesTo(*m_actors, m_blockTargets, (float)m_interval);
+		}
+		if (m_fields != nullptr)
+		{
+			m_fields->applyForcesTo(*m_actors, m_blockTargets, (float)m_interval);
+		}
+	}
+
+	for (int b = 0; b < blockSize; b++)
+	{
+		int i = m_block[b];
+		glm::vec2 force(m_appliedAccelerationX[i], m_appliedAccelerationY[i]);
+		if (m_hasForceSources)
+		{
+			force += m_bodies[i]->getAcceleration();
+		}
+		m_stageAccelerationX[i] = force.x + m_gravity.x - (m_stageVelocityX[i] * m_linearDrag[i]);
+		m_stageAccelerationY[i] = force.y + m_gravity.y - (m_stageVelocityY[i] * m_linearDrag[i]);
+	}
+
+	if (m_hasForceSources)
+	{
+		clearAccelerations();
+	}
+}
+
+//============================================================================================================================================
+// Body Data
+
+// Gather Bodies, levels carry over from the last interval if the bodies are the same ones
+void AdaptiveIntegrator::gatherBodies(const std::vector<PhysicsObject*>& bodies)
+{
+	IntegratorBodies<double>::gatherBodies(bodies);
+
+	int bodyCount = m_bodies.size();
+	if (m_levelBodies != m_bodies)
+	{
+		m_levels.assign(bodyCount, 0);
+		m_levelBodies = m_bodies;
+	}
+	m_tick.assign(bodyCount, 0);
+	m_accelerationX.resize(bodyCount);
+	m_accelerationY.resize(bodyCount);
+	m_stagePositionX.resize(bodyCount);
+	m_stagePositionY.resize(bodyCount);
+	m_stageVelocityX.resize(bodyCount);
+	m_stageVelocityY.resize(bodyCount);
+	m_stageAccelerationX.resize(bodyCount);
+	m_stageAccelerationY.resize(bodyCount);
+}
\ No newline at end of file
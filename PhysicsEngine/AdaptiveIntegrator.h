@@ -0,0 +1,107 @@
+#pragma once
+// Include .h files
+#include "PhysicsObject.h"
+#include "ForceGenerator.h"
+#include "IntegratorBodies.h"
+
+// Other includes
+#include <vector>
+#include <glm\vec2.hpp>
+#include <glm\glm.hpp>
+
+// Typedefs
+
+//============================================================================================================================================
+// AdaptiveIntegrator CLASS
+
+// Error controlled integration for force dominated scenes. The scene's time step becomes an output interval: every body
+// is brought up to the end of each interval so the scene can render, collide and constrain a consistent snapshot, but
+// inside the interval each body takes its own steps. Steps are Dormand-Prince 5(4), whose embedded 4th order solution
+// gives an error estimate for free; a body whose error is too big retries with half the step, one whose error is
+// comfortably small takes double steps once it lines up with them. The state is carried in double between the start
+// and end of the interval so thousands of small steps don't drift by float rounding. Step sizes are the interval over
+// a power of two, so bodies on the same level finish their steps together and are integrated as one block. Force
+// passes for a block only ask the generators for the block's forces; everyone else is predicted to the stage time from
+// their last step. Calm bodies cross the interval in one step while the ones in a close encounter take hundreds
+class AdaptiveIntegrator : public IntegratorBodies<double>
+{
+
+public:
+	AdaptiveIntegrator();
+
+	void advance(float interval, glm::vec2 gravity, const std::vector<PhysicsObject*>& actors, const std::vector<PhysicsObject*>& bodies,
+				 const std::vector<ForceGenerator*>& generators, ForceGenerator* fields);
+
+	//============================================================================================================================================
+	// Getters and Setters
+
+	// Error a step may make in each position and velocity: the absolute tolerance plus the relative tolerance times the
+	// size of the value, both 1e-5 to begin with. The relative tolerance stops at 1e-6, the forces are worked out from
+	// float positions
+	void setTolerance(float relative, float absolute);
+	float getRelativeTolerance() const { return m_relativeTolerance; }
+	float getAbsoluteTolerance() const { return m_absoluteTolerance; }
+
+	// Finest step is the interval over 2 ^ maxLevel, steps that still fail there are taken anyway
+	void setMaxLevel(int maxLevel) { m_maxLevel = glm::clamp(maxLevel, 0, 20); m_levels.clear(); }
+	int getMaxLevel() const { return m_maxLevel; }
+
+	// Counters since the scene was made. Body evaluations count one for each body a force pass was done for
+	long long getForcePassCount() const { return m_forcePasses; }
+	long long getBodyEvaluationCount() const { return m_bodyEvaluations; }
+	long long getAcceptedStepCount() const { return m_acceptedSteps; }
+	long long getRejectedStepCount() const { return m_rejectedSteps; }
+
+	// Level each body finished the last interval on, in the order the bodies were passed in
+	const std::vector<int>& getLevels() const { return m_levels; }
+
+protected:
+	void gatherBodies(const std::vector<PhysicsObject*>& bodies);
+	void stepBlock(int level, int endTick);
+	void evaluate(double time);
+	double getScaledError(double error, double before, double after) const;
+
+	float m_relativeTolerance;
+	float m_absoluteTolerance;
+	int m_maxLevel;
+	double m_interval;
+	glm::vec2 m_gravity;
+
+	long long m_forcePasses;
+	long long m_bodyEvaluations;
+	long long m_acceptedSteps;
+	long long m_rejectedSteps;
+
+	// Where the forces come from, only valid during advance
+	const std::vector<ForceGenerator*>* m_generators;
+	ForceGenerator* m_fields;
+	bool m_hasForceSources;
+
+	//============================================================================================================================================
+	// Dynamic Bodies, each as of the end of its last step. The state is in IntegratorBodies
+
+	std::vector<double> m_accelerationX;	// Including gravity and drag, also used to predict the body between steps
+	std::vector<double> m_accelerationY;
+	std::vector<int> m_tick;				// Time reached in units of the finest step
+	std::vector<int> m_levels;
+	std::vector<Rigidbody*> m_levelBodies;	// Which body each level belongs to, to keep levels across intervals
+
+	//============================================================================================================================================
+	// Block Being Stepped
+
+	std::vector<int> m_block;				// Body indices
+	std::vector<int> m_blockTargets;		// The same bodies as actor indices
+	std::vector<char> m_inBlock;
+	std::vector<double> m_stagePositionX;	// Per body, where the block's bodies are at the current stage
+	std::vector<double> m_stagePositionY;
+	std::vector<double> m_stageVelocityX;
+	std::vector<double> m_stageVelocityY;
+	std::vector<double> m_stageAccelerationX;
+	std::vector<double> m_stageAccelerationY;
+
+	// Slopes of every stage, stage major with one entry per block body
+	std::vector<double> m_slopePositionX;
+	std::vector<double> m_slopePositionY;
+	std::vector<double> m_slopeVelocityX;
+	std::vector<double> m_slopeVelocityY;
+};
\ No newline at end of file
@@ -0,0 +1,276 @@
+// Include .h files
+#include "BarnesHut.h"
+#include "RigidBody.h"
+
+// Other includes
+#include <algorithm>
+#include <cmath>
+
+// Typedefs
+
+// Leaves hold up to this many bodies, summed directly
+static const int LEAF_SIZE = 8;
+// Stops coincident bodies splitting forever
+static const int MAX_TREE_DEPTH = 32;
+// Each level of the walk pushes at most four nodes and pops one
+static const int MAX_STACK_SIZE = (MAX_TREE_DEPTH * 3) + 8;
+
+//============================================================================================================================================
+// Constructors
+
+// Constructor
+BarnesHut::BarnesHut(LongRangeForce forceType, float strength, float openingAngle, float softening)
+{
+	m_forceType = forceType;
+	m_strength = strength;
+	m_openingAngle = openingAngle;
+	m_softening = softening;
+}
+
+//============================================================================================================================================
+// Tree Functions
+
+// Build Node
+void BarnesHut::buildNode(int nodeIndex, glm::vec2 min, float size, int firstBody, int bodyCount, int depth)
+{
+	QuadTreeNode node;
+	node.min = min;
+	node.size = size;
+	node.firstChild = -1;
+	node.firstBody = firstBody;
+	node.bodyCount = bodyCount;
+	node.weight = 0.0f;
+	node.absoluteWeight = 0.0f;
+	node.centre = min + (size * 0.5f);
+
+	glm::vec2 weightedCentre(0, 0);
+
+	if (bodyCount > LEAF_SIZE && depth < MAX_TREE_DEPTH)
+	{
+		// Split the bodies into quadrants, first by y and then each half by x
+		glm::vec2 middle = min + (size * 0.5f);
+		std::vector<int>::iterator begin = m_order.begin() + firstBody;
+		std::vector<int>::iterator end = begin + bodyCount;
+		std::vector<int>::iterator splitY = std::partition(begin, end, [&](int body) { return m_positions[body].y < middle.y; });
+		std::vector<int>::iterator splitBottom = std::partition(begin, splitY, [&](int body) { return m_positions[body].x < middle.x; });
+		std::vector<int>::iterator splitTop = std::partition(splitY, end, [&](int body) { return m_positions[body].x < middle.x; });
+
+		int quadrantStart[5] = { firstBody, firstBody + (int)(splitBottom - begin), firstBody + (int)(splitY - begin), firstBody + (int)(splitTop - begin), firstBody + bodyCount };
+		float half = size * 0.5f;
+		glm::vec2 quadrantMin[4] = { min, glm::vec2(middle.x, min.y), glm::vec2(min.x, middle.y), middle };
+
+		// The four children sit next to each other so the walk only needs the first index
+		node.firstChild = m_nodes.size();
+		m_nodes.resize(m_nodes.size() + 4);
+		for (int quadrant = 0; quadrant < 4; quadrant++)
+		{
+			buildNode(node.firstChild + quadrant, quadrantMin[quadrant], half, quadrantStart[quadrant], quadrantStart[quadrant + 1] - quadrantStart[quadrant], depth + 1);
+		}
+
+		// Bottom-up: the node's centre of mass comes from its children's
+		for (int quadrant = 0; quadrant < 4; quadrant++)
+		{
+			const QuadTreeNode& child = m_nodes[node.firstChild + quadrant];
+			node.weight += child.weight;
+			node.absoluteWeight += child.absoluteWeight;
+			weightedCentre += child.centre * child.absoluteWeight;
+		}
+	}
+	else
+	{
+		for (int i = firstBody; i < firstBody + bodyCount; i++)
+		{
+			int body = m_order[i];
+			float absoluteWeight = std::abs(m_weights[body]);
+			node.weight += m_weights[body];
+			node.absoluteWeight += absoluteWeight;
+			weightedCentre += m_positions[body] * absoluteWeight;
+		}
+	}
+
+	if (node.absoluteWeight > 0.0f)
+	{
+		node.centre = weightedCentre / node.absoluteWeight;
+	}
+
+	m_nodes[nodeIndex] = node;
+}
+
+// Acceleration At
+glm::vec2 BarnesHut::accelerationAt(int body) const
+{
+	glm::vec2 position = m_positions[body];
+	float softeningSquared = m_softening * m_softening;
+	float openingAngleSquared = m_openingAngle * m_openingAngle;
+	glm::vec2 field(0, 0);
+
+	int stack[MAX_STACK_SIZE];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const QuadTreeNode& node = m_nodes[stack[--stackSize]];
+		if (node.absoluteWeight == 0.0f)
+		{
+			continue;
+		}
+
+		if (node.firstChild < 0)
+		{
+			// Leaves are summed body by body
+			for (int i = node.firstBody; i < node.firstBody + node.bodyCount; i++)
+			{
+				int other = m_order[i];
+				if (other == body)
+				{
+					continue;
+				}
+
+				glm::vec2 offset = m_positions[other] - position;
+				float distanceSquared = glm::dot(offset, offset) + softeningSquared;
+				field += offset * (m_weights[other] / (distanceSquared * std::sqrt(distanceSquared)));
+			}
+			continue;
+		}
+
+		glm::vec2 offset = node.centre - position;
+		float distanceSquared = glm::dot(offset, offset);
+		bool inside = position.x >= node.min.x && position.x < node.min.x + node.size &&
+					  position.y >= node.min.y && position.y < node.min.y + node.size;
+
+		// Far enough away (and not our own node), treat the whole node as one point
+		if (!inside && (node.size * node.size) < (openingAngleSquared * distanceSquared))
+		{
+			distanceSquared += softeningSquared;
+			field += offset * (node.weight / (distanceSquared * std::sqrt(distanceSquared)));
+		}
+		else
+		{
+			for (int quadrant = 0; quadrant < 4; quadrant++)
+			{
+				stack[stackSize++] = node.firstChild + quadrant;
+			}
+		}
+	}
+
+	// Gravity pulls towards mass, like charges push apart and the acceleration scales with charge over mass
+	if (m_forceType == GRAVITATION)
+	{
+		return field * m_strength;
+	}
+	return field * (-m_strength * m_weights[body] / m_bodies[body]->getMass());
+}
+
+//============================================================================================================================================
+// Force Functions
+
+// Build Tree, over every actor that has a usable position
+void BarnesHut::buildTree(const std::vector<PhysicsObject*>& actors)
+{
+	// Gather positions and weights, bodies that have blown up are left out of the tree
+	m_bodies.clear();
+	m_positions.clear();
+	m_weights.clear();
+	m_actorBodies.assign(actors.size(), -1);
+	for (int actor = 0; actor < (int)actors.size(); actor++)
+	{
+		PhysicsObject* pActor = actors[actor];
+		if (pActor->getShapeID() == PLANE)
+		{
+			continue;
+		}
+
+		Rigidbody* rigidBody = static_cast<Rigidbody*>(pActor);
+		glm::vec2 position = rigidBody->getPosition();
+		float weight = (m_forceType == GRAVITATION) ? rigidBody->getMass() : rigidBody->getCharge();
+		if (!(std::isfinite(position.x) && std::isfinite(position.y)))
+		{
+			continue;
+		}
+
+		m_actorBodies[actor] = m_bodies.size();
+		m_bodies.push_back(rigidBody);
+		m_positions.push_back(position);
+		m_weights.push_back(weight);
+	}
+
+	int bodyCount = m_bodies.size();
+	m_nodes.clear();
+	if (bodyCount == 0)
+	{
+		return;
+	}
+
+	// The root is the square around every body
+	glm::vec2 min = m_positions[0];
+	glm::vec2 max = m_positions[0];
+	for (int i = 1; i < bodyCount; i++)
+	{
+		min = glm::min(min, m_positions[i]);
+		max = glm::max(max, m_positions[i]);
+	}
+	float size = glm::max(max.x - min.x, max.y - min.y) * 1.001f + 0.001f;
+
+	m_order.resize(bodyCount);
+	for (int i = 0; i < bodyCount; i++)
+	{
+		m_order[i] = i;
+	}
+
+	m_nodes.reserve((bodyCount / LEAF_SIZE) * 2 + 4);
+	m_nodes.resize(1);
+	buildNode(0, min, size, 0, bodyCount, 0);
+}
+
+// Apply Forces
+void BarnesHut::applyForces(const std::vector<PhysicsObject*>& actors, float /*timeStep*/)
+{
+	buildTree(actors);
+	int bodyCount = m_bodies.size();
+	if (bodyCount == 0)
+	{
+		return;
+	}
+
+	// Every body walks the tree on its own, they only read the tree and write their own slot
+	m_accelerations.resize(bodyCount);
+#pragma omp parallel for schedule(dynamic, 256)
+	for (int i = 0; i < bodyCount; i++)
+	{
+		m_accelerations[i] = accelerationAt(i);
+	}
+
+	for (int i = 0; i < bodyCount; i++)
+	{
+		m_bodies[i]->applyForce(m_accelerations[i] * m_bodies[i]->getMass());
+	}
+}
+
+// Apply Forces To, the tree still needs every body but the walks are only paid for the targets
+void BarnesHut::applyForcesTo(const std::vector<PhysicsObject*>& actors, const std::vector<int>& targets, float /*timeStep*/)
+{
+	buildTree(actors);
+	if (m_bodies.empty())
+	{
+		return;
+	}
+
+	int targetCount = targets.size();
+	m_accelerations.resize(targetCount);
+#pragma omp parallel for schedule(dynamic, 256)
+	for (int i = 0; i < targetCount; i++)
+	{
+		int body = m_actorBodies[targets[i]];
+		m_accelerations[i] = (body >= 0) ? accelerationAt(body) : glm::vec2(0, 0);
+	}
+
+	for (int i = 0; i < targetCount; i++)
+	{
+		int body = m_actorBodies[targets[i]];
+		if (body >= 0)
+		{
+			m_bodies[body]->applyForce(m_accelerations[i] * m_bodies[body]->getMass());
+		}
+	}
+}
\ No newline at end of file
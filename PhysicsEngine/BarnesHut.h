@@ -0,0 +1,87 @@
+#pragma once
+// Include .h files
+#include "ForceGenerator.h"
+
+// Other includes
+#include <vector>
+#include <glm\vec2.hpp>
+#include <glm\glm.hpp>
+
+// Typedefs
+
+//============================================================================================================================================
+// LongRangeForce ENUM
+
+enum LongRangeForce
+{
+	GRAVITATION,	// Attracts by mass, strength is G
+	COULOMB			// Charges of the same sign repel, strength is k
+};
+
+//============================================================================================================================================
+// BarnesHut CLASS
+
+// Pairwise gravity or Coulomb forces in O(n log n). A quadtree is built over the body positions every step with the
+// centre of mass (or charge) of every node worked out bottom-up, then each body walks the tree in parallel, treating
+// any node that looks smaller than the opening angle as a single point
+class BarnesHut : public ForceGenerator
+{
+
+public:
+	BarnesHut(LongRangeForce forceType = GRAVITATION, float strength = 1.0f, float openingAngle = 0.5f, float softening = 0.1f);
+
+	virtual void applyForces(const std::vector<PhysicsObject*>& actors, float timeStep);
+	// Builds the tree over every actor but only walks it for the targets
+	virtual void applyForcesTo(const std::vector<PhysicsObject*>& actors, const std::vector<int>& targets, float timeStep);
+
+	//============================================================================================================================================
+	// Getters and Setters
+
+	// 0 is exact (every node is opened), larger angles are faster and less accurate. 0.5 is the usual trade
+	void setOpeningAngle(float openingAngle) { m_openingAngle = openingAngle; }
+	float getOpeningAngle() const { return m_openingAngle; }
+
+	void setStrength(float strength) { m_strength = strength; }
+	float getStrength() const { return m_strength; }
+
+	// Plummer softening length, stops close encounters blowing up
+	void setSoftening(float softening) { m_softening = softening; }
+	float getSoftening() const { return m_softening; }
+
+	int getNodeCount() const { return m_nodes.size(); }
+
+protected:
+	//============================================================================================================================================
+	// QuadTreeNode STRUCT
+
+	struct QuadTreeNode
+	{
+		glm::vec2 centre;		// Centre of mass (or of absolute charge)
+		float weight;			// Total mass (or signed total charge)
+		float absoluteWeight;	// Total of the absolute weights, 0 for an empty node
+		glm::vec2 min;			// Bottom left corner of the node's square
+		float size;				// Side length of the node's square
+		int firstChild;			// Index of the first of four children, -1 for a leaf
+		int firstBody;			// Leaves only, range into m_order
+		int bodyCount;
+	};
+
+	void buildTree(const std::vector<PhysicsObject*>& actors);
+	void buildNode(int nodeIndex, glm::vec2 min, float size, int firstBody, int bodyCount, int depth);
+	glm::vec2 accelerationAt(int body) const;
+
+	LongRangeForce m_forceType;
+	float m_strength;
+	float m_openingAngle;
+	float m_softening;
+
+	// Per-step body data
+	std::vector<Rigidbody*> m_bodies;
+	std::vector<int> m_actorBodies;		// Each actor's index in m_bodies, -1 if it was left out
+	std::vector<glm::vec2> m_positions;
+	std::vector<float> m_weights;		// Mass or charge
+	std::vector<int> m_order;			// Body indices, grouped by leaf
+	std::vector<glm::vec2> m_accelerations;
+
+	std::vector<QuadTreeNode> m_nodes;
+};
\ No newline at end of file
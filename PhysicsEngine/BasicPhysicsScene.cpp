@@ -0,0 +1,643 @@
+// Include .h files
+#include "BasicPhysicsScene.h"
+#include "PhysicsObject.h"
+#include "RigidBody.h"
+#include "Sphere.h"
+#include "Plane.h"
+#include "AABB.h"
+#include "Fixed64.h"
+
+// Other includes
+#include <iostream>
+#include <algorithm>
+
+// Typedefs
+
+//============================================================================================================================================
+// Constructors
+
+// Constructor
+template <class Scalar, int Dimensions>
+BasicPhysicsScene<Scalar, Dimensions>::BasicPhysicsScene()
+{
+	// Set time step to 0 and gravity to 0
+	m_timeStep = Scalar(0);
+	m_gravity = VMath::zero();
+	m_accumulatedTime = 0.0f;
+	m_sweepDirty = true;
+}
+
+// Deconstructor
+template <class Scalar, int Dimensions>
+BasicPhysicsScene<Scalar, Dimensions>::~BasicPhysicsScene()
+{
+	// Delete all actors in the scene
+	for (auto& actor : m_actors)
+	{
+		delete actor;
+	}
+	for (auto& actor : m_staticActors)
+	{
+		delete actor;
+	}
+}
+
+//============================================================================================================================================
+// Actor Functions
+
+// Add Actor
+template <class Scalar, int Dimensions>
+void BasicPhysicsScene<Scalar, Dimensions>::addActor(Object* actor)
+{
+	// Static colliders are kept apart from the bodies that move
+	m_sweepDirty = true;
+	if (actor->isStatic())
+	{
+		m_staticActors.push_back(actor);
+		return;
+	}
+
+	// Push the new Actor onto the m_actors stack
+	m_actors.push_back(actor);
+}
+
+// Remove Actor
+template <class Scalar, int Dimensions>
+void BasicPhysicsScene<Scalar, Dimensions>::removeActor(Object* actor)
+{
+	// Remove specified actor from whichever stack it lives on
+	m_actors.erase(std::remove(std::begin(m_actors), std::end(m_actors), actor), std::end(m_actors));
+	m_staticActors.erase(std::remove(std::begin(m_staticActors), std::end(m_staticActors), actor), std::end(m_staticActors));
+	m_sweepDirty = true;
+}
+
+// Remove Actors
+template <class Scalar, int Dimensions>
+void BasicPhysicsScene<Scalar, Dimensions>::removeActors(const std::vector<Object*>& actors)
+{
+	if (actors.empty())
+	{
+		return;
+	}
+
+	// Sorted so each actor on the stacks is looked up with a binary search rather than a walk of the whole list
+	std::vector<Object*> removed(actors);
+	std::sort(removed.begin(), removed.end());
+	auto isRemoved = [&removed](Object* actor) { return std::binary_search(removed.begin(), removed.end(), actor); };
+	m_actors.erase(std::remove_if(std::begin(m_actors), std::end(m_actors), isRemoved), std::end(m_actors));
+	m_staticActors.erase(std::remove_if(std::begin(m_staticActors), std::end(m_staticActors), isRemoved), std::end(m_staticActors));
+	m_sweepDirty = true;
+}
+
+// Release Actors
+template <class Scalar, int Dimensions>
+void BasicPhysicsScene<Scalar, Dimensions>::releaseActors()
+{
+	m_actors.clear();
+	m_staticActors.clear();
+	m_sweepDirty = true;
+}
+
+//============================================================================================================================================
+// Update Functions
+
+// Update
+template <class Scalar, int Dimensions>
+void BasicPhysicsScene<Scalar, Dimensions>::update(float dt)
+{
+	// Update physics at a fixed time step
+	// Increment the accumulated time by delta time
+	m_accumulatedTime += dt;
+
+	// Check if accumulated time is equal to or greater than the timestep
+	float timeStep = Math::toFloat(m_timeStep);
+	while (m_accumulatedTime >= timeStep)
+	{
+		step();
+
+		// Subtract accumulated time from timestep
+		m_accumulatedTime -= timeStep;
+	}
+}
+
+// Step, one fixed step
+template <class Scalar, int Dimensions>
+void BasicPhysicsScene<Scalar, Dimensions>::step()
+{
+	// Static colliders are never integrated
+	for (auto pActor : m_actors)
+	{
+		pActor->fixedUpdate(m_gravity, m_timeStep);
+	}
+
+	sweepPairs();
+	collidePlanes();
+}
+
+// Update Gizmos
+template <class Scalar, int Dimensions>
+void BasicPhysicsScene<Scalar, Dimensions>::updateGizmos()
+{
+	for (auto pActor : m_staticActors)
+	{
+		pActor->makeGizmo();
+	}
+	for (auto pActor : m_actors)
+	{
+		pActor->makeGizmo();
+	}
+}
+
+// Debugging
+template <class Scalar, int Dimensions>
+void BasicPhysicsScene<Scalar, Dimensions>::debugScene()
+{
+	// Set count to 0 for iteration
+	int count = 0;
+	for (auto pActor : m_staticActors)
+	{
+		std::cout << count << " : ";
+		pActor->debug();
+		count++;
+	}
+	for (auto pActor : m_actors)
+	{
+		std::cout << count << " : ";
+		pActor->debug();
+		count++;
+	}
+}
+
+// Get Checksum, FNV-1a over the raw bits
+template <class Scalar, int Dimensions>
+unsigned long long BasicPhysicsScene<Scalar, Dimensions>::getChecksum() const
+{
+	unsigned long long hash = 14695981039346656037ULL;
+	for (auto pActor : m_actors)
+	{
+		Body* body = static_cast<Body*>(pActor);
+		Vector position = body->getPosition();
+		Vector velocity = body->getVelocity();
+		for (int axis = 0; axis < Dimensions; axis++)
+		{
+			hash = (hash ^ Math::bits(position[axis])) * 1099511628211ULL;
+			hash = (hash ^ Math::bits(velocity[axis])) * 1099511628211ULL;
+		}
+	}
+	return hash;
+}
+
+//============================================================================================================================================
+// Pair Search
+
+// Get Bounds
+template <class Scalar, int Dimensions>
+void BasicPhysicsScene<Scalar, Dimensions>::getBounds(Object* actor, Vector& min, Vector& max)
+{
+	if (actor->getShapeID() == SPHERE)
+	{
+		BasicSphere<Scalar, Dimensions>* sphere = static_cast<BasicSphere<Scalar, Dimensions>*>(actor);
+		Vector reach;
+		for (int axis = 0; axis < Dimensions; axis++)
+		{
+			reach[axis] = sphere->getRadius();
+		}
+		min = sphere->getPosition() - reach;
+		max = sphere->getPosition() + reach;
+	}
+	else
+	{
+		BasicAABB<Scalar, Dimensions>* aabb = static_cast<BasicAABB<Scalar, Dimensions>*>(actor);
+		min = aabb->m_min;
+		max = aabb->m_max;
+	}
+}
+
+// Sweep Pairs, an insertion sort on the left edges, nearly free when the order barely changes between steps, then a
+// sweep along x that runs the narrowphase on any pair whose bounds overlap
+template <class Scalar, int Dimensions>
+void BasicPhysicsScene<Scalar, Dimensions>::sweepPairs()
+{
+	// Bodies came or went, start again in the order they sit on the stacks
+	if (m_sweepDirty)
+	{
+		m_sweep.clear();
+		for (auto pActor : m_actors)
+		{
+			SweepEntry entry;
+			entry.actor = pActor;
+			m_sweep.push_back(entry);
+		}
+		for (auto pStatic : m_staticActors)
+		{
+			if (pStatic->getShapeID() == SPHERE || pStatic->getShapeID() == AABB_)
+			{
+				SweepEntry entry;
+				entry.actor = pStatic;
+				m_sweep.push_back(entry);
+			}
+		}
+		m_sweepDirty = false;
+	}
+
+	int entryCount = m_sweep.size();
+	for (auto& entry : m_sweep)
+	{
+		getBounds(entry.actor, entry.min, entry.max);
+	}
+	for (int i = 1; i < entryCount; i++)
+	{
+		SweepEntry entry = m_sweep[i];
+		int slot = i;
+		while (slot > 0 && m_sweep[slot - 1].min[0] > entry.min[0])
+		{
+			m_sweep[slot] = m_sweep[slot - 1];
+			slot--;
+		}
+		m_sweep[slot] = entry;
+	}
+
+	for (int i = 0; i < entryCount; i++)
+	{
+		for (int j = i + 1; j < entryCount; j++)
+		{
+			const SweepEntry& entry1 = m_sweep[i];
+			const SweepEntry& entry2 = m_sweep[j];
+			if (entry2.min[0] > entry1.max[0])
+			{
+				break;
+			}
+
+			// Only pairs with a dynamic body in them do anything, and only if they overlap on every other axis too
+			if (!entry1.actor->isDynamic() && !entry2.actor->isDynamic())
+			{
+				continue;
+			}
+			bool apart = false;
+			for (int axis = 1; axis < Dimensions && !apart; axis++)
+			{
+				apart = (entry1.max[axis] < entry2.min[axis]) || (entry2.max[axis] < entry1.min[axis]);
+			}
+			if (apart || !entry1.actor->shouldCollide(entry2.actor))
+			{
+				continue;
+			}
+
+			collide(entry1.actor, entry2.actor);
+		}
+	}
+}
+
+// Collide Planes, every dynamic body against every Plane
+template <class Scalar, int Dimensions>
+void BasicPhysicsScene<Scalar, Dimensions>::collidePlanes()
+{
+	for (auto pStatic : m_staticActors)
+	{
+		if (pStatic->getShapeID() != PLANE)
+		{
+			continue;
+		}
+		for (auto pActor : m_actors)
+		{
+			if (pActor->isDynamic() && pActor->shouldCollide(pStatic))
+			{
+				collide(pActor, pStatic);
+			}
+		}
+	}
+}
+
+//============================================================================================================================================
+// Collision Functions
+
+// Collide, through the collision function array
+template <class Scalar, int Dimensions>
+bool BasicPhysicsScene<Scalar, Dimensions>::collide(Object* obj1, Object* obj2)
+{
+	typedef bool(*fn)(Object*, Object*);
+	static const fn collisionFunctionArray[] =
+	{
+		// Plane collides with Plane	// Plane collides with Sphere	// Plane collides with AABB	// Plane collides with SDF
+		plane2Plane,					plane2Sphere,					plane2AABB,					nullptr,
+		// Sphere collides with Plane	// Sphere collides with Sphere	// Sphere collides with AABB	// Sphere collides with SDF
+		sphere2Plane,					sphere2Sphere,					sphere2AABB,				nullptr,
+		// AABB collides with Plane		// AABB collides with Sphere	// AABB collides with AABB	// AABB collides with SDF
+		AABB2Plane,						AABB2Sphere,					AABB2AABB,					nullptr,
+		// SDF collides with Plane		// SDF collides with Sphere		// SDF collides with AABB	// SDF collides with SDF
+		nullptr,						nullptr,						nullptr,					nullptr,
+	};
+
+	fn collisionFunctionPtr = collisionFunctionArray[(obj1->getShapeID() * SHAPE_COUNT) + obj2->getShapeID()];
+	return (collisionFunctionPtr != nullptr) && collisionFunctionPtr(obj1, obj2);
+}
+
+// Plane to Plane Collision
+template <class Scalar, int Dimensions>
+bool BasicPhysicsScene<Scalar, Dimensions>::plane2Plane(Object *, Object *)
+{
+	// Return false, two static objects won't really collide anyway
+	return false;
+}
+
+// Plane to Sphere Collision
+template <class Scalar, int Dimensions>
+bool BasicPhysicsScene<Scalar, Dimensions>::plane2Sphere(Object* obj1, Object* obj2)
+{
+	// Run Sphere to Plane collission function in reverse
+	return sphere2Plane(obj2, obj1);
+}
+
+// Plane to AABB Collision
+template <class Scalar, int Dimensions>
+bool BasicPhysicsScene<Scalar, Dimensions>::plane2AABB(Object* obj1, Object* obj2)
+{
+	// Run AABB to Plane collission function in reverse
+	return AABB2Plane(obj2, obj1);
+}
+
+// Sphere to Plane Collision
+template <class Scalar, int Dimensions>
+bool BasicPhysicsScene<Scalar, Dimensions>::sphere2Plane(Object* obj1, Object* obj2)
+{
+	// Cast the Sphere to Obj1 and the Plane to Obj2
+	BasicSphere<Scalar, Dimensions> *sphere = dynamic_cast <BasicSphere<Scalar, Dimensions>*> (obj1);
+	BasicPlane<Scalar, Dimensions>  *plane  = dynamic_cast <BasicPlane<Scalar, Dimensions>*>  (obj2);
+
+	// Check if both objects actually exist
+	if (sphere != nullptr && plane != nullptr)
+	{
+		// Get the Plane's normal
+		Vector collisionNormal = plane->getNormal();
+		Scalar sphereToPlane = VMath::dot(sphere->getPosition(), plane->getNormal()) - plane->getDistanceToOrigin();
+
+		// If the sphere is behind the plane, we flip the normal
+		if (sphereToPlane < Scalar(0))
+		{
+			collisionNormal = -collisionNormal; sphereToPlane = -sphereToPlane;
+		}
+
+		// Get the intersection from the sphere to the plane
+		Scalar intersection = sphere->getRadius() - sphereToPlane;
+
+		// Check if they're actually intersecting
+		if (intersection > Scalar(0))
+		{
+			// Call resolve collision function
+			separateCollision(sphere, plane, -collisionNormal, intersection);
+			plane->resolveCollision(sphere, collisionNormal);
+			return true;
+		}
+	}
+	// Return false if either object doesn't exist
+	return false;
+}
+
+// Sphere to Sphere Collision
+template <class Scalar, int Dimensions>
+bool BasicPhysicsScene<Scalar, Dimensions>::sphere2Sphere(Object* obj1, Object* obj2)
+{
+	// Cast Sphere 1 to Obj1 and Sphere 2 to Obj2
+	BasicSphere<Scalar, Dimensions> *sphere1 = dynamic_cast <BasicSphere<Scalar, Dimensions>*> (obj1);
+	BasicSphere<Scalar, Dimensions> *sphere2 = dynamic_cast <BasicSphere<Scalar, Dimensions>*> (obj2);
+
+	// Check if both Spheres exist
+	if (sphere1 != nullptr && sphere2 != nullptr)
+	{
+		// Get the radii of both Spheres and combine them
+		Scalar combinedRadii = (sphere1->getRadius() + sphere2->getRadius());
+		// Get the distance between both Spheres
+		Scalar objectDistance = VMath::distance(sphere1->getPosition(), sphere2->getPosition());
+
+		// A variable for the collision normal, any direction will do for two Spheres on the same spot
+		Vector collisionNormal = (objectDistance > Scalar(0)) ? ((sphere1->getPosition() - sphere2->getPosition()) / objectDistance) : VMath::axis(0);
+
+		// Check if the distance between both Spheres is less than their combined radii
+		if (objectDistance < combinedRadii)
+		{
+			// Call resolve collision function
+			separateCollision(sphere1, sphere2, -collisionNormal, (combinedRadii - objectDistance));
+			sphere1->resolveCollision(sphere2, collisionNormal);
+			return true;
+		}
+	}
+
+	// Return false if either Sphere doesn't exist
+	return false;
+}
+
+// Sphere to AABB Collision
+template <class Scalar, int Dimensions>
+bool BasicPhysicsScene<Scalar, Dimensions>::sphere2AABB(Object* obj1, Object* obj2)
+{
+	// Run AABB to Sphere collission function in reverse
+	return AABB2Sphere(obj2, obj1);
+}
+
+// AABB to Plane Collision
+template <class Scalar, int Dimensions>
+bool BasicPhysicsScene<Scalar, Dimensions>::AABB2Plane(Object* obj1, Object* obj2)
+{
+	// Cast the AABB to Obj1 and the Plane to Obj2
+	BasicAABB<Scalar, Dimensions>  *aabb  = dynamic_cast <BasicAABB<Scalar, Dimensions>*>  (obj1);
+	BasicPlane<Scalar, Dimensions> *plane = dynamic_cast <BasicPlane<Scalar, Dimensions>*> (obj2);
+
+	// Check if both objects actually exist
+	if (aabb != nullptr && plane != nullptr)
+	{
+		// Get the Plane's normal
+		Vector collisionNormal = plane->getNormal();
+
+		// Dot product every corner of the AABB by the Plane's normal, a corner takes the min or the max on each axis by
+		// the bits of its number, and keep the lowest (furthest) overlap
+		Scalar lowestValue = Scalar(0);
+		for (int cornerIndex = 0; cornerIndex < (1 << Dimensions); cornerIndex++)
+		{
+			Vector corner;
+			for (int axis = 0; axis < Dimensions; axis++)
+			{
+				corner[axis] = (cornerIndex & (1 << axis)) ? aabb->m_max[axis] : aabb->m_min[axis];
+			}
+			Scalar overlap = VMath::dot(corner, collisionNormal) - plane->getDistanceToOrigin();
+			if (cornerIndex == 0 || overlap < lowestValue)
+			{
+				lowestValue = overlap;
+			}
+		}
+
+		// Check if any of the corners are below the plane
+		if (lowestValue < Scalar(0))
+		{
+			// Call resolve collision function, the deepest corner is how far the AABB has to move back out
+			separateCollision(aabb, plane, -collisionNormal, -lowestValue);
+			plane->resolveCollision(aabb, collisionNormal);
+			return true;
+		}
+	}
+	// Return false if either object doesn't exist
+	return false;
+}
+
+// AABB to Sphere Collision
+template <class Scalar, int Dimensions>
+bool BasicPhysicsScene<Scalar, Dimensions>::AABB2Sphere(Object* obj1, Object* obj2)
+{
+	// Cast the AABB to Obj1 and the Sphere to Obj2
+	BasicAABB<Scalar, Dimensions>   *aabb   = dynamic_cast <BasicAABB<Scalar, Dimensions>*>   (obj1);
+	BasicSphere<Scalar, Dimensions> *sphere = dynamic_cast <BasicSphere<Scalar, Dimensions>*> (obj2);
+
+	// Check if both objects exist
+	if (aabb != nullptr && sphere != nullptr)
+	{
+		// Get a clamped position with the AABB and the Sphere
+		Vector clampedPosition = VMath::clamp(sphere->getPosition(), aabb->m_min, aabb->m_max);
+
+		// A variable for the distance between the Sphere and the clamped position
+		Scalar objectDistance = VMath::length(sphere->getPosition() - clampedPosition);
+
+		// A variable for the collision normal
+		Vector collisionNormal;
+
+		// A variable for the overlap
+		Scalar overlap;
+
+		if (objectDistance > Scalar(0))
+		{
+			collisionNormal = (sphere->getPosition() - clampedPosition) / objectDistance;
+			overlap = (sphere->getRadius() - objectDistance);
+		}
+		else
+		{
+			// The Sphere's centre is inside the AABB, push it out through the nearest face, the later axis on a tie
+			Vector toCentre = sphere->getPosition() - aabb->getPosition();
+			Vector faceDepth = aabb->getExtents() - VMath::abs(toCentre);
+			int nearestAxis = 0;
+			for (int axis = 1; axis < Dimensions; axis++)
+			{
+				if (!(faceDepth[nearestAxis] < faceDepth[axis]))
+				{
+					nearestAxis = axis;
+				}
+			}
+			collisionNormal = VMath::axis(nearestAxis, (toCentre[nearestAxis] >= Scalar(0)) ? Scalar(1) : Scalar(-1));
+			overlap = sphere->getRadius() + faceDepth[nearestAxis];
+		}
+
+		// Check if the objectDistance is less than the Sphere's radius
+		if (objectDistance < sphere->getRadius())
+		{
+			// Call resolve collision function
+			separateCollision(aabb, sphere, collisionNormal, overlap);
+			aabb->resolveCollision(sphere, collisionNormal);
+			return true;
+		}
+	}
+
+	// Return false if either object doesn't exist
+	return false;
+}
+
+// AABB to AABB Collision
+template <class Scalar, int Dimensions>
+bool BasicPhysicsScene<Scalar, Dimensions>::AABB2AABB(Object* obj1, Object* obj2)
+{
+	//// Cast AABB 1 to Obj1 and AABB 2 to Obj2
+	BasicAABB<Scalar, Dimensions> *aabb1 = dynamic_cast <BasicAABB<Scalar, Dimensions>*> (obj1);
+	BasicAABB<Scalar, Dimensions> *aabb2 = dynamic_cast <BasicAABB<Scalar, Dimensions>*> (obj2);
+
+	// Check if both AABBs actually exist
+	if (aabb1 != nullptr && aabb2 != nullptr)
+	{
+		// Check if the AABBs are colliding
+		for (int axis = 0; axis < Dimensions; axis++)
+		{
+			if ((aabb1->m_max[axis]) < (aabb2->m_min[axis]) || (aabb1->m_min[axis]) > (aabb2->m_max[axis]))
+			{
+				return false;
+			}
+		}
+
+		// How far the AABBs would have to move to come apart each way along each axis, the least of them is the
+		// collision normal, set to the right by default
+		Vector collisionNormal = VMath::axis(0);
+		Scalar overlap = (aabb1->m_max[0]) - (aabb2->m_min[0]);
+		for (int axis = 0; axis < Dimensions; axis++)
+		{
+			Scalar forwards = (aabb1->m_max[axis]) - (aabb2->m_min[axis]);
+			Scalar backwards = (aabb2->m_max[axis]) - (aabb1->m_min[axis]);
+			if (Math::abs(forwards) < Math::abs(overlap)) { collisionNormal = VMath::axis(axis); overlap = forwards; }
+			if (Math::abs(backwards) < Math::abs(overlap)) { collisionNormal = VMath::axis(axis, Scalar(-1)); overlap = backwards; }
+		}
+
+		// Call resolve collision function
+		separateCollision(aabb1, aabb2, collisionNormal, overlap);
+		aabb1->resolveCollision(aabb2, collisionNormal);
+		return true;
+	}
+
+	// Return false if either object doesn't exist
+	return false;
+}
+
+// Separate Collsion
+template <class Scalar, int Dimensions>
+void BasicPhysicsScene<Scalar, Dimensions>::separateCollision(Object* obj1, Object* obj2, Vector normal, Scalar overlap)
+{
+	// Static and kinematic Objects are never pushed, only the dynamic side of the pair moves
+	bool firstIsStatic = !obj1->isDynamic();
+	bool secondIsStatic = !obj2->isDynamic();
+
+	// If the first Object is static, push the second Object out by the whole overlap
+	if (firstIsStatic && !secondIsStatic)
+	{
+		// Cast rigidbody to Object 2
+		Body *rigidBody = dynamic_cast<Body*>(obj2);
+		if (rigidBody)
+		{
+			// Set a variable with the current position
+			Vector currentPosition = rigidBody->getPosition();
+			// Set position of the Object
+			rigidBody->setPosition(currentPosition + (overlap * normal));
+		}
+	}
+	// If the second Object is static, push the first Object out by the whole overlap
+	if (secondIsStatic && !firstIsStatic)
+	{
+		// Cast rigidbody to Object 1
+		Body *rigidBody = dynamic_cast<Body*>(obj1);
+		if (rigidBody)
+		{
+			// Set a variable with the current position
+			Vector currentPosition = rigidBody->getPosition();
+			// Set position of the Object
+			rigidBody->setPosition(currentPosition - (overlap * normal));
+		}
+	}
+	// If neither Object is static
+	if (!firstIsStatic && !secondIsStatic)
+	{
+		// Cast rigidbody1 to Object 1
+		Body *rigidBody1 = dynamic_cast<Body*>(obj1);
+		// Cast rigidbody2 to Object 2
+		Body *rigidBody2 = dynamic_cast<Body*>(obj2);
+		if (rigidBody1 && rigidBody2)
+		{
+			// Set a variable with Object 1's and Object 2's current positions
+			Vector currentPosition1 = rigidBody1->getPosition();
+			Vector currentPosition2 = rigidBody2->getPosition();
+			// Set position of the Objects
+			Scalar half = Scalar(1) / Scalar(2);
+			rigidBody1->setPosition(currentPosition1 - ((overlap * normal) * half));
+			rigidBody2->setPosition(currentPosition2 + ((overlap * normal) * half));
+		}
+	}
+}
+
+//============================================================================================================================================
+// Instantiations
+
+// float for PhysicsScene, double and Q32.32 fixed point for long runs and lockstep, and float in 3D
+template class BasicPhysicsScene<float, 2>;
+template class BasicPhysicsScene<double, 2>;
+template class BasicPhysicsScene<Fixed64, 2>;
+template class BasicPhysicsScene<float, 3>;
\ No newline at end of file
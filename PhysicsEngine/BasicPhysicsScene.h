@@ -0,0 +1,99 @@
+#pragma once
+// Include .h files
+#include "PhysicsObject.h"
+
+// Other includes
+#include <vector>
+#include <glm\glm.hpp>
+
+// Typedefs
+
+//============================================================================================================================================
+// BasicPhysicsScene CLASS
+
+// The core every scene is built on, over the same scalar type and number of dimensions as its bodies: the actors, the
+// fixed step, and the Sphere, AABB and Plane collision routines with their separation and impulses. PhysicsScene is the
+// float 2D one with the broadphase, solvers, fluids and the rest on top. Any other instantiation (double for long runs
+// float would drift on, Q32.32 fixed point for lockstep, and 3D) steps here: bodies integrate with fixedUpdate, pairs
+// come from a sort-and-sweep along x kept sorted with an insertion sort, so the order pairs are resolved in, and so the
+// result, depends only on the bodies, and every dynamic body is tested against every Plane
+template <class Scalar, int Dimensions>
+class BasicPhysicsScene
+{
+
+public:
+	typedef BasicPhysicsObject<Scalar, Dimensions> Object;
+	typedef BasicRigidbody<Scalar, Dimensions> Body;
+	typedef typename Object::Vector Vector;
+	typedef ScalarMath<Scalar> Math;
+	typedef VectorMath<Scalar, Dimensions> VMath;
+
+	BasicPhysicsScene();
+	virtual ~BasicPhysicsScene();
+
+	virtual void addActor(Object* actor);
+	virtual void removeActor(Object* actor);
+	virtual void removeActors(const std::vector<Object*>& actors);	// One pass over the stacks however many are removed
+	virtual void releaseActors();	// Drops every actor without deleting it, for actors owned by something else (see SceneFork)
+
+	// Moving bodies in the order they were added, and the static colliders
+	const std::vector<Object*>& getActors() const { return m_actors; }
+	const std::vector<Object*>& getStaticActors() const { return m_staticActors; }
+
+	virtual void update(float dt);
+	virtual void step();	// One fixed step of the time step, whatever time has built up
+	virtual void updateGizmos();
+	void debugScene();
+
+	void setGravity(const Vector gravity) { m_gravity = gravity; }
+	Vector getGravity() const { return m_gravity; }
+
+	void setTimeStep(const float timeStep) { m_timeStep = Math::fromFloat(timeStep); }
+	float getTimeStep() const { return Math::toFloat(m_timeStep); }
+
+	// Hash of every moving body's position and velocity bits, equal checksums mean identical runs
+	unsigned long long getChecksum() const;
+
+	//============================================================================================================================================
+	// Collision
+
+	// Runs the shape routine for the pair, if there is one. Returns whether they touched
+	static bool collide(Object* obj1, Object* obj2);
+	// Planes
+	static bool plane2Plane(Object* obj1, Object* obj2);
+	static bool plane2Sphere(Object* obj1, Object* obj2);
+	static bool plane2AABB(Object* obj1, Object* obj2);
+	// Spheres
+	static bool sphere2Plane(Object* obj1, Object* obj2);
+	static bool sphere2Sphere(Object* obj1, Object* obj2);
+	static bool sphere2AABB(Object* obj1, Object* obj2);
+	// AABBs
+	static bool AABB2Plane(Object* obj1, Object* obj2);
+	static bool AABB2Sphere(Object* obj1, Object* obj2);
+	static bool AABB2AABB(Object* obj1, Object* obj2);
+
+	static void separateCollision(Object* obj1, Object* obj2, Vector normal, Scalar overlap);
+
+protected:
+	// A body in the sweep with its bounds from this step
+	struct SweepEntry
+	{
+		Object* actor;
+		Vector min;
+		Vector max;
+	};
+
+	void sweepPairs();
+	void collidePlanes();
+	static void getBounds(Object* actor, Vector& min, Vector& max);
+
+	Vector m_gravity;
+	Scalar m_timeStep;
+	float m_accumulatedTime;	// Time not yet stepped, each scene keeps its own so many can run side by side
+	std::vector<Object*> m_actors;			// Dynamic and kinematic bodies, integrated and paired every step
+	std::vector<Object*> m_staticActors;	// Static colliders, never integrated and never paired with each other
+
+	// Every body but the Planes by the left edge of its bounds, kept from step to step
+	std::vector<SweepEntry> m_sweep;
+	bool m_sweepDirty;
+};
\ No newline at end of file
@@ -0,0 +1,1520 @@
+// Include .h files
+#include "Benchmarks.h"
+#include "PhysicsScene.h"
+#include "Sphere.h"
+#include "Plane.h"
+#include "AABB.h"
+#include "BarnesHut.h"
+#include "BasicPhysicsScene.h"
+#include "TiledWorld.h"
+#include "EnsembleRunner.h"
+#include "TrajectoryPredictor.h"
+#include "SceneFork.h"
+#include "SdfCollider.h"
+
+// Other includes
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <omp.h>
+
+// Typedefs
+typedef std::chrono::high_resolution_clock Clock;
+
+// Same launch as the commented out setupContinuousDemo call in PhysicsEngineApp::startup
+static const glm::vec2 PROJECTILE_START(-100, -50);
+static const float PROJECTILE_INCLINATION = 3.14f * 0.33f;
+static const float PROJECTILE_SPEED = 25.0f;
+static const float PROJECTILE_GRAVITY = -10.0f;
+static const float PROJECTILE_TIME = 5.0f;
+
+// Orbits round a body of GM = ORBIT_MU, the innermost takes about 2 seconds to go round
+static const float ORBIT_MU = 10000.0f;
+static const float ORBIT_ECCENTRICITY = 0.8f;
+static const float ORBIT_TIME = 4.0f;
+static const float ORBIT_OUTPUT_INTERVAL = 0.1f;
+static const int ORBIT_COUNT = 100;
+
+// Enough bodies that the cost of a step is the integrator's rather than the scene's overhead
+static const int PROJECTILE_COUNT = 2000;
+static const float PROJECTILE_SPACING = 3.0f;
+
+// A closed box of mixed bodies, each scalar type runs the same scene from the same start
+static const int SCALAR_BODY_COUNT = 2000;
+static const int SCALAR_COLUMNS = 50;
+static const float SCALAR_BOX_HALF_SIZE = 100.0f;
+static const float SCALAR_TIME_STEP = 0.01f;
+static const int SCALAR_STEPS = 1000;
+
+// A projectile launched far from the origin, where float has few bits left for the fraction
+static const glm::vec2 FAR_START(1000000.0f, 0.0f);
+static const glm::vec2 FAR_VELOCITY(3.0f, 20.0f);
+static const int FAR_STEPS = 500;
+
+// A band of bricks TILED_ROWS high, as long as the brick count needs, swept by one region
+static const int TILED_ROWS = 100;
+static const float TILED_SPACING = 2.0f;
+static const float TILED_TILE_SIZE = 20.0f;
+static const float TILED_REGION_RADIUS = 30.0f;
+static const float TILED_REGION_SPEED = 40.0f;
+static const int TILED_STEPS = 2000;
+
+// A wide field of drifting bodies with one focus point in the middle
+static const int LOD_BODY_COUNT = 20000;
+static const float LOD_FIELD_HALF_SIZE = 500.0f;
+static const float LOD_NEAR_DISTANCE = 100.0f;
+static const float LOD_FAR_DISTANCE = 250.0f;
+static const int LOD_STEPS = 1000;
+
+// Morton reordering, a field of bodies added in random order
+static const int LOCALITY_BODY_COUNT = 200000;
+static const float LOCALITY_FIELD_HALF_SIZE = 1500.0f;
+static const int LOCALITY_STEPS = 200;
+static const int LOCALITY_INTERVAL = 50;
+
+// Body layout, a field of bodies in a few materials and colours
+static const int LAYOUT_BODY_COUNT = 200000;
+static const float LAYOUT_FIELD_HALF_SIZE = 1500.0f;
+static const int LAYOUT_STEPS = 200;
+static const int LAYOUT_MATERIAL_COUNT = 4;
+
+// Ensemble sweep, the projectile launch over a grid of angles and speeds onto flat ground
+static const int ENSEMBLE_ANGLE_COUNT = 100;
+static const int ENSEMBLE_SPEED_COUNT = 100;
+static const float ENSEMBLE_GROUND = -60.0f;
+static const float ENSEMBLE_RADIUS = 1.0f;
+
+// Ensemble pile, a few balls thrown together onto the same ground so each run's bodies collide with each other
+static const int ENSEMBLE_PILE_RUNS = 64;
+static const int ENSEMBLE_PILE_BODIES = 12;
+
+// Trajectory benchmark, aiming previews fanned over angles and speeds from the continuous demo's start
+static const int TRAJECTORY_BODY_COUNT = 10000;
+static const int TRAJECTORY_SAMPLES = 64;
+static const int TRAJECTORY_REPEATS = 20;
+
+// Scene fork, a box of mixed bodies falling under gravity, forked and looked ahead once a frame
+static const int FORK_BODY_COUNT = 10000;
+static const int FORK_COLUMNS = 100;
+static const float FORK_BOX_HALF_SIZE = 200.0f;
+static const int FORK_FRAMES = 5;
+
+// Rollback, the same kind of box with a history, rewound a few steps and re-simulated every frame
+static const int ROLLBACK_BODY_COUNT = 5000;
+static const int ROLLBACK_HISTORY = 64;
+static const int ROLLBACK_KEYFRAME_INTERVAL = 16;
+static const int ROLLBACK_STEPS = 8;
+static const int ROLLBACK_FRAMES = 100;
+
+// Contact events, the same kind of box stepped with the event stream off and on, then with LOD scheduling and with
+// bodies deleted and replaced every step
+static const int CONTACT_BODY_COUNT = 10000;
+static const int CONTACT_STEPS = 200;
+static const int CONTACT_CHURN = 20;
+
+// Signed distance fields, a funnel of curved walls baked from finer and finer polylines with bodies poured through it
+static const int SDF_BODY_COUNT = 4000;
+static const int SDF_COLUMNS = 60;
+static const int SDF_STEPS = 300;
+static const int SDF_LOOKUPS = 1000000;
+static const int SDF_MIP_LEVELS = 4;
+static const float SDF_CELL_SIZE = 1.0f;
+static const float SDF_WALL_RADIUS = 1.5f;
+static const int SDF_MASK_SIZE = 512;
+
+//============================================================================================================================================
+// Benchmarks
+
+// Run Benchmarks
+void runBenchmarks(const char* name)
+{
+	bool all = (name == nullptr);
+	if (all || std::strcmp(name, "integrators") == 0)
+	{
+		runIntegratorBenchmark();
+	}
+	if (all || std::strcmp(name, "adaptive") == 0)
+	{
+		runAdaptiveBenchmark();
+	}
+	if (all || std::strcmp(name, "scalar") == 0)
+	{
+		runScalarBenchmark();
+	}
+	if (all || std::strcmp(name, "tiled") == 0)
+	{
+		runTiledWorldBenchmark();
+	}
+	if (all || std::strcmp(name, "lod") == 0)
+	{
+		runLodBenchmark();
+	}
+	if (all || std::strcmp(name, "locality") == 0)
+	{
+		runLocalityBenchmark();
+	}
+	if (all || std::strcmp(name, "layout") == 0)
+	{
+		runLayoutBenchmark();
+	}
+	if (all || std::strcmp(name, "ensemble") == 0)
+	{
+		runEnsembleBenchmark();
+	}
+	if (all || std::strcmp(name, "trajectory") == 0)
+	{
+		runTrajectoryBenchmark();
+	}
+	if (all || std::strcmp(name, "fork") == 0)
+	{
+		runSceneForkBenchmark();
+	}
+	if (all || std::strcmp(name, "rollback") == 0)
+	{
+		runRollbackBenchmark();
+	}
+	if (all || std::strcmp(name, "contacts") == 0)
+	{
+		runContactEventBenchmark();
+	}
+	if (all || std::strcmp(name, "sdf") == 0)
+	{
+		runSdfBenchmark();
+	}
+}
+
+//============================================================================================================================================
+// Integrator Benchmark
+
+// Projectile Position, closed form for constant gravity and linear drag
+static glm::vec2 projectilePosition(glm::vec2 velocity, float drag, float time)
+{
+	glm::vec2 gravity(0, PROJECTILE_GRAVITY);
+	if (drag == 0.0f)
+	{
+		return PROJECTILE_START + (velocity * time) + (0.5f * gravity * time * time);
+	}
+
+	// Velocity relaxes towards the terminal velocity gravity / drag
+	double decay = (1.0 - std::exp(-(double)drag * time)) / drag;
+	glm::dvec2 terminal = glm::dvec2(gravity) / (double)drag;
+	glm::dvec2 position = glm::dvec2(PROJECTILE_START) + (terminal * (double)time) + ((glm::dvec2(velocity) - terminal) * decay);
+	return glm::vec2(position);
+}
+
+// Run Integrator Benchmark
+void runIntegratorBenchmark()
+{
+	const IntegratorType integrators[] = { SEMI_IMPLICIT_EULER, VELOCITY_VERLET, LEAPFROG, RUNGE_KUTTA_4, YOSHIDA_4 };
+	const char* integratorNames[] = { "Semi-implicit Euler", "Velocity Verlet", "Leapfrog", "RK4", "Yoshida 4" };
+	const float timeSteps[] = { 0.001f, 0.01f, 0.05f, 0.1f };
+	const float drags[] = { 0.0f, 0.5f };
+
+	glm::vec2 velocity = glm::vec2(std::sin(PROJECTILE_INCLINATION), std::cos(PROJECTILE_INCLINATION)) * PROJECTILE_SPEED;
+
+	for (float drag : drags)
+	{
+		glm::vec2 expected = projectilePosition(velocity, drag, PROJECTILE_TIME);
+		std::printf("Projectile, %d bodies, %.1fs, linear drag %.1f\n", PROJECTILE_COUNT, PROJECTILE_TIME, drag);
+		std::printf("%-20s %10s %14s %14s %16s\n", "Integrator", "Step", "Error", "Force passes", "ns/body/step");
+
+		for (int i = 0; i < 5; i++)
+		{
+			for (float timeStep : timeSteps)
+			{
+				PhysicsScene scene;
+				scene.setGravity(glm::vec2(0, PROJECTILE_GRAVITY));
+				scene.setTimeStep(timeStep);
+				scene.setIntegrator(integrators[i]);
+
+				// Launched side by side so the broadphase isn't piling them all into one cell
+				std::vector<Sphere*> projectiles;
+				for (int body = 0; body < PROJECTILE_COUNT; body++)
+				{
+					Sphere* projectile = new Sphere(PROJECTILE_START + glm::vec2(body * PROJECTILE_SPACING, 0), velocity, glm::vec2(0, 0), 1.0f, 1.0f, 1.0f, glm::vec4(1, 1, 0, 1));
+					projectile->setLinearDrag(drag);
+					// Projectiles fly through each other so only the integration is measured
+					projectile->setCollisionFilter(0x0002, 0x0000);
+					scene.addActor(projectile);
+					projectiles.push_back(projectile);
+				}
+
+				int steps = (int)std::floor((PROJECTILE_TIME / timeStep) + 0.5f);
+				Clock::time_point start = Clock::now();
+				for (int step = 0; step < steps; step++)
+				{
+					scene.update(timeStep);
+				}
+				double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+				// Measured on the first projectile, the ones further along lose more to float rounding the bigger their x
+				float error = glm::length(projectiles[0]->getPosition() - expected);
+				long long forcePasses = (integrators[i] == SEMI_IMPLICIT_EULER) ? steps : scene.getBodyIntegrator().getEvaluationCount();
+				double nanoseconds = (seconds * 1e9) / ((double)steps * PROJECTILE_COUNT);
+				std::printf("%-20s %10.3f %14.6f %14lld %16.1f\n", integratorNames[i], timeStep, error, forcePasses / steps, nanoseconds);
+			}
+		}
+		std::printf("\n");
+	}
+}
+
+//============================================================================================================================================
+// Adaptive Benchmark
+
+// Orbit Position, solves Kepler's equation for an orbit that starts at pericentre along the given direction
+static glm::vec2 orbitPosition(float semiMajorAxis, float angle, float time)
+{
+	double e = ORBIT_ECCENTRICITY;
+	double meanAnomaly = std::sqrt(ORBIT_MU / std::pow((double)semiMajorAxis, 3.0)) * time;
+	double eccentricAnomaly = meanAnomaly;
+	for (int iteration = 0; iteration < 50; iteration++)
+	{
+		eccentricAnomaly -= (eccentricAnomaly - (e * std::sin(eccentricAnomaly)) - meanAnomaly) / (1.0 - (e * std::cos(eccentricAnomaly)));
+	}
+
+	double x = semiMajorAxis * (std::cos(eccentricAnomaly) - e);
+	double y = semiMajorAxis * std::sqrt(1.0 - (e * e)) * std::sin(eccentricAnomaly);
+	return glm::vec2((float)((x * std::cos(angle)) - (y * std::sin(angle))), (float)((x * std::sin(angle)) + (y * std::cos(angle))));
+}
+
+// Run Orbits, returns the worst position error at the end and fills in the cost
+static float runOrbits(bool adaptive, float timeStep, float tolerance, long long& evaluations, double& seconds)
+{
+	PhysicsScene scene;
+	scene.setTimeStep(adaptive ? ORBIT_OUTPUT_INTERVAL : timeStep);
+	scene.setIntegrator(RUNGE_KUTTA_4);
+	scene.setAdaptiveStepping(adaptive);
+	scene.getAdaptiveIntegrator().setTolerance(tolerance, tolerance);
+
+	// The heavy body is held still so the orbits are exact Kepler ellipses
+	Sphere* sun = new Sphere(glm::vec2(0, 0), glm::vec2(0, 0), glm::vec2(0, 0), ORBIT_MU, 1.0f, 1.0f, glm::vec4(1, 1, 0, 1));
+	sun->setBodyType(KINEMATIC_BODY);
+	sun->setCollisionFilter(0x0002, 0x0000);
+	scene.addActor(sun);
+
+	std::vector<Sphere*> planets;
+	std::vector<float> semiMajorAxes;
+	std::vector<float> angles;
+	for (int i = 0; i < ORBIT_COUNT; i++)
+	{
+		float semiMajorAxis = 10.0f + (30.0f * i / ORBIT_COUNT);
+		float angle = 2.39996f * i;
+		float periapsisSpeed = std::sqrt(ORBIT_MU * (1.0f + ORBIT_ECCENTRICITY) / (semiMajorAxis * (1.0f - ORBIT_ECCENTRICITY)));
+		glm::vec2 direction(std::cos(angle), std::sin(angle));
+
+		// Light enough that they don't disturb each other
+		Sphere* planet = new Sphere(direction * semiMajorAxis * (1.0f - ORBIT_ECCENTRICITY), glm::vec2(-direction.y, direction.x) * periapsisSpeed, glm::vec2(0, 0), 1e-6f, 0.2f, 1.0f, glm::vec4(1, 1, 1, 1));
+		planet->setCollisionFilter(0x0002, 0x0000);
+		scene.addActor(planet);
+		planets.push_back(planet);
+		semiMajorAxes.push_back(semiMajorAxis);
+		angles.push_back(angle);
+	}
+	scene.addForceGenerator(new BarnesHut(GRAVITATION, 1.0f, 0.5f, 1e-3f));
+
+	float step = scene.getTimeStep();
+	int steps = (int)std::floor((ORBIT_TIME / step) + 0.5f);
+	Clock::time_point start = Clock::now();
+	for (int i = 0; i < steps; i++)
+	{
+		scene.update(step);
+	}
+	seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	evaluations = adaptive ? scene.getAdaptiveIntegrator().getBodyEvaluationCount() : scene.getBodyIntegrator().getEvaluationCount() * ORBIT_COUNT;
+
+	float error = 0.0f;
+	for (int i = 0; i < ORBIT_COUNT; i++)
+	{
+		error = glm::max(error, glm::length(planets[i]->getPosition() - orbitPosition(semiMajorAxes[i], angles[i], ORBIT_TIME)));
+	}
+	return error;
+}
+
+// Run Adaptive Benchmark
+void runAdaptiveBenchmark()
+{
+	const float timeSteps[] = { 0.01f, 0.0025f, 0.001f };
+	const float tolerances[] = { 1e-3f, 1e-4f, 1e-5f, 1e-6f };
+
+	std::printf("Kepler orbits, %d bodies, eccentricity %.1f, %.1fs\n", ORBIT_COUNT, ORBIT_ECCENTRICITY, ORBIT_TIME);
+	std::printf("%-24s %14s %18s %12s\n", "Integrator", "Error", "Body evaluations", "Seconds");
+
+	for (float timeStep : timeSteps)
+	{
+		long long evaluations = 0;
+		double seconds = 0.0;
+		float error = runOrbits(false, timeStep, 0.0f, evaluations, seconds);
+		std::printf("RK4 step %-15.4f %14.6f %18lld %12.3f\n", timeStep, error, evaluations, seconds);
+	}
+	for (float tolerance : tolerances)
+	{
+		long long evaluations = 0;
+		double seconds = 0.0;
+		float error = runOrbits(true, 0.0f, tolerance, evaluations, seconds);
+		std::printf("Adaptive tolerance %-5g %14.6f %18lld %12.3f\n", tolerance, error, evaluations, seconds);
+	}
+	std::printf("\n");
+}
+
+//============================================================================================================================================
+// Scalar Benchmark
+
+// Get Kinetic Energy, of every body in a scalar scene
+template <class Scalar>
+static float getKineticEnergy(const BasicPhysicsScene<Scalar, 2>& scene)
+{
+	typedef ScalarMath<Scalar> Math;
+	double energy = 0.0;
+	for (auto pActor : scene.getActors())
+	{
+		BasicRigidbody<Scalar, 2>* body = static_cast<BasicRigidbody<Scalar, 2>*>(pActor);
+		double speedSquared = Math::toDouble(VectorMath<Scalar, 2>::dot(body->getVelocity(), body->getVelocity()));
+		energy += 0.5 * Math::toDouble(body->getMass()) * speedSquared;
+	}
+	return (float)energy;
+}
+
+// Run Scalar Box, prints one row for the scalar type
+template <class Scalar>
+static void runScalarBox()
+{
+	typedef ScalarMath<Scalar> Math;
+	typedef VectorMath<Scalar, 2> VMath;
+
+	BasicPhysicsScene<Scalar, 2> scene;
+	scene.setGravity(VMath::fromFloat(glm::vec2(0, PROJECTILE_GRAVITY)));
+	scene.setTimeStep(SCALAR_TIME_STEP);
+	Scalar boxDistance = Math::fromFloat(-SCALAR_BOX_HALF_SIZE);
+	scene.addActor(new BasicPlane<Scalar, 2>(VMath::fromFloat(glm::vec2(1, 0)), boxDistance, glm::vec4(1, 1, 1, 1)));
+	scene.addActor(new BasicPlane<Scalar, 2>(VMath::fromFloat(glm::vec2(-1, 0)), boxDistance, glm::vec4(1, 1, 1, 1)));
+	scene.addActor(new BasicPlane<Scalar, 2>(VMath::fromFloat(glm::vec2(0, 1)), boxDistance, glm::vec4(1, 1, 1, 1)));
+	scene.addActor(new BasicPlane<Scalar, 2>(VMath::fromFloat(glm::vec2(0, -1)), boxDistance, glm::vec4(1, 1, 1, 1)));
+
+	// Same pseudo random velocities for every type
+	unsigned int seed = 12345;
+	for (int body = 0; body < SCALAR_BODY_COUNT; body++)
+	{
+		glm::vec2 position(-75.0f + (body % SCALAR_COLUMNS) * 3.0f, -60.0f + (body / SCALAR_COLUMNS) * 3.0f);
+		seed = seed * 1664525u + 1013904223u;
+		float velocityX = ((seed >> 8) % 2001) / 100.0f - 10.0f;
+		seed = seed * 1664525u + 1013904223u;
+		float velocityY = ((seed >> 8) % 2001) / 100.0f - 10.0f;
+		if (body % 2 == 0)
+		{
+			scene.addActor(new BasicSphere<Scalar, 2>(VMath::fromFloat(position), VMath::fromFloat(glm::vec2(velocityX, velocityY)), VMath::zero(), Scalar(1), Scalar(1), 0.9f, glm::vec4(1, 1, 1, 1)));
+		}
+		else
+		{
+			scene.addActor(new BasicAABB<Scalar, 2>(VMath::fromFloat(position), VMath::fromFloat(glm::vec2(velocityX, velocityY)), VMath::zero(), VMath::fromFloat(glm::vec2(1.0f, 0.75f)), Scalar(1), 0.9f, glm::vec4(1, 1, 1, 1)));
+		}
+	}
+
+	float startEnergy = getKineticEnergy(scene);
+	Clock::time_point start = Clock::now();
+	for (int step = 0; step < SCALAR_STEPS; step++)
+	{
+		scene.step();
+	}
+	double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	std::printf("%-10s %14.4f %14.1f %14.1f %20llx\n", Math::getName(), (seconds * 1000.0) / SCALAR_STEPS, startEnergy, getKineticEnergy(scene), scene.getChecksum());
+}
+
+// Run Far Projectile, returns how far the scalar type's result is from the exact result of the same steps
+template <class Scalar>
+static double runFarProjectile()
+{
+	typedef VectorMath<Scalar, 2> VMath;
+
+	BasicPhysicsScene<Scalar, 2> scene;
+	scene.setGravity(VMath::fromFloat(glm::vec2(0, PROJECTILE_GRAVITY)));
+	scene.setTimeStep(SCALAR_TIME_STEP);
+	BasicSphere<Scalar, 2>* projectile = new BasicSphere<Scalar, 2>(VMath::fromFloat(FAR_START), VMath::fromFloat(FAR_VELOCITY), VMath::zero(), Scalar(1), Scalar(1), 1.0f, glm::vec4(1, 1, 1, 1));
+	scene.addActor(projectile);
+	for (int step = 0; step < FAR_STEPS; step++)
+	{
+		scene.step();
+	}
+
+	// Semi-implicit Euler adds gravity before moving, so after n steps x = x0 + v0 n h + g h^2 n (n + 1) / 2
+	double timeStep = SCALAR_TIME_STEP;
+	double steps = FAR_STEPS;
+	double expectedX = (double)FAR_START.x + (double)FAR_VELOCITY.x * steps * timeStep;
+	double expectedY = (double)FAR_START.y + (double)FAR_VELOCITY.y * steps * timeStep + (double)PROJECTILE_GRAVITY * timeStep * timeStep * steps * (steps + 1.0) * 0.5;
+
+	typename VMath::Vector position = projectile->getPosition();
+	double errorX = ScalarMath<Scalar>::toDouble(position[0]) - expectedX;
+	double errorY = ScalarMath<Scalar>::toDouble(position[1]) - expectedY;
+	return std::sqrt((errorX * errorX) + (errorY * errorY));
+}
+
+// Run Scalar Benchmark
+void runScalarBenchmark()
+{
+	std::printf("Box of %d Spheres and AABBs, %d steps\n", SCALAR_BODY_COUNT, SCALAR_STEPS);
+	std::printf("%-10s %14s %14s %14s %20s\n", "Scalar", "ms/step", "Start energy", "End energy", "Checksum");
+	runScalarBox<float>();
+	runScalarBox<double>();
+	runScalarBox<Fixed64>();
+	std::printf("\n");
+
+	std::printf("Projectile from x = %.0f, %d steps, error against exact arithmetic\n", FAR_START.x, FAR_STEPS);
+	std::printf("%-10s %14s\n", "Scalar", "Error");
+	std::printf("%-10s %14.8f\n", ScalarMath<float>::getName(), runFarProjectile<float>());
+	std::printf("%-10s %14.8f\n", ScalarMath<double>::getName(), runFarProjectile<double>());
+	std::printf("%-10s %14.8f\n", ScalarMath<Fixed64>::getName(), runFarProjectile<Fixed64>());
+	std::printf("\n");
+}
+
+//============================================================================================================================================
+// Tiled World Benchmark
+
+// Run Tiled World Benchmark
+void runTiledWorldBenchmark()
+{
+	const int brickCounts[] = { 10000, 100000, 1000000 };
+
+	std::printf("Tiled world, band of bricks swept by a region of radius %.0f for %d steps\n", TILED_REGION_RADIUS, TILED_STEPS);
+	std::printf("%12s %10s %10s %14s %14s %12s %12s %10s\n", "Bricks", "Build s", "ms/step", "Max resident", "Tile loads", "Tile saves", "Hand offs", "Errors");
+
+	for (int brickCount : brickCounts)
+	{
+		PhysicsScene* scene = new PhysicsScene();
+		scene->setGravity(glm::vec2(0, 0));
+		scene->setTimeStep(SCALAR_TIME_STEP);
+		TiledWorld* world = new TiledWorld(scene, TILED_TILE_SIZE, "tiled_benchmark");
+
+		// Bricks drift slowly so some cross tile borders, written straight to the tile files
+		Clock::time_point start = Clock::now();
+		unsigned int seed = 12345;
+		for (int brick = 0; brick < brickCount; brick++)
+		{
+			glm::vec2 position(1.0f + (brick / TILED_ROWS) * TILED_SPACING, 1.0f + (brick % TILED_ROWS) * TILED_SPACING);
+			seed = seed * 1664525u + 1013904223u;
+			float velocityX = ((seed >> 8) % 201) / 100.0f - 1.0f;
+			seed = seed * 1664525u + 1013904223u;
+			float velocityY = ((seed >> 8) % 201) / 100.0f - 1.0f;
+			world->addAABB(position, glm::vec2(velocityX, velocityY), glm::vec2(0.8f, 0.4f), 1.0f, 0.5f, glm::vec4(1, 1, 1, 1));
+		}
+		world->freezeAll();
+		double buildSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+		// Same sweep whatever the length of the band, so only the world size changes
+		glm::vec2 centre(0.0f, TILED_ROWS * TILED_SPACING * 0.5f);
+		int region = world->addRegion(centre, TILED_REGION_RADIUS);
+		int maxResident = 0;
+		start = Clock::now();
+		for (int step = 0; step < TILED_STEPS; step++)
+		{
+			centre.x += TILED_REGION_SPEED * SCALAR_TIME_STEP;
+			world->setRegion(region, centre, TILED_REGION_RADIUS);
+			world->update(SCALAR_TIME_STEP);
+			scene->update(SCALAR_TIME_STEP);
+			maxResident = glm::max(maxResident, world->getResidentBodyCount());
+		}
+		double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+		std::printf("%12d %10.2f %10.3f %14d %14lld %12lld %12lld %10lld\n", brickCount, buildSeconds, (seconds * 1000.0) / TILED_STEPS, maxResident,
+					world->getTileLoadCount(), world->getTileSaveCount(), world->getHandOffCount(), world->getFileErrorCount());
+
+		// Leaves no tile files behind
+		world->discardAll();
+		delete world;
+		delete scene;
+	}
+	std::printf("\n");
+}
+
+//============================================================================================================================================
+// LOD Benchmark
+
+// Run LOD Field, the same field with and without scheduling. Returns the position of a probe body near the edge
+static glm::vec2 runLodField(bool scheduled, double& seconds, long long& pairs, PhysicsScene*& scene)
+{
+	scene = new PhysicsScene();
+	scene->setGravity(glm::vec2(0, 0));
+	scene->setTimeStep(SCALAR_TIME_STEP);
+	scene->setLodScheduling(scheduled);
+	scene->getLodScheduler().addFocus(glm::vec2(0, 0));
+	scene->getLodScheduler().setTierDistances(LOD_NEAR_DISTANCE, LOD_FAR_DISTANCE);
+	scene->addActor(new Plane(glm::vec2(1, 0), -LOD_FIELD_HALF_SIZE, glm::vec4(1, 0, 1, 1)));
+	scene->addActor(new Plane(glm::vec2(-1, 0), -LOD_FIELD_HALF_SIZE, glm::vec4(1, 0, 1, 1)));
+	scene->addActor(new Plane(glm::vec2(0, 1), -LOD_FIELD_HALF_SIZE, glm::vec4(1, 0, 1, 1)));
+	scene->addActor(new Plane(glm::vec2(0, -1), -LOD_FIELD_HALF_SIZE, glm::vec4(1, 0, 1, 1)));
+
+	// Bodies scattered over the field, the probe flies alone under a steady force in the slowest tier
+	unsigned int seed = 12345;
+	for (int body = 0; body < LOD_BODY_COUNT; body++)
+	{
+		float random[4];
+		for (int i = 0; i < 4; i++)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			random[i] = ((seed >> 8) % 10001) / 10000.0f;
+		}
+		glm::vec2 position((random[0] * 2.0f - 1.0f) * (LOD_FIELD_HALF_SIZE - 2.0f), (random[1] * 2.0f - 1.0f) * (LOD_FIELD_HALF_SIZE - 2.0f));
+		glm::vec2 velocity(random[2] * 4.0f - 2.0f, random[3] * 4.0f - 2.0f);
+		scene->addActor(new Sphere(position, velocity, glm::vec2(0, 0), 1.0f, 1.0f, 0.9f, glm::vec4(1, 1, 0, 1)));
+	}
+	Sphere* probe = new Sphere(glm::vec2(400, 400), glm::vec2(-1, 0), glm::vec2(0, 0), 1.0f, 1.0f, 1.0f, glm::vec4(1, 0, 0, 1));
+	probe->setCollisionFilter(0x0002, 0x0000);
+	scene->addActor(probe);
+
+	pairs = 0;
+	Clock::time_point start = Clock::now();
+	for (int step = 0; step < LOD_STEPS; step++)
+	{
+		probe->applyForce(glm::vec2(0, -1));
+		scene->update(SCALAR_TIME_STEP);
+		pairs += scene->getCollisionPairCount();
+	}
+	seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	return probe->getPosition();
+}
+
+// Run LOD Benchmark
+void runLodBenchmark()
+{
+	std::printf("LOD scheduling, %d bodies over %.0f x %.0f, tiers at %.0f and %.0f, %d steps\n", LOD_BODY_COUNT, LOD_FIELD_HALF_SIZE * 2.0f,
+				LOD_FIELD_HALF_SIZE * 2.0f, LOD_NEAR_DISTANCE, LOD_FAR_DISTANCE, LOD_STEPS);
+	std::printf("%-12s %10s %16s %14s %16s %16s\n", "Scheduling", "ms/step", "Integrations", "Pairs/step", "Tiers 0/1/2", "Probe drift");
+
+	PhysicsScene* fullScene = nullptr;
+	PhysicsScene* lodScene = nullptr;
+	double fullSeconds = 0.0;
+	double lodSeconds = 0.0;
+	long long fullPairs = 0;
+	long long lodPairs = 0;
+	glm::vec2 fullProbe = runLodField(false, fullSeconds, fullPairs, fullScene);
+	glm::vec2 lodProbe = runLodField(true, lodSeconds, lodPairs, lodScene);
+
+	long long fullIntegrations = (long long)(LOD_BODY_COUNT + 1) * LOD_STEPS;
+	std::printf("%-12s %10.3f %16lld %14lld %16s %16s\n", "Off", (fullSeconds * 1000.0) / LOD_STEPS, fullIntegrations, fullPairs / LOD_STEPS, "-", "-");
+
+	LodScheduler& scheduler = lodScene->getLodScheduler();
+	char tiers[64];
+	std::snprintf(tiers, sizeof(tiers), "%d/%d/%d", scheduler.getTierCount(0), scheduler.getTierCount(1), scheduler.getTierCount(2));
+	std::printf("%-12s %10.3f %16lld %14lld %16s %16.6f\n", "On", (lodSeconds * 1000.0) / LOD_STEPS, scheduler.getIntegrationCount(), lodPairs / LOD_STEPS,
+				tiers, glm::length(lodProbe - fullProbe));
+	std::printf("Cost per step %.0f%% of full rate, %lld promotions\n\n", (100.0 * lodSeconds) / fullSeconds, scheduler.getPromotionCount());
+
+	delete fullScene;
+	delete lodScene;
+}
+
+//============================================================================================================================================
+// Locality Benchmark
+
+// Run Locality Field, bodies scattered over the field in the order they were made so neighbours in space are far apart
+// in memory. Returns the seconds per step, and the list spacing and sorts done at the end through the out parameters
+static double runLocalityField(ReorderTrigger trigger, float& spacing, int& sorts)
+{
+	PhysicsScene* scene = new PhysicsScene();
+	scene->setGravity(glm::vec2(0, 0));
+	scene->setTimeStep(SCALAR_TIME_STEP);
+	scene->setReorderTrigger(trigger);
+	scene->getMortonOrder().setInterval(LOCALITY_INTERVAL);
+	scene->addActor(new Plane(glm::vec2(1, 0), -LOCALITY_FIELD_HALF_SIZE, glm::vec4(1, 0, 1, 1)));
+	scene->addActor(new Plane(glm::vec2(-1, 0), -LOCALITY_FIELD_HALF_SIZE, glm::vec4(1, 0, 1, 1)));
+	scene->addActor(new Plane(glm::vec2(0, 1), -LOCALITY_FIELD_HALF_SIZE, glm::vec4(1, 0, 1, 1)));
+	scene->addActor(new Plane(glm::vec2(0, -1), -LOCALITY_FIELD_HALF_SIZE, glm::vec4(1, 0, 1, 1)));
+
+	std::vector<PhysicsObject*> bodies;
+	unsigned int seed = 54321;
+	for (int body = 0; body < LOCALITY_BODY_COUNT; body++)
+	{
+		float random[4];
+		for (int i = 0; i < 4; i++)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			random[i] = ((seed >> 8) % 10001) / 10000.0f;
+		}
+		glm::vec2 position((random[0] * 2.0f - 1.0f) * (LOCALITY_FIELD_HALF_SIZE - 2.0f), (random[1] * 2.0f - 1.0f) * (LOCALITY_FIELD_HALF_SIZE - 2.0f));
+		glm::vec2 velocity(random[2] * 4.0f - 2.0f, random[3] * 4.0f - 2.0f);
+		bodies.push_back(new Sphere(position, velocity, glm::vec2(0, 0), 1.0f, 1.0f, 0.9f, glm::vec4(1, 1, 0, 1)));
+		scene->addActor(bodies.back());
+	}
+
+	Clock::time_point start = Clock::now();
+	for (int step = 0; step < LOCALITY_STEPS; step++)
+	{
+		scene->update(SCALAR_TIME_STEP);
+	}
+	double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	// Unsorted the scene's list is still the order the bodies were added in
+	MortonOrder& order = scene->getMortonOrder();
+	spacing = (order.getSortCount() > 0) ? order.getLastSpacing() : MortonOrder::measureSpacing(bodies);
+	sorts = order.getSortCount();
+	delete scene;
+	return seconds / LOCALITY_STEPS;
+}
+
+// Run Locality Benchmark
+void runLocalityBenchmark()
+{
+	std::printf("Morton reordering, %d bodies added in random order over %.0f x %.0f, %d steps\n", LOCALITY_BODY_COUNT,
+				LOCALITY_FIELD_HALF_SIZE * 2.0f, LOCALITY_FIELD_HALF_SIZE * 2.0f, LOCALITY_STEPS);
+	std::printf("%-12s %10s %8s %16s %10s\n", "Trigger", "ms/step", "Sorts", "List spacing", "vs Never");
+
+	const char* names[] = { "Never", "Interval", "Locality" };
+	ReorderTrigger triggers[] = { REORDER_NEVER, REORDER_INTERVAL, REORDER_LOCALITY };
+	double baseline = 0.0;
+	for (int run = 0; run < 3; run++)
+	{
+		float spacing = 0.0f;
+		int sorts = 0;
+		double seconds = runLocalityField(triggers[run], spacing, sorts);
+		baseline = (run == 0) ? seconds : baseline;
+		std::printf("%-12s %10.3f %8d %16.3f %9.0f%%\n", names[run], seconds * 1000.0, sorts, spacing, (100.0 * seconds) / baseline);
+	}
+
+	// The sort on its own, on the random order it starts from
+	std::vector<PhysicsObject*> bodies;
+	unsigned int seed = 54321;
+	for (int body = 0; body < LOCALITY_BODY_COUNT; body++)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		float x = ((seed >> 8) % 10001) / 10000.0f;
+		seed = seed * 1664525u + 1013904223u;
+		float y = ((seed >> 8) % 10001) / 10000.0f;
+		bodies.push_back(new Sphere(glm::vec2(x, y) * LOCALITY_FIELD_HALF_SIZE, glm::vec2(0, 0), glm::vec2(0, 0), 1.0f, 1.0f, 0.9f, glm::vec4(1, 1, 0, 1)));
+	}
+	MortonOrder order;
+	Clock::time_point start = Clock::now();
+	order.reorder(bodies);
+	double sortSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+	std::printf("One sort of %d bodies %.3f ms\n\n", LOCALITY_BODY_COUNT, sortSeconds * 1000.0);
+	for (auto pBody : bodies)
+	{
+		delete pBody;
+	}
+}
+
+//============================================================================================================================================
+// Layout Benchmark
+
+// Run Layout, either a few shared materials or one for every body, which is more than 16 bit indices could hold
+static void runLayout(bool bodyMaterials)
+{
+	if (bodyMaterials)
+	{
+		std::printf("Body layout, %d Spheres each in its own material and colour over %.0f x %.0f, %d steps\n", LAYOUT_BODY_COUNT,
+					LAYOUT_FIELD_HALF_SIZE * 2.0f, LAYOUT_FIELD_HALF_SIZE * 2.0f, LAYOUT_STEPS);
+	}
+	else
+	{
+		std::printf("Body layout, %d Spheres in %d materials over %.0f x %.0f, %d steps\n", LAYOUT_BODY_COUNT, LAYOUT_MATERIAL_COUNT,
+					LAYOUT_FIELD_HALF_SIZE * 2.0f, LAYOUT_FIELD_HALF_SIZE * 2.0f, LAYOUT_STEPS);
+	}
+
+	PhysicsScene* scene = new PhysicsScene();
+	scene->setGravity(glm::vec2(0, 0));
+	scene->setTimeStep(SCALAR_TIME_STEP);
+	scene->addActor(new Plane(glm::vec2(1, 0), -LAYOUT_FIELD_HALF_SIZE, glm::vec4(1, 0, 1, 1)));
+	scene->addActor(new Plane(glm::vec2(-1, 0), -LAYOUT_FIELD_HALF_SIZE, glm::vec4(1, 0, 1, 1)));
+	scene->addActor(new Plane(glm::vec2(0, 1), -LAYOUT_FIELD_HALF_SIZE, glm::vec4(1, 0, 1, 1)));
+	scene->addActor(new Plane(glm::vec2(0, -1), -LAYOUT_FIELD_HALF_SIZE, glm::vec4(1, 0, 1, 1)));
+
+	// Elasticity, drag and colour cycle through a few settings, as a real scene's would
+	glm::vec4 colors[LAYOUT_MATERIAL_COUNT] = { glm::vec4(1, 1, 0, 1), glm::vec4(0, 1, 1, 1), glm::vec4(1, 0, 0, 1), glm::vec4(0, 1, 0, 1) };
+	std::vector<Sphere*> spheres;
+	std::vector<float> elasticities;
+	unsigned int seed = 24680;
+	for (int body = 0; body < LAYOUT_BODY_COUNT; body++)
+	{
+		float random[4];
+		for (int i = 0; i < 4; i++)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			random[i] = ((seed >> 8) % 10001) / 10000.0f;
+		}
+		int material = body % LAYOUT_MATERIAL_COUNT;
+		glm::vec2 position((random[0] * 2.0f - 1.0f) * (LAYOUT_FIELD_HALF_SIZE - 2.0f), (random[1] * 2.0f - 1.0f) * (LAYOUT_FIELD_HALF_SIZE - 2.0f));
+		glm::vec2 velocity(random[2] * 4.0f - 2.0f, random[3] * 4.0f - 2.0f);
+		float elasticity = 0.6f + (0.1f * material);
+		glm::vec4 color = colors[material];
+		if (bodyMaterials)
+		{
+			elasticity = 0.6f + (0.3f * body) / LAYOUT_BODY_COUNT;
+			color = glm::vec4(random[0], random[1], random[2], 1);
+		}
+		Sphere* sphere = new Sphere(position, velocity, glm::vec2(0, 0), 1.0f, 1.0f, elasticity, color);
+		sphere->setLinearDrag(0.01f * material);
+		scene->addActor(sphere);
+		spheres.push_back(sphere);
+		elasticities.push_back(elasticity);
+	}
+
+	Clock::time_point start = Clock::now();
+	for (int step = 0; step < LAYOUT_STEPS; step++)
+	{
+		scene->update(SCALAR_TIME_STEP);
+	}
+	double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	// Each step reads every body whole to integrate it, every proxy for the pair search and the plane pass arrays. The
+	// shared tables are read too but hold a few entries, and the colours aren't read at all
+	long long bodyBytes = (long long)LAYOUT_BODY_COUNT * sizeof(Sphere);
+	long long materialBytes = (long long)MaterialTable::getCount() * sizeof(BodyMaterial);
+	long long proxyBytes = (long long)LAYOUT_BODY_COUNT * sizeof(BroadPhaseProxy);
+	long long planeBytes = (long long)LAYOUT_BODY_COUNT * 5 * sizeof(float);
+	long long renderBytes = (long long)RenderStateTable::getCount() * sizeof(BodyRenderState);
+	long long stepBytes = bodyBytes + materialBytes + proxyBytes + planeBytes;
+
+	// The same fields kept inside every body, as they were before the split
+	long long inlineBodySize = sizeof(Sphere) - (2 * sizeof(unsigned int)) + sizeof(BodyMaterial) + sizeof(BodyRenderState);
+	long long inlineBytes = ((long long)LAYOUT_BODY_COUNT * inlineBodySize) + proxyBytes + planeBytes;
+
+	std::printf("%-22s %12s %12s\n", "Data", "Bytes/body", "Total KB");
+	std::printf("%-22s %12d %12lld\n", "Hot, Sphere", (int)sizeof(Sphere), bodyBytes / 1024);
+	std::printf("%-22s %12s %12.1f   %d entries\n", "Warm, materials", "shared", materialBytes / 1024.0, MaterialTable::getCount());
+	std::printf("%-22s %12s %12.1f   %d entries, not read by the step\n", "Cold, render states", "shared", renderBytes / 1024.0, RenderStateTable::getCount());
+	std::printf("%-22s %12d %12lld\n", "Broadphase proxies", (int)sizeof(BroadPhaseProxy), proxyBytes / 1024);
+	std::printf("%-22s %12d %12lld\n", "Plane pass arrays", (int)(5 * sizeof(float)), planeBytes / 1024);
+	std::printf("Bytes touched per step %lld KB, %lld KB with every field inline in the body (%.0f%%)\n", stepBytes / 1024, inlineBytes / 1024,
+				(100.0 * stepBytes) / inlineBytes);
+	std::printf("%.3f ms/step\n", (seconds * 1000.0) / LAYOUT_STEPS);
+
+	// Every body should still read back the material it was made with
+	int wrongMaterials = 0;
+	for (int body = 0; body < LAYOUT_BODY_COUNT; body++)
+	{
+		if (spheres[body]->getElasticity() != elasticities[body])
+		{
+			wrongMaterials++;
+		}
+	}
+	std::printf("Bodies reading back the wrong material %d\n\n", wrongMaterials);
+	delete scene;
+}
+
+// Run Layout Benchmark
+void runLayoutBenchmark()
+{
+	runLayout(false);
+	runLayout(true);
+}
+
+//============================================================================================================================================
+// Ensemble Benchmark
+
+// Launch Experiment, a ball fired from the continuous demo's start over flat ground. Results are the range and time of
+// the first landing and the highest point above the start
+class LaunchExperiment : public EnsembleExperiment
+{
+
+public:
+	virtual void build(PhysicsScene* scene, const float* parameters)
+	{
+		scene->setGravity(glm::vec2(0, PROJECTILE_GRAVITY));
+		scene->setTimeStep(SCALAR_TIME_STEP);
+		glm::vec2 velocity = glm::vec2(std::sin(parameters[0]), std::cos(parameters[0])) * parameters[1];
+		scene->addActor(new Sphere(PROJECTILE_START, velocity, glm::vec2(0, 0), 1.0f, ENSEMBLE_RADIUS, 0.8f, glm::vec4(1, 1, 0, 1)));
+		scene->addActor(new Plane(glm::vec2(0, 1), ENSEMBLE_GROUND, glm::vec4(1, 1, 1, 1)));
+	}
+
+	virtual void measure(const std::vector<PhysicsObject*>& bodies, const float* /*parameters*/, float time, float* results)
+	{
+		glm::vec2 position = static_cast<Sphere*>(bodies[0])->getPosition();
+		results[2] = glm::max(results[2], position.y - PROJECTILE_START.y);
+		if (results[1] == 0.0f && position.y <= ENSEMBLE_GROUND + ENSEMBLE_RADIUS + 0.01f)
+		{
+			results[0] = position.x - PROJECTILE_START.x;
+			results[1] = time;
+		}
+	}
+};
+
+// Pile Experiment, balls thrown together from a seeded scatter so they land on each other. Results are the sums of the
+// balls' coordinates, which any change in the order contacts are resolved in shows up in
+class PileExperiment : public EnsembleExperiment
+{
+
+public:
+	virtual void build(PhysicsScene* scene, const float* parameters)
+	{
+		scene->setGravity(glm::vec2(0, PROJECTILE_GRAVITY));
+		scene->setTimeStep(SCALAR_TIME_STEP);
+		unsigned int seed = 13579u + (unsigned int)parameters[0];
+		for (int body = 0; body < ENSEMBLE_PILE_BODIES; body++)
+		{
+			float random[4];
+			for (int i = 0; i < 4; i++)
+			{
+				seed = seed * 1664525u + 1013904223u;
+				random[i] = ((seed >> 8) % 10001) / 10000.0f;
+			}
+			glm::vec2 position((random[0] * 8.0f) - 4.0f, ENSEMBLE_GROUND + 2.0f + (random[1] * 12.0f));
+			glm::vec2 velocity((random[2] * 10.0f) - 5.0f, (random[3] * 10.0f) - 5.0f);
+			scene->addActor(new Sphere(position, velocity, glm::vec2(0, 0), 1.0f, ENSEMBLE_RADIUS, 0.8f, glm::vec4(0, 1, 1, 1)));
+		}
+		scene->addActor(new Plane(glm::vec2(0, 1), ENSEMBLE_GROUND, glm::vec4(1, 1, 1, 1)));
+	}
+
+	virtual void measure(const std::vector<PhysicsObject*>& bodies, const float* /*parameters*/, float /*time*/, float* results)
+	{
+		results[0] = 0.0f;
+		results[1] = 0.0f;
+		for (auto pBody : bodies)
+		{
+			glm::vec2 position = static_cast<Sphere*>(pBody)->getPosition();
+			results[0] += position.x;
+			results[1] += position.y;
+		}
+	}
+};
+
+// Largest Ensemble Difference, between the same runs in two runners
+static float getLargestEnsembleDifference(const EnsembleRunner& runner1, const EnsembleRunner& runner2)
+{
+	float largestDifference = 0.0f;
+	for (int run = 0; run < runner1.getRunCount(); run++)
+	{
+		for (int i = 0; i < runner1.getResultCount(); i++)
+		{
+			largestDifference = glm::max(largestDifference, std::abs(runner1.getResults(run)[i] - runner2.getResults(run)[i]));
+		}
+	}
+	return largestDifference;
+}
+
+// Run Ensemble Benchmark
+void runEnsembleBenchmark()
+{
+	std::printf("Ensemble sweep, %d launch angles x %d speeds, %.1fs each, %d threads\n", ENSEMBLE_ANGLE_COUNT, ENSEMBLE_SPEED_COUNT,
+				PROJECTILE_TIME, omp_get_max_threads());
+	std::printf("%-10s %8s %8s %12s %12s\n", "Packing", "Runs", "Scenes", "Seconds", "us/run");
+
+	LaunchExperiment experiment;
+	EnsembleRunner runners[2];
+	for (int packed = 1; packed >= 0; packed--)
+	{
+		EnsembleRunner& runner = runners[packed];
+		runner.addParameter("angle", 0.1f, 1.5f, ENSEMBLE_ANGLE_COUNT);
+		runner.addParameter("speed", 5.0f, 30.0f, ENSEMBLE_SPEED_COUNT);
+		runner.setResultNames({ "range", "flight time", "peak" });
+		runner.setDuration(PROJECTILE_TIME);
+		runner.setPacking(packed == 1);
+
+		Clock::time_point start = Clock::now();
+		int runCount = runner.run(experiment);
+		double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		std::printf("%-10s %8d %8d %12.3f %12.1f\n", (packed == 1) ? "On" : "Off", runCount, runner.getSceneCount(), seconds,
+					(seconds * 1000000.0) / runCount);
+	}
+
+	// Packing must not change a single result
+	int longestRun = 0;
+	for (int run = 0; run < runners[0].getRunCount(); run++)
+	{
+		longestRun = (runners[1].getResults(run)[0] > runners[1].getResults(longestRun)[0]) ? run : longestRun;
+	}
+	std::printf("Largest difference packed against alone %g\n", getLargestEnsembleDifference(runners[0], runners[1]));
+	std::printf("Longest range %.3f at angle %.3f speed %.3f\n\n", runners[1].getResults(longestRun)[0], runners[1].getParameters(longestRun)[0],
+				runners[1].getParameters(longestRun)[1]);
+
+	// One Sphere a run never meets another body, the pile checks runs whose bodies collide with each other
+	std::printf("Ensemble pile, %d runs of %d Spheres over one ground Plane, %.1fs each\n", ENSEMBLE_PILE_RUNS, ENSEMBLE_PILE_BODIES, PROJECTILE_TIME);
+	std::printf("%-10s %8s %8s %12s %12s\n", "Packing", "Runs", "Scenes", "Seconds", "us/run");
+
+	PileExperiment pileExperiment;
+	EnsembleRunner pileRunners[2];
+	for (int packed = 1; packed >= 0; packed--)
+	{
+		EnsembleRunner& runner = pileRunners[packed];
+		runner.addParameter("seed", 0.0f, (float)(ENSEMBLE_PILE_RUNS - 1), ENSEMBLE_PILE_RUNS);
+		runner.setResultNames({ "sum x", "sum y" });
+		runner.setDuration(PROJECTILE_TIME);
+		runner.setPacking(packed == 1);
+
+		Clock::time_point start = Clock::now();
+		int runCount = runner.run(pileExperiment);
+		double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		std::printf("%-10s %8d %8d %12.3f %12.1f\n", (packed == 1) ? "On" : "Off", runCount, runner.getSceneCount(), seconds,
+					(seconds * 1000000.0) / runCount);
+	}
+	std::printf("Largest difference packed against alone %g\n\n", getLargestEnsembleDifference(pileRunners[0], pileRunners[1]));
+}
+
+//============================================================================================================================================
+// Trajectory Benchmark
+
+// Run Trajectory Benchmark
+void runTrajectoryBenchmark()
+{
+	const float drags[] = { 0.0f, 0.5f };
+
+	std::printf("Trajectory prediction, %d launches, %d samples over %.1fs, ground at %.1f\n", TRAJECTORY_BODY_COUNT, TRAJECTORY_SAMPLES,
+				PROJECTILE_TIME, ENSEMBLE_GROUND);
+	std::printf("%-6s %14s %14s %14s %14s %14s %14s\n", "Drag", "ns/body/sample", "Path error", "Hits", "Hit ns/body", "Hit difference",
+				"Step ms");
+
+	float times[TRAJECTORY_SAMPLES];
+	for (int sample = 0; sample < TRAJECTORY_SAMPLES; sample++)
+	{
+		times[sample] = PROJECTILE_TIME * (sample + 1) / TRAJECTORY_SAMPLES;
+	}
+
+	for (float drag : drags)
+	{
+		// The same launches for the predictor and a stepped scene, fanned over angles and speeds and set side by side so
+		// the broadphase isn't piling them all into one cell
+		PhysicsScene scene;
+		scene.setGravity(glm::vec2(0, PROJECTILE_GRAVITY));
+		scene.setTimeStep(SCALAR_TIME_STEP);
+		scene.addActor(new Plane(glm::vec2(0, 1), ENSEMBLE_GROUND, glm::vec4(1, 1, 1, 1)));
+
+		TrajectoryPredictor predictor;
+		predictor.setScene(&scene);
+		std::vector<Sphere*> projectiles;
+		std::vector<glm::vec2> velocities;
+		for (int body = 0; body < TRAJECTORY_BODY_COUNT; body++)
+		{
+			float angle = 0.1f + (1.4f * (body % 100) / 100.0f);
+			float speed = 5.0f + (25.0f * (body / 100) / (TRAJECTORY_BODY_COUNT / 100));
+			glm::vec2 velocity = glm::vec2(std::sin(angle), std::cos(angle)) * speed;
+			glm::vec2 offset((float)body * PROJECTILE_SPACING, 0.0f);
+			Sphere* projectile = new Sphere(PROJECTILE_START + offset, velocity, glm::vec2(0, 0), 1.0f, ENSEMBLE_RADIUS, 0.8f, glm::vec4(1, 1, 0, 1));
+			projectile->setLinearDrag(drag);
+			// Projectiles only meet the ground
+			projectile->setCollisionFilter(0x0002, 0x0001);
+			scene.addActor(projectile);
+			predictor.addBody(projectile);
+			projectiles.push_back(projectile);
+			velocities.push_back(velocity);
+		}
+
+		// Every launch at every sample time, checked against the benchmark's own closed form
+		std::vector<glm::vec2> positions(TRAJECTORY_BODY_COUNT * TRAJECTORY_SAMPLES);
+		Clock::time_point start = Clock::now();
+		for (int repeat = 0; repeat < TRAJECTORY_REPEATS; repeat++)
+		{
+			predictor.predictPositions(times, TRAJECTORY_SAMPLES, positions.data());
+		}
+		double pathSeconds = std::chrono::duration<double>(Clock::now() - start).count() / TRAJECTORY_REPEATS;
+
+		float pathError = 0.0f;
+		for (int body = 0; body < TRAJECTORY_BODY_COUNT; body++)
+		{
+			for (int sample = 0; sample < TRAJECTORY_SAMPLES; sample += 7)
+			{
+				glm::vec2 expected = projectilePosition(velocities[body], drag, times[sample]) + glm::vec2((float)body * PROJECTILE_SPACING, 0.0f);
+				pathError = glm::max(pathError, glm::length(positions[(body * TRAJECTORY_SAMPLES) + sample] - expected));
+			}
+		}
+
+		std::vector<float> hitTimes(TRAJECTORY_BODY_COUNT);
+		std::vector<int> hitPlanes(TRAJECTORY_BODY_COUNT);
+		start = Clock::now();
+		for (int repeat = 0; repeat < TRAJECTORY_REPEATS; repeat++)
+		{
+			predictor.predictPlaneHits(PROJECTILE_TIME, hitTimes.data(), hitPlanes.data());
+		}
+		double hitSeconds = std::chrono::duration<double>(Clock::now() - start).count() / TRAJECTORY_REPEATS;
+
+		// Stepping the scene for the same answer, a landing is the first step that ends resting on the ground
+		std::vector<float> steppedTimes(TRAJECTORY_BODY_COUNT, -1.0f);
+		int steps = (int)((PROJECTILE_TIME / SCALAR_TIME_STEP) + 0.5f);
+		double stepSeconds = 0.0;
+		for (int step = 0; step < steps; step++)
+		{
+			start = Clock::now();
+			scene.update(SCALAR_TIME_STEP);
+			stepSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+
+			for (int body = 0; body < TRAJECTORY_BODY_COUNT; body++)
+			{
+				if (steppedTimes[body] < 0.0f && projectiles[body]->getPosition().y <= ENSEMBLE_GROUND + ENSEMBLE_RADIUS + 0.01f)
+				{
+					steppedTimes[body] = (step + 1) * SCALAR_TIME_STEP;
+				}
+			}
+		}
+
+		// Stepped landings are rounded up to a whole step, so agreement is to within about a step
+		int hits = 0;
+		int disagreements = 0;
+		float hitDifference = 0.0f;
+		for (int body = 0; body < TRAJECTORY_BODY_COUNT; body++)
+		{
+			if ((hitTimes[body] >= 0.0f) != (steppedTimes[body] >= 0.0f))
+			{
+				// Landings in the last couple of steps can fall either side of the horizon
+				float landing = glm::max(hitTimes[body], steppedTimes[body]);
+				disagreements += (landing < PROJECTILE_TIME - (2.0f * SCALAR_TIME_STEP)) ? 1 : 0;
+				continue;
+			}
+			if (hitTimes[body] >= 0.0f)
+			{
+				hits++;
+				hitDifference = glm::max(hitDifference, std::abs(hitTimes[body] - steppedTimes[body]));
+			}
+		}
+
+		std::printf("%-6.1f %14.2f %14.6f %14d %14.1f %14.4f %14.1f\n", drag, (pathSeconds * 1e9) / ((double)TRAJECTORY_BODY_COUNT * TRAJECTORY_SAMPLES),
+					pathError, hits, (hitSeconds * 1e9) / TRAJECTORY_BODY_COUNT, hitDifference, stepSeconds * 1000.0);
+		if (disagreements > 0)
+		{
+			std::printf("%d launches landed in one and not the other\n", disagreements);
+		}
+	}
+	std::printf("\n");
+}
+
+//============================================================================================================================================
+// Scene Fork Benchmark
+
+// Fill Mixed Box, a grid of alternating Spheres and AABBs with pseudo random velocities in a box under gravity, so
+// there are plenty of collisions
+static void fillMixedBox(PhysicsScene& scene, int bodyCount)
+{
+	scene.setGravity(glm::vec2(0, PROJECTILE_GRAVITY));
+	scene.setTimeStep(SCALAR_TIME_STEP);
+	scene.addActor(new Plane(glm::vec2(1, 0), -FORK_BOX_HALF_SIZE, glm::vec4(1, 0, 1, 1)));
+	scene.addActor(new Plane(glm::vec2(-1, 0), -FORK_BOX_HALF_SIZE, glm::vec4(1, 0, 1, 1)));
+	scene.addActor(new Plane(glm::vec2(0, 1), -FORK_BOX_HALF_SIZE, glm::vec4(1, 0, 1, 1)));
+	scene.addActor(new Plane(glm::vec2(0, -1), -FORK_BOX_HALF_SIZE, glm::vec4(1, 0, 1, 1)));
+
+	unsigned int seed = 13579;
+	for (int body = 0; body < bodyCount; body++)
+	{
+		glm::vec2 position(-150.0f + (body % FORK_COLUMNS) * 3.0f, -150.0f + (body / FORK_COLUMNS) * 3.0f);
+		seed = seed * 1664525u + 1013904223u;
+		float velocityX = ((seed >> 8) % 2001) / 100.0f - 10.0f;
+		seed = seed * 1664525u + 1013904223u;
+		float velocityY = ((seed >> 8) % 2001) / 100.0f - 10.0f;
+		if (body % 2 == 0)
+		{
+			scene.addActor(new Sphere(position, glm::vec2(velocityX, velocityY), glm::vec2(0, 0), 1.0f, 1.0f, 0.9f, glm::vec4(1, 1, 0, 1)));
+		}
+		else
+		{
+			scene.addActor(new AABB(position, glm::vec2(velocityX, velocityY), glm::vec2(0, 0), glm::vec2(1.0f, 0.75f), 1.0f, 0.9f, glm::vec4(0, 1, 1, 1)));
+		}
+	}
+}
+
+// Run Scene Fork Benchmark
+void runSceneForkBenchmark()
+{
+	PhysicsScene scene;
+	fillMixedBox(scene, FORK_BODY_COUNT);
+
+	SceneFork fork;
+	std::printf("Scene fork, %d bodies, %.1fs look ahead, step budget %d, %d frames\n", FORK_BODY_COUNT, fork.getDuration(),
+				fork.getStepBudget(), FORK_FRAMES);
+
+	// The first fork lays out the pools, the rest copy over them in place
+	Clock::time_point start = Clock::now();
+	fork.fork(&scene);
+	double firstSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+	fork.wait();
+
+	ForkPaths paths;
+	fork.takePaths(paths);
+	double forkSeconds = 1.0;
+	double jobSeconds = 0.0;
+	for (int frame = 0; frame < FORK_FRAMES; frame++)
+	{
+		scene.update(SCALAR_TIME_STEP);
+
+		start = Clock::now();
+		fork.fork(&scene);
+		Clock::time_point forked = Clock::now();
+		fork.wait();
+		// Fastest rather than mean, waking the worker can hand it the core before fork returns
+		forkSeconds = glm::min(forkSeconds, std::chrono::duration<double>(forked - start).count());
+		jobSeconds += std::chrono::duration<double>(Clock::now() - forked).count();
+		fork.takePaths(paths);
+	}
+
+	// A new body per copy, the way forking would go with the scene's own actors
+	start = Clock::now();
+	std::vector<PhysicsObject*> copies;
+	for (auto pActor : scene.getActors())
+	{
+		copies.push_back((pActor->getShapeID() == SPHERE) ? (PhysicsObject*)new Sphere(*static_cast<Sphere*>(pActor)) :
+						 (PhysicsObject*)new AABB(*static_cast<AABB*>(pActor)));
+	}
+	double newSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+	for (auto pCopy : copies)
+	{
+		delete pCopy;
+	}
+
+	// The live scene stepped the same distance has to land exactly where the last fork said it would
+	std::vector<PhysicsObject*> bodies(scene.getActors());
+	for (int step = 0; step < paths.sampleCount; step++)
+	{
+		scene.update(SCALAR_TIME_STEP);
+	}
+	float largestDifference = 0.0f;
+	for (int body = 0; body < (int)bodies.size(); body++)
+	{
+		glm::vec2 predicted = paths.positions[(body * paths.sampleCount) + paths.sampleCount - 1];
+		largestDifference = glm::max(largestDifference, glm::length(static_cast<Rigidbody*>(bodies[body])->getPosition() - predicted));
+	}
+
+	std::printf("%-28s %12.1f us\n", "First fork, pools laid out", firstSeconds * 1000000.0);
+	std::printf("%-28s %12.1f us\n", "Fork, copied in place", forkSeconds * 1000000.0);
+	std::printf("%-28s %12.1f us\n", "Copy with a new per body", newSeconds * 1000000.0);
+	std::printf("%-28s %12.1f ms, %d samples\n", "Look ahead job", (jobSeconds * 1000.0) / FORK_FRAMES, paths.sampleCount);
+	std::printf("Pool rebuilds %d of %d forks, largest difference from the live scene %g\n\n", fork.getPoolRebuildCount(),
+				fork.getForkCount(), largestDifference);
+}
+
+//============================================================================================================================================
+// Rollback Benchmark
+
+// Run Rollback Benchmark
+void runRollbackBenchmark()
+{
+	PhysicsScene scene;
+	fillMixedBox(scene, ROLLBACK_BODY_COUNT);
+	scene.setHistory(ROLLBACK_HISTORY, ROLLBACK_KEYFRAME_INTERVAL);
+	std::printf("Rollback, %d bodies, %d steps of history with a keyframe every %d, rewinding %d steps\n", ROLLBACK_BODY_COUNT,
+				ROLLBACK_HISTORY, ROLLBACK_KEYFRAME_INTERVAL, ROLLBACK_STEPS);
+
+	// Plain steps first for the cost of recording, then the same again with no history
+	Clock::time_point start = Clock::now();
+	for (int step = 0; step < ROLLBACK_HISTORY; step++)
+	{
+		scene.step();
+	}
+	double recordedSeconds = std::chrono::duration<double>(Clock::now() - start).count() / ROLLBACK_HISTORY;
+
+	PhysicsScene plain;
+	fillMixedBox(plain, ROLLBACK_BODY_COUNT);
+	start = Clock::now();
+	for (int step = 0; step < ROLLBACK_HISTORY; step++)
+	{
+		plain.step();
+	}
+	double plainSeconds = std::chrono::duration<double>(Clock::now() - start).count() / ROLLBACK_HISTORY;
+
+	// Rewinding and stepping back to the same step without changing anything has to land on exactly the same state
+	std::vector<glm::vec2> before;
+	for (auto pActor : scene.getActors())
+	{
+		before.push_back(static_cast<Rigidbody*>(pActor)->getPosition());
+	}
+	int now = scene.getStepCount();
+	scene.rewind(now - ROLLBACK_STEPS);
+	for (int step = 0; step < ROLLBACK_STEPS; step++)
+	{
+		scene.step();
+	}
+	float largestDifference = 0.0f;
+	for (int body = 0; body < ROLLBACK_BODY_COUNT; body++)
+	{
+		largestDifference = glm::max(largestDifference, glm::length(static_cast<Rigidbody*>(scene.getActors()[body])->getPosition() - before[body]));
+	}
+
+	// A frame of rollback: a late input arrives for a step a few frames back, the scene goes back to it, takes the input
+	// and catches up again, then steps the frame itself
+	double worstSeconds = 0.0;
+	double totalSeconds = 0.0;
+	for (int frame = 0; frame < ROLLBACK_FRAMES; frame++)
+	{
+		start = Clock::now();
+		scene.rewind(scene.getStepCount() - ROLLBACK_STEPS);
+		Rigidbody* player = static_cast<Rigidbody*>(scene.getActors()[frame % ROLLBACK_BODY_COUNT]);
+		player->setVelocity(player->getVelocity() + glm::vec2(0, 5));
+		for (int step = 0; step < ROLLBACK_STEPS; step++)
+		{
+			scene.step();
+		}
+		double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		worstSeconds = glm::max(worstSeconds, seconds);
+		totalSeconds += seconds;
+		scene.step();
+	}
+
+	SnapshotRing& history = scene.getHistory();
+	std::printf("%-32s %10.3f ms, %.3f ms without a history\n", "Step with recording", recordedSeconds * 1000.0, plainSeconds * 1000.0);
+	std::printf("%-32s %10.3f ms mean, %.3f ms worst\n", "Rewind and re-simulate", (totalSeconds * 1000.0) / ROLLBACK_FRAMES, worstSeconds * 1000.0);
+	std::printf("%-32s %10d KB, %d KB stored whole (%.0f%%)\n", "History", history.getEncodedBytes() / 1024, history.getRawBytes() / 1024,
+				(100.0 * history.getEncodedBytes()) / history.getRawBytes());
+	std::printf("Steps %d to %d can be restored, largest difference re-simulating unchanged %g\n\n", history.getOldestStep(),
+				history.getNewestStep(), largestDifference);
+}
+
+//============================================================================================================================================
+// Contact Event Benchmark
+
+// Run Contact Event Benchmark
+void runContactEventBenchmark()
+{
+	const int everyEvent = (1 << CONTACT_BEGIN) | (1 << CONTACT_PERSIST) | (1 << CONTACT_END);
+	const char* settingNames[] = { "Off", "Begin and end", "Every event", "LOD", "Replacing" };
+	const int eventTypes[] = { 0, (1 << CONTACT_BEGIN) | (1 << CONTACT_END), everyEvent, everyEvent, everyEvent };
+
+	std::printf("Contact events, %d bodies, %d steps\n", CONTACT_BODY_COUNT, CONTACT_STEPS);
+	std::printf("%-16s %12s %12s %12s %12s %12s %14s\n", "Events", "ms/step", "Begins", "Persists", "Ends", "Touching", "Read ns/event");
+
+	for (int setting = 0; setting < 5; setting++)
+	{
+		PhysicsScene scene;
+		fillMixedBox(scene, CONTACT_BODY_COUNT);
+		scene.setContactEvents(setting > 0);
+		scene.getContactStream().setEventTypes(eventTypes[setting]);
+
+		// Bodies round one corner step every step, the rest less often
+		if (setting == 3)
+		{
+			scene.setLodScheduling(true);
+			scene.getLodScheduler().addFocus(glm::vec2(-FORK_BOX_HALF_SIZE, -FORK_BOX_HALF_SIZE));
+			scene.getLodScheduler().setTierDistances(LOD_NEAR_DISTANCE, LOD_FAR_DISTANCE);
+		}
+
+		// Gameplay's side: one pass over the buffer after each update. The pairs touching are kept as well by the bodies'
+		// ids, every begin has to be new and every persist and end has to be for a pair that began
+		std::set<std::pair<unsigned int, unsigned int>> touching;
+		unsigned int seed = 24680;
+		long long eventCount = 0;
+		long long typeCounts[CONTACT_EVENT_TYPE_COUNT] = { 0, 0, 0 };
+		int mismatches = 0;
+		double stepSeconds = 0.0;
+		double readSeconds = 0.0;
+		for (int step = 0; step < CONTACT_STEPS; step++)
+		{
+			// Delete a few bodies and put new ones where they were, the new ones are likely to get the same addresses
+			if (setting == 4)
+			{
+				std::vector<PhysicsObject*> replaced;
+				for (int body = 0; body < CONTACT_CHURN; body++)
+				{
+					seed = seed * 1664525u + 1013904223u;
+					PhysicsObject* actor = scene.getActors()[(seed >> 8) % scene.getActors().size()];
+					if (std::find(replaced.begin(), replaced.end(), actor) == replaced.end())
+					{
+						replaced.push_back(actor);
+					}
+				}
+				scene.removeActors(replaced);
+				for (auto actor : replaced)
+				{
+					Rigidbody* old = static_cast<Rigidbody*>(actor);
+					glm::vec2 position = old->getPosition();
+					glm::vec2 velocity = old->getVelocity();
+					delete actor;
+					scene.addActor(new Sphere(position, velocity, glm::vec2(0, 0), 1.0f, 1.0f, 0.9f, glm::vec4(1, 1, 0, 1)));
+				}
+			}
+
+			Clock::time_point start = Clock::now();
+			scene.update(SCALAR_TIME_STEP);
+			Clock::time_point stepped = Clock::now();
+
+			const std::vector<ContactEvent>& events = scene.getContactStream().getEvents();
+			for (auto& event : events)
+			{
+				typeCounts[event.type]++;
+			}
+			readSeconds += std::chrono::duration<double>(Clock::now() - stepped).count();
+			stepSeconds += std::chrono::duration<double>(stepped - start).count();
+			eventCount += events.size();
+
+			for (auto& event : events)
+			{
+				std::pair<unsigned int, unsigned int> pair(event.firstId, event.secondId);
+				if (event.type == CONTACT_BEGIN)
+				{
+					mismatches += touching.insert(pair).second ? 0 : 1;
+				}
+				else if (event.type == CONTACT_PERSIST)
+				{
+					mismatches += (touching.count(pair) == 1) ? 0 : 1;
+				}
+				else
+				{
+					mismatches += (touching.erase(pair) == 1) ? 0 : 1;
+				}
+			}
+		}
+
+		int tracked = scene.getContactStream().getTrackedCount();
+		std::printf("%-16s %12.3f %12lld %12lld %12lld %12d %14.2f\n", settingNames[setting], (stepSeconds * 1000.0) / CONTACT_STEPS,
+					typeCounts[CONTACT_BEGIN], typeCounts[CONTACT_PERSIST], typeCounts[CONTACT_END], tracked,
+					(eventCount > 0) ? (readSeconds * 1e9) / eventCount : 0.0);
+		if (setting > 0 && (mismatches > 0 || (int)touching.size() != tracked))
+		{
+			std::printf("%d events didn't match, %d pairs touching by the events against %d tracked\n", mismatches, (int)touching.size(), tracked);
+		}
+	}
+	std::printf("\n");
+}
+
+//============================================================================================================================================
+// SDF Benchmark
+
+// Funnel Wall, one side of the funnel as a polyline, a parabola from the neck up to the rim
+static std::vector<glm::vec2> funnelWall(int segments, float side)
+{
+	std::vector<glm::vec2> points;
+	for (int i = 0; i <= segments; i++)
+	{
+		float s = (float)i / segments;
+		points.push_back(glm::vec2(side * (8.0f + (92.0f * s)), 100.0f * s * s));
+	}
+	return points;
+}
+
+// Run Funnel, bodies poured into the funnel built either as one distance field or as a static AABB round every wall
+// segment, the way it would have to be built without one. Returns the seconds per step and how many bodies ended up
+// inside the walls
+static double runFunnel(int segments, bool distanceField, int& buried)
+{
+	PhysicsScene scene;
+	scene.setGravity(glm::vec2(0, PROJECTILE_GRAVITY));
+	scene.setTimeStep(SCALAR_TIME_STEP);
+	scene.addActor(new Plane(glm::vec2(1, 0), -FORK_BOX_HALF_SIZE, glm::vec4(1, 0, 1, 1)));
+	scene.addActor(new Plane(glm::vec2(-1, 0), -FORK_BOX_HALF_SIZE, glm::vec4(1, 0, 1, 1)));
+	scene.addActor(new Plane(glm::vec2(0, 1), -FORK_BOX_HALF_SIZE, glm::vec4(1, 0, 1, 1)));
+
+	SdfCollider* funnel = new SdfCollider(glm::vec2(-110, -10), glm::vec2(220, 120), SDF_CELL_SIZE, glm::vec4(1, 1, 1, 1));
+	for (int side = -1; side <= 1; side += 2)
+	{
+		std::vector<glm::vec2> wall = funnelWall(segments, (float)side);
+		funnel->addPolyline(wall, false, SDF_WALL_RADIUS);
+		if (distanceField)
+		{
+			continue;
+		}
+		for (int i = 0; i < segments; i++)
+		{
+			glm::vec2 extents = (glm::abs(wall[i + 1] - wall[i]) * 0.5f) + glm::vec2(SDF_WALL_RADIUS, SDF_WALL_RADIUS);
+			AABB* box = new AABB((wall[i] + wall[i + 1]) * 0.5f, glm::vec2(0, 0), glm::vec2(0, 0), extents, 1.0f, 1.0f, glm::vec4(1, 1, 1, 1));
+			box->setBodyType(STATIC_BODY);
+			scene.addActor(box);
+		}
+	}
+	funnel->bakePolylines();
+	funnel->setMipLevels(SDF_MIP_LEVELS);
+	if (distanceField)
+	{
+		scene.addActor(funnel);
+	}
+
+	std::vector<Rigidbody*> bodies;
+	for (int body = 0; body < SDF_BODY_COUNT; body++)
+	{
+		// Thrown down, bodies starting at rest never get past the drag cutoff on the first step
+		glm::vec2 position(-88.5f + (body % SDF_COLUMNS) * 3.0f, 110.0f + (body / SDF_COLUMNS) * 3.0f);
+		glm::vec2 velocity(((body * 7) % 11) - 5.0f, -20.0f);
+		Rigidbody* rigidbody = (body % 2 == 0) ? (Rigidbody*)new Sphere(position, velocity, glm::vec2(0, 0), 1.0f, 1.0f, 0.5f, glm::vec4(1, 1, 0, 1)) :
+			(Rigidbody*)new AABB(position, velocity, glm::vec2(0, 0), glm::vec2(1.0f, 0.75f), 1.0f, 0.5f, glm::vec4(0, 1, 1, 1));
+		scene.addActor(rigidbody);
+		bodies.push_back(rigidbody);
+	}
+
+	Clock::time_point start = Clock::now();
+	for (int step = 0; step < SDF_STEPS; step++)
+	{
+		scene.update(SCALAR_TIME_STEP);
+	}
+	double seconds = std::chrono::duration<double>(Clock::now() - start).count() / SDF_STEPS;
+
+	// A body whose centre is well into a wall has gone through it
+	buried = 0;
+	for (auto body : bodies)
+	{
+		buried += (funnel->getDistance(body->getPosition()) < -SDF_WALL_RADIUS * 0.5f) ? 1 : 0;
+	}
+	if (!distanceField)
+	{
+		delete funnel;
+	}
+	return seconds;
+}
+
+// Run SDF Benchmark
+void runSdfBenchmark()
+{
+	const int segmentCounts[] = { 16, 128, 1024 };
+
+	std::printf("Signed distance fields, a funnel of two curved walls, %d bodies, %d steps\n", SDF_BODY_COUNT, SDF_STEPS);
+	std::printf("%-10s %10s %12s %12s %12s %14s %14s %8s\n", "Segments", "Bake ms", "Lookup ns", "Mip ns", "Rejected", "Field ms/step", "Boxes ms/step", "Buried");
+
+	for (int segmentCount : segmentCounts)
+	{
+		SdfCollider funnel(glm::vec2(-110, -10), glm::vec2(220, 120), SDF_CELL_SIZE, glm::vec4(1, 1, 1, 1));
+		funnel.addPolyline(funnelWall(segmentCount, -1.0f), false, SDF_WALL_RADIUS);
+		funnel.addPolyline(funnelWall(segmentCount, 1.0f), false, SDF_WALL_RADIUS);
+		Clock::time_point bakeStart = Clock::now();
+		funnel.bakePolylines();
+		double bakeSeconds = std::chrono::duration<double>(Clock::now() - bakeStart).count();
+
+		// Sphere lookups spread over the field, without mip levels and then with them
+		std::vector<glm::vec2> points(SDF_LOOKUPS);
+		unsigned int seed = 24680;
+		for (auto& point : points)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			point.x = -110.0f + ((seed >> 8) % 22001) / 100.0f;
+			seed = seed * 1664525u + 1013904223u;
+			point.y = -10.0f + ((seed >> 8) % 12001) / 100.0f;
+		}
+
+		double lookupSeconds[2];
+		int touching[2] = { 0, 0 };
+		int rejected = 0;
+		for (int pass = 0; pass < 2; pass++)
+		{
+			funnel.setMipLevels((pass == 0) ? 0 : SDF_MIP_LEVELS);
+			Clock::time_point lookupStart = Clock::now();
+			for (auto& point : points)
+			{
+				float depth;
+				glm::vec2 normal;
+				touching[pass] += funnel.penetrate(point, glm::vec2(0, 0), 1.0f, depth, normal) ? 1 : 0;
+			}
+			lookupSeconds[pass] = std::chrono::duration<double>(Clock::now() - lookupStart).count();
+		}
+		for (auto& point : points)
+		{
+			rejected += funnel.isClear(point - glm::vec2(1, 1), point + glm::vec2(1, 1)) ? 1 : 0;
+		}
+
+		int buried = 0;
+		int boxBuried = 0;
+		double fieldSeconds = runFunnel(segmentCount, true, buried);
+		double boxSeconds = runFunnel(segmentCount, false, boxBuried);
+
+		std::printf("%-10d %10.2f %12.2f %12.2f %11.1f%% %14.3f %14.3f %8d\n", segmentCount * 2, bakeSeconds * 1000.0,
+					(lookupSeconds[0] * 1e9) / SDF_LOOKUPS, (lookupSeconds[1] * 1e9) / SDF_LOOKUPS, (100.0 * rejected) / SDF_LOOKUPS,
+					fieldSeconds * 1000.0, boxSeconds * 1000.0, buried);
+		if (touching[0] != touching[1])
+		{
+			std::printf("Mip rejection changed the contacts found, %d without against %d with\n", touching[0], touching[1]);
+		}
+	}
+
+	// The same field from a mask, as an image would bake
+	std::vector<unsigned char> mask(SDF_MASK_SIZE * SDF_MASK_SIZE);
+	for (int row = 0; row < SDF_MASK_SIZE; row++)
+	{
+		for (int column = 0; column < SDF_MASK_SIZE; column++)
+		{
+			glm::vec2 offset = glm::vec2(column, row) - glm::vec2(SDF_MASK_SIZE * 0.5f, SDF_MASK_SIZE * 0.5f);
+			mask[(row * SDF_MASK_SIZE) + column] = (glm::length(offset) < SDF_MASK_SIZE * 0.3f) ? 255 : 0;
+		}
+	}
+	SdfCollider disc(glm::vec2(0, 0), glm::vec2(1, 1), 1.0f, glm::vec4(1, 1, 1, 1));
+	Clock::time_point maskStart = Clock::now();
+	disc.bakeMask(&mask[0], SDF_MASK_SIZE, SDF_MASK_SIZE, 127);
+	double maskSeconds = std::chrono::duration<double>(Clock::now() - maskStart).count();
+	glm::vec2 centre(SDF_MASK_SIZE * 0.5f, SDF_MASK_SIZE * 0.5f);
+	float maskError = 0.0f;
+	for (int i = 0; i < 360; i++)
+	{
+		glm::vec2 point = centre + (glm::vec2(std::cos(i * 0.01745f), std::sin(i * 0.01745f)) * (SDF_MASK_SIZE * 0.4f));
+		maskError = glm::max(maskError, std::abs(disc.getDistance(point) - (SDF_MASK_SIZE * 0.1f)));
+	}
+	std::printf("%dx%d mask baked in %.2f ms, distance off by at most %.2f cells round a disc\n\n", SDF_MASK_SIZE, SDF_MASK_SIZE, maskSeconds * 1000.0, maskError);
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+// Include .h files
+
+// Other includes
+
+// Typedefs
+
+//============================================================================================================================================
+// Benchmarks
+
+// Headless runs started with --benchmark on the command line, results are printed as plain tables. A name after the
+// flag runs just that benchmark, otherwise every one runs in turn
+void runBenchmarks(const char* name);
+
+// Analytic projectile from PhysicsEngineApp::setupContinuousDemo, with and without drag, for every integrator and a
+// range of time steps. Reports the final position error against the closed form and the cost per body per second
+void runIntegratorBenchmark();
+
+// Eccentric Kepler orbits round a heavy body through Barnes-Hut gravity. Fixed RK4 steps against adaptive stepping at a
+// range of tolerances, reporting the error against Kepler's equation and the number of body force evaluations
+void runAdaptiveBenchmark();
+
+// BasicPhysicsScene and its bodies in float, double and Q32.32 fixed point. A box of colliding bodies for the cost per
+// step and a checksum of the result, then a projectile far from the origin for the rounding error of each type
+void runScalarBenchmark();
+
+// A band of bricks, up to a million, paged through a TiledWorld by one region sweeping along it. The time per step and
+// the bodies in the scene should stay the same whatever the size of the world
+void runTiledWorldBenchmark();
+
+// A wide field of bodies stepped at full rate and then with LOD scheduling round a focus point in the middle. Reports
+// the cost per step, integrations and pairs done, and how far a probe in the slowest tier ends up from its full rate path
+void runLodBenchmark();
+
+// A big field of bodies added in random order, stepped with no reordering, reordering every few steps, and reordering
+// when the locality metric drifts. Reports the cost per step, the sorts done and the spacing of the list, then one sort
+void runLocalityBenchmark();
+
+// A big field of Spheres sharing a few materials and colours. Reports the bytes each step reads from the hot body data,
+// the shared warm tables and the broadphase, against the same fields stored inline in every body, and the cost per step.
+// Runs again with a material and colour for every body, past what 16 bit indices held, and checks each reads back its own
+void runLayoutBenchmark();
+
+// The continuous demo's launch swept over a grid of angles and speeds with EnsembleRunner, with runs packed into shared
+// scenes and with a scene each. Reports the time for the whole sweep and checks packing leaves every result the same
+void runEnsembleBenchmark();
+
+// Aiming previews for launches fanned over angles and speeds, with and without drag. Reports the cost of every position
+// sample and of finding each landing on the ground with TrajectoryPredictor, the error against the closed form, and how
+// far the predicted landings are from a stepped scene's along with the cost of stepping it
+void runTrajectoryBenchmark();
+
+// A box of Spheres and AABBs forked with SceneFork and looked ahead every frame on its worker. Reports the cost of the
+// first fork, of later forks copying over the pools and of copying every body with new, the time the look ahead takes,
+// and checks the live scene stepped the same distance ends up exactly where the fork said
+void runSceneForkBenchmark();
+
+// A box of Spheres and AABBs stepped with a history, then rewound a few steps and re-simulated with a changed input
+// every frame. Reports the cost of recording, of a rewind and re-simulation against a 16 ms frame, the memory the
+// history takes against storing every step whole, and checks re-simulating with nothing changed repeats exactly
+void runRollbackBenchmark();
+
+// A box of Spheres and AABBs stepped with contact events off, with begin and end events, and with every event. Reports
+// the cost per step, the events written, the pairs touching at the end and the cost of reading the events back, and
+// checks the begins and ends pair up
+void runContactEventBenchmark();
+
+// A funnel of two curved walls baked into an SdfCollider from finer and finer polylines, with bodies poured through it.
+// Reports the bake time, the cost of a contact lookup with and without mip levels and how many the mips rejected, and
+// the cost per step against the same walls built from a static AABB per segment, then the bake time and accuracy of a
+// field baked from a mask
+void runSdfBenchmark();
\ No newline at end of file
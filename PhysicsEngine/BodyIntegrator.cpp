@@ -0,0 +1,183 @@
+// Include .h files
+#include "BodyIntegrator.h"
+#include "RigidBody.h"
+
+// Other includes
+
+// Typedefs
+
+//============================================================================================================================================
+// Constructors
+
+// Constructor
+BodyIntegrator::BodyIntegrator()
+{
+	m_timeStep = 0.0f;
+	m_gravity = glm::vec2(0, 0);
+	m_evaluationCount = 0;
+	m_generators = nullptr;
+	m_fields = nullptr;
+	m_hasForceSources = false;
+}
+
+//============================================================================================================================================
+// Stages
+
+// Drift
+void BodyIntegrator::drift(float h)
+{
+	int bodyCount = m_bodies.size();
+	for (int i = 0; i < bodyCount; i++)
+	{
+		m_positionX[i] += m_velocityX[i] * h;
+		m_positionY[i] += m_velocityY[i] * h;
+	}
+}
+
+// Kick, drag is taken half from the old velocity and half from the new one so the kick stays time reversible and a
+// symmetric sequence of kicks and drifts keeps its order with drag on
+void BodyIntegrator::kick(float h)
+{
+	int bodyCount = m_bodies.size();
+	for (int i = 0; i < bodyCount; i++)
+	{
+		float halfDrag = m_linearDrag[i] * h * 0.5f;
+		m_velocityX[i] = ((m_velocityX[i] * (1.0f - halfDrag)) + (m_accelerationX[i] * h)) / (1.0f + halfDrag);
+		m_velocityY[i] = ((m_velocityY[i] * (1.0f - halfDrag)) + (m_accelerationY[i] * h)) / (1.0f + halfDrag);
+	}
+}
+
+// Evaluate, forces come from the generators plus whatever was applied before the step and gravity is added here, drag
+// is left to the kicks
+void BodyIntegrator::evaluate()
+{
+	int bodyCount = m_bodies.size();
+	m_evaluationCount++;
+
+	if (m_hasForceSources)
+	{
+		applyForceSources();
+		for (int i = 0; i < bodyCount; i++)
+		{
+			m_forceX[i] += m_appliedAccelerationX[i];
+			m_forceY[i] += m_appliedAccelerationY[i];
+		}
+	}
+
+	for (int i = 0; i < bodyCount; i++)
+	{
+		m_accelerationX[i] = m_forceX[i] + m_gravity.x;
+		m_accelerationY[i] = m_forceY[i] + m_gravity.y;
+	}
+}
+
+// Apply Force Sources, puts the generator and field forces at the current positions and velocities in the forces
+void BodyIntegrator::applyForceSources()
+{
+	// The generators read the bodies themselves, so put them where this stage has them
+	int bodyCount = m_bodies.size();
+	for (int i = 0; i < bodyCount; i++)
+	{
+		m_bodies[i]->setPosition(glm::vec2(m_positionX[i], m_positionY[i]));
+		m_bodies[i]->setVelocity(glm::vec2(m_velocityX[i], m_velocityY[i]));
+	}
+
+	for (auto pGenerator : *m_generators)
+	{
+		pGenerator->applyForces(*m_actors, m_timeStep);
+	}
+	if (m_fields != nullptr)
+	{
+		m_fields->applyForces(*m_actors, m_timeStep);
+	}
+
+	for (int i = 0; i < bodyCount; i++)
+	{
+		glm::vec2 force = m_bodies[i]->getAcceleration();
+		m_forceX[i] = force.x;
+		m_forceY[i] = force.y;
+	}
+	clearAccelerations();
+}
+
+// Save Start
+void BodyIntegrator::saveStart()
+{
+	m_startPositionX = m_positionX;
+	m_startPositionY = m_positionY;
+	m_startVelocityX = m_velocityX;
+	m_startVelocityY = m_velocityY;
+}
+
+// Clear Slopes
+void BodyIntegrator::clearSlopes()
+{
+	int bodyCount = m_bodies.size();
+	m_slopePositionX.assign(bodyCount, 0.0f);
+	m_slopePositionY.assign(bodyCount, 0.0f);
+	m_slopeVelocityX.assign(bodyCount, 0.0f);
+	m_slopeVelocityY.assign(bodyCount, 0.0f);
+}
+
+// Accumulate Slopes, the current velocity is the slope of the position and the acceleration with drag the slope of
+// the velocity
+void BodyIntegrator::accumulateSlopes(float weight)
+{
+	int bodyCount = m_bodies.size();
+	for (int i = 0; i < bodyCount; i++)
+	{
+		m_slopePositionX[i] += m_velocityX[i] * weight;
+		m_slopePositionY[i] += m_velocityY[i] * weight;
+		m_slopeVelocityX[i] += (m_accelerationX[i] - (m_velocityX[i] * m_linearDrag[i])) * weight;
+		m_slopeVelocityY[i] += (m_accelerationY[i] - (m_velocityY[i] * m_linearDrag[i])) * weight;
+	}
+}
+
+// Runge Kutta Stage, steps h from the start of the step along the current slopes
+void BodyIntegrator::rungeKuttaStage(float h)
+{
+	int bodyCount = m_bodies.size();
+	for (int i = 0; i < bodyCount; i++)
+	{
+		float slopeVelocityX = m_accelerationX[i] - (m_velocityX[i] * m_linearDrag[i]);
+		float slopeVelocityY = m_accelerationY[i] - (m_velocityY[i] * m_linearDrag[i]);
+		m_positionX[i] = m_startPositionX[i] + (m_velocityX[i] * h);
+		m_positionY[i] = m_startPositionY[i] + (m_velocityY[i] * h);
+		m_velocityX[i] = m_startVelocityX[i] + (slopeVelocityX * h);
+		m_velocityY[i] = m_startVelocityY[i] + (slopeVelocityY * h);
+	}
+}
+
+// Runge Kutta Finish, steps from the start of the step along the weighted slopes
+void BodyIntegrator::rungeKuttaFinish(float h)
+{
+	int bodyCount = m_bodies.size();
+	for (int i = 0; i < bodyCount; i++)
+	{
+		m_positionX[i] = m_startPositionX[i] + (m_slopePositionX[i] * h);
+		m_positionY[i] = m_startPositionY[i] + (m_slopePositionY[i] * h);
+		m_velocityX[i] = m_startVelocityX[i] + (m_slopeVelocityX[i] * h);
+		m_velocityY[i] = m_startVelocityY[i] + (m_slopeVelocityY[i] * h);
+	}
+}
+
+//============================================================================================================================================
+// Body Data
+
+// Gather Bodies, the forces the bodies already hold are the ones for the first pass
+void BodyIntegrator::gatherBodies(const std::vector<PhysicsObject*>& bodies)
+{
+	IntegratorBodies<float>::gatherBodies(bodies);
+
+	m_forceX = m_appliedAccelerationX;
+	m_forceY = m_appliedAccelerationY;
+
+	int bodyCount = m_bodies.size();
+	m_accelerationX.resize(bodyCount);
+	m_accelerationY.resize(bodyCount);
+	for (int i = 0; i < bodyCount; i++)
+	{
+		m_accelerationX[i] = m_forceX[i] + m_gravity.x;
+		m_accelerationY[i] = m_forceY[i] + m_gravity.y;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,209 @@
+#pragma once
+// Include .h files
+#include "PhysicsObject.h"
+#include "ForceGenerator.h"
+#include "IntegratorBodies.h"
+
+// Other includes
+#include <vector>
+#include <glm\vec2.hpp>
+#include <glm\glm.hpp>
+
+// Typedefs
+
+//============================================================================================================================================
+// IntegratorType ENUM
+
+enum IntegratorType
+{
+	SEMI_IMPLICIT_EULER,	// Rigidbody::fixedUpdate, one force pass, first order
+	VELOCITY_VERLET,		// Kick-drift-kick, two force passes, second order and symplectic
+	LEAPFROG,				// Drift-kick-drift, one force pass at the midpoint, second order and symplectic
+	RUNGE_KUTTA_4,			// Classic RK4, four force passes, fourth order but slowly leaks energy
+	YOSHIDA_4				// Three velocity Verlet steps of Yoshida's weights, four force passes, fourth order and symplectic
+};
+
+//============================================================================================================================================
+// BodyIntegrator CLASS
+
+// Higher order integration for the scene's dynamic bodies. Each integrator is a policy struct that strings together
+// drift, kick and force passes; step is instantiated once per policy so the bodies are moved by tight loops over flat
+// arrays, with the choice of integrator made once per step rather than per body. Every force pass puts the bodies at
+// that stage's positions and velocities and re-runs the scene's force generators and fields, so springs and gravity
+// wells are sampled where the method expects them, and adds back the forces applied to the bodies before the step.
+// Linear drag is folded into the kicks. Kinematic bodies just move with their velocity
+class BodyIntegrator : public IntegratorBodies<float>
+{
+
+public:
+	BodyIntegrator();
+
+	// startForces says whether the bodies already hold the forces at the start of the step
+	template <class Policy>
+	void step(float timeStep, glm::vec2 gravity, const std::vector<PhysicsObject*>& actors, const std::vector<PhysicsObject*>& bodies,
+			  const std::vector<ForceGenerator*>& generators, ForceGenerator* fields, bool startForces);
+
+	//============================================================================================================================================
+	// Stages, used by the policies
+
+	void drift(float h);			// Positions move on by h of their velocity
+	void kick(float h);				// Velocities move on by h of their acceleration and drag
+	void evaluate();				// Accelerations at the current positions and velocities
+
+	// RK4 stages restart from the start of the step, the accumulators gather the weighted slopes
+	void saveStart();
+	void clearSlopes();
+	void accumulateSlopes(float weight);
+	void rungeKuttaStage(float h);
+	void rungeKuttaFinish(float h);
+
+	//============================================================================================================================================
+	// Getters
+
+	int getBodyCount() const { return m_bodies.size(); }
+	long long getEvaluationCount() const { return m_evaluationCount; }
+
+protected:
+	void gatherBodies(const std::vector<PhysicsObject*>& bodies);
+	void applyForceSources();
+
+	float m_timeStep;
+	glm::vec2 m_gravity;
+	long long m_evaluationCount;
+
+	// Where the forces come from, only valid during a step
+	const std::vector<ForceGenerator*>* m_generators;
+	ForceGenerator* m_fields;
+	bool m_hasForceSources;
+
+	//============================================================================================================================================
+	// Dynamic Bodies, the rest are in IntegratorBodies
+
+	std::vector<float> m_accelerationX;		// Applied forces over mass plus gravity, drag is worked out from the velocity
+	std::vector<float> m_accelerationY;
+	std::vector<float> m_forceX;			// Generator, field and applied forces over mass from the last pass
+	std::vector<float> m_forceY;
+
+	// RK4 only
+	std::vector<float> m_startPositionX;
+	std::vector<float> m_startPositionY;
+	std::vector<float> m_startVelocityX;
+	std::vector<float> m_startVelocityY;
+	std::vector<float> m_slopePositionX;
+	std::vector<float> m_slopePositionY;
+	std::vector<float> m_slopeVelocityX;
+	std::vector<float> m_slopeVelocityY;
+};
+
+//============================================================================================================================================
+// Integrator Policies
+
+// Velocity Verlet, needs the forces at the start of the step
+struct VelocityVerletPolicy
+{
+	static const bool START_FORCES = true;
+	static void integrate(BodyIntegrator& bodies, float h)
+	{
+		bodies.kick(h * 0.5f);
+		bodies.drift(h);
+		bodies.evaluate();
+		bodies.kick(h * 0.5f);
+	}
+};
+
+// Leapfrog in drift-kick-drift form, only needs the forces half way through
+struct LeapfrogPolicy
+{
+	static const bool START_FORCES = false;
+	static void integrate(BodyIntegrator& bodies, float h)
+	{
+		bodies.drift(h * 0.5f);
+		bodies.evaluate();
+		bodies.kick(h);
+		bodies.drift(h * 0.5f);
+	}
+};
+
+// Runge-Kutta 4, each stage steps from the start of the step using the last stage's slopes
+struct RungeKutta4Policy
+{
+	static const bool START_FORCES = true;
+	static void integrate(BodyIntegrator& bodies, float h)
+	{
+		bodies.saveStart();
+		bodies.clearSlopes();
+		bodies.accumulateSlopes(1.0f);
+		bodies.rungeKuttaStage(h * 0.5f);
+		bodies.evaluate();
+		bodies.accumulateSlopes(2.0f);
+		bodies.rungeKuttaStage(h * 0.5f);
+		bodies.evaluate();
+		bodies.accumulateSlopes(2.0f);
+		bodies.rungeKuttaStage(h);
+		bodies.evaluate();
+		bodies.accumulateSlopes(1.0f);
+		bodies.rungeKuttaFinish(h / 6.0f);
+	}
+};
+
+// Yoshida 4th order, velocity Verlet steps of w1, w0 and w1. The kicks either side of each force pass are kept apart,
+// merging them is only exact without drag
+struct Yoshida4Policy
+{
+	static const bool START_FORCES = true;
+	static void integrate(BodyIntegrator& bodies, float h)
+	{
+		// w1 = 1 / (2 - 2^(1/3)), w0 = 1 - 2 * w1, so w0 steps backwards
+		const float weights[3] = { 1.35120719195966f, -1.70241438391932f, 1.35120719195966f };
+		for (float weight : weights)
+		{
+			bodies.kick(weight * h * 0.5f);
+			bodies.drift(weight * h);
+			bodies.evaluate();
+			bodies.kick(weight * h * 0.5f);
+		}
+	}
+};
+
+//============================================================================================================================================
+// Step
+
+// Step, moves the bodies one step with the given policy and leaves every actor's accumulated forces cleared
+template <class Policy>
+void BodyIntegrator::step(float timeStep, glm::vec2 gravity, const std::vector<PhysicsObject*>& actors, const std::vector<PhysicsObject*>& bodies,
+						  const std::vector<ForceGenerator*>& generators, ForceGenerator* fields, bool startForces)
+{
+	m_timeStep = timeStep;
+	m_gravity = gravity;
+	m_actors = &actors;
+	m_generators = &generators;
+	m_fields = fields;
+	m_hasForceSources = !generators.empty() || fields != nullptr;
+
+	gatherBodies(bodies);
+
+	// What the bodies hold is kept and added to every force pass. Forces already applied this step are the start forces,
+	// but they include the generators' share, which is worked out again and taken off what the later passes add
+	clearAccelerations();
+	if (startForces && m_hasForceSources)
+	{
+		applyForceSources();
+		int bodyCount = m_bodies.size();
+		for (int i = 0; i < bodyCount; i++)
+		{
+			m_appliedAccelerationX[i] -= m_forceX[i];
+			m_appliedAccelerationY[i] -= m_forceY[i];
+		}
+	}
+	else if (Policy::START_FORCES && !startForces)
+	{
+		evaluate();
+	}
+
+	Policy::integrate(*this, timeStep);
+	scatterBodies(timeStep);
+
+	m_actors = nullptr;
+	m_generators = nullptr;
+	m_fields = nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,146 @@
+// Include .h files
+#include "BodyTables.h"
+
+// Other includes
+#include <cstring>
+#include <cstddef>
+#include <unordered_map>
+
+// Typedefs
+typedef std::unordered_multimap<size_t, unsigned int> EntryLookup;
+
+// Entries in a page, and enough pages for every 32 bit index
+static const int SHARED_PAGE_SIZE = 1 << SHARED_PAGE_BITS;
+static const int MAX_SHARED_PAGES = 1 << (32 - SHARED_PAGE_BITS);
+
+std::vector<std::vector<BodyMaterial>> MaterialTable::s_pages;
+std::vector<int> MaterialTable::s_references;
+std::vector<unsigned int> MaterialTable::s_free;
+std::vector<std::vector<BodyRenderState>> RenderStateTable::s_pages;
+std::vector<int> RenderStateTable::s_references;
+std::vector<unsigned int> RenderStateTable::s_free;
+
+static EntryLookup s_materialLookup;
+static EntryLookup s_renderStateLookup;
+
+//============================================================================================================================================
+// Shared Entries
+
+// Hash Bytes, FNV-1a over the entry as it sits in memory
+static size_t hashBytes(const void* data, int size)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	unsigned long long hash = 14695981039346656037ull;
+	for (int i = 0; i < size; i++)
+	{
+		hash = (hash ^ bytes[i]) * 1099511628211ull;
+	}
+	return (size_t)hash;
+}
+
+// Add Shared, finds an entry with the same bytes or stores a new one, returning its index with a reference taken
+template <class Entry>
+static unsigned int addShared(std::vector<std::vector<Entry>>& pages, std::vector<int>& references, std::vector<unsigned int>& freeEntries,
+							  EntryLookup& lookup, const Entry& entry)
+{
+	size_t hash = hashBytes(&entry, sizeof(Entry));
+	auto range = lookup.equal_range(hash);
+	for (auto found = range.first; found != range.second; ++found)
+	{
+		const Entry& stored = pages[found->second >> SHARED_PAGE_BITS][found->second & SHARED_PAGE_MASK];
+		if (std::memcmp(&stored, &entry, sizeof(Entry)) == 0)
+		{
+			references[found->second]++;
+			return found->second;
+		}
+	}
+
+	// Freed entries are used again before the table grows
+	unsigned int index;
+	if (!freeEntries.empty())
+	{
+		index = freeEntries.back();
+		freeEntries.pop_back();
+		pages[index >> SHARED_PAGE_BITS][index & SHARED_PAGE_MASK] = entry;
+	}
+	else
+	{
+		// Room for every page and every entry in a page up front, so entries never move and readers on other threads
+		// can't be left holding a stale one
+		index = references.size();
+		if (pages.empty())
+		{
+			pages.reserve(MAX_SHARED_PAGES);
+		}
+		if ((index & SHARED_PAGE_MASK) == 0)
+		{
+			pages.push_back(std::vector<Entry>());
+			pages.back().reserve(SHARED_PAGE_SIZE);
+		}
+		pages.back().push_back(entry);
+		references.push_back(0);
+	}
+
+	references[index] = 1;
+	lookup.insert(std::make_pair(hash, index));
+	return index;
+}
+
+// Release Shared, gives back a reference and frees the entry once nothing refers to it
+template <class Entry>
+static void releaseShared(std::vector<std::vector<Entry>>& pages, std::vector<int>& references, std::vector<unsigned int>& freeEntries,
+						  EntryLookup& lookup, unsigned int index)
+{
+	if (--references[index] > 0)
+	{
+		return;
+	}
+
+	// Out of the lookup so nothing new can find it, the bytes stay until the index is handed out again
+	auto range = lookup.equal_range(hashBytes(&pages[index >> SHARED_PAGE_BITS][index & SHARED_PAGE_MASK], sizeof(Entry)));
+	for (auto found = range.first; found != range.second; ++found)
+	{
+		if (found->second == index)
+		{
+			lookup.erase(found);
+			break;
+		}
+	}
+	freeEntries.push_back(index);
+}
+
+//============================================================================================================================================
+// MaterialTable
+
+// Add
+unsigned int MaterialTable::add(const BodyMaterial& material)
+{
+	return addShared(s_pages, s_references, s_free, s_materialLookup, material);
+}
+
+// Release
+void MaterialTable::release(unsigned int material)
+{
+	releaseShared(s_pages, s_references, s_free, s_materialLookup, material);
+}
+
+//============================================================================================================================================
+// RenderStateTable
+
+// Add
+unsigned int RenderStateTable::add(const BodyRenderState& renderState)
+{
+	// Zero the padding so equal states always compare equal byte for byte
+	BodyRenderState packed;
+	std::memset(&packed, 0, sizeof(packed));
+	packed.color = renderState.color;
+	packed.rotation = renderState.rotation;
+
+	return addShared(s_pages, s_references, s_free, s_renderStateLookup, packed);
+}
+
+// Release
+void RenderStateTable::release(unsigned int renderState)
+{
+	releaseShared(s_pages, s_references, s_free, s_renderStateLookup, renderState);
+}
\ No newline at end of file
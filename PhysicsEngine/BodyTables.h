@@ -0,0 +1,90 @@
+#pragma once
+// Include .h files
+
+// Other includes
+#include <vector>
+#include <glm\vec4.hpp>
+#include <glm\glm.hpp>
+
+// Typedefs
+
+//============================================================================================================================================
+// BodyMaterial STRUCT
+
+// Warm per-body data, read by the solver and the integrator but hardly ever changed, and shared by every body set up
+// the same way. Plain floats only, entries are compared and hashed byte for byte
+struct BodyMaterial
+{
+	float elasticity;
+	float charge;			// Only used by Coulomb force generators
+	float linearDrag;
+	float minLinearDrag;	// Slower than this and the body comes to rest
+	float angularDrag;
+	float minAngularDrag;
+};
+
+//============================================================================================================================================
+// BodyRenderState STRUCT
+
+// Cold per-body data, only read when drawing. Rotation is here since nothing integrates it
+struct BodyRenderState
+{
+	glm::vec4 color;
+	float rotation;
+};
+
+//============================================================================================================================================
+// Shared Entry Pages
+
+// Entries are kept in pages that never move once made, an index is the page number over the place in the page
+static const int SHARED_PAGE_BITS = 16;
+static const unsigned int SHARED_PAGE_MASK = (1u << SHARED_PAGE_BITS) - 1;
+
+//============================================================================================================================================
+// MaterialTable CLASS
+
+// Every distinct BodyMaterial in use, each stored once. A Rigidbody keeps an index in place of the six floats, so the
+// integrator walks bodies a cache line each and the handful of materials they share stay in L1. Entries are counted by
+// reference: add and acquire take one, release gives it back, and an entry nothing refers to any more is freed for the
+// next new material, so changing a body's drag or charge over and over doesn't use the table up. Indices are 32 bits
+// and every one in use is held by a live body, so a scene runs out of memory long before it runs out of indices.
+// Entries never move once added, so threads stepping bodies can read the table while one other thread adds to it, but
+// adding, acquiring or releasing from more than one thread at once is not safe
+class MaterialTable
+{
+
+public:
+	static unsigned int add(const BodyMaterial& material);
+	static void acquire(unsigned int material) { s_references[material]++; }
+	static void release(unsigned int material);
+	static const BodyMaterial& get(unsigned int material) { return s_pages[material >> SHARED_PAGE_BITS][material & SHARED_PAGE_MASK]; }
+
+	static int getCount() { return s_references.size() - s_free.size(); }
+
+protected:
+	static std::vector<std::vector<BodyMaterial>> s_pages;
+	static std::vector<int> s_references;
+	static std::vector<unsigned int> s_free;
+};
+
+//============================================================================================================================================
+// RenderStateTable CLASS
+
+// Every distinct BodyRenderState in use, stored, shared and counted the same way as the materials. A scene is usually
+// drawn in a few colours, so this stays small and the colours never come near the cache during a step
+class RenderStateTable
+{
+
+public:
+	static unsigned int add(const BodyRenderState& renderState);
+	static void acquire(unsigned int renderState) { s_references[renderState]++; }
+	static void release(unsigned int renderState);
+	static const BodyRenderState& get(unsigned int renderState) { return s_pages[renderState >> SHARED_PAGE_BITS][renderState & SHARED_PAGE_MASK]; }
+
+	static int getCount() { return s_references.size() - s_free.size(); }
+
+protected:
+	static std::vector<std::vector<BodyRenderState>> s_pages;
+	static std::vector<int> s_references;
+	static std::vector<unsigned int> s_free;
+};
\ No newline at end of file
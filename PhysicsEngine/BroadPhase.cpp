@@ -0,0 +1,575 @@
+// Include .h files
+#include "BroadPhase.h"
+#include "Sphere.h"
+#include "AABB.h"
+#include "SdfCollider.h"
+
+// Other includes
+#include <cmath>
+#include <algorithm>
+
+// Typedefs
+
+// Largest number of cells along either side of the grid, the cell size grows instead once it's reached
+static const int MAX_GRID_DIMENSION = 1024;
+
+// Spare cells round a grid made on a partial refresh
+static const int GRID_MARGIN_CELLS = 4;
+
+//============================================================================================================================================
+// Constructors
+
+// Constructor
+BroadPhase::BroadPhase()
+{
+	m_gridOrigin = glm::vec2(0, 0);
+	m_cellSize = 1.0f;
+	m_minCellSize = 0.0f;
+	m_columns = 1;
+	m_rows = 1;
+	m_cellStart.assign(1, 0);
+	m_cellEnd.assign(1, 0);
+	m_periodic = false;
+	m_domainMin = glm::vec2(0, 0);
+	m_domainSize = glm::vec2(0, 0);
+}
+
+//============================================================================================================================================
+// Proxy Functions
+
+// Get Actor Bounds
+bool BroadPhase::getActorBounds(PhysicsObject* actor, glm::vec2& min, glm::vec2& max)
+{
+	switch (actor->getShapeID())
+	{
+	case SPHERE:
+	{
+		Sphere* sphere = static_cast<Sphere*>(actor);
+		glm::vec2 radius(sphere->getRadius(), sphere->getRadius());
+		min = sphere->getPosition() - radius;
+		max = sphere->getPosition() + radius;
+		return true;
+	}
+	case AABB_:
+	{
+		AABB* aabb = static_cast<AABB*>(actor);
+		min = aabb->getPosition() - aabb->getExtents();
+		max = aabb->getPosition() + aabb->getExtents();
+		return true;
+	}
+	case SDF:
+	{
+		SdfCollider* sdf = static_cast<SdfCollider*>(actor);
+		min = sdf->getMin();
+		max = sdf->getMax();
+		return true;
+	}
+	default:
+		// Planes are infinite and have no bounds
+		return false;
+	}
+}
+
+// Make Proxy
+BroadPhaseProxy BroadPhase::makeProxy(PhysicsObject* actor)
+{
+	BroadPhaseProxy proxy;
+	proxy.category = actor->getCollisionCategory();
+	proxy.mask = actor->getCollisionMask();
+	proxy.group = actor->getCollisionGroup();
+	proxy.dynamic = actor->isDynamic();
+	proxy.actor = actor;
+	getActorBounds(actor, proxy.min, proxy.max);
+	return proxy;
+}
+
+// Should Collide
+bool BroadPhase::shouldCollide(const BroadPhaseProxy& proxy1, const BroadPhaseProxy& proxy2)
+{
+	// A shared group wins over the category bits
+	if (proxy1.group == proxy2.group && proxy1.group != 0)
+	{
+		return proxy1.group > 0;
+	}
+
+	// Each side's category has to be in the other side's mask
+	return ((proxy1.category & proxy2.mask) != 0) && ((proxy2.category & proxy1.mask) != 0);
+}
+
+// Overlaps
+bool BroadPhase::overlaps(const BroadPhaseProxy& proxy1, const BroadPhaseProxy& proxy2)
+{
+	return (proxy1.max.x >= proxy2.min.x) && (proxy1.min.x <= proxy2.max.x) &&
+		   (proxy1.max.y >= proxy2.min.y) && (proxy1.min.y <= proxy2.max.y);
+}
+
+// Overlaps In Domain
+bool BroadPhase::overlapsInDomain(const BroadPhaseProxy& proxy1, const BroadPhaseProxy& proxy2) const
+{
+	if (!m_periodic)
+	{
+		return overlaps(proxy1, proxy2);
+	}
+
+	// Move the second proxy to its image nearest the first
+	glm::vec2 offset = getImageOffset((proxy1.min + proxy1.max) * 0.5f, (proxy2.min + proxy2.max) * 0.5f);
+	return (proxy1.max.x >= proxy2.min.x + offset.x) && (proxy1.min.x <= proxy2.max.x + offset.x) &&
+		   (proxy1.max.y >= proxy2.min.y + offset.y) && (proxy1.min.y <= proxy2.max.y + offset.y);
+}
+
+//============================================================================================================================================
+// Periodic Domain Functions
+
+// Set Periodic Domain
+void BroadPhase::setPeriodicDomain(glm::vec2 min, glm::vec2 max)
+{
+	m_periodic = true;
+	m_domainMin = min;
+	m_domainSize = max - min;
+}
+
+// Get Image Offset
+glm::vec2 BroadPhase::getImageOffset(glm::vec2 from, glm::vec2 to) const
+{
+	if (!m_periodic)
+	{
+		return glm::vec2(0, 0);
+	}
+	glm::vec2 delta = to - from;
+	return -m_domainSize * glm::round(delta / m_domainSize);
+}
+
+// Wrap Position, back into the domain
+glm::vec2 BroadPhase::wrapPosition(glm::vec2 position) const
+{
+	if (!m_periodic)
+	{
+		return position;
+	}
+	glm::vec2 local = position - m_domainMin;
+	return m_domainMin + local - (m_domainSize * glm::floor(local / m_domainSize));
+}
+
+// Get Neighbour Columns
+void BroadPhase::getNeighbourColumns(int column, int reach, std::vector<int>& columns) const
+{
+	columns.clear();
+	if (!m_periodic)
+	{
+		for (int neighbour = glm::max(column - reach, 0); neighbour <= glm::min(column + reach, m_columns - 1); neighbour++)
+		{
+			columns.push_back(neighbour);
+		}
+		return;
+	}
+
+	// A small grid would otherwise see the same column from both sides
+	int count = glm::min((2 * reach) + 1, m_columns);
+	int first = column - glm::min(reach, (count - 1) / 2);
+	for (int i = 0; i < count; i++)
+	{
+		columns.push_back((((first + i) % m_columns) + m_columns) % m_columns);
+	}
+}
+
+// Get Neighbour Rows
+void BroadPhase::getNeighbourRows(int row, int reach, std::vector<int>& rows) const
+{
+	rows.clear();
+	if (!m_periodic)
+	{
+		for (int neighbour = glm::max(row - reach, 0); neighbour <= glm::min(row + reach, m_rows - 1); neighbour++)
+		{
+			rows.push_back(neighbour);
+		}
+		return;
+	}
+
+	int count = glm::min((2 * reach) + 1, m_rows);
+	int first = row - glm::min(reach, (count - 1) / 2);
+	for (int i = 0; i < count; i++)
+	{
+		rows.push_back((((first + i) % m_rows) + m_rows) % m_rows);
+	}
+}
+
+//============================================================================================================================================
+// Grid Functions
+
+// Get Cell Column
+int BroadPhase::getCellColumn(float x) const
+{
+	// Written so NaN and anything off the grid land on the nearest edge cell
+	float column = (x - m_gridOrigin.x) / m_cellSize;
+	if (!(column >= 0.0f)) { return 0; }
+	if (column >= (float)m_columns) { return m_columns - 1; }
+	return (int)column;
+}
+
+// Get Cell Row
+int BroadPhase::getCellRow(float y) const
+{
+	float row = (y - m_gridOrigin.y) / m_cellSize;
+	if (!(row >= 0.0f)) { return 0; }
+	if (row >= (float)m_rows) { return m_rows - 1; }
+	return (int)row;
+}
+
+// Build
+void BroadPhase::build(const std::vector<PhysicsObject*>& actors, const std::vector<PhysicsObject*>& staticActors, const std::vector<char>* refresh)
+{
+	// Static colliders without bounds (Planes) are handled by the scene's plane pass
+	m_staticProxies.clear();
+	for (auto pStatic : staticActors)
+	{
+		if (pStatic->getShapeID() != PLANE)
+		{
+			m_staticProxies.push_back(makeProxy(pStatic));
+		}
+	}
+
+	int proxyCount = actors.size();
+	bool reuse = (refresh != nullptr) && ((int)m_proxies.size() == proxyCount);
+	m_proxies.resize(proxyCount);
+
+	// A partial refresh keeps the grid while every remade proxy still fits it, then only they can have changed cell
+	if (reuse && (int)m_cellEntries.size() == proxyCount && refreshProxies(actors, *refresh))
+	{
+		patchCells();
+		return;
+	}
+
+	// Gather the hot data for every moving body, tracking the grid bounds and the largest body as we go
+	glm::vec2 boundsMin(0, 0);
+	glm::vec2 boundsMax(0, 0);
+	float largestSize = m_minCellSize;
+	bool first = true;
+
+	for (int i = 0; i < proxyCount; i++)
+	{
+		BroadPhaseProxy& proxy = m_proxies[i];
+		if (!reuse || (*refresh)[i] || proxy.actor != actors[i])
+		{
+			proxy = makeProxy(actors[i]);
+		}
+
+		// Skip bodies that have blown up, they still get a cell but can't stretch the grid
+		glm::vec2 size = proxy.max - proxy.min;
+		if (!(std::isfinite(size.x) && std::isfinite(size.y) && std::isfinite(proxy.min.x) && std::isfinite(proxy.min.y)))
+		{
+			continue;
+		}
+
+		if (first)
+		{
+			boundsMin = proxy.min;
+			boundsMax = proxy.max;
+			first = false;
+		}
+		boundsMin = glm::min(boundsMin, proxy.min);
+		boundsMax = glm::max(boundsMax, proxy.max);
+		largestSize = glm::max(largestSize, glm::max(size.x, size.y));
+	}
+
+	// Cells at least as big as the largest body mean overlapping bodies always sit in neighbouring cells
+	m_cellSize = glm::max(largestSize, 0.0001f);
+	if (m_periodic)
+	{
+		// The grid covers the domain exactly. Rounding the cell count down leaves the last cell on each axis wider
+		// than the rest rather than narrower, so neighbours across the wrap are still never more than a cell apart
+		m_cellSize = glm::max(m_cellSize, glm::max(m_domainSize.x, m_domainSize.y) / (float)MAX_GRID_DIMENSION);
+		m_gridOrigin = m_domainMin;
+		m_columns = glm::clamp((int)(m_domainSize.x / m_cellSize), 1, MAX_GRID_DIMENSION);
+		m_rows = glm::clamp((int)(m_domainSize.y / m_cellSize), 1, MAX_GRID_DIMENSION);
+	}
+	else
+	{
+		// A grid that's going to be patched gets room for the bodies to drift before it has to be made again
+		if (reuse)
+		{
+			boundsMin -= glm::vec2(m_cellSize * GRID_MARGIN_CELLS);
+			boundsMax += glm::vec2(m_cellSize * GRID_MARGIN_CELLS);
+		}
+		glm::vec2 gridSize = boundsMax - boundsMin;
+		m_cellSize = glm::max(m_cellSize, glm::max(gridSize.x, gridSize.y) / (float)MAX_GRID_DIMENSION);
+		m_gridOrigin = boundsMin;
+		m_columns = glm::clamp((int)(gridSize.x / m_cellSize) + 1, 1, MAX_GRID_DIMENSION);
+		m_rows = glm::clamp((int)(gridSize.y / m_cellSize) + 1, 1, MAX_GRID_DIMENSION);
+	}
+
+	sortCells();
+}
+
+// Fits Grid, whether the grid from the last build still holds a body without clamping it to an edge cell
+bool BroadPhase::fitsGrid(glm::vec2 min, glm::vec2 max) const
+{
+	glm::vec2 size = max - min;
+	if (glm::max(glm::max(size.x, size.y), m_minCellSize) > m_cellSize)
+	{
+		return false;
+	}
+	if (m_periodic)
+	{
+		return true;
+	}
+
+	glm::vec2 gridMax = m_gridOrigin + (glm::vec2((float)m_columns, (float)m_rows) * m_cellSize);
+	return min.x >= m_gridOrigin.x && min.y >= m_gridOrigin.y && max.x < gridMax.x && max.y < gridMax.y;
+}
+
+// Refresh Proxies, remakes the flagged proxies and any whose actor changed. Returns whether they all still fit the grid
+bool BroadPhase::refreshProxies(const std::vector<PhysicsObject*>& actors, const std::vector<char>& refresh)
+{
+	m_refreshed.clear();
+	bool fits = true;
+	int proxyCount = m_proxies.size();
+	for (int i = 0; i < proxyCount; i++)
+	{
+		BroadPhaseProxy& proxy = m_proxies[i];
+		if (!refresh[i] && proxy.actor == actors[i])
+		{
+			continue;
+		}
+
+		proxy = makeProxy(actors[i]);
+		m_refreshed.push_back(i);
+
+		// Bodies that have blown up can't stretch the grid, they sit in an edge cell as they would after a full build
+		glm::vec2 size = proxy.max - proxy.min;
+		if (std::isfinite(size.x) && std::isfinite(size.y) && std::isfinite(proxy.min.x) && std::isfinite(proxy.min.y))
+		{
+			fits = fits && fitsGrid(proxy.min, proxy.max);
+		}
+	}
+	return fits;
+}
+
+// Sort Cells, a counting sort of the proxies into cells by centre
+void BroadPhase::sortCells()
+{
+	int proxyCount = m_proxies.size();
+	int cellCount = m_columns * m_rows;
+	m_cellStart.assign(cellCount, 0);
+	m_cellEnd.resize(cellCount);
+	m_proxyCell.resize(proxyCount);
+	for (int i = 0; i < proxyCount; i++)
+	{
+		glm::vec2 centre = wrapPosition((m_proxies[i].min + m_proxies[i].max) * 0.5f);
+		int cell = (getCellRow(centre.y) * m_columns) + getCellColumn(centre.x);
+		m_proxyCell[i] = cell;
+		m_cellStart[cell]++;
+	}
+
+	// Counts to starts, each cell's end is its fill point until the entries are in
+	int start = 0;
+	for (int cell = 0; cell < cellCount; cell++)
+	{
+		int count = m_cellStart[cell];
+		m_cellStart[cell] = (count > 0) ? start : 0;
+		m_cellEnd[cell] = m_cellStart[cell];
+		start += count;
+	}
+
+	m_cellEntries.resize(proxyCount);
+	m_proxyEntry.resize(proxyCount);
+	for (int i = 0; i < proxyCount; i++)
+	{
+		int entry = m_cellEnd[m_proxyCell[i]]++;
+		m_cellEntries[entry] = i;
+		m_proxyEntry[i] = entry;
+	}
+}
+
+// Patch Cells, moves each refreshed proxy that changed cell to its new place in the cell list. Costs the entries it
+// passes on the way rather than the whole list, and the entries end up in the order sortCells would put them in, so
+// the pairs come out the same either way
+void BroadPhase::patchCells()
+{
+	for (int i : m_refreshed)
+	{
+		glm::vec2 centre = wrapPosition((m_proxies[i].min + m_proxies[i].max) * 0.5f);
+		int cell = (getCellRow(centre.y) * m_columns) + getCellColumn(centre.x);
+		if (cell != m_proxyCell[i])
+		{
+			moveEntry(i, cell);
+		}
+	}
+}
+
+// Move Entry, an insertion sort step for one proxy, entries are ordered by cell then by index
+void BroadPhase::moveEntry(int i, int cell)
+{
+	int oldCell = m_proxyCell[i];
+	m_proxyCell[i] = cell;
+
+	int entryCount = m_cellEntries.size();
+	int from = m_proxyEntry[i];
+	int entry = from;
+	while (entry + 1 < entryCount && isEntryBefore(m_cellEntries[entry + 1], i))
+	{
+		m_cellEntries[entry] = m_cellEntries[entry + 1];
+		m_proxyEntry[m_cellEntries[entry]] = entry;
+		entry++;
+	}
+	while (entry > 0 && isEntryBefore(i, m_cellEntries[entry - 1]))
+	{
+		m_cellEntries[entry] = m_cellEntries[entry - 1];
+		m_proxyEntry[m_cellEntries[entry]] = entry;
+		entry--;
+	}
+	m_cellEntries[entry] = i;
+	m_proxyEntry[i] = entry;
+
+	// Only the runs the proxy passed shifted. One entry either side catches the edges of the cell it left, which is
+	// emptied if none of it is left
+	int first = glm::max(glm::min(from, entry) - 1, 0);
+	int last = glm::min(glm::max(from, entry) + 1, entryCount - 1);
+	bool oldCellFound = false;
+	for (int run = first; run <= last; run++)
+	{
+		int runCell = m_proxyCell[m_cellEntries[run]];
+		if (run == 0 || m_proxyCell[m_cellEntries[run - 1]] != runCell)
+		{
+			m_cellStart[runCell] = run;
+		}
+		if (run == entryCount - 1 || m_proxyCell[m_cellEntries[run + 1]] != runCell)
+		{
+			m_cellEnd[runCell] = run + 1;
+		}
+		oldCellFound = oldCellFound || (runCell == oldCell);
+	}
+	if (!oldCellFound)
+	{
+		m_cellStart[oldCell] = 0;
+		m_cellEnd[oldCell] = 0;
+	}
+}
+
+// Find Pairs
+void BroadPhase::findPairs(std::vector<CollisionPair>& pairs)
+{
+	pairs.clear();
+
+	int proxyCount = m_proxies.size();
+	for (int i = 0; i < proxyCount; i++)
+	{
+		const BroadPhaseProxy& proxy1 = m_proxies[i];
+		getNeighbourColumns(m_proxyCell[i] % m_columns, 1, m_neighbourColumns);
+		getNeighbourRows(m_proxyCell[i] / m_columns, 1, m_neighbourRows);
+
+		// Search the 3x3 block of cells around this proxy, taking only higher indices so each pair is found once
+		m_partners.clear();
+		for (int neighbourRow : m_neighbourRows)
+		{
+			for (int neighbourColumn : m_neighbourColumns)
+			{
+				int cell = (neighbourRow * m_columns) + neighbourColumn;
+				for (int entry = m_cellStart[cell]; entry < m_cellEnd[cell]; entry++)
+				{
+					int j = m_cellEntries[entry];
+					if (j <= i)
+					{
+						continue;
+					}
+
+					// Filter first, it only reads the proxies and throws out whole layers before any bounds maths
+					const BroadPhaseProxy& proxy2 = m_proxies[j];
+					if (!(proxy1.dynamic || proxy2.dynamic) || !shouldCollide(proxy1, proxy2) || !overlapsInDomain(proxy1, proxy2))
+					{
+						continue;
+					}
+					m_partners.push_back(j);
+				}
+			}
+		}
+		addPairs(proxy1, m_partners, pairs);
+	}
+
+	// Moving bodies against static colliders, the moving body always comes first
+	for (auto& staticProxy : m_staticProxies)
+	{
+		for (auto& proxy : m_proxies)
+		{
+			if (!proxy.dynamic || !shouldCollide(proxy, staticProxy) || !overlapsInDomain(proxy, staticProxy))
+			{
+				continue;
+			}
+
+			CollisionPair pair = { proxy.actor, staticProxy.actor };
+			pairs.push_back(pair);
+		}
+	}
+}
+
+// Find Pairs, searching from the awake proxies only
+void BroadPhase::findPairs(std::vector<CollisionPair>& pairs, const std::vector<char>& awake)
+{
+	pairs.clear();
+
+	int proxyCount = m_proxies.size();
+	for (int i = 0; i < proxyCount; i++)
+	{
+		if (!awake[i])
+		{
+			continue;
+		}
+
+		const BroadPhaseProxy& proxy1 = m_proxies[i];
+		getNeighbourColumns(m_proxyCell[i] % m_columns, 1, m_neighbourColumns);
+		getNeighbourRows(m_proxyCell[i] / m_columns, 1, m_neighbourRows);
+
+		// Two awake proxies are found from the lower index, an awake one and a sleeping one from the awake side
+		m_partners.clear();
+		for (int neighbourRow : m_neighbourRows)
+		{
+			for (int neighbourColumn : m_neighbourColumns)
+			{
+				int cell = (neighbourRow * m_columns) + neighbourColumn;
+				for (int entry = m_cellStart[cell]; entry < m_cellEnd[cell]; entry++)
+				{
+					int j = m_cellEntries[entry];
+					if (awake[j] && j <= i)
+					{
+						continue;
+					}
+
+					const BroadPhaseProxy& proxy2 = m_proxies[j];
+					if (!(proxy1.dynamic || proxy2.dynamic) || !shouldCollide(proxy1, proxy2) || !overlapsInDomain(proxy1, proxy2))
+					{
+						continue;
+					}
+					m_partners.push_back(j);
+				}
+			}
+		}
+		addPairs(proxy1, m_partners, pairs);
+	}
+
+	// Awake moving bodies against static colliders
+	for (auto& staticProxy : m_staticProxies)
+	{
+		for (int i = 0; i < proxyCount; i++)
+		{
+			const BroadPhaseProxy& proxy = m_proxies[i];
+			if (!awake[i] || !proxy.dynamic || !shouldCollide(proxy, staticProxy) || !overlapsInDomain(proxy, staticProxy))
+			{
+				continue;
+			}
+
+			CollisionPair pair = { proxy.actor, staticProxy.actor };
+			pairs.push_back(pair);
+		}
+	}
+}
+
+// Add Pairs, a proxy's partners in index order. The cells are walked in an order set by where the grid lies, which
+// depends on every body in the scene, so sorting keeps the order contacts are resolved in down to the bodies themselves
+void BroadPhase::addPairs(const BroadPhaseProxy& proxy, std::vector<int>& partners, std::vector<CollisionPair>& pairs) const
+{
+	std::sort(partners.begin(), partners.end());
+	for (int j : partners)
+	{
+		CollisionPair pair = { proxy.actor, m_proxies[j].actor };
+		pairs.push_back(pair);
+	}
+}
\ No newline at end of file
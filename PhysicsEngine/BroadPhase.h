@@ -0,0 +1,142 @@
+#pragma once
+// Include .h files
+#include "PhysicsObject.h"
+
+// Other includes
+#include <vector>
+#include <glm\vec2.hpp>
+#include <glm\glm.hpp>
+
+// Typedefs
+
+//============================================================================================================================================
+// BroadPhaseProxy STRUCT
+
+// Everything the broadphase needs about a body, packed together so filtering and bounds tests never touch the body itself
+struct BroadPhaseProxy
+{
+	unsigned int category;	// Collision category bits
+	unsigned int mask;		// Categories this body collides with
+	int group;				// Collision group, 0 for none
+	bool dynamic;			// False for kinematic bodies
+	glm::vec2 min;			// Bounds min
+	glm::vec2 max;			// Bounds max
+	PhysicsObject* actor;	// The body this proxy stands for
+};
+
+//============================================================================================================================================
+// CollisionPair STRUCT
+
+struct CollisionPair
+{
+	PhysicsObject* first;
+	PhysicsObject* second;
+};
+
+//============================================================================================================================================
+// BroadPhase CLASS
+
+// Uniform grid over the moving bodies, rebuilt every step with a counting sort. When only some proxies are refreshed
+// the grid is kept as long as every body still fits it, and the cell list is patched with an insertion sort instead,
+// so the build costs the bodies rather than the cells. Static colliders that aren't Planes are few and are tested
+// against the proxies directly. With a periodic domain the grid covers exactly the domain, its edge cells neighbour
+// the cells on the opposite edge and bounds are compared through the minimum image
+class BroadPhase
+{
+
+public:
+	BroadPhase();
+
+	// With a refresh list only the proxies flagged in it are made again, the rest are kept from the last build as long
+	// as the actors are the same ones in the same order. The grid is kept too while every body still fits it
+	void build(const std::vector<PhysicsObject*>& actors, const std::vector<PhysicsObject*>& staticActors, const std::vector<char>* refresh = nullptr);
+
+	// Pairs come out by the first body's index then the second's, so the order doesn't depend on where the grid lies
+	void findPairs(std::vector<CollisionPair>& pairs);
+
+	// Only the pairs with at least one awake proxy, for when most of the bodies didn't move this step
+	void findPairs(std::vector<CollisionPair>& pairs, const std::vector<char>& awake);
+
+	static bool shouldCollide(const BroadPhaseProxy& proxy1, const BroadPhaseProxy& proxy2);
+	static bool overlaps(const BroadPhaseProxy& proxy1, const BroadPhaseProxy& proxy2);
+	static bool getActorBounds(PhysicsObject* actor, glm::vec2& min, glm::vec2& max);
+	static BroadPhaseProxy makeProxy(PhysicsObject* actor);
+
+	// Overlap test that goes through the minimum image when the domain is periodic
+	bool overlapsInDomain(const BroadPhaseProxy& proxy1, const BroadPhaseProxy& proxy2) const;
+
+	//============================================================================================================================================
+	// Periodic Domain
+
+	// Bodies leaving one side of the domain come back in the other, the domain should be at least three of the largest
+	// bodies across in both directions
+	void setPeriodicDomain(glm::vec2 min, glm::vec2 max);
+	void clearPeriodicDomain() { m_periodic = false; }
+	bool isPeriodic() const { return m_periodic; }
+	glm::vec2 getDomainMin() const { return m_domainMin; }
+	glm::vec2 getDomainSize() const { return m_domainSize; }
+
+	// Shift to add to a point at 'to' so it becomes the image nearest 'from', 0 when the domain isn't periodic
+	glm::vec2 getImageOffset(glm::vec2 from, glm::vec2 to) const;
+	glm::vec2 wrapPosition(glm::vec2 position) const;
+
+	// Columns (or rows) within reach of the given one, wrapped round the domain and without repeats when periodic
+	void getNeighbourColumns(int column, int reach, std::vector<int>& columns) const;
+	void getNeighbourRows(int row, int reach, std::vector<int>& rows) const;
+
+	//============================================================================================================================================
+	// Getters and Setters
+
+	// Smallest cell size the grid may use, the grid grows it to fit the largest body. 0 sizes to the bodies alone
+	void setMinCellSize(float cellSize) { m_minCellSize = cellSize; }
+	float getMinCellSize() const { return m_minCellSize; }
+
+	const std::vector<BroadPhaseProxy>& getProxies() const { return m_proxies; }
+	const std::vector<BroadPhaseProxy>& getStaticProxies() const { return m_staticProxies; }
+
+	float getCellSize() const { return m_cellSize; }
+	glm::vec2 getGridOrigin() const { return m_gridOrigin; }
+	int getColumns() const { return m_columns; }
+	int getRows() const { return m_rows; }
+
+	// Proxy indices in a cell run from getCellStart(cell) to getCellEnd(cell) in getCellEntries()
+	int getCellStart(int cell) const { return m_cellStart[cell]; }
+	int getCellEnd(int cell) const { return m_cellEnd[cell]; }
+	const std::vector<int>& getCellEntries() const { return m_cellEntries; }
+	int getCellColumn(float x) const;
+	int getCellRow(float y) const;
+
+protected:
+	bool fitsGrid(glm::vec2 min, glm::vec2 max) const;
+	bool refreshProxies(const std::vector<PhysicsObject*>& actors, const std::vector<char>& refresh);
+	void sortCells();
+	void patchCells();
+	void moveEntry(int i, int cell);
+	bool isEntryBefore(int i, int j) const { return (m_proxyCell[i] < m_proxyCell[j]) || (m_proxyCell[i] == m_proxyCell[j] && i < j); }
+	void addPairs(const BroadPhaseProxy& proxy, std::vector<int>& partners, std::vector<CollisionPair>& pairs) const;
+
+	std::vector<BroadPhaseProxy> m_proxies;			// One per moving body, same order as the scene's actors
+	std::vector<BroadPhaseProxy> m_staticProxies;	// One per static collider that isn't a Plane
+
+	std::vector<int> m_proxyCell;		// Cell of each proxy
+	std::vector<int> m_refreshed;		// Proxies remade by the last partial refresh
+	std::vector<int> m_cellStart;		// Start of each cell's run in m_cellEntries
+	std::vector<int> m_cellEnd;			// One past the end of each cell's run, empty cells start and end at 0
+	std::vector<int> m_cellEntries;		// Proxy indices sorted by cell, then by index
+	std::vector<int> m_proxyEntry;		// Where each proxy sits in m_cellEntries
+
+	// Scratch for findPairs, kept so a step doesn't allocate once they've grown
+	std::vector<int> m_neighbourColumns;
+	std::vector<int> m_neighbourRows;
+	std::vector<int> m_partners;
+
+	glm::vec2 m_gridOrigin;
+	float m_cellSize;
+	float m_minCellSize;
+	int m_columns;
+	int m_rows;
+
+	bool m_periodic;
+	glm::vec2 m_domainMin;
+	glm::vec2 m_domainSize;
+};
\ No newline at end of file
@@ -0,0 +1,474 @@
+// Include .h files
+#include "ConstraintSolver.h"
+#include "RigidBody.h"
+
+// Other includes
+#include <Gizmos.h>
+#include <cmath>
+#include <glm\ext.hpp>
+
+// Typedefs
+
+// Colours tracked per body while colouring, constraints that can't fit in one go into a last colour solved serially
+static const int MAX_CONSTRAINT_COLORS = 64;
+
+// Constraints in a colour smaller than this aren't worth waking the other threads for
+static const int MIN_PARALLEL_BATCH = 256;
+
+//============================================================================================================================================
+// Constructors
+
+// Constructor
+ConstraintSolver::ConstraintSolver()
+{
+	m_iterations = 8;
+	m_color = glm::vec4(1, 1, 1, 1);
+	m_colorsDirty = false;
+	m_colorStart.push_back(0);
+}
+
+//============================================================================================================================================
+// Constraint Functions
+
+// Add Distance Constraint, a negative rest length takes the distance the bodies are apart now
+void ConstraintSolver::addDistanceConstraint(Rigidbody* body1, Rigidbody* body2, float compliance, float restLength)
+{
+	if (restLength < 0.0f)
+	{
+		restLength = glm::length(body2->getPosition() - body1->getPosition());
+	}
+	addConstraint(DISTANCE_CONSTRAINT, addBody(body1), addBody(body2), -1, restLength, compliance);
+}
+
+// Add Bending Constraint, holds the angle at body2 between body1 and body3 to what it is now
+void ConstraintSolver::addBendingConstraint(Rigidbody* body1, Rigidbody* body2, Rigidbody* body3, float compliance)
+{
+	glm::vec2 edge1 = body1->getPosition() - body2->getPosition();
+	glm::vec2 edge2 = body3->getPosition() - body2->getPosition();
+	float restAngle = std::atan2((edge1.x * edge2.y) - (edge1.y * edge2.x), glm::dot(edge1, edge2));
+	addConstraint(BENDING_CONSTRAINT, addBody(body1), addBody(body2), addBody(body3), restAngle, compliance);
+}
+
+// Add Area Constraint, holds the signed area of the triangle to what it is now
+void ConstraintSolver::addAreaConstraint(Rigidbody* body1, Rigidbody* body2, Rigidbody* body3, float compliance)
+{
+	glm::vec2 edge1 = body2->getPosition() - body1->getPosition();
+	glm::vec2 edge2 = body3->getPosition() - body1->getPosition();
+	float restArea = 0.5f * ((edge1.x * edge2.y) - (edge1.y * edge2.x));
+	addConstraint(AREA_CONSTRAINT, addBody(body1), addBody(body2), addBody(body3), restArea, compliance);
+}
+
+// Add Body, returns the body's index in the flat arrays
+int ConstraintSolver::addBody(Rigidbody* body)
+{
+	auto found = m_bodyIndices.find(body);
+	if (found != m_bodyIndices.end())
+	{
+		return found->second;
+	}
+
+	int index = m_bodies.size();
+	m_bodies.push_back(body);
+	m_bodyIndices[body] = index;
+	return index;
+}
+
+// Add Constraint
+void ConstraintSolver::addConstraint(ConstraintType type, int body1, int body2, int body3, float restValue, float compliance)
+{
+	m_type.push_back(type);
+	m_body1.push_back(body1);
+	m_body2.push_back(body2);
+	m_body3.push_back(body3);
+	m_restValue.push_back(restValue);
+	m_compliance.push_back(compliance);
+	m_lambda.push_back(0.0f);
+	m_colorsDirty = true;
+}
+
+// Remove Body, drops every constraint that uses it. Call this before deleting a constrained body
+void ConstraintSolver::removeBody(PhysicsObject* body)
+{
+	// Planes are never constrained
+	if (body->getShapeID() == PLANE)
+	{
+		return;
+	}
+
+	auto found = m_bodyIndices.find(static_cast<Rigidbody*>(body));
+	if (found == m_bodyIndices.end())
+	{
+		return;
+	}
+	int removed = found->second;
+
+	// Keep the constraints that don't touch it
+	int kept = 0;
+	int constraintCount = getConstraintCount();
+	for (int i = 0; i < constraintCount; i++)
+	{
+		if (m_body1[i] == removed || m_body2[i] == removed || m_body3[i] == removed)
+		{
+			continue;
+		}
+		m_type[kept] = m_type[i];
+		m_body1[kept] = m_body1[i];
+		m_body2[kept] = m_body2[i];
+		m_body3[kept] = m_body3[i];
+		m_restValue[kept] = m_restValue[i];
+		m_compliance[kept] = m_compliance[i];
+		kept++;
+	}
+	m_type.resize(kept);
+	m_body1.resize(kept);
+	m_body2.resize(kept);
+	m_body3.resize(kept);
+	m_restValue.resize(kept);
+	m_compliance.resize(kept);
+	m_lambda.assign(kept, 0.0f);
+
+	// Move the last body into the gap so the indices stay dense
+	int last = m_bodies.size() - 1;
+	m_bodyIndices.erase(found);
+	if (removed != last)
+	{
+		m_bodies[removed] = m_bodies[last];
+		m_bodyIndices[m_bodies[removed]] = removed;
+		for (int i = 0; i < kept; i++)
+		{
+			m_body1[i] = (m_body1[i] == last) ? removed : m_body1[i];
+			m_body2[i] = (m_body2[i] == last) ? removed : m_body2[i];
+			m_body3[i] = (m_body3[i] == last) ? removed : m_body3[i];
+		}
+	}
+	m_bodies.pop_back();
+	m_colorsDirty = true;
+}
+
+// Clear Constraints
+void ConstraintSolver::clearConstraints()
+{
+	m_bodies.clear();
+	m_bodyIndices.clear();
+	m_type.clear();
+	m_body1.clear();
+	m_body2.clear();
+	m_body3.clear();
+	m_restValue.clear();
+	m_compliance.clear();
+	m_lambda.clear();
+	m_colorStart.assign(1, 0);
+	m_colorsDirty = false;
+}
+
+// Color Constraints, greedy graph colouring then a counting sort of every array by colour
+void ConstraintSolver::colorConstraints()
+{
+	if (!m_colorsDirty)
+	{
+		return;
+	}
+	m_colorsDirty = false;
+
+	int constraintCount = getConstraintCount();
+	std::vector<unsigned long long> bodyColors(m_bodies.size(), 0);
+	std::vector<int> constraintColor(constraintCount);
+	std::vector<int> colorCount(MAX_CONSTRAINT_COLORS + 1, 0);
+	int usedColors = 0;
+
+	for (int i = 0; i < constraintCount; i++)
+	{
+		// Lowest colour none of the constraint's bodies have yet
+		unsigned long long taken = bodyColors[m_body1[i]] | bodyColors[m_body2[i]];
+		if (m_body3[i] >= 0)
+		{
+			taken |= bodyColors[m_body3[i]];
+		}
+
+		int color = 0;
+		while (color < MAX_CONSTRAINT_COLORS && (taken & (1ULL << color)))
+		{
+			color++;
+		}
+
+		if (color < MAX_CONSTRAINT_COLORS)
+		{
+			bodyColors[m_body1[i]] |= 1ULL << color;
+			bodyColors[m_body2[i]] |= 1ULL << color;
+			if (m_body3[i] >= 0)
+			{
+				bodyColors[m_body3[i]] |= 1ULL << color;
+			}
+		}
+		constraintColor[i] = color;
+		colorCount[color]++;
+		usedColors = glm::max(usedColors, color + 1);
+	}
+
+	// Prefix sum into colour starts
+	m_colorStart.assign(usedColors + 1, 0);
+	for (int color = 0; color < usedColors; color++)
+	{
+		m_colorStart[color + 1] = m_colorStart[color] + colorCount[color];
+	}
+
+	// Scatter every array into colour order
+	std::vector<int> order(constraintCount);
+	std::vector<int> next(m_colorStart.begin(), m_colorStart.end() - 1);
+	for (int i = 0; i < constraintCount; i++)
+	{
+		order[next[constraintColor[i]]++] = i;
+	}
+
+	std::vector<ConstraintType> type(constraintCount);
+	std::vector<int> body1(constraintCount);
+	std::vector<int> body2(constraintCount);
+	std::vector<int> body3(constraintCount);
+	std::vector<float> restValue(constraintCount);
+	std::vector<float> compliance(constraintCount);
+	for (int i = 0; i < constraintCount; i++)
+	{
+		int source = order[i];
+		type[i] = m_type[source];
+		body1[i] = m_body1[source];
+		body2[i] = m_body2[source];
+		body3[i] = m_body3[source];
+		restValue[i] = m_restValue[source];
+		compliance[i] = m_compliance[source];
+	}
+	m_type.swap(type);
+	m_body1.swap(body1);
+	m_body2.swap(body2);
+	m_body3.swap(body3);
+	m_restValue.swap(restValue);
+	m_compliance.swap(compliance);
+}
+
+//============================================================================================================================================
+// Solver Functions
+
+// Begin Step, remembers where the bodies were before the scene integrates them
+void ConstraintSolver::beginStep()
+{
+	int bodyCount = m_bodies.size();
+	m_previousX.resize(bodyCount);
+	m_previousY.resize(bodyCount);
+	for (int i = 0; i < bodyCount; i++)
+	{
+		glm::vec2 position = m_bodies[i]->getPosition();
+		m_previousX[i] = position.x;
+		m_previousY[i] = position.y;
+	}
+}
+
+// Solve, projects the integrated positions onto the constraints then derives the velocities from the correction
+void ConstraintSolver::solve(float timeStep)
+{
+	if (m_type.empty() || timeStep <= 0.0f)
+	{
+		return;
+	}
+	colorConstraints();
+
+	// Gather the predicted positions, static and kinematic bodies have no inverse mass and act as pins
+	int bodyCount = m_bodies.size();
+	m_positionX.resize(bodyCount);
+	m_positionY.resize(bodyCount);
+	m_inverseMass.resize(bodyCount);
+	for (int i = 0; i < bodyCount; i++)
+	{
+		glm::vec2 position = m_bodies[i]->getPosition();
+		m_positionX[i] = position.x;
+		m_positionY[i] = position.y;
+		m_inverseMass[i] = m_bodies[i]->getInverseMass();
+	}
+
+	m_lambda.assign(m_type.size(), 0.0f);
+	float inverseTimeStepSquared = 1.0f / (timeStep * timeStep);
+	int colorCount = m_colorStart.size() - 1;
+
+	for (int iteration = 0; iteration < m_iterations; iteration++)
+	{
+		for (int color = 0; color < colorCount; color++)
+		{
+			int first = m_colorStart[color];
+			int last = m_colorStart[color + 1];
+			// The overflow colour can share bodies, it has to run in order
+#pragma omp parallel for if((color < MAX_CONSTRAINT_COLORS) && ((last - first) >= MIN_PARALLEL_BATCH))
+			for (int i = first; i < last; i++)
+			{
+				float alpha = m_compliance[i] * inverseTimeStepSquared;
+				switch (m_type[i])
+				{
+				case DISTANCE_CONSTRAINT:
+					solveDistance(i, alpha);
+					break;
+				case BENDING_CONSTRAINT:
+					solveBending(i, alpha);
+					break;
+				case AREA_CONSTRAINT:
+					solveArea(i, alpha);
+					break;
+				}
+			}
+		}
+	}
+
+	// Hand the corrected positions back, velocity is whatever the body actually moved this step
+	float inverseTimeStep = 1.0f / timeStep;
+	for (int i = 0; i < bodyCount; i++)
+	{
+		if (m_inverseMass[i] > 0.0f)
+		{
+			glm::vec2 position(m_positionX[i], m_positionY[i]);
+			m_bodies[i]->setPosition(position);
+			m_bodies[i]->setVelocity((position - glm::vec2(m_previousX[i], m_previousY[i])) * inverseTimeStep);
+		}
+	}
+}
+
+// Solve Distance, C = |x1 - x2| - rest
+void ConstraintSolver::solveDistance(int constraint, float alpha)
+{
+	int body1 = m_body1[constraint];
+	int body2 = m_body2[constraint];
+	float weight1 = m_inverseMass[body1];
+	float weight2 = m_inverseMass[body2];
+
+	float deltaX = m_positionX[body1] - m_positionX[body2];
+	float deltaY = m_positionY[body1] - m_positionY[body2];
+	float distance = std::sqrt((deltaX * deltaX) + (deltaY * deltaY));
+	float denominator = weight1 + weight2 + alpha;
+	if (distance <= 0.0f || denominator <= 0.0f)
+	{
+		return;
+	}
+
+	// The gradient is the unit direction between the bodies, so its squared length is 1 for both
+	float error = distance - m_restValue[constraint];
+	float deltaLambda = (-error - (alpha * m_lambda[constraint])) / denominator;
+	m_lambda[constraint] += deltaLambda;
+
+	float normalX = deltaX / distance;
+	float normalY = deltaY / distance;
+	m_positionX[body1] += weight1 * deltaLambda * normalX;
+	m_positionY[body1] += weight1 * deltaLambda * normalY;
+	m_positionX[body2] -= weight2 * deltaLambda * normalX;
+	m_positionY[body2] -= weight2 * deltaLambda * normalY;
+}
+
+// Solve Bending, C = angle(x1 - x2, x3 - x2) - rest
+void ConstraintSolver::solveBending(int constraint, float alpha)
+{
+	int body1 = m_body1[constraint];
+	int body2 = m_body2[constraint];
+	int body3 = m_body3[constraint];
+	float weight1 = m_inverseMass[body1];
+	float weight2 = m_inverseMass[body2];
+	float weight3 = m_inverseMass[body3];
+
+	float edge1X = m_positionX[body1] - m_positionX[body2];
+	float edge1Y = m_positionY[body1] - m_positionY[body2];
+	float edge2X = m_positionX[body3] - m_positionX[body2];
+	float edge2Y = m_positionY[body3] - m_positionY[body2];
+	float lengthSquared1 = (edge1X * edge1X) + (edge1Y * edge1Y);
+	float lengthSquared2 = (edge2X * edge2X) + (edge2Y * edge2Y);
+	if (lengthSquared1 <= 0.0f || lengthSquared2 <= 0.0f)
+	{
+		return;
+	}
+
+	// Wrap the error into -pi..pi so the constraint always turns the short way round
+	float angle = std::atan2((edge1X * edge2Y) - (edge1Y * edge2X), (edge1X * edge2X) + (edge1Y * edge2Y));
+	float error = angle - m_restValue[constraint];
+	error -= glm::two_pi<float>() * std::floor((error + glm::pi<float>()) / glm::two_pi<float>());
+
+	// The angle of an edge turns along its perpendicular, faster the shorter the edge
+	float gradient1X = edge1Y / lengthSquared1;
+	float gradient1Y = -edge1X / lengthSquared1;
+	float gradient3X = -edge2Y / lengthSquared2;
+	float gradient3Y = edge2X / lengthSquared2;
+	float gradient2X = -(gradient1X + gradient3X);
+	float gradient2Y = -(gradient1Y + gradient3Y);
+
+	float denominator = (weight1 * ((gradient1X * gradient1X) + (gradient1Y * gradient1Y))) +
+						(weight2 * ((gradient2X * gradient2X) + (gradient2Y * gradient2Y))) +
+						(weight3 * ((gradient3X * gradient3X) + (gradient3Y * gradient3Y))) + alpha;
+	if (denominator <= 0.0f)
+	{
+		return;
+	}
+
+	float deltaLambda = (-error - (alpha * m_lambda[constraint])) / denominator;
+	m_lambda[constraint] += deltaLambda;
+
+	m_positionX[body1] += weight1 * deltaLambda * gradient1X;
+	m_positionY[body1] += weight1 * deltaLambda * gradient1Y;
+	m_positionX[body2] += weight2 * deltaLambda * gradient2X;
+	m_positionY[body2] += weight2 * deltaLambda * gradient2Y;
+	m_positionX[body3] += weight3 * deltaLambda * gradient3X;
+	m_positionY[body3] += weight3 * deltaLambda * gradient3Y;
+}
+
+// Solve Area, C = signed area(x1, x2, x3) - rest
+void ConstraintSolver::solveArea(int constraint, float alpha)
+{
+	int body1 = m_body1[constraint];
+	int body2 = m_body2[constraint];
+	int body3 = m_body3[constraint];
+	float weight1 = m_inverseMass[body1];
+	float weight2 = m_inverseMass[body2];
+	float weight3 = m_inverseMass[body3];
+
+	float x1 = m_positionX[body1];
+	float y1 = m_positionY[body1];
+	float x2 = m_positionX[body2];
+	float y2 = m_positionY[body2];
+	float x3 = m_positionX[body3];
+	float y3 = m_positionY[body3];
+
+	float area = 0.5f * (((x2 - x1) * (y3 - y1)) - ((y2 - y1) * (x3 - x1)));
+	float error = area - m_restValue[constraint];
+
+	// Each corner moves along the perpendicular of the opposite edge
+	float gradient1X = 0.5f * (y2 - y3);
+	float gradient1Y = 0.5f * (x3 - x2);
+	float gradient2X = 0.5f * (y3 - y1);
+	float gradient2Y = 0.5f * (x1 - x3);
+	float gradient3X = 0.5f * (y1 - y2);
+	float gradient3Y = 0.5f * (x2 - x1);
+
+	float denominator = (weight1 * ((gradient1X * gradient1X) + (gradient1Y * gradient1Y))) +
+						(weight2 * ((gradient2X * gradient2X) + (gradient2Y * gradient2Y))) +
+						(weight3 * ((gradient3X * gradient3X) + (gradient3Y * gradient3Y))) + alpha;
+	if (denominator <= 0.0f)
+	{
+		return;
+	}
+
+	float deltaLambda = (-error - (alpha * m_lambda[constraint])) / denominator;
+	m_lambda[constraint] += deltaLambda;
+
+	m_positionX[body1] += weight1 * deltaLambda * gradient1X;
+	m_positionY[body1] += weight1 * deltaLambda * gradient1Y;
+	m_positionX[body2] += weight2 * deltaLambda * gradient2X;
+	m_positionY[body2] += weight2 * deltaLambda * gradient2Y;
+	m_positionX[body3] += weight3 * deltaLambda * gradient3X;
+	m_positionY[body3] += weight3 * deltaLambda * gradient3Y;
+}
+
+//============================================================================================================================================
+// Misc
+
+// Make Gizmo, draws the distance constraints as lines
+void ConstraintSolver::makeGizmo()
+{
+	int constraintCount = getConstraintCount();
+	for (int i = 0; i < constraintCount; i++)
+	{
+		if (m_type[i] == DISTANCE_CONSTRAINT)
+		{
+			aie::Gizmos::add2DLine(m_bodies[m_body1[i]]->getPosition(), m_bodies[m_body2[i]]->getPosition(), m_color);
+		}
+	}
+}
\ No newline at end of file
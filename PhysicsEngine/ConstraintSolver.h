@@ -0,0 +1,93 @@
+#pragma once
+// Include .h files
+#include "PhysicsObject.h"
+
+// Other includes
+#include <vector>
+#include <unordered_map>
+#include <glm\vec2.hpp>
+#include <glm\glm.hpp>
+
+// Typedefs
+
+//============================================================================================================================================
+// ConstraintType ENUM
+
+enum ConstraintType
+{
+	DISTANCE_CONSTRAINT,	// Keeps two bodies a set distance apart, ropes, chains and cloth edges
+	BENDING_CONSTRAINT,		// Keeps the angle at the middle of three bodies, stiffens ropes and cloth
+	AREA_CONSTRAINT			// Keeps the signed area of a triangle of bodies, soft bodies
+};
+
+//============================================================================================================================================
+// ConstraintSolver CLASS
+
+// Extended position-based dynamics. Bodies are integrated as normal, then their new positions are projected onto the
+// constraints and their velocities worked back out from how far they actually moved, so constraints can't store energy
+// and blow up the way stiff springs do. Compliance is the inverse of stiffness, 0 is perfectly rigid and it doesn't
+// depend on the time step or iteration count. Constraints live in flat arrays sorted by graph colour; no two
+// constraints in a colour share a body, so each colour is solved as one parallel batch
+class ConstraintSolver
+{
+
+public:
+	ConstraintSolver();
+
+	void addDistanceConstraint(Rigidbody* body1, Rigidbody* body2, float compliance = 0.0f, float restLength = -1.0f);
+	void addBendingConstraint(Rigidbody* body1, Rigidbody* body2, Rigidbody* body3, float compliance = 0.0f);
+	void addAreaConstraint(Rigidbody* body1, Rigidbody* body2, Rigidbody* body3, float compliance = 0.0f);
+	void removeBody(PhysicsObject* body);
+	bool hasBody(Rigidbody* body) const { return m_bodyIndices.count(body) != 0; }
+	void clearConstraints();
+
+	void beginStep();
+	void solve(float timeStep);
+	void makeGizmo();
+
+	//============================================================================================================================================
+	// Getters and Setters
+
+	void setIterations(int iterations) { m_iterations = iterations; }
+	int getIterations() const { return m_iterations; }
+	void setColor(glm::vec4 color) { m_color = color; }
+
+	int getConstraintCount() const { return m_type.size(); }
+	int getColorCount() { colorConstraints(); return m_colorStart.size() - 1; }
+
+protected:
+	int addBody(Rigidbody* body);
+	void addConstraint(ConstraintType type, int body1, int body2, int body3, float restValue, float compliance);
+	void colorConstraints();
+
+	void solveDistance(int constraint, float alpha);
+	void solveBending(int constraint, float alpha);
+	void solveArea(int constraint, float alpha);
+
+	int m_iterations;
+	glm::vec4 m_color;
+	bool m_colorsDirty;		// Set when constraints are added or removed, the colouring is redone before the next solve
+
+	//============================================================================================================================================
+	// Bodies
+
+	std::vector<Rigidbody*> m_bodies;
+	std::unordered_map<Rigidbody*, int> m_bodyIndices;
+	std::vector<float> m_positionX;
+	std::vector<float> m_positionY;
+	std::vector<float> m_previousX;		// Positions before this step's integration
+	std::vector<float> m_previousY;
+	std::vector<float> m_inverseMass;
+
+	//============================================================================================================================================
+	// Constraints, one entry per constraint in every array
+
+	std::vector<ConstraintType> m_type;
+	std::vector<int> m_body1;
+	std::vector<int> m_body2;
+	std::vector<int> m_body3;			// -1 for distance constraints
+	std::vector<float> m_restValue;		// Length, angle or area
+	std::vector<float> m_compliance;
+	std::vector<float> m_lambda;		// Accumulated multiplier, reset every step
+	std::vector<int> m_colorStart;		// Start of each colour's constraints, one extra entry at the end
+};
\ No newline at end of file
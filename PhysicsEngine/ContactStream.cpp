@@ -0,0 +1,269 @@
+// Include .h files
+#include "ContactStream.h"
+#include "LodScheduler.h"
+
+// Other includes
+#include <algorithm>
+#include <utility>
+
+// Typedefs
+
+// Slots a set starts with, always a power of two
+static const int MIN_PAIR_SLOTS = 64;
+
+//============================================================================================================================================
+// Constructors
+
+// Constructor
+ContactStream::ContactStream()
+{
+	m_current = &m_sets[0];
+	m_previous = &m_sets[1];
+	for (auto& set : m_sets)
+	{
+		set.stamp = 1;
+		set.slots.assign(MIN_PAIR_SLOTS, PairSlot{ 0, 0, 0 });
+	}
+	m_nextBodyId = 0;
+	m_eventTypes = (1 << CONTACT_BEGIN) | (1 << CONTACT_END);
+	m_categoryFilter = 0xFFFFFFFF;
+	m_staticContacts = true;
+}
+
+//============================================================================================================================================
+// Contacts
+
+// Add Contact
+void ContactStream::addContact(PhysicsObject* object1, PhysicsObject* object2)
+{
+	bool staticPair = object1->isStatic() || object2->isStatic();
+	if ((staticPair && !m_staticContacts) ||
+		((object1->getCollisionCategory() | object2->getCollisionCategory()) & m_categoryFilter) == 0)
+	{
+		return;
+	}
+
+	// The moving body comes first against a static collider, otherwise the lower id so a pair has one key
+	unsigned int id1 = getBodyId(object1);
+	unsigned int id2 = getBodyId(object2);
+	bool swap = staticPair ? object1->isStatic() : (id2 < id1);
+	TrackedPair pair;
+	pair.first = swap ? object2 : object1;
+	pair.second = swap ? object1 : object2;
+	pair.firstId = swap ? id2 : id1;
+	pair.secondId = swap ? id1 : id2;
+	insert(*m_current, pair);
+}
+
+// End Step
+void ContactStream::endStep(int step, const LodScheduler* lodScheduler)
+{
+	// Pairs a removed body was in end with the step after it went
+	for (auto& pair : m_removedPairs)
+	{
+		addEvent(pair, CONTACT_END, step);
+	}
+	m_removedPairs.clear();
+
+	// Touching now: new unless it was touching last step too
+	if (m_eventTypes & ((1 << CONTACT_BEGIN) | (1 << CONTACT_PERSIST)))
+	{
+		for (auto& pair : m_current->pairs)
+		{
+			addEvent(pair, contains(*m_previous, pair.firstId, pair.secondId) ? CONTACT_PERSIST : CONTACT_BEGIN, step);
+		}
+	}
+
+	// Touching last step and not now. On a LOD step a pair neither of whose bodies was due was never tested, it carries
+	// over still touching
+	if ((m_eventTypes & (1 << CONTACT_END)) || lodScheduler != nullptr)
+	{
+		for (auto& pair : m_previous->pairs)
+		{
+			if (contains(*m_current, pair.firstId, pair.secondId))
+			{
+				continue;
+			}
+			if (lodScheduler != nullptr && !lodScheduler->isAwake(pair.first) && !lodScheduler->isAwake(pair.second))
+			{
+				insert(*m_current, pair);
+				addEvent(pair, CONTACT_PERSIST, step);
+			}
+			else
+			{
+				addEvent(pair, CONTACT_END, step);
+			}
+		}
+	}
+
+	// This step becomes the one before, and the old one is emptied for the next step
+	std::swap(m_current, m_previous);
+	clearSet(*m_current);
+}
+
+// Remove Bodies
+void ContactStream::removeBodies(const std::vector<PhysicsObject*>& bodies)
+{
+	// Only bodies that have touched something have an id
+	std::vector<unsigned int> removedIds;
+	for (auto body : bodies)
+	{
+		auto found = m_bodyIds.find(body);
+		if (found != m_bodyIds.end())
+		{
+			removedIds.push_back(found->second);
+			m_bodyIds.erase(found);
+		}
+	}
+	if (removedIds.empty())
+	{
+		return;
+	}
+
+	std::sort(removedIds.begin(), removedIds.end());
+	removePairs(*m_previous, removedIds, true);
+	removePairs(*m_current, removedIds, false);
+}
+
+// Reset
+void ContactStream::reset()
+{
+	clearSet(m_sets[0]);
+	clearSet(m_sets[1]);
+	m_removedPairs.clear();
+}
+
+// Get Body Id, handing out the next one to a body seen for the first time
+unsigned int ContactStream::getBodyId(PhysicsObject* body)
+{
+	auto found = m_bodyIds.find(body);
+	if (found != m_bodyIds.end())
+	{
+		return found->second;
+	}
+	m_bodyIds[body] = m_nextBodyId;
+	return m_nextBodyId++;
+}
+
+// Remove Pairs, puts back every pair without a removed body in it, keeping the ones with one to end if asked
+void ContactStream::removePairs(PairSet& set, const std::vector<unsigned int>& removedIds, bool endPairs)
+{
+	std::vector<TrackedPair> pairs;
+	pairs.swap(set.pairs);
+	clearSet(set);
+	for (auto& pair : pairs)
+	{
+		if (std::binary_search(removedIds.begin(), removedIds.end(), pair.firstId) ||
+			std::binary_search(removedIds.begin(), removedIds.end(), pair.secondId))
+		{
+			if (endPairs)
+			{
+				m_removedPairs.push_back(pair);
+			}
+			continue;
+		}
+		insert(set, pair);
+	}
+}
+
+// Add Event
+void ContactStream::addEvent(const TrackedPair& pair, ContactEventType type, int step)
+{
+	if (m_eventTypes & (1 << type))
+	{
+		ContactEvent event;
+		event.first = pair.first;
+		event.second = pair.second;
+		event.firstId = pair.firstId;
+		event.secondId = pair.secondId;
+		event.type = type;
+		event.step = step;
+		m_events.push_back(event);
+	}
+}
+
+//============================================================================================================================================
+// Pair Sets
+
+// Hash Pair, both ids mixed so pairs sharing a body still spread out
+unsigned int ContactStream::hashPair(unsigned int first, unsigned int second)
+{
+	unsigned long long hash = (unsigned long long)first * 0x9E3779B97F4A7C15ull;
+	hash ^= (unsigned long long)second + 0x632BE59BD9B4E019ull + (hash << 6) + (hash >> 2);
+	hash ^= hash >> 31;
+	hash *= 0xBF58476D1CE4E5B9ull;
+	return (unsigned int)(hash >> 32);
+}
+
+// Contains
+bool ContactStream::contains(const PairSet& set, unsigned int first, unsigned int second)
+{
+	unsigned int mask = set.slots.size() - 1;
+	for (unsigned int slot = hashPair(first, second) & mask; set.slots[slot].stamp == set.stamp; slot = (slot + 1) & mask)
+	{
+		if (set.slots[slot].first == first && set.slots[slot].second == second)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+// Insert, returns false if the pair is already in the set
+bool ContactStream::insert(PairSet& set, const TrackedPair& pair)
+{
+	// Kept under half full so probes stay short
+	if ((set.pairs.size() + 1) * 2 > set.slots.size())
+	{
+		grow(set);
+	}
+
+	unsigned int mask = set.slots.size() - 1;
+	unsigned int slot = hashPair(pair.firstId, pair.secondId) & mask;
+	for (; set.slots[slot].stamp == set.stamp; slot = (slot + 1) & mask)
+	{
+		if (set.slots[slot].first == pair.firstId && set.slots[slot].second == pair.secondId)
+		{
+			return false;
+		}
+	}
+
+	set.slots[slot].first = pair.firstId;
+	set.slots[slot].second = pair.secondId;
+	set.slots[slot].stamp = set.stamp;
+	set.pairs.push_back(pair);
+	return true;
+}
+
+// Grow, doubles the slots and puts the pairs back in
+void ContactStream::grow(PairSet& set)
+{
+	set.slots.assign(set.slots.size() * 2, PairSlot{ 0, 0, 0 });
+	set.stamp = 1;
+	unsigned int mask = set.slots.size() - 1;
+	for (auto& pair : set.pairs)
+	{
+		unsigned int slot = hashPair(pair.firstId, pair.secondId) & mask;
+		while (set.slots[slot].stamp == set.stamp)
+		{
+			slot = (slot + 1) & mask;
+		}
+		set.slots[slot].first = pair.firstId;
+		set.slots[slot].second = pair.secondId;
+		set.slots[slot].stamp = set.stamp;
+	}
+}
+
+// Clear Set, every slot from an older stamp counts as empty
+void ContactStream::clearSet(PairSet& set)
+{
+	set.pairs.clear();
+	set.stamp++;
+
+	// Once in four billion clears the stamp comes round again, when old slots could look current
+	if (set.stamp == 0)
+	{
+		set.slots.assign(set.slots.size(), PairSlot{ 0, 0, 0 });
+		set.stamp = 1;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,140 @@
+#pragma once
+// Include .h files
+#include "BroadPhase.h"
+
+// Other includes
+#include <vector>
+#include <unordered_map>
+#include <glm\vec2.hpp>
+#include <glm\glm.hpp>
+
+// Typedefs
+
+//============================================================================================================================================
+// ContactEventType ENUM
+
+enum ContactEventType
+{
+	CONTACT_BEGIN,		// The pair touched this step and didn't the step before
+	CONTACT_PERSIST,	// The pair touched this step and the step before
+	CONTACT_END,		// The pair touched the step before and doesn't any more
+	CONTACT_EVENT_TYPE_COUNT
+};
+
+//============================================================================================================================================
+// ContactEvent STRUCT
+
+struct ContactEvent
+{
+	PhysicsObject* first;	// The moving body for contacts with static colliders
+	PhysicsObject* second;
+	unsigned int firstId;	// The stream's ids for the two bodies, see ContactStream
+	unsigned int secondId;
+	ContactEventType type;
+	int step;				// The scene step it happened in
+};
+
+//============================================================================================================================================
+// ContactStream CLASS
+
+// Turns the pairs the narrowphase found touching into begin, persist and end events. Each body gets an id the first time
+// it touches anything, kept until the scene removes it, so a new body at a deleted one's address is a different body.
+// Each step's contacts go into an open addressing hash set with linear probing, keyed by the pair's two ids: the moving
+// body first against a static collider, the lower id first otherwise. The set from the step before is kept alongside, so
+// a contact is a begin or a persist depending on whether it was there, and anything there that isn't now is an end. Two
+// sets swapped each step means nothing is ever deleted from one during a step, and a set is cleared in O(1) by moving
+// its stamp on. Events go into one flat buffer in the order they happened, for gameplay code to walk once after
+// PhysicsScene::update; there are no callbacks. Pairs outside the category filter, and static contacts when they're
+// turned off, are never tracked; event types that are turned off are tracked but not written. Grains in granular mode
+// don't report contacts. With LOD scheduling a pair is only tested on steps where one of its bodies is due, on the other
+// steps it carries over as it was. A removed body's pairs end on the next step, with an address that mustn't be followed
+// if the body has been deleted since
+class ContactStream
+{
+
+public:
+	ContactStream();
+
+	// Called by the scene for every pair the narrowphase finds touching, duplicates within a step are dropped
+	void addContact(PhysicsObject* object1, PhysicsObject* object2);
+
+	// Works out the events for the step once every contact is in, then gets ready for the next one. Pass the scheduler on
+	// LOD steps so pairs that weren't tested carry over
+	void endStep(int step, const class LodScheduler* lodScheduler = nullptr);
+
+	// Called by the scene for bodies leaving it, their pairs end on the next step and their ids are never used again
+	void removeBodies(const std::vector<PhysicsObject*>& bodies);
+
+	// Forgets every contact without ending them, for when the scene jumps (see PhysicsScene::rewind)
+	void reset();
+
+	// Events since the last clear, the scene clears them at the start of each update
+	const std::vector<ContactEvent>& getEvents() const { return m_events; }
+	void clearEvents() { m_events.clear(); }
+
+	int getContactCount() const { return m_current->pairs.size(); }	// Pairs touching in the step being built
+	int getTrackedCount() const { return m_previous->pairs.size(); }	// Pairs touching as of the last step
+
+	//============================================================================================================================================
+	// Filtering
+
+	// Which event types are written, a bit per ContactEventType. Begin and end by default, persist is most of the traffic
+	void setEventTypes(int eventTypes) { m_eventTypes = eventTypes; }
+	int getEventTypes() const { return m_eventTypes; }
+
+	// Only pairs where either body's collision category is in the filter are tracked, all of them by default
+	void setCategoryFilter(unsigned int categories) { m_categoryFilter = categories; }
+	unsigned int getCategoryFilter() const { return m_categoryFilter; }
+
+	// Whether contacts against static colliders are tracked, on by default
+	void setStaticContacts(bool staticContacts) { m_staticContacts = staticContacts; }
+	bool getStaticContacts() const { return m_staticContacts; }
+
+protected:
+	struct PairSlot
+	{
+		unsigned int first;
+		unsigned int second;
+		unsigned int stamp;		// The slot is in use only if this matches the set's stamp
+	};
+
+	// A touching pair, the ids it's keyed by and the bodies for the events
+	struct TrackedPair
+	{
+		PhysicsObject* first;
+		PhysicsObject* second;
+		unsigned int firstId;
+		unsigned int secondId;
+	};
+
+	// One step's contacts, the slots for lookups and a dense list to walk
+	struct PairSet
+	{
+		std::vector<PairSlot> slots;
+		std::vector<TrackedPair> pairs;
+		unsigned int stamp;
+	};
+
+	unsigned int getBodyId(PhysicsObject* body);
+	void removePairs(PairSet& set, const std::vector<unsigned int>& removedIds, bool endPairs);
+
+	static unsigned int hashPair(unsigned int first, unsigned int second);
+	static bool contains(const PairSet& set, unsigned int first, unsigned int second);
+	static bool insert(PairSet& set, const TrackedPair& pair);
+	static void grow(PairSet& set);
+	static void clearSet(PairSet& set);
+	void addEvent(const TrackedPair& pair, ContactEventType type, int step);
+
+	PairSet m_sets[2];
+	PairSet* m_current;
+	PairSet* m_previous;
+	std::vector<TrackedPair> m_removedPairs;	// Touching when a body in them was removed, ended on the next step
+
+	std::unordered_map<PhysicsObject*, unsigned int> m_bodyIds;
+	unsigned int m_nextBodyId;
+
+	std::vector<ContactEvent> m_events;
+	int m_eventTypes;
+	unsigned int m_categoryFilter;
+	bool m_staticContacts;
+};
\ No newline at end of file
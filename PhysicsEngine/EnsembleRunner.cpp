@@ -0,0 +1,295 @@
+// Include .h files
+#include "EnsembleRunner.h"
+#include "PhysicsScene.h"
+#include "Plane.h"
+
+// Other includes
+#include <cstdio>
+
+// Typedefs
+
+// One collision category bit per packed run
+static const int MAX_PACKED_RUNS = 32;
+
+// Runs built and stepped at once, so a big sweep never has all its scenes in memory together
+static const int ENSEMBLE_CHUNK_RUNS = 4096;
+
+// Filter every actor starts with, packing needs it free to hand out
+static const unsigned int DEFAULT_CATEGORY = 0x0001;
+static const unsigned int DEFAULT_MASK = 0xFFFFFFFF;
+
+//============================================================================================================================================
+// Constructors
+
+// Constructor
+EnsembleRunner::EnsembleRunner()
+{
+	m_duration = 1.0f;
+	m_packing = true;
+	m_sceneCount = 0;
+	m_packedRuns = 0;
+}
+
+//============================================================================================================================================
+// Parameters and Results
+
+// Add Parameter, count values evenly spaced from first to last
+int EnsembleRunner::addParameter(const char* name, float first, float last, int count)
+{
+	std::vector<float> values;
+	for (int i = 0; i < count; i++)
+	{
+		float t = (count > 1) ? ((float)i / (float)(count - 1)) : 0.0f;
+		values.push_back(first + ((last - first) * t));
+	}
+	return addParameterValues(name, values);
+}
+
+// Add Parameter Values
+int EnsembleRunner::addParameterValues(const char* name, const std::vector<float>& values)
+{
+	m_parameterNames.push_back(name);
+	m_parameterValues.push_back(values);
+	return m_parameterNames.size() - 1;
+}
+
+// Get Run Count
+int EnsembleRunner::getRunCount() const
+{
+	int runCount = 1;
+	for (auto& values : m_parameterValues)
+	{
+		runCount *= values.size();
+	}
+	return runCount;
+}
+
+// Write Table
+bool EnsembleRunner::writeTable(const char* fileName) const
+{
+	FILE* file = std::fopen(fileName, "w");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	// Header, then a row per run
+	int columns = 0;
+	for (auto& name : m_parameterNames)
+	{
+		std::fprintf(file, (columns++ > 0) ? ",%s" : "%s", name.c_str());
+	}
+	for (auto& name : m_resultNames)
+	{
+		std::fprintf(file, (columns++ > 0) ? ",%s" : "%s", name.c_str());
+	}
+	std::fprintf(file, "\n");
+
+	int runCount = m_parameterTable.size() / glm::max(getParameterCount(), 1);
+	for (int run = 0; run < runCount; run++)
+	{
+		columns = 0;
+		for (int i = 0; i < getParameterCount(); i++)
+		{
+			std::fprintf(file, (columns++ > 0) ? ",%g" : "%g", getParameters(run)[i]);
+		}
+		for (int i = 0; i < getResultCount(); i++)
+		{
+			std::fprintf(file, (columns++ > 0) ? ",%g" : "%g", getResults(run)[i]);
+		}
+		std::fprintf(file, "\n");
+	}
+	return std::fclose(file) == 0;
+}
+
+// Fill Parameter Table, every combination of the axes with the last one changing fastest
+void EnsembleRunner::fillParameterTable()
+{
+	int runCount = getRunCount();
+	int parameterCount = getParameterCount();
+	m_parameterTable.resize(runCount * parameterCount);
+	for (int run = 0; run < runCount; run++)
+	{
+		int remaining = run;
+		for (int i = parameterCount - 1; i >= 0; i--)
+		{
+			int valueCount = m_parameterValues[i].size();
+			m_parameterTable[(run * parameterCount) + i] = m_parameterValues[i][remaining % valueCount];
+			remaining /= valueCount;
+		}
+	}
+}
+
+//============================================================================================================================================
+// Running
+
+// Run
+int EnsembleRunner::run(EnsembleExperiment& experiment)
+{
+	fillParameterTable();
+	int runCount = getRunCount();
+	m_resultTable.assign(runCount * getResultCount(), 0.0f);
+	m_sceneCount = 0;
+	m_packedRuns = 0;
+
+	for (int firstRun = 0; firstRun < runCount; firstRun += ENSEMBLE_CHUNK_RUNS)
+	{
+		// Building touches the shared material tables so it stays on this thread, stepping is spread over all of them
+		std::vector<EnsembleGroup> groups;
+		buildGroups(experiment, firstRun, glm::min(ENSEMBLE_CHUNK_RUNS, runCount - firstRun), groups);
+
+		int groupCount = groups.size();
+#pragma omp parallel for schedule(dynamic, 1)
+		for (int group = 0; group < groupCount; group++)
+		{
+			stepGroup(experiment, groups[group]);
+		}
+
+		for (auto& group : groups)
+		{
+			delete group.scene;
+		}
+	}
+	return runCount;
+}
+
+// Build Groups, a scene per run that can't be packed and as few as possible for the rest
+void EnsembleRunner::buildGroups(EnsembleExperiment& experiment, int firstRun, int runCount, std::vector<EnsembleGroup>& groups)
+{
+	int packingGroup = -1;
+	for (int run = firstRun; run < firstRun + runCount; run++)
+	{
+		PhysicsScene* scene = new PhysicsScene();
+		experiment.build(scene, getParameters(run));
+
+		if (!m_packing || !isPackable(scene))
+		{
+			EnsembleGroup group;
+			group.scene = scene;
+			group.runs.push_back(run);
+			group.bodies.push_back(scene->getActors());
+			groups.push_back(group);
+			continue;
+		}
+
+		// Start a new packed scene once the last one is full or this run doesn't line up with it
+		if (packingGroup < 0 || (int)groups[packingGroup].runs.size() >= MAX_PACKED_RUNS || !canJoin(groups[packingGroup].scene, scene))
+		{
+			EnsembleGroup group;
+			group.scene = new PhysicsScene();
+			group.scene->setGravity(scene->getGravity());
+			group.scene->setTimeStep(scene->getTimeStep());
+			group.scene->setIntegrator(scene->getIntegrator());
+			group.scene->setPairProvider(scene->getPairProvider());
+			groups.push_back(group);
+			packingGroup = groups.size() - 1;
+		}
+		packRun(groups[packingGroup], scene, run);
+		delete scene;
+		m_packedRuns++;
+	}
+	m_sceneCount += groups.size();
+}
+
+// Step Group, the whole duration with every run in the scene measured after each step
+void EnsembleRunner::stepGroup(EnsembleExperiment& experiment, EnsembleGroup& group)
+{
+	float timeStep = group.scene->getTimeStep();
+	int stepCount = (timeStep > 0.0f) ? (int)((m_duration / timeStep) + 0.5f) : 0;
+	int resultCount = getResultCount();
+	int groupRuns = group.runs.size();
+
+	for (int step = 0; step < stepCount; step++)
+	{
+		group.scene->update(timeStep);
+
+		float time = (step + 1) * timeStep;
+		for (int i = 0; i < groupRuns; i++)
+		{
+			int run = group.runs[i];
+			experiment.measure(group.bodies[i], getParameters(run), time, &m_resultTable[run * resultCount]);
+		}
+	}
+}
+
+//============================================================================================================================================
+// Packing
+
+// Is Packable, only bodies and Planes with nothing acting on the whole scene
+bool EnsembleRunner::isPackable(PhysicsScene* scene)
+{
+	if (scene->getForceGeneratorCount() > 0 || scene->getForceFields().getFieldCount() > 0 || scene->getFluidCount() > 0 ||
+		scene->getConstraints().getConstraintCount() > 0 || scene->getSceneMode() != IMPULSE_MODE || scene->getAdaptiveStepping() ||
+		scene->getLodScheduling() || scene->getReorderTrigger() != REORDER_NEVER || scene->isPeriodic())
+	{
+		return false;
+	}
+
+	// Packing hands out the collision filters, so runs can't be using them already
+	for (int list = 0; list < 2; list++)
+	{
+		for (auto pActor : (list == 0) ? scene->getActors() : scene->getStaticActors())
+		{
+			if (pActor->getCollisionCategory() != DEFAULT_CATEGORY || pActor->getCollisionMask() != DEFAULT_MASK || pActor->getCollisionGroup() != 0)
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// Can Join, the settings every run in a packed scene has to share
+bool EnsembleRunner::canJoin(PhysicsScene* packed, PhysicsScene* scene)
+{
+	return packed->getGravity() == scene->getGravity() && packed->getTimeStep() == scene->getTimeStep() &&
+		packed->getIntegrator() == scene->getIntegrator() && packed->getPairProvider() == scene->getPairProvider();
+}
+
+// Pack Run, moves a run's actors into the packed scene under a collision category of its own
+void EnsembleRunner::packRun(EnsembleGroup& group, PhysicsScene* scene, int run)
+{
+	unsigned int runBit = 1u << group.runs.size();
+	std::vector<PhysicsObject*> bodies(scene->getActors());
+	std::vector<PhysicsObject*> statics(scene->getStaticActors());
+	scene->removeActors(bodies);
+	scene->removeActors(statics);
+
+	for (auto pBody : bodies)
+	{
+		pBody->setCollisionFilter(runBit, runBit);
+		group.scene->addActor(pBody);
+	}
+
+	for (auto pStatic : statics)
+	{
+		// A Plane another run already has is shared, its filter takes this run's bit as well
+		PhysicsObject* shared = nullptr;
+		if (pStatic->getShapeID() == PLANE)
+		{
+			Plane* plane = static_cast<Plane*>(pStatic);
+			for (auto pPacked : group.scene->getStaticActors())
+			{
+				Plane* packedPlane = static_cast<Plane*>(pPacked);
+				if (pPacked->getShapeID() == PLANE && packedPlane->getNormal() == plane->getNormal() &&
+					packedPlane->getDistanceToOrigin() == plane->getDistanceToOrigin())
+				{
+					shared = pPacked;
+					break;
+				}
+			}
+		}
+
+		if (shared != nullptr)
+		{
+			shared->setCollisionFilter(shared->getCollisionCategory() | runBit, shared->getCollisionMask() | runBit);
+			delete static_cast<Plane*>(pStatic);
+			continue;
+		}
+		pStatic->setCollisionFilter(runBit, runBit);
+		group.scene->addActor(pStatic);
+	}
+
+	group.runs.push_back(run);
+	group.bodies.push_back(bodies);
+}
\ No newline at end of file
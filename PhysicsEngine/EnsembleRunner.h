@@ -0,0 +1,119 @@
+#pragma once
+// Include .h files
+#include "PhysicsObject.h"
+
+// Other includes
+#include <vector>
+#include <string>
+#include <glm\vec2.hpp>
+#include <glm\glm.hpp>
+
+// Typedefs
+
+//============================================================================================================================================
+// EnsembleExperiment CLASS
+
+// One experiment run many times over a grid of parameters. build is the template, it sets up a scene the same way every
+// run apart from the parameters it is given; measure reduces what happened into the run's row of the results table
+class EnsembleExperiment
+{
+
+public:
+	virtual ~EnsembleExperiment() {}
+
+	// Sets up the scene for one run: actors, gravity, time step and any other settings. Called on the main thread
+	virtual void build(class PhysicsScene* scene, const float* parameters) = 0;
+
+	// Called after every fixed step with the run's moving bodies in the order build added them, and the time since the
+	// start. Results start at zero and keep whatever was written last step. Called on worker threads, runs in parallel
+	virtual void measure(const std::vector<PhysicsObject*>& bodies, const float* parameters, float time, float* results) = 0;
+};
+
+//============================================================================================================================================
+// EnsembleRunner CLASS
+
+// Runs every combination of a set of parameters as its own independent simulation, in place of a process per run. Runs
+// are built a chunk at a time and stepped in parallel on OpenMP threads, each thread taking whole scenes.
+// Runs whose scenes line up are packed into one PhysicsScene, up to 32 at a time: bodies from each run get a collision
+// category and mask of their own so runs never touch, and Planes common to several runs are kept once and shared. The
+// packed scene pays the fixed cost of a step once for all its runs, and its batched plane pass tests bodies from
+// different runs side by side in the same lanes. A run can be packed when its scene has only bodies and Planes, with the
+// default collision filter, and uses the same gravity, time step, integrator and pair provider as the runs it joins;
+// anything with force generators, fields, fluids, constraints, grains, adaptive stepping, LOD scheduling, reordering or
+// a periodic domain gets a scene to itself. A packed run steps exactly as it would alone: the broadphase hands out each
+// body's pairs in actor order, so contacts are resolved in the same order whatever other runs share the grid, and runs
+// add their Planes in the same order, which a template building every run the same way does
+class EnsembleRunner
+{
+
+public:
+	EnsembleRunner();
+
+	//============================================================================================================================================
+	// Parameters and Results
+
+	// Each parameter is an axis of the grid, runs are every combination with the last axis changing fastest
+	int addParameter(const char* name, float first, float last, int count);
+	int addParameterValues(const char* name, const std::vector<float>& values);
+	void clearParameters() { m_parameterNames.clear(); m_parameterValues.clear(); }
+
+	// Columns measure fills in for every run
+	void setResultNames(const std::vector<std::string>& names) { m_resultNames = names; }
+
+	// How long each run is simulated for
+	void setDuration(float duration) { m_duration = duration; }
+	float getDuration() const { return m_duration; }
+
+	// Packing is on by default, turn it off to give every run a scene of its own
+	void setPacking(bool packing) { m_packing = packing; }
+	bool getPacking() const { return m_packing; }
+
+	//============================================================================================================================================
+	// Running
+
+	// Builds, steps and measures every run, filling the results table. Returns the number of runs
+	int run(EnsembleExperiment& experiment);
+
+	int getRunCount() const;
+	int getParameterCount() const { return m_parameterNames.size(); }
+	int getResultCount() const { return m_resultNames.size(); }
+	const float* getParameters(int run) const { return &m_parameterTable[run * getParameterCount()]; }
+	const float* getResults(int run) const { return &m_resultTable[run * getResultCount()]; }
+
+	// One row per run, the parameters then the results, comma separated with a header line. Returns false if the file
+	// couldn't be written
+	bool writeTable(const char* fileName) const;
+
+	// What the last run did
+	int getSceneCount() const { return m_sceneCount; }
+	int getPackedRunCount() const { return m_packedRuns; }
+
+protected:
+	// A scene being stepped and the runs in it
+	struct EnsembleGroup
+	{
+		class PhysicsScene* scene;
+		std::vector<int> runs;
+		std::vector<std::vector<PhysicsObject*>> bodies;	// Each run's moving bodies
+	};
+
+	void fillParameterTable();
+	void buildGroups(EnsembleExperiment& experiment, int firstRun, int runCount, std::vector<EnsembleGroup>& groups);
+	void stepGroup(EnsembleExperiment& experiment, EnsembleGroup& group);
+	static bool isPackable(class PhysicsScene* scene);
+	static bool canJoin(class PhysicsScene* packed, class PhysicsScene* scene);
+	void packRun(EnsembleGroup& group, class PhysicsScene* scene, int run);
+
+	std::vector<std::string> m_parameterNames;
+	std::vector<std::vector<float>> m_parameterValues;
+	std::vector<std::string> m_resultNames;
+	float m_duration;
+	bool m_packing;
+
+	// One row per run
+	std::vector<float> m_parameterTable;
+	std::vector<float> m_resultTable;
+
+	int m_sceneCount;
+	int m_packedRuns;
+};
\ No newline at end of file
@@ -0,0 +1,536 @@
+// Include .h files
+#include "EventDrivenScene.h"
+#include "Sphere.h"
+#include "Plane.h"
+
+// Other includes
+#include <cmath>
+#include <cfloat>
+#include <cassert>
+
+// Typedefs
+
+// Largest number of grid cells along either side
+static const int MAX_EVENT_GRID_DIMENSION = 1024;
+
+// Approach speeds this small, relative to the speeds involved, are rounding left over from the last collision
+static const double SEPARATION_TOLERANCE = 1e-9;
+
+//============================================================================================================================================
+// Constructors
+
+// Constructor, the grid covers worldMin to worldMax. A cell size of 0 uses the largest Sphere's diameter
+EventDrivenScene::EventDrivenScene(glm::vec2 worldMin, glm::vec2 worldMax, float cellSize)
+{
+	m_time = 0.0;
+	m_initialised = false;
+	m_worldMin = worldMin;
+	m_worldMax = worldMax;
+	m_requestedCellSize = cellSize;
+	m_cellSize = 1.0;
+	m_columns = 1;
+	m_rows = 1;
+	m_collisionEvents = 0;
+	m_cellEvents = 0;
+	m_staleEvents = 0;
+}
+
+// Deconstructor
+EventDrivenScene::~EventDrivenScene()
+{
+	for (auto pSphere : m_spheres)
+	{
+		delete pSphere;
+	}
+	for (auto pPlane : m_planes)
+	{
+		delete pPlane;
+	}
+}
+
+//============================================================================================================================================
+// Actor Functions
+
+// Add Actor
+void EventDrivenScene::addActor(PhysicsObject* actor)
+{
+	assert(actor->getShapeID() == SPHERE || actor->getShapeID() == PLANE);
+
+	if (actor->getShapeID() == PLANE)
+	{
+		m_planes.push_back(static_cast<Plane*>(actor));
+	}
+	else
+	{
+		Sphere* sphere = static_cast<Sphere*>(actor);
+		m_spheres.push_back(sphere);
+		m_positionX.push_back(sphere->getPosition().x);
+		m_positionY.push_back(sphere->getPosition().y);
+		m_velocityX.push_back(sphere->isDynamic() ? sphere->getVelocity().x : 0.0);
+		m_velocityY.push_back(sphere->isDynamic() ? sphere->getVelocity().y : 0.0);
+		m_sphereTime.push_back(m_time);
+		m_radius.push_back(sphere->getRadius());
+		m_inverseMass.push_back(sphere->getInverseMass());
+		m_elasticity.push_back(sphere->getElasticity());
+		m_collisions.push_back(0);
+	}
+
+	// Every prediction is redone with the new actor in the world
+	m_initialised = false;
+}
+
+//============================================================================================================================================
+// Simulation Functions
+
+// Initialise, bins every Sphere and predicts its first event
+void EventDrivenScene::initialise()
+{
+	int sphereCount = m_spheres.size();
+
+	double maxRadius = 0.0;
+	for (int i = 0; i < sphereCount; i++)
+	{
+		maxRadius = glm::max(maxRadius, m_radius[i]);
+	}
+
+	// Touching Spheres always have their centres in neighbouring cells
+	glm::vec2 size = m_worldMax - m_worldMin;
+	m_cellSize = glm::max((double)m_requestedCellSize, 2.0 * maxRadius);
+	m_cellSize = glm::max(m_cellSize, (double)glm::max(size.x, size.y) / MAX_EVENT_GRID_DIMENSION);
+	m_columns = glm::clamp((int)(size.x / m_cellSize) + 1, 1, MAX_EVENT_GRID_DIMENSION);
+	m_rows = glm::clamp((int)(size.y / m_cellSize) + 1, 1, MAX_EVENT_GRID_DIMENSION);
+
+	m_cells.assign(m_columns * m_rows, std::vector<int>());
+	m_sphereCell.assign(sphereCount, -1);
+	m_cellSlot.assign(sphereCount, -1);
+	for (int i = 0; i < sphereCount; i++)
+	{
+		advanceSphere(i, m_time);
+		moveToCell(i, (getCellRow(m_positionY[i]) * m_columns) + getCellColumn(m_positionX[i]));
+	}
+
+	m_eventTime.assign(sphereCount, DBL_MAX);
+	m_eventType.assign(sphereCount, NO_EVENT);
+	m_eventPartner.assign(sphereCount, -1);
+	m_eventPartnerCollisions.assign(sphereCount, 0);
+	m_heap.resize(sphereCount);
+	m_heapPosition.resize(sphereCount);
+	for (int i = 0; i < sphereCount; i++)
+	{
+		m_heap[i] = i;
+		m_heapPosition[i] = i;
+	}
+	for (int i = 0; i < sphereCount; i++)
+	{
+		predict(i, m_time);
+	}
+
+	m_initialised = true;
+}
+
+// Advance To, runs the events in time order
+void EventDrivenScene::advanceTo(double time)
+{
+	if (!m_initialised)
+	{
+		initialise();
+	}
+
+	while (!m_heap.empty() && m_eventTime[m_heap[0]] <= time)
+	{
+		int sphere = m_heap[0];
+		double eventTime = m_eventTime[sphere];
+		int partner = m_eventPartner[sphere];
+
+		switch (m_eventType[sphere])
+		{
+		case SPHERE_EVENT:
+		{
+			// The partner has hit something else since this was predicted
+			if (m_collisions[partner] != m_eventPartnerCollisions[sphere])
+			{
+				m_staleEvents++;
+				predict(sphere, eventTime);
+				break;
+			}
+
+			advanceSphere(sphere, eventTime);
+			advanceSphere(partner, eventTime);
+
+			double normalX = m_positionX[partner] - m_positionX[sphere];
+			double normalY = m_positionY[partner] - m_positionY[sphere];
+			double distance = std::sqrt((normalX * normalX) + (normalY * normalY));
+			double inverseMassSum = m_inverseMass[sphere] + m_inverseMass[partner];
+			if (distance > 0.0 && inverseMassSum > 0.0)
+			{
+				// Same impulse as Rigidbody::resolveCollision, along the line between the centres
+				normalX /= distance;
+				normalY /= distance;
+				double approachSpeed = ((m_velocityX[partner] - m_velocityX[sphere]) * normalX) + ((m_velocityY[partner] - m_velocityY[sphere]) * normalY);
+				double elasticity = (m_elasticity[sphere] + m_elasticity[partner]) * 0.5;
+				double impulse = -(1.0 + elasticity) * approachSpeed / inverseMassSum;
+				m_velocityX[sphere] -= impulse * m_inverseMass[sphere] * normalX;
+				m_velocityY[sphere] -= impulse * m_inverseMass[sphere] * normalY;
+				m_velocityX[partner] += impulse * m_inverseMass[partner] * normalX;
+				m_velocityY[partner] += impulse * m_inverseMass[partner] * normalY;
+			}
+
+			m_collisions[sphere]++;
+			m_collisions[partner]++;
+			m_collisionEvents++;
+			predict(sphere, eventTime);
+			predict(partner, eventTime);
+			notifyNeighbours(sphere, eventTime);
+			notifyNeighbours(partner, eventTime);
+			break;
+		}
+
+		case PLANE_EVENT:
+		{
+			// Reflect off the Plane with the Sphere's own elasticity
+			advanceSphere(sphere, eventTime);
+			glm::vec2 normal = m_planes[partner]->getNormal();
+			double normalSpeed = (m_velocityX[sphere] * normal.x) + (m_velocityY[sphere] * normal.y);
+			m_velocityX[sphere] -= (1.0 + m_elasticity[sphere]) * normalSpeed * normal.x;
+			m_velocityY[sphere] -= (1.0 + m_elasticity[sphere]) * normalSpeed * normal.y;
+
+			m_collisions[sphere]++;
+			m_collisionEvents++;
+			predict(sphere, eventTime);
+			notifyNeighbours(sphere, eventTime);
+			break;
+		}
+
+		case CELL_EVENT:
+			// Velocity is unchanged, so events other Spheres have with this one stay valid
+			advanceSphere(sphere, eventTime);
+			moveToCell(sphere, partner);
+			m_cellEvents++;
+			predict(sphere, eventTime);
+			notifyNeighbours(sphere, eventTime);
+			break;
+
+		case NO_EVENT:
+			// Only reached when asked to advance to the end of time
+			m_time = time;
+			return;
+		}
+	}
+
+	// Move the Spheres to where they are now so they can be drawn
+	m_time = time;
+	int sphereCount = m_spheres.size();
+	for (int i = 0; i < sphereCount; i++)
+	{
+		m_spheres[i]->setPosition(getPositionAt(i, time));
+		m_spheres[i]->setVelocity(getVelocity(i));
+	}
+}
+
+// Predict, finds the Sphere's earliest event from the given time on
+void EventDrivenScene::predict(int sphere, double time)
+{
+	double bestTime = DBL_MAX;
+	EventType bestType = NO_EVENT;
+	int bestPartner = -1;
+
+	double positionX = m_positionX[sphere] + (m_velocityX[sphere] * (time - m_sphereTime[sphere]));
+	double positionY = m_positionY[sphere] + (m_velocityY[sphere] * (time - m_sphereTime[sphere]));
+	int column = m_sphereCell[sphere] % m_columns;
+	int row = m_sphereCell[sphere] / m_columns;
+
+	// Leaving the cell, Spheres in the edge cells can wander off the grid without any more crossings
+	double left = m_worldMin.x + (column * m_cellSize);
+	double bottom = m_worldMin.y + (row * m_cellSize);
+	if (m_velocityX[sphere] > 0.0 && column < m_columns - 1)
+	{
+		bestTime = time + glm::max((left + m_cellSize - positionX) / m_velocityX[sphere], 0.0);
+		bestType = CELL_EVENT;
+		bestPartner = m_sphereCell[sphere] + 1;
+	}
+	else if (m_velocityX[sphere] < 0.0 && column > 0)
+	{
+		bestTime = time + glm::max((left - positionX) / m_velocityX[sphere], 0.0);
+		bestType = CELL_EVENT;
+		bestPartner = m_sphereCell[sphere] - 1;
+	}
+	if (m_velocityY[sphere] > 0.0 && row < m_rows - 1)
+	{
+		double crossingTime = time + glm::max((bottom + m_cellSize - positionY) / m_velocityY[sphere], 0.0);
+		if (crossingTime < bestTime)
+		{
+			bestTime = crossingTime;
+			bestType = CELL_EVENT;
+			bestPartner = m_sphereCell[sphere] + m_columns;
+		}
+	}
+	else if (m_velocityY[sphere] < 0.0 && row > 0)
+	{
+		double crossingTime = time + glm::max((bottom - positionY) / m_velocityY[sphere], 0.0);
+		if (crossingTime < bestTime)
+		{
+			bestTime = crossingTime;
+			bestType = CELL_EVENT;
+			bestPartner = m_sphereCell[sphere] - m_columns;
+		}
+	}
+
+	// Spheres in the 3x3 cells around this one
+	for (int neighbourRow = glm::max(row - 1, 0); neighbourRow <= glm::min(row + 1, m_rows - 1); neighbourRow++)
+	{
+		for (int neighbourColumn = glm::max(column - 1, 0); neighbourColumn <= glm::min(column + 1, m_columns - 1); neighbourColumn++)
+		{
+			for (int other : m_cells[(neighbourRow * m_columns) + neighbourColumn])
+			{
+				if (other == sphere)
+				{
+					continue;
+				}
+				double collisionTime = sphereCollisionTime(sphere, other, time);
+				if (collisionTime < bestTime)
+				{
+					bestTime = collisionTime;
+					bestType = SPHERE_EVENT;
+					bestPartner = other;
+				}
+			}
+		}
+	}
+
+	// Planes
+	int planeCount = m_planes.size();
+	for (int plane = 0; plane < planeCount; plane++)
+	{
+		double collisionTime = planeCollisionTime(sphere, plane, time);
+		if (collisionTime < bestTime)
+		{
+			bestTime = collisionTime;
+			bestType = PLANE_EVENT;
+			bestPartner = plane;
+		}
+	}
+
+	m_eventTime[sphere] = bestTime;
+	m_eventType[sphere] = bestType;
+	m_eventPartner[sphere] = bestPartner;
+	m_eventPartnerCollisions[sphere] = (bestType == SPHERE_EVENT) ? m_collisions[bestPartner] : 0;
+	heapUpdate(sphere);
+}
+
+// Notify Neighbours, a Sphere that just changed course may now reach a neighbour before that neighbour's own next event
+void EventDrivenScene::notifyNeighbours(int sphere, double time)
+{
+	int column = m_sphereCell[sphere] % m_columns;
+	int row = m_sphereCell[sphere] / m_columns;
+
+	for (int neighbourRow = glm::max(row - 1, 0); neighbourRow <= glm::min(row + 1, m_rows - 1); neighbourRow++)
+	{
+		for (int neighbourColumn = glm::max(column - 1, 0); neighbourColumn <= glm::min(column + 1, m_columns - 1); neighbourColumn++)
+		{
+			for (int other : m_cells[(neighbourRow * m_columns) + neighbourColumn])
+			{
+				if (other == sphere)
+				{
+					continue;
+				}
+				double collisionTime = sphereCollisionTime(other, sphere, time);
+				if (collisionTime < m_eventTime[other])
+				{
+					m_eventTime[other] = collisionTime;
+					m_eventType[other] = SPHERE_EVENT;
+					m_eventPartner[other] = sphere;
+					m_eventPartnerCollisions[other] = m_collisions[sphere];
+					heapUpdate(other);
+				}
+			}
+		}
+	}
+}
+
+// Sphere Collision Time, exact time the two Spheres touch while closing, DBL_MAX if they never do
+double EventDrivenScene::sphereCollisionTime(int sphere1, int sphere2, double time) const
+{
+	double deltaX = (m_positionX[sphere2] + (m_velocityX[sphere2] * (time - m_sphereTime[sphere2]))) - (m_positionX[sphere1] + (m_velocityX[sphere1] * (time - m_sphereTime[sphere1])));
+	double deltaY = (m_positionY[sphere2] + (m_velocityY[sphere2] * (time - m_sphereTime[sphere2]))) - (m_positionY[sphere1] + (m_velocityY[sphere1] * (time - m_sphereTime[sphere1])));
+	double relativeX = m_velocityX[sphere2] - m_velocityX[sphere1];
+	double relativeY = m_velocityY[sphere2] - m_velocityY[sphere1];
+
+	// Moving apart, or too close to level to tell
+	double b = (deltaX * relativeX) + (deltaY * relativeY);
+	double a = (relativeX * relativeX) + (relativeY * relativeY);
+	double distanceSquared = (deltaX * deltaX) + (deltaY * deltaY);
+	if (b >= -SEPARATION_TOLERANCE * std::sqrt(a * distanceSquared))
+	{
+		return DBL_MAX;
+	}
+
+	double reach = m_radius[sphere1] + m_radius[sphere2];
+	double c = distanceSquared - (reach * reach);
+	if (c <= 0.0)
+	{
+		// Already touching and still closing
+		return time;
+	}
+
+	double discriminant = (b * b) - (a * c);
+	if (discriminant < 0.0)
+	{
+		return DBL_MAX;
+	}
+
+	// Smaller root of a t^2 + 2 b t + c = 0, written to avoid cancellation
+	return time + (c / (-b + std::sqrt(discriminant)));
+}
+
+// Plane Collision Time, exact time the Sphere reaches the front of the Plane, DBL_MAX if it's moving away
+double EventDrivenScene::planeCollisionTime(int sphere, int plane, double time) const
+{
+	glm::vec2 normal = m_planes[plane]->getNormal();
+	double normalSpeed = (m_velocityX[sphere] * normal.x) + (m_velocityY[sphere] * normal.y);
+	double speed = std::sqrt((m_velocityX[sphere] * m_velocityX[sphere]) + (m_velocityY[sphere] * m_velocityY[sphere]));
+	if (normalSpeed >= -SEPARATION_TOLERANCE * speed)
+	{
+		return DBL_MAX;
+	}
+
+	double positionX = m_positionX[sphere] + (m_velocityX[sphere] * (time - m_sphereTime[sphere]));
+	double positionY = m_positionY[sphere] + (m_velocityY[sphere] * (time - m_sphereTime[sphere]));
+	double gap = (positionX * normal.x) + (positionY * normal.y) - m_planes[plane]->getDistanceToOrigin() - m_radius[sphere];
+	if (gap <= 0.0)
+	{
+		return time;
+	}
+	return time - (gap / normalSpeed);
+}
+
+// Advance Sphere, moves its stored state along its straight line to the given time
+void EventDrivenScene::advanceSphere(int sphere, double time)
+{
+	m_positionX[sphere] += m_velocityX[sphere] * (time - m_sphereTime[sphere]);
+	m_positionY[sphere] += m_velocityY[sphere] * (time - m_sphereTime[sphere]);
+	m_sphereTime[sphere] = time;
+}
+
+// Get Position At
+glm::vec2 EventDrivenScene::getPositionAt(int sphere, double time) const
+{
+	double elapsed = time - m_sphereTime[sphere];
+	return glm::vec2((float)(m_positionX[sphere] + (m_velocityX[sphere] * elapsed)), (float)(m_positionY[sphere] + (m_velocityY[sphere] * elapsed)));
+}
+
+//============================================================================================================================================
+// Grid
+
+// Get Cell Column
+int EventDrivenScene::getCellColumn(double x) const
+{
+	double column = (x - m_worldMin.x) / m_cellSize;
+	if (!(column >= 0.0)) { return 0; }
+	if (column >= (double)m_columns) { return m_columns - 1; }
+	return (int)column;
+}
+
+// Get Cell Row
+int EventDrivenScene::getCellRow(double y) const
+{
+	double row = (y - m_worldMin.y) / m_cellSize;
+	if (!(row >= 0.0)) { return 0; }
+	if (row >= (double)m_rows) { return m_rows - 1; }
+	return (int)row;
+}
+
+// Move To Cell, swaps the Sphere out of its old cell's list and onto the end of the new one
+void EventDrivenScene::moveToCell(int sphere, int cell)
+{
+	int oldCell = m_sphereCell[sphere];
+	if (oldCell >= 0)
+	{
+		std::vector<int>& oldList = m_cells[oldCell];
+		int slot = m_cellSlot[sphere];
+		oldList[slot] = oldList.back();
+		m_cellSlot[oldList[slot]] = slot;
+		oldList.pop_back();
+	}
+
+	m_sphereCell[sphere] = cell;
+	m_cellSlot[sphere] = m_cells[cell].size();
+	m_cells[cell].push_back(sphere);
+}
+
+//============================================================================================================================================
+// Event Heap
+
+// Heap Update, restores the heap order after a Sphere's event time changes
+void EventDrivenScene::heapUpdate(int sphere)
+{
+	heapSiftUp(m_heapPosition[sphere]);
+	heapSiftDown(m_heapPosition[sphere]);
+}
+
+// Heap Sift Up
+void EventDrivenScene::heapSiftUp(int position)
+{
+	while (position > 0)
+	{
+		int parent = (position - 1) / 2;
+		if (m_eventTime[m_heap[parent]] <= m_eventTime[m_heap[position]])
+		{
+			return;
+		}
+		heapSwap(position, parent);
+		position = parent;
+	}
+}
+
+// Heap Sift Down
+void EventDrivenScene::heapSiftDown(int position)
+{
+	int heapSize = m_heap.size();
+	while (true)
+	{
+		int smallest = position;
+		int left = (2 * position) + 1;
+		int right = left + 1;
+		if (left < heapSize && m_eventTime[m_heap[left]] < m_eventTime[m_heap[smallest]])
+		{
+			smallest = left;
+		}
+		if (right < heapSize && m_eventTime[m_heap[right]] < m_eventTime[m_heap[smallest]])
+		{
+			smallest = right;
+		}
+		if (smallest == position)
+		{
+			return;
+		}
+		heapSwap(position, smallest);
+		position = smallest;
+	}
+}
+
+// Heap Swap
+void EventDrivenScene::heapSwap(int position1, int position2)
+{
+	int sphere1 = m_heap[position1];
+	int sphere2 = m_heap[position2];
+	m_heap[position1] = sphere2;
+	m_heap[position2] = sphere1;
+	m_heapPosition[sphere1] = position2;
+	m_heapPosition[sphere2] = position1;
+}
+
+//============================================================================================================================================
+// Misc
+
+// Update Gizmos
+void EventDrivenScene::updateGizmos()
+{
+	for (auto pPlane : m_planes)
+	{
+		pPlane->makeGizmo();
+	}
+	for (auto pSphere : m_spheres)
+	{
+		pSphere->makeGizmo();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,126 @@
+#pragma once
+// Include .h files
+#include "PhysicsObject.h"
+
+// Other includes
+#include <vector>
+#include <glm\vec2.hpp>
+#include <glm\glm.hpp>
+
+// Typedefs
+
+//============================================================================================================================================
+// EventType ENUM
+
+enum EventType
+{
+	SPHERE_EVENT,	// Two Spheres touch
+	PLANE_EVENT,	// A Sphere reaches a Plane
+	CELL_EVENT,		// A Sphere's centre moves into the next grid cell
+	NO_EVENT		// Nothing will ever happen to the Sphere
+};
+
+//============================================================================================================================================
+// EventDrivenScene CLASS
+
+// Hard-sphere simulation that jumps from collision to collision instead of stepping. Spheres fly in straight lines
+// between events, so their state at any time is worked out exactly from where they were at their last event. Every
+// Sphere keeps its own earliest predicted event in an indexed min-heap. An event goes stale when its partner collides
+// with something else first; rather than hunting stale events down, each one remembers its partner's collision count
+// and is simply repredicted if that has changed by the time it reaches the top. Spheres are binned into a grid of cells
+// at least one diameter wide and only look for partners in the 3x3 cells around them, crossing into a new cell is an
+// event in its own right that checks the new neighbours. Planes are one-sided as in PhysicsScene, and there is no gravity
+class EventDrivenScene
+{
+
+public:
+	EventDrivenScene(glm::vec2 worldMin, glm::vec2 worldMax, float cellSize = 0.0f);
+	~EventDrivenScene();
+
+	// Takes Spheres and Planes, and deletes them like PhysicsScene does
+	void addActor(PhysicsObject* actor);
+
+	// Run every event up to the given time and move the Spheres to where they are at that time
+	void advanceTo(double time);
+	void update(float dt) { advanceTo(m_time + dt); }
+	void updateGizmos();
+
+	// Where a Sphere is at any time from the last event it was in up to its next one
+	glm::vec2 getPositionAt(int sphere, double time) const;
+	glm::vec2 getVelocity(int sphere) const { return glm::vec2((float)m_velocityX[sphere], (float)m_velocityY[sphere]); }
+
+	//============================================================================================================================================
+	// Getters
+
+	double getTime() const { return m_time; }
+	int getSphereCount() const { return m_spheres.size(); }
+	Sphere* getSphere(int sphere) { return m_spheres[sphere]; }
+	long long getCollisionCount() const { return m_collisionEvents; }
+	long long getCellCrossingCount() const { return m_cellEvents; }
+	long long getStaleEventCount() const { return m_staleEvents; }
+
+protected:
+	void initialise();
+	void predict(int sphere, double time);
+	void notifyNeighbours(int sphere, double time);
+	double sphereCollisionTime(int sphere1, int sphere2, double time) const;
+	double planeCollisionTime(int sphere, int plane, double time) const;
+	void advanceSphere(int sphere, double time);
+	void moveToCell(int sphere, int cell);
+
+	int getCellColumn(double x) const;
+	int getCellRow(double y) const;
+
+	// Indexed min-heap on each Sphere's event time
+	void heapUpdate(int sphere);
+	void heapSiftUp(int position);
+	void heapSiftDown(int position);
+	void heapSwap(int position1, int position2);
+
+	double m_time;
+	bool m_initialised;
+
+	std::vector<Sphere*> m_spheres;
+	std::vector<Plane*> m_planes;
+
+	//============================================================================================================================================
+	// Sphere State, each one as of its own last event
+
+	std::vector<double> m_positionX;
+	std::vector<double> m_positionY;
+	std::vector<double> m_velocityX;
+	std::vector<double> m_velocityY;
+	std::vector<double> m_sphereTime;
+	std::vector<double> m_radius;
+	std::vector<double> m_inverseMass;
+	std::vector<double> m_elasticity;
+	std::vector<int> m_collisions;			// Bumped every collision, events that saw an older count are stale
+
+	//============================================================================================================================================
+	// Predicted Events, one per Sphere
+
+	std::vector<double> m_eventTime;
+	std::vector<EventType> m_eventType;
+	std::vector<int> m_eventPartner;		// Sphere, Plane or cell index depending on the type
+	std::vector<int> m_eventPartnerCollisions;
+
+	std::vector<int> m_heap;				// Sphere indices
+	std::vector<int> m_heapPosition;		// Where each Sphere sits in m_heap
+
+	//============================================================================================================================================
+	// Grid
+
+	glm::vec2 m_worldMin;
+	glm::vec2 m_worldMax;
+	float m_requestedCellSize;
+	double m_cellSize;
+	int m_columns;
+	int m_rows;
+	std::vector<std::vector<int>> m_cells;
+	std::vector<int> m_sphereCell;
+	std::vector<int> m_cellSlot;			// Where each Sphere sits in its cell's list
+
+	long long m_collisionEvents;
+	long long m_cellEvents;
+	long long m_staleEvents;
+};
\ No newline at end of file
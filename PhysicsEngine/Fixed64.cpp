@@ -0,0 +1,138 @@
+// Include .h files
+#include "Fixed64.h"
+
+// Other includes
+#include <cmath>
+#include <climits>
+
+// Typedefs
+
+// Largest magnitude a double can be converted from without overflowing the raw value
+static const double MAX_CONVERTIBLE = 2147483647.0;
+
+//============================================================================================================================================
+// Wide Arithmetic
+
+// Multiply Wide, the full 128-bit product of two unsigned 64-bit numbers
+static void multiplyWide(unsigned long long a, unsigned long long b, unsigned long long& high, unsigned long long& low)
+{
+	unsigned long long aHigh = a >> 32;
+	unsigned long long aLow = a & 0xFFFFFFFFULL;
+	unsigned long long bHigh = b >> 32;
+	unsigned long long bLow = b & 0xFFFFFFFFULL;
+
+	unsigned long long lowLow = aLow * bLow;
+	unsigned long long highLow = aHigh * bLow;
+	unsigned long long lowHigh = aLow * bHigh;
+	unsigned long long highHigh = aHigh * bHigh;
+
+	// Middle terms overlap both halves, carry what spills out of the low half
+	unsigned long long middle = (lowLow >> 32) + (highLow & 0xFFFFFFFFULL) + (lowHigh & 0xFFFFFFFFULL);
+	low = (middle << 32) | (lowLow & 0xFFFFFFFFULL);
+	high = highHigh + (highLow >> 32) + (lowHigh >> 32) + (middle >> 32);
+}
+
+//============================================================================================================================================
+// Conversion
+
+// From Double, rounded to the nearest raw value and clamped to the representable range
+long long Fixed64::fromDouble(double value)
+{
+	value = (value > MAX_CONVERTIBLE) ? MAX_CONVERTIBLE : ((value < -MAX_CONVERTIBLE) ? -MAX_CONVERTIBLE : value);
+	return (long long)std::floor((value * (double)ONE_RAW) + 0.5);
+}
+
+//============================================================================================================================================
+// Arithmetic
+
+// Multiply Raw Portable, the same result as the 128-bit shift without a 128-bit type
+long long Fixed64::multiplyRawPortable(long long a, long long b)
+{
+	bool negative = (a < 0) != (b < 0);
+	unsigned long long magnitudeA = (a < 0) ? (0ULL - (unsigned long long)a) : (unsigned long long)a;
+	unsigned long long magnitudeB = (b < 0) ? (0ULL - (unsigned long long)b) : (unsigned long long)b;
+
+	unsigned long long high;
+	unsigned long long low;
+	multiplyWide(magnitudeA, magnitudeB, high, low);
+	unsigned long long shifted = (high << 32) | (low >> 32);
+
+	// Shifting a negative product rounds down, so anything in the dropped bits takes it one further from zero
+	if (negative)
+	{
+		bool remainder = (low & 0xFFFFFFFFULL) != 0;
+		return (long long)(0ULL - shifted - (remainder ? 1ULL : 0ULL));
+	}
+	return (long long)shifted;
+}
+
+// Divide Raw, rounds towards zero and saturates on a divide by zero
+long long Fixed64::divideRaw(long long numerator, long long denominator)
+{
+	if (denominator == 0)
+	{
+		return (numerator >= 0) ? LLONG_MAX : LLONG_MIN;
+	}
+
+#if defined(__SIZEOF_INT128__)
+	return (long long)(((__int128)numerator * ONE_RAW) / denominator);
+#else
+	bool negative = (numerator < 0) != (denominator < 0);
+	unsigned long long magnitudeN = (numerator < 0) ? (0ULL - (unsigned long long)numerator) : (unsigned long long)numerator;
+	unsigned long long magnitudeD = (denominator < 0) ? (0ULL - (unsigned long long)denominator) : (unsigned long long)denominator;
+
+	// Long division of the numerator shifted up 32 bits, one bit at a time
+	unsigned long long high = magnitudeN >> 32;
+	unsigned long long low = magnitudeN << 32;
+	unsigned long long remainder = 0;
+	unsigned long long quotient = 0;
+	for (int bit = 127; bit >= 0; bit--)
+	{
+		unsigned long long nextBit = (bit >= 64) ? ((high >> (bit - 64)) & 1ULL) : ((low >> bit) & 1ULL);
+		bool carry = (remainder >> 63) != 0;
+		remainder = (remainder << 1) | nextBit;
+		quotient <<= 1;
+		if (carry || remainder >= magnitudeD)
+		{
+			remainder -= magnitudeD;
+			quotient |= 1ULL;
+		}
+	}
+	return negative ? (long long)(0ULL - quotient) : (long long)quotient;
+#endif
+}
+
+// Sqrt, the exact rounded down root worked out in integers so every platform agrees
+Fixed64 Fixed64::sqrt(Fixed64 value)
+{
+	if (value.m_raw <= 0)
+	{
+		return Fixed64();
+	}
+
+	// The raw root is the integer root of raw * 2^32
+	unsigned long long targetHigh = (unsigned long long)value.m_raw >> 32;
+	unsigned long long targetLow = (unsigned long long)value.m_raw << 32;
+
+	// A double gets within a couple of units, the corrections below make it exact
+	unsigned long long root = (unsigned long long)std::sqrt((double)value.m_raw * (double)ONE_RAW);
+	unsigned long long high;
+	unsigned long long low;
+	while (true)
+	{
+		multiplyWide(root, root, high, low);
+		if (high > targetHigh || (high == targetHigh && low > targetLow))
+		{
+			root--;
+			continue;
+		}
+		multiplyWide(root + 1, root + 1, high, low);
+		if (high < targetHigh || (high == targetHigh && low <= targetLow))
+		{
+			root++;
+			continue;
+		}
+		break;
+	}
+	return fromRaw((long long)root);
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+// Include .h files
+
+// Other includes
+
+// Typedefs
+
+//============================================================================================================================================
+// Fixed64 CLASS
+
+// Q32.32 fixed point number, 32 integer bits and 32 fraction bits in one 64-bit integer. Every operation is done in
+// integer arithmetic with fixed rounding (multiplies round down, divides round towards zero, square roots round down),
+// so a simulation run in Fixed64 gives the same bits on every compiler and CPU. Overflow wraps rather than being
+// undefined. Compilers with a 128-bit integer type use it for multiplies and divides, everything else gets a portable
+// version that rounds the same way
+class Fixed64
+{
+
+public:
+	Fixed64() { m_raw = 0; }
+	Fixed64(int value) { m_raw = (long long)value * ONE_RAW; }
+	explicit Fixed64(float value) { m_raw = fromDouble(value); }
+	explicit Fixed64(double value) { m_raw = fromDouble(value); }
+
+	static Fixed64 fromRaw(long long raw) { Fixed64 result; result.m_raw = raw; return result; }
+	long long getRaw() const { return m_raw; }
+
+	float toFloat() const { return (float)toDouble(); }
+	double toDouble() const { return (double)m_raw * (1.0 / (double)ONE_RAW); }
+
+	//============================================================================================================================================
+	// Arithmetic
+
+	Fixed64 operator+(Fixed64 other) const { return fromRaw((long long)((unsigned long long)m_raw + (unsigned long long)other.m_raw)); }
+	Fixed64 operator-(Fixed64 other) const { return fromRaw((long long)((unsigned long long)m_raw - (unsigned long long)other.m_raw)); }
+	Fixed64 operator-() const { return fromRaw((long long)(0ULL - (unsigned long long)m_raw)); }
+	Fixed64 operator*(Fixed64 other) const { return fromRaw(multiplyRaw(m_raw, other.m_raw)); }
+	Fixed64 operator/(Fixed64 other) const { return fromRaw(divideRaw(m_raw, other.m_raw)); }
+
+	Fixed64& operator+=(Fixed64 other) { *this = *this + other; return *this; }
+	Fixed64& operator-=(Fixed64 other) { *this = *this - other; return *this; }
+	Fixed64& operator*=(Fixed64 other) { *this = *this * other; return *this; }
+	Fixed64& operator/=(Fixed64 other) { *this = *this / other; return *this; }
+
+	bool operator==(Fixed64 other) const { return m_raw == other.m_raw; }
+	bool operator!=(Fixed64 other) const { return m_raw != other.m_raw; }
+	bool operator<(Fixed64 other) const { return m_raw < other.m_raw; }
+	bool operator<=(Fixed64 other) const { return m_raw <= other.m_raw; }
+	bool operator>(Fixed64 other) const { return m_raw > other.m_raw; }
+	bool operator>=(Fixed64 other) const { return m_raw >= other.m_raw; }
+
+	static Fixed64 sqrt(Fixed64 value);
+	static Fixed64 abs(Fixed64 value) { return (value.m_raw < 0) ? -value : value; }
+
+	static const long long ONE_RAW = 1LL << 32;
+
+protected:
+	static long long fromDouble(double value);
+	static long long divideRaw(long long numerator, long long denominator);
+	static long long multiplyRawPortable(long long a, long long b);
+
+	// Rounds down like an arithmetic shift of the full 128-bit product
+	static long long multiplyRaw(long long a, long long b)
+	{
+#if defined(__SIZEOF_INT128__)
+		return (long long)(((__int128)a * b) >> 32);
+#else
+		return multiplyRawPortable(a, b);
+#endif
+	}
+
+	long long m_raw;
+};
\ No newline at end of file
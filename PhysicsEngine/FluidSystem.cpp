@@ -0,0 +1,445 @@
+// Include .h files
+#include "FluidSystem.h"
+#include "BroadPhase.h"
+#include "RigidBody.h"
+#include "Plane.h"
+
+// Other includes
+#include <Gizmos.h>
+#include <glm\ext.hpp>
+#include <cmath>
+
+// Typedefs
+
+// Largest number of grid cells along either side, the cells grow past the smoothing radius once it's reached
+static const int MAX_FLUID_GRID_DIMENSION = 2048;
+
+//============================================================================================================================================
+// Constructors
+
+// Constructor
+FluidSystem::FluidSystem(float smoothingRadius, float restDensity, float particleSpacing)
+{
+	m_smoothingRadius = smoothingRadius;
+	m_restDensity = restDensity;
+	// A particle at rest fills one spacing-sized square
+	m_particleMass = restDensity * particleSpacing * particleSpacing;
+	m_particleRadius = particleSpacing * 0.5f;
+	m_stiffness = 1000.0f;
+	m_viscosity = 0.5f;
+	m_boundaryElasticity = 0.2f;
+	m_color = glm::vec4(0.2f, 0.5f, 1.0f, 1.0f);
+
+	// 2D poly6, spiky gradient and viscosity laplacian kernels
+	float h = smoothingRadius;
+	m_poly6 = 4.0f / (glm::pi<float>() * std::pow(h, 8.0f));
+	m_spikyGradient = 30.0f / (glm::pi<float>() * std::pow(h, 5.0f));
+	m_viscosityLaplacian = 40.0f / (glm::pi<float>() * std::pow(h, 5.0f));
+
+	m_gridOrigin = glm::vec2(0, 0);
+	m_cellSize = smoothingRadius;
+	m_columns = 1;
+	m_rows = 1;
+	m_maxDisplacement = 0.0f;
+}
+
+//============================================================================================================================================
+// Particle Functions
+
+// Add Particle
+void FluidSystem::addParticle(glm::vec2 position, glm::vec2 velocity)
+{
+	m_positionX.push_back(position.x);
+	m_positionY.push_back(position.y);
+	m_velocityX.push_back(velocity.x);
+	m_velocityY.push_back(velocity.y);
+	m_density.push_back(m_restDensity);
+	m_pressure.push_back(0.0f);
+	m_accelerationX.push_back(0.0f);
+	m_accelerationY.push_back(0.0f);
+}
+
+// Add Block, fills the box with particles at their rest spacing
+void FluidSystem::addBlock(glm::vec2 min, glm::vec2 max, glm::vec2 velocity)
+{
+	float spacing = m_particleRadius * 2.0f;
+	for (float y = min.y; y <= max.y; y += spacing)
+	{
+		for (float x = min.x; x <= max.x; x += spacing)
+		{
+			addParticle(glm::vec2(x, y), velocity);
+		}
+	}
+}
+
+// Clear Particles
+void FluidSystem::clearParticles()
+{
+	m_positionX.clear();
+	m_positionY.clear();
+	m_velocityX.clear();
+	m_velocityY.clear();
+	m_density.clear();
+	m_pressure.clear();
+	m_accelerationX.clear();
+	m_accelerationY.clear();
+}
+
+//============================================================================================================================================
+// Neighbour Grid
+
+// Get Cell Column
+int FluidSystem::getCellColumn(float x) const
+{
+	float column = (x - m_gridOrigin.x) / m_cellSize;
+	if (!(column >= 0.0f)) { return 0; }
+	if (column >= (float)m_columns) { return m_columns - 1; }
+	return (int)column;
+}
+
+// Get Cell Row
+int FluidSystem::getCellRow(float y) const
+{
+	float row = (y - m_gridOrigin.y) / m_cellSize;
+	if (!(row >= 0.0f)) { return 0; }
+	if (row >= (float)m_rows) { return m_rows - 1; }
+	return (int)row;
+}
+
+// Sort Particles, counting sort by cell and then reorder every array to match
+void FluidSystem::sortParticles()
+{
+	int particleCount = getParticleCount();
+
+	glm::vec2 min(m_positionX[0], m_positionY[0]);
+	glm::vec2 max = min;
+	for (int i = 1; i < particleCount; i++)
+	{
+		min = glm::min(min, glm::vec2(m_positionX[i], m_positionY[i]));
+		max = glm::max(max, glm::vec2(m_positionX[i], m_positionY[i]));
+	}
+
+	glm::vec2 size = max - min;
+	m_cellSize = glm::max(m_smoothingRadius, glm::max(size.x, size.y) / (float)MAX_FLUID_GRID_DIMENSION);
+	m_gridOrigin = min;
+	m_columns = glm::clamp((int)(size.x / m_cellSize) + 1, 1, MAX_FLUID_GRID_DIMENSION);
+	m_rows = glm::clamp((int)(size.y / m_cellSize) + 1, 1, MAX_FLUID_GRID_DIMENSION);
+
+	int cellCount = m_columns * m_rows;
+	m_cellStart.assign(cellCount + 1, 0);
+	m_particleCell.resize(particleCount);
+	for (int i = 0; i < particleCount; i++)
+	{
+		int cell = (getCellRow(m_positionY[i]) * m_columns) + getCellColumn(m_positionX[i]);
+		m_particleCell[i] = cell;
+		m_cellStart[cell + 1]++;
+	}
+	for (int cell = 0; cell < cellCount; cell++)
+	{
+		m_cellStart[cell + 1] += m_cellStart[cell];
+	}
+
+	// m_sortOrder maps each new slot to the particle that moves into it
+	m_sortOrder.resize(particleCount);
+	std::vector<int> cellFill(m_cellStart.begin(), m_cellStart.end() - 1);
+	for (int i = 0; i < particleCount; i++)
+	{
+		m_sortOrder[cellFill[m_particleCell[i]]++] = i;
+	}
+
+	std::vector<float>* arrays[] = { &m_positionX, &m_positionY, &m_velocityX, &m_velocityY, &m_density };
+	m_sortScratch.resize(particleCount);
+	for (auto pArray : arrays)
+	{
+		std::vector<float>& values = *pArray;
+		for (int i = 0; i < particleCount; i++)
+		{
+			m_sortScratch[i] = values[m_sortOrder[i]];
+		}
+		values.swap(m_sortScratch);
+	}
+}
+
+//============================================================================================================================================
+// Simulation Passes
+
+// Compute Density
+void FluidSystem::computeDensity()
+{
+	int particleCount = getParticleCount();
+	float radiusSquared = m_smoothingRadius * m_smoothingRadius;
+
+#pragma omp parallel for schedule(dynamic, 512)
+	for (int i = 0; i < particleCount; i++)
+	{
+		float x = m_positionX[i];
+		float y = m_positionY[i];
+		int column = getCellColumn(x);
+		int row = getCellRow(y);
+		float density = 0.0f;
+
+		for (int neighbourRow = glm::max(row - 1, 0); neighbourRow <= glm::min(row + 1, m_rows - 1); neighbourRow++)
+		{
+			// The three cells in a row are next to each other in memory after the sort, so walk them as one run
+			int first = m_cellStart[(neighbourRow * m_columns) + glm::max(column - 1, 0)];
+			int last = m_cellStart[(neighbourRow * m_columns) + glm::min(column + 1, m_columns - 1) + 1];
+			for (int j = first; j < last; j++)
+			{
+				float offsetX = x - m_positionX[j];
+				float offsetY = y - m_positionY[j];
+				float difference = glm::max(radiusSquared - ((offsetX * offsetX) + (offsetY * offsetY)), 0.0f);
+				density += difference * difference * difference;
+			}
+		}
+
+		m_density[i] = density * m_particleMass * m_poly6;
+		// Only positive pressure, pulling particles together makes them clump
+		m_pressure[i] = glm::max(m_stiffness * (m_density[i] - m_restDensity), 0.0f);
+	}
+}
+
+// Compute Forces
+void FluidSystem::computeForces(glm::vec2 gravity)
+{
+	int particleCount = getParticleCount();
+	float radiusSquared = m_smoothingRadius * m_smoothingRadius;
+
+#pragma omp parallel for schedule(dynamic, 512)
+	for (int i = 0; i < particleCount; i++)
+	{
+		float x = m_positionX[i];
+		float y = m_positionY[i];
+		int column = getCellColumn(x);
+		int row = getCellRow(y);
+		float forceX = 0.0f;
+		float forceY = 0.0f;
+
+		for (int neighbourRow = glm::max(row - 1, 0); neighbourRow <= glm::min(row + 1, m_rows - 1); neighbourRow++)
+		{
+			int first = m_cellStart[(neighbourRow * m_columns) + glm::max(column - 1, 0)];
+			int last = m_cellStart[(neighbourRow * m_columns) + glm::min(column + 1, m_columns - 1) + 1];
+			for (int j = first; j < last; j++)
+			{
+				float offsetX = x - m_positionX[j];
+				float offsetY = y - m_positionY[j];
+				float distanceSquared = (offsetX * offsetX) + (offsetY * offsetY);
+				if (j == i || distanceSquared >= radiusSquared || distanceSquared == 0.0f)
+				{
+					continue;
+				}
+
+				float distance = std::sqrt(distanceSquared);
+				float falloff = m_smoothingRadius - distance;
+
+				// Pressure pushes apart along the offset, viscosity pulls velocities together
+				float pressure = m_particleMass * (m_pressure[i] + m_pressure[j]) / (2.0f * m_density[j]) * m_spikyGradient * falloff * falloff / distance;
+				float viscosity = m_viscosity * m_particleMass / m_density[j] * m_viscosityLaplacian * falloff;
+				forceX += (offsetX * pressure) + ((m_velocityX[j] - m_velocityX[i]) * viscosity);
+				forceY += (offsetY * pressure) + ((m_velocityY[j] - m_velocityY[i]) * viscosity);
+			}
+		}
+
+		m_accelerationX[i] = (forceX / m_density[i]) + gravity.x;
+		m_accelerationY[i] = (forceY / m_density[i]) + gravity.y;
+	}
+}
+
+// Integrate, semi-implicit Euler like the rigid bodies
+void FluidSystem::integrate(float timeStep)
+{
+	int particleCount = getParticleCount();
+
+#pragma omp parallel for
+	for (int i = 0; i < particleCount; i++)
+	{
+		m_velocityX[i] += m_accelerationX[i] * timeStep;
+		m_velocityY[i] += m_accelerationY[i] * timeStep;
+		m_positionX[i] += m_velocityX[i] * timeStep;
+		m_positionY[i] += m_velocityY[i] * timeStep;
+	}
+
+	// The grid is still sorted by where particles were before this move, so collideWithBodies has to look this much
+	// further out to find everything that moved into a body
+	float maxSpeedSquared = 0.0f;
+	for (int i = 0; i < particleCount; i++)
+	{
+		maxSpeedSquared = glm::max(maxSpeedSquared, (m_velocityX[i] * m_velocityX[i]) + (m_velocityY[i] * m_velocityY[i]));
+	}
+	m_maxDisplacement = std::sqrt(maxSpeedSquared) * timeStep;
+}
+
+//============================================================================================================================================
+// Coupling
+
+// Collide With Bodies, both ways: particles are pushed out and the body takes the opposite impulse
+void FluidSystem::collideWithBodies(const std::vector<PhysicsObject*>& actors)
+{
+	float particleInverseMass = 1.0f / m_particleMass;
+
+	for (auto pActor : actors)
+	{
+		ShapeType shape = pActor->getShapeID();
+		if (shape != SPHERE && shape != AABB_)
+		{
+			continue;
+		}
+
+		Rigidbody* body = static_cast<Rigidbody*>(pActor);
+		glm::vec2 min;
+		glm::vec2 max;
+		BroadPhase::getActorBounds(pActor, min, max);
+		glm::vec2 centre = (min + max) * 0.5f;
+		float radius = (max.x - min.x) * 0.5f;
+		glm::vec2 bodyVelocity = body->getVelocity();
+		float bodyInverseMass = body->getInverseMass();
+		glm::vec2 bodyImpulse(0, 0);
+
+		// Only the particles in the cells the body covers, widened by how far particles moved since the grid was built
+		glm::vec2 reach(m_particleRadius + m_maxDisplacement, m_particleRadius + m_maxDisplacement);
+		int firstColumn = getCellColumn(min.x - reach.x);
+		int lastColumn = getCellColumn(max.x + reach.x);
+		int firstRow = getCellRow(min.y - reach.y);
+		int lastRow = getCellRow(max.y + reach.y);
+
+		for (int row = firstRow; row <= lastRow; row++)
+		{
+			int first = m_cellStart[(row * m_columns) + firstColumn];
+			int last = m_cellStart[(row * m_columns) + lastColumn + 1];
+			for (int i = first; i < last; i++)
+			{
+				glm::vec2 position(m_positionX[i], m_positionY[i]);
+				glm::vec2 normal;
+				glm::vec2 surface;
+
+				if (shape == SPHERE)
+				{
+					glm::vec2 offset = position - centre;
+					float distance = glm::length(offset);
+					if (distance >= radius + m_particleRadius)
+					{
+						continue;
+					}
+					normal = (distance > 0.0f) ? (offset / distance) : glm::vec2(0, 1);
+					surface = centre + (normal * (radius + m_particleRadius));
+				}
+				else
+				{
+					glm::vec2 closest = glm::clamp(position, min, max);
+					glm::vec2 offset = position - closest;
+					float distance = glm::length(offset);
+					if (distance >= m_particleRadius)
+					{
+						continue;
+					}
+
+					if (distance > 0.0f)
+					{
+						normal = offset / distance;
+						surface = closest + (normal * m_particleRadius);
+					}
+					else
+					{
+						// Inside the box, leave through the nearest face
+						float toLeft = position.x - min.x;
+						float toRight = max.x - position.x;
+						float toBottom = position.y - min.y;
+						float toTop = max.y - position.y;
+						float nearest = glm::min(glm::min(toLeft, toRight), glm::min(toBottom, toTop));
+						if (nearest == toLeft)			{ normal = glm::vec2(-1, 0); surface = glm::vec2(min.x - m_particleRadius, position.y); }
+						else if (nearest == toRight)	{ normal = glm::vec2(1, 0);  surface = glm::vec2(max.x + m_particleRadius, position.y); }
+						else if (nearest == toBottom)	{ normal = glm::vec2(0, -1); surface = glm::vec2(position.x, min.y - m_particleRadius); }
+						else							{ normal = glm::vec2(0, 1);  surface = glm::vec2(position.x, max.y + m_particleRadius); }
+					}
+				}
+
+				m_positionX[i] = surface.x;
+				m_positionY[i] = surface.y;
+
+				// Same impulse as Rigidbody::resolveCollision, shared between the particle and the body by inverse mass
+				glm::vec2 relativeVelocity = glm::vec2(m_velocityX[i], m_velocityY[i]) - bodyVelocity;
+				float approach = glm::dot(relativeVelocity, normal);
+				if (approach < 0.0f)
+				{
+					float j = -(1.0f + m_boundaryElasticity) * approach / (particleInverseMass + bodyInverseMass);
+					m_velocityX[i] += normal.x * j * particleInverseMass;
+					m_velocityY[i] += normal.y * j * particleInverseMass;
+					bodyImpulse -= normal * j;
+				}
+			}
+		}
+
+		if (bodyInverseMass > 0.0f && (bodyImpulse.x != 0.0f || bodyImpulse.y != 0.0f))
+		{
+			body->setVelocity(bodyVelocity + (bodyImpulse * bodyInverseMass));
+		}
+	}
+}
+
+// Collide With Planes, particles stay on the side the normal points to
+void FluidSystem::collideWithPlanes(const std::vector<PhysicsObject*>& staticActors)
+{
+	int particleCount = getParticleCount();
+
+	for (auto pStatic : staticActors)
+	{
+		if (pStatic->getShapeID() != PLANE)
+		{
+			continue;
+		}
+
+		Plane* plane = static_cast<Plane*>(pStatic);
+		glm::vec2 normal = plane->getNormal();
+		float distanceToOrigin = plane->getDistanceToOrigin();
+
+#pragma omp parallel for
+		for (int i = 0; i < particleCount; i++)
+		{
+			float signedDistance = (m_positionX[i] * normal.x) + (m_positionY[i] * normal.y) - distanceToOrigin;
+			if (signedDistance < m_particleRadius)
+			{
+				float push = m_particleRadius - signedDistance;
+				m_positionX[i] += normal.x * push;
+				m_positionY[i] += normal.y * push;
+
+				float approach = (m_velocityX[i] * normal.x) + (m_velocityY[i] * normal.y);
+				if (approach < 0.0f)
+				{
+					m_velocityX[i] -= normal.x * approach * (1.0f + m_boundaryElasticity);
+					m_velocityY[i] -= normal.y * approach * (1.0f + m_boundaryElasticity);
+				}
+			}
+		}
+	}
+}
+
+//============================================================================================================================================
+// Update Functions
+
+// Step
+void FluidSystem::step(float timeStep, glm::vec2 gravity, const std::vector<PhysicsObject*>& actors, const std::vector<PhysicsObject*>& staticActors)
+{
+	if (getParticleCount() == 0)
+	{
+		return;
+	}
+
+	sortParticles();
+	computeDensity();
+	computeForces(gravity);
+	integrate(timeStep);
+
+	// Static colliders that aren't Planes push particles but take no impulse back
+	collideWithBodies(staticActors);
+	collideWithBodies(actors);
+	collideWithPlanes(staticActors);
+}
+
+// Make Gizmo
+void FluidSystem::makeGizmo()
+{
+	int particleCount = getParticleCount();
+	for (int i = 0; i < particleCount; i++)
+	{
+		aie::Gizmos::add2DCircle(glm::vec2(m_positionX[i], m_positionY[i]), m_particleRadius, 6, m_color);
+	}
+}
\ No newline at end of file
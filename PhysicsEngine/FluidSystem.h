@@ -0,0 +1,100 @@
+#pragma once
+// Include .h files
+#include "PhysicsObject.h"
+
+// Other includes
+#include <vector>
+#include <glm\vec2.hpp>
+#include <glm\glm.hpp>
+
+// Typedefs
+
+//============================================================================================================================================
+// FluidSystem CLASS
+
+// Smoothed-particle hydrodynamics liquid. Particles are plain arrays rather than PhysicsObjects; every step they are
+// counting-sorted into a grid of smoothing-radius cells and physically reordered by cell, so every neighbour search
+// walks contiguous memory. Density, pressure/viscosity forces and integration each run as a parallel pass, then
+// particles are pushed out of the scene's Spheres, AABBs and Planes with the equal and opposite impulse handed back
+// to dynamic bodies, searching the grid from before the move widened by the furthest any particle moved. Particle
+// indices change every step, don't hold on to them
+class FluidSystem
+{
+
+public:
+	FluidSystem(float smoothingRadius = 1.0f, float restDensity = 1.0f, float particleSpacing = 0.5f);
+
+	void addParticle(glm::vec2 position, glm::vec2 velocity);
+	void addBlock(glm::vec2 min, glm::vec2 max, glm::vec2 velocity);
+	void clearParticles();
+
+	void step(float timeStep, glm::vec2 gravity, const std::vector<PhysicsObject*>& actors, const std::vector<PhysicsObject*>& staticActors);
+	void makeGizmo();
+
+	//============================================================================================================================================
+	// Getters and Setters
+
+	int getParticleCount() const { return m_positionX.size(); }
+	glm::vec2 getParticlePosition(int index) const { return glm::vec2(m_positionX[index], m_positionY[index]); }
+	glm::vec2 getParticleVelocity(int index) const { return glm::vec2(m_velocityX[index], m_velocityY[index]); }
+	float getParticleDensity(int index) const { return m_density[index]; }
+
+	void setStiffness(float stiffness) { m_stiffness = stiffness; }
+	void setViscosity(float viscosity) { m_viscosity = viscosity; }
+	void setBoundaryElasticity(float elasticity) { m_boundaryElasticity = elasticity; }
+	void setColor(glm::vec4 color) { m_color = color; }
+	float getParticleMass() const { return m_particleMass; }
+
+protected:
+	void sortParticles();
+	void computeDensity();
+	void computeForces(glm::vec2 gravity);
+	void integrate(float timeStep);
+	void collideWithBodies(const std::vector<PhysicsObject*>& actors);
+	void collideWithPlanes(const std::vector<PhysicsObject*>& staticActors);
+
+	int getCellColumn(float x) const;
+	int getCellRow(float y) const;
+
+	//============================================================================================================================================
+	// Settings
+
+	float m_smoothingRadius;
+	float m_restDensity;
+	float m_particleMass;
+	float m_particleRadius;		// Collision radius against rigid bodies
+	float m_stiffness;
+	float m_viscosity;
+	float m_boundaryElasticity;
+	glm::vec4 m_color;
+
+	// Kernel constants, worked out once from the smoothing radius
+	float m_poly6;
+	float m_spikyGradient;
+	float m_viscosityLaplacian;
+
+	//============================================================================================================================================
+	// Particles
+
+	std::vector<float> m_positionX;
+	std::vector<float> m_positionY;
+	std::vector<float> m_velocityX;
+	std::vector<float> m_velocityY;
+	std::vector<float> m_density;
+	std::vector<float> m_pressure;
+	std::vector<float> m_accelerationX;
+	std::vector<float> m_accelerationY;
+
+	//============================================================================================================================================
+	// Neighbour Grid
+
+	glm::vec2 m_gridOrigin;
+	float m_cellSize;
+	int m_columns;
+	int m_rows;
+	std::vector<int> m_cellStart;		// Start of each cell's particles, one extra entry at the end
+	std::vector<int> m_particleCell;
+	std::vector<int> m_sortOrder;
+	std::vector<float> m_sortScratch;
+	float m_maxDisplacement;			// Furthest a particle moved since the grid was built
+};
\ No newline at end of file
@@ -0,0 +1,235 @@
+// Include .h files
+#include "ForceFields.h"
+#include "RigidBody.h"
+
+// Other includes
+#include <cmath>
+
+// Typedefs
+
+// Number of bodies evaluated together, the bounds prefilter works at this granularity too
+static const int FIELD_BATCH_WIDTH = 8;
+
+//============================================================================================================================================
+// ForceField Constructors
+
+// Uniform Field
+ForceField ForceField::uniform(glm::vec2 acceleration, glm::vec2 min, glm::vec2 max)
+{
+	ForceField field;
+	field.type = UNIFORM_FIELD;
+	field.vector = acceleration;
+	field.strength = 0.0f;
+	field.radius = 0.0f;
+	field.min = min;
+	field.max = max;
+	return field;
+}
+
+// Point Field
+ForceField ForceField::point(glm::vec2 centre, float strength, float radius)
+{
+	ForceField field;
+	field.type = POINT_FIELD;
+	field.vector = centre;
+	field.strength = strength;
+	field.radius = radius;
+	field.min = centre - glm::vec2(radius, radius);
+	field.max = centre + glm::vec2(radius, radius);
+	return field;
+}
+
+// Vortex Field
+ForceField ForceField::vortex(glm::vec2 centre, float strength, float radius)
+{
+	ForceField field = point(centre, strength, radius);
+	field.type = VORTEX_FIELD;
+	return field;
+}
+
+// Damping Field
+ForceField ForceField::damping(float coefficient, glm::vec2 min, glm::vec2 max)
+{
+	ForceField field;
+	field.type = DAMPING_FIELD;
+	field.vector = glm::vec2(0, 0);
+	field.strength = coefficient;
+	field.radius = 0.0f;
+	field.min = min;
+	field.max = max;
+	return field;
+}
+
+//============================================================================================================================================
+// Constructors
+
+// Constructor
+ForceFieldSystem::ForceFieldSystem()
+{
+	m_skippedBatches = 0;
+}
+
+//============================================================================================================================================
+// Field Functions
+
+// Add Field
+int ForceFieldSystem::addField(const ForceField& field)
+{
+	m_fields.push_back(field);
+	return m_fields.size() - 1;
+}
+
+// Remove Field, the fields after it move down one index
+void ForceFieldSystem::removeField(int index)
+{
+	m_fields.erase(m_fields.begin() + index);
+}
+
+//============================================================================================================================================
+// Force Functions
+
+// Apply Forces
+void ForceFieldSystem::applyForces(const std::vector<PhysicsObject*>& actors, float /*timeStep*/)
+{
+	m_skippedBatches = 0;
+	if (m_fields.empty())
+	{
+		return;
+	}
+
+	// Gather the dynamic bodies, kinematic ones ignore forces anyway
+	m_bodies.clear();
+	for (auto pActor : actors)
+	{
+		if (pActor->isDynamic() && pActor->getShapeID() != PLANE)
+		{
+			m_bodies.push_back(static_cast<Rigidbody*>(pActor));
+		}
+	}
+
+	int bodyCount = m_bodies.size();
+	int batchCount = (bodyCount + FIELD_BATCH_WIDTH - 1) / FIELD_BATCH_WIDTH;
+	int paddedCount = batchCount * FIELD_BATCH_WIDTH;
+
+	// Padding sits at infinity, outside every field's bounds
+	m_positionX.assign(paddedCount, FLT_MAX);
+	m_positionY.assign(paddedCount, FLT_MAX);
+	m_velocityX.assign(paddedCount, 0.0f);
+	m_velocityY.assign(paddedCount, 0.0f);
+	m_accelerationX.assign(paddedCount, 0.0f);
+	m_accelerationY.assign(paddedCount, 0.0f);
+	m_batchMin.assign(batchCount, glm::vec2(FLT_MAX));
+	m_batchMax.assign(batchCount, glm::vec2(-FLT_MAX));
+
+	glm::vec2 bodiesMin(FLT_MAX);
+	glm::vec2 bodiesMax(-FLT_MAX);
+	for (int i = 0; i < bodyCount; i++)
+	{
+		glm::vec2 position = m_bodies[i]->getPosition();
+		glm::vec2 velocity = m_bodies[i]->getVelocity();
+		m_positionX[i] = position.x;
+		m_positionY[i] = position.y;
+		m_velocityX[i] = velocity.x;
+		m_velocityY[i] = velocity.y;
+
+		int batch = i / FIELD_BATCH_WIDTH;
+		m_batchMin[batch] = glm::min(m_batchMin[batch], position);
+		m_batchMax[batch] = glm::max(m_batchMax[batch], position);
+		bodiesMin = glm::min(bodiesMin, position);
+		bodiesMax = glm::max(bodiesMax, position);
+	}
+
+	const float* positionX = m_positionX.data();
+	const float* positionY = m_positionY.data();
+	const float* velocityX = m_velocityX.data();
+	const float* velocityY = m_velocityY.data();
+	float* accelerationX = m_accelerationX.data();
+	float* accelerationY = m_accelerationY.data();
+
+	for (auto& field : m_fields)
+	{
+		// Fields nowhere near any body are skipped outright
+		if (field.max.x < bodiesMin.x || field.min.x > bodiesMax.x || field.max.y < bodiesMin.y || field.min.y > bodiesMax.y)
+		{
+			m_skippedBatches += batchCount;
+			continue;
+		}
+
+		float inverseRadius = (field.radius > 0.0f) ? (1.0f / field.radius) : 0.0f;
+
+		for (int batch = 0; batch < batchCount; batch++)
+		{
+			// Then per batch
+			if (field.max.x < m_batchMin[batch].x || field.min.x > m_batchMax[batch].x ||
+				field.max.y < m_batchMin[batch].y || field.min.y > m_batchMax[batch].y)
+			{
+				m_skippedBatches++;
+				continue;
+			}
+
+			// One branch-free loop per field type, bodies outside the bounds get a weight of 0
+			int first = batch * FIELD_BATCH_WIDTH;
+			switch (field.type)
+			{
+			case UNIFORM_FIELD:
+				for (int i = first; i < first + FIELD_BATCH_WIDTH; i++)
+				{
+					float inside = (positionX[i] >= field.min.x && positionX[i] <= field.max.x && positionY[i] >= field.min.y && positionY[i] <= field.max.y) ? 1.0f : 0.0f;
+					accelerationX[i] += inside * field.vector.x;
+					accelerationY[i] += inside * field.vector.y;
+				}
+				break;
+
+			case POINT_FIELD:
+			case VORTEX_FIELD:
+			{
+				// Vortices are point fields turned through 90 degrees, clockwise from the inward offset so they run anticlockwise
+				float vortex = (field.type == VORTEX_FIELD) ? 1.0f : 0.0f;
+				float radial = 1.0f - vortex;
+				for (int i = first; i < first + FIELD_BATCH_WIDTH; i++)
+				{
+					float inside = (positionX[i] >= field.min.x && positionX[i] <= field.max.x && positionY[i] >= field.min.y && positionY[i] <= field.max.y) ? 1.0f : 0.0f;
+					float offsetX = field.vector.x - positionX[i];
+					float offsetY = field.vector.y - positionY[i];
+					float distance = std::sqrt((offsetX * offsetX) + (offsetY * offsetY));
+					float inverseDistance = (distance > 0.0f) ? (1.0f / distance) : 0.0f;
+					float falloff = (inverseRadius > 0.0f) ? glm::max(1.0f - (distance * inverseRadius), 0.0f) : 1.0f;
+					float scale = inside * field.strength * falloff * inverseDistance;
+					accelerationX[i] += ((radial * offsetX) + (vortex * offsetY)) * scale;
+					accelerationY[i] += ((radial * offsetY) + (vortex * -offsetX)) * scale;
+				}
+				break;
+			}
+
+			case DAMPING_FIELD:
+				for (int i = first; i < first + FIELD_BATCH_WIDTH; i++)
+				{
+					float inside = (positionX[i] >= field.min.x && positionX[i] <= field.max.x && positionY[i] >= field.min.y && positionY[i] <= field.max.y) ? 1.0f : 0.0f;
+					accelerationX[i] -= inside * field.strength * velocityX[i];
+					accelerationY[i] -= inside * field.strength * velocityY[i];
+				}
+				break;
+			}
+		}
+	}
+
+	// Hand the summed accelerations back to the bodies in one pass
+	for (int i = 0; i < bodyCount; i++)
+	{
+		if (accelerationX[i] != 0.0f || accelerationY[i] != 0.0f)
+		{
+			m_bodies[i]->applyForce(glm::vec2(accelerationX[i], accelerationY[i]) * m_bodies[i]->getMass());
+		}
+	}
+}
+
+// Apply Forces To
+void ForceFieldSystem::applyForcesTo(const std::vector<PhysicsObject*>& actors, const std::vector<int>& targets, float timeStep)
+{
+	m_targetActors.clear();
+	for (int target : targets)
+	{
+		m_targetActors.push_back(actors[target]);
+	}
+	applyForces(m_targetActors, timeStep);
+}
\ No newline at end of file
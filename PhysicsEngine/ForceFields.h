@@ -0,0 +1,86 @@
+#pragma once
+// Include .h files
+#include "ForceGenerator.h"
+
+// Other includes
+#include <vector>
+#include <cfloat>
+#include <glm\vec2.hpp>
+#include <glm\glm.hpp>
+
+// Typedefs
+
+//============================================================================================================================================
+// ForceFieldType ENUM
+
+enum ForceFieldType
+{
+	UNIFORM_FIELD,	// Constant acceleration, wind or extra gravity
+	POINT_FIELD,	// Towards (positive strength) or away from (negative strength) a point
+	VORTEX_FIELD,	// Around a point, anticlockwise for positive strength
+	DAMPING_FIELD	// Slows bodies down in proportion to their velocity
+};
+
+//============================================================================================================================================
+// ForceField STRUCT
+
+// Fields are described once and evaluated for every body inside their bounds. Accelerations don't depend on mass
+struct ForceField
+{
+	ForceFieldType type;
+	glm::vec2 vector;	// Acceleration for uniform fields, centre for point and vortex fields
+	float strength;		// Acceleration at the centre for point and vortex fields, drag coefficient for damping fields
+	float radius;		// Point and vortex fields fade out linearly to nothing at this distance
+	glm::vec2 min;		// Bodies outside these bounds are untouched
+	glm::vec2 max;
+
+	static ForceField uniform(glm::vec2 acceleration, glm::vec2 min = glm::vec2(-FLT_MAX), glm::vec2 max = glm::vec2(FLT_MAX));
+	static ForceField point(glm::vec2 centre, float strength, float radius);
+	static ForceField vortex(glm::vec2 centre, float strength, float radius);
+	static ForceField damping(float coefficient, glm::vec2 min, glm::vec2 max);
+};
+
+//============================================================================================================================================
+// ForceFieldSystem CLASS
+
+// Evaluates every field over every dynamic body in batches. Body data is gathered into flat arrays once per step,
+// each field is thrown out early if it doesn't touch the bodies' bounds, then per batch if it doesn't touch the batch
+class ForceFieldSystem : public ForceGenerator
+{
+
+public:
+	ForceFieldSystem();
+
+	virtual void applyForces(const std::vector<PhysicsObject*>& actors, float timeStep);
+	// Fields only look at each body's own state, so the targets are simply run on their own
+	virtual void applyForcesTo(const std::vector<PhysicsObject*>& actors, const std::vector<int>& targets, float timeStep);
+
+	int addField(const ForceField& field);
+	void removeField(int index);
+	void clearFields() { m_fields.clear(); }
+
+	ForceField& getField(int index) { return m_fields[index]; }
+	int getFieldCount() const { return m_fields.size(); }
+
+	// Batch/field combinations the spatial prefilter threw out on the last step
+	int getSkippedBatches() const { return m_skippedBatches; }
+
+protected:
+	std::vector<ForceField> m_fields;
+
+	// Per-step body data, padded to a whole number of batches
+	std::vector<Rigidbody*> m_bodies;
+	std::vector<PhysicsObject*> m_targetActors;
+	std::vector<float> m_positionX;
+	std::vector<float> m_positionY;
+	std::vector<float> m_velocityX;
+	std::vector<float> m_velocityY;
+	std::vector<float> m_accelerationX;
+	std::vector<float> m_accelerationY;
+
+	// Bounds of each batch
+	std::vector<glm::vec2> m_batchMin;
+	std::vector<glm::vec2> m_batchMax;
+
+	int m_skippedBatches;
+};
\ No newline at end of file
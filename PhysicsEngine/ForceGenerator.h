@@ -0,0 +1,27 @@
+#pragma once
+// Include .h files
+#include "PhysicsObject.h"
+
+// Other includes
+#include <vector>
+
+// Typedefs
+
+//============================================================================================================================================
+// ForceGenerator CLASS
+
+// Anything that pushes bodies around every step. PhysicsScene runs its generators at the start of each fixed step,
+// before any body is integrated, so the forces they apply are used by that step's fixedUpdate
+class ForceGenerator
+{
+
+public:
+	virtual ~ForceGenerator() {}
+
+	// actors holds the scene's moving bodies, static colliders are never passed in
+	virtual void applyForces(const std::vector<PhysicsObject*>& actors, float timeStep) = 0;
+
+	// Only the targets, indices into actors, need their forces. Generators that can skip the other bodies override this,
+	// by default every actor gets its forces as usual
+	virtual void applyForcesTo(const std::vector<PhysicsObject*>& actors, const std::vector<int>& /*targets*/, float timeStep) { applyForces(actors, timeStep); }
+};
\ No newline at end of file
@@ -0,0 +1,548 @@
+// Include .h files
+#include "GranularSolver.h"
+#include "RigidBody.h"
+#include "Sphere.h"
+#include "AABB.h"
+#include "Plane.h"
+
+// Other includes
+#include <glm\ext.hpp>
+#include <cmath>
+#include <cfloat>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Typedefs
+
+// Largest number of grid cells along either side, the cells grow past the grain size once it's reached
+static const int MAX_GRANULAR_GRID_DIMENSION = 2048;
+
+// Substeps never go past this many per scene step however stiff the springs are
+static const int MAX_GRANULAR_SUBSTEPS = 200;
+
+// Substep length as a fraction of sqrt(mass / stiffness), about a thirtieth of the shortest contact
+static const float SUBSTEP_FRACTION = 0.2f;
+
+//============================================================================================================================================
+// Constructors
+
+// Constructor
+GranularSolver::GranularSolver()
+{
+	m_contactModel = LINEAR_SPRING;
+	m_stiffness = 10000.0f;
+	m_restitution = 0.5f;
+	m_friction = 0.5f;
+	m_dampingRatio = 0.0f;
+	m_substepTime = 0.0f;
+	m_substepCount = 0;
+	m_substepCapped = false;
+	m_threadCount = 1;
+
+	m_gridOrigin = glm::vec2(0, 0);
+	m_cellSize = 1.0f;
+	m_columns = 1;
+	m_rows = 1;
+}
+
+//============================================================================================================================================
+// Step Functions
+
+// Step
+void GranularSolver::step(float timeStep, glm::vec2 gravity, const std::vector<PhysicsObject*>& actors, const std::vector<PhysicsObject*>& staticActors)
+{
+	gatherBodies(actors, staticActors);
+
+	int grainCount = m_grains.size();
+	int obstacleCount = m_obstacles.size();
+	if (grainCount == 0)
+	{
+		m_substepCapped = false;
+		return;
+	}
+
+	for (int i = 0; i < grainCount; i++)
+	{
+		m_externalX[i] += gravity.x;
+		m_externalY[i] += gravity.y;
+	}
+
+	// Damping ratio that gives the wanted restitution for a linear spring-dashpot
+	float logRestitution = std::log(glm::clamp(m_restitution, 0.001f, 1.0f));
+	m_dampingRatio = -logRestitution / std::sqrt((glm::pi<float>() * glm::pi<float>()) + (logRestitution * logRestitution));
+
+	// Substeps short enough to follow the lightest pair of grains through a contact
+	float minMass = FLT_MAX;
+	float maxRadius = 0.0f;
+	float maxSpeedSquared = 0.0f;
+	for (int i = 0; i < grainCount; i++)
+	{
+		minMass = glm::min(minMass, m_mass[i]);
+		maxRadius = glm::max(maxRadius, m_radius[i]);
+		maxSpeedSquared = glm::max(maxSpeedSquared, (m_velocityX[i] * m_velocityX[i]) + (m_velocityY[i] * m_velocityY[i]));
+	}
+	float maxSubstep = SUBSTEP_FRACTION * std::sqrt((0.5f * minMass) / m_stiffness);
+	float wantedSubsteps = std::ceil(timeStep / maxSubstep);
+	m_substepCapped = wantedSubsteps > (float)MAX_GRANULAR_SUBSTEPS;
+	m_substepCount = glm::clamp((int)glm::min(wantedSubsteps, (float)MAX_GRANULAR_SUBSTEPS), 1, MAX_GRANULAR_SUBSTEPS);
+	m_substepTime = timeStep / (float)m_substepCount;
+
+	// Two grains can close on each other by twice what either one can move this step
+	float maxTravel = (std::sqrt(maxSpeedSquared) + (glm::length(gravity) * timeStep)) * timeStep;
+	findContacts((2.0f * maxTravel) + (0.05f * maxRadius));
+
+	// Velocity Verlet as kick, drift, kick. Contact damping sees the half-step velocity
+	float halfStep = 0.5f * m_substepTime;
+	m_obstacleForceX.assign(obstacleCount, 0.0f);
+	m_obstacleForceY.assign(obstacleCount, 0.0f);
+	computeForces();
+	// That first pass only primes the accelerations, the reactions are averaged over the substeps proper
+	m_obstacleForceX.assign(obstacleCount, 0.0f);
+	m_obstacleForceY.assign(obstacleCount, 0.0f);
+	for (int substep = 0; substep < m_substepCount; substep++)
+	{
+#pragma omp parallel for
+		for (int i = 0; i < grainCount; i++)
+		{
+			m_velocityX[i] += m_accelerationX[i] * halfStep;
+			m_velocityY[i] += m_accelerationY[i] * halfStep;
+			m_positionX[i] += m_velocityX[i] * m_substepTime;
+			m_positionY[i] += m_velocityY[i] * m_substepTime;
+		}
+
+		computeForces();
+
+#pragma omp parallel for
+		for (int i = 0; i < grainCount; i++)
+		{
+			m_velocityX[i] += m_accelerationX[i] * halfStep;
+			m_velocityY[i] += m_accelerationY[i] * halfStep;
+		}
+	}
+
+	// Hand the grains back
+	for (int i = 0; i < grainCount; i++)
+	{
+		m_grains[i]->setPosition(glm::vec2(m_positionX[i], m_positionY[i]));
+		m_grains[i]->setVelocity(glm::vec2(m_velocityX[i], m_velocityY[i]));
+	}
+
+	// Dynamic obstacles get the average reaction over the step, the scene integrates them next
+	for (int i = 0; i < obstacleCount; i++)
+	{
+		if (m_obstacles[i]->isDynamic() && (m_obstacleForceX[i] != 0.0f || m_obstacleForceY[i] != 0.0f))
+		{
+			m_obstacles[i]->applyForce(glm::vec2(m_obstacleForceX[i], m_obstacleForceY[i]) / (float)m_substepCount);
+		}
+	}
+}
+
+// Gather Bodies
+void GranularSolver::gatherBodies(const std::vector<PhysicsObject*>& actors, const std::vector<PhysicsObject*>& staticActors)
+{
+	m_grains.clear();
+	m_obstacles.clear();
+	m_planes.clear();
+
+	for (auto pActor : actors)
+	{
+		if (isGrain(pActor))
+		{
+			m_grains.push_back(static_cast<Sphere*>(pActor));
+		}
+		else if (pActor->getShapeID() != PLANE)
+		{
+			m_obstacles.push_back(static_cast<Rigidbody*>(pActor));
+		}
+	}
+	for (auto pStatic : staticActors)
+	{
+		if (pStatic->getShapeID() == PLANE)
+		{
+			m_planes.push_back(static_cast<Plane*>(pStatic));
+		}
+		else if (pStatic->getShapeID() != SDF)
+		{
+			// Signed distance fields aren't obstacles, the contact model only knows Spheres and AABBs
+			m_obstacles.push_back(static_cast<Rigidbody*>(pStatic));
+		}
+	}
+
+	int grainCount = m_grains.size();
+	int bodyCount = grainCount + m_obstacles.size();
+	m_positionX.resize(bodyCount);
+	m_positionY.resize(bodyCount);
+	m_velocityX.resize(bodyCount);
+	m_velocityY.resize(bodyCount);
+	m_accelerationX.assign(bodyCount, 0.0f);
+	m_accelerationY.assign(bodyCount, 0.0f);
+	m_externalX.assign(bodyCount, 0.0f);
+	m_externalY.assign(bodyCount, 0.0f);
+	m_radius.assign(bodyCount, 0.0f);
+	m_extentX.assign(bodyCount, 0.0f);
+	m_extentY.assign(bodyCount, 0.0f);
+	m_inverseMass.resize(bodyCount);
+	m_mass.resize(bodyCount);
+
+	for (int i = 0; i < bodyCount; i++)
+	{
+		Rigidbody* body = (i < grainCount) ? m_grains[i] : m_obstacles[i - grainCount];
+		m_positionX[i] = body->getPosition().x;
+		m_positionY[i] = body->getPosition().y;
+		m_velocityX[i] = body->getVelocity().x;
+		m_velocityY[i] = body->getVelocity().y;
+		m_inverseMass[i] = body->getInverseMass();
+		m_mass[i] = body->getMass();
+
+		if (body->getShapeID() == SPHERE)
+		{
+			m_radius[i] = static_cast<Sphere*>(body)->getRadius();
+		}
+		else if (body->getShapeID() == AABB_)
+		{
+			m_extentX[i] = static_cast<AABB*>(body)->getExtents().x;
+			m_extentY[i] = static_cast<AABB*>(body)->getExtents().y;
+		}
+
+		// Grains take over their accumulated forces, fixedUpdate never sees them in granular mode
+		if (i < grainCount)
+		{
+			m_externalX[i] = body->getAcceleration().x;
+			m_externalY[i] = body->getAcceleration().y;
+			body->setAcceleration(glm::vec2(0, 0));
+		}
+	}
+}
+
+//============================================================================================================================================
+// Neighbour Grid
+
+// Get Cell Column
+int GranularSolver::getCellColumn(float x) const
+{
+	float column = (x - m_gridOrigin.x) / m_cellSize;
+	if (!(column >= 0.0f)) { return 0; }
+	if (column >= (float)m_columns) { return m_columns - 1; }
+	return (int)column;
+}
+
+// Get Cell Row
+int GranularSolver::getCellRow(float y) const
+{
+	float row = (y - m_gridOrigin.y) / m_cellSize;
+	if (!(row >= 0.0f)) { return 0; }
+	if (row >= (float)m_rows) { return m_rows - 1; }
+	return (int)row;
+}
+
+// Find Contacts, every pair close enough that it could touch before the step is over
+void GranularSolver::findContacts(float skin)
+{
+	int grainCount = m_grains.size();
+	int obstacleCount = m_obstacles.size();
+
+	// Bin the grains into cells big enough that touching grains are always in neighbouring cells
+	glm::vec2 min(m_positionX[0], m_positionY[0]);
+	glm::vec2 max = min;
+	float maxRadius = 0.0f;
+	for (int i = 0; i < grainCount; i++)
+	{
+		min = glm::min(min, glm::vec2(m_positionX[i], m_positionY[i]));
+		max = glm::max(max, glm::vec2(m_positionX[i], m_positionY[i]));
+		maxRadius = glm::max(maxRadius, m_radius[i]);
+	}
+
+	glm::vec2 size = max - min;
+	m_cellSize = glm::max((2.0f * maxRadius) + skin, glm::max(size.x, size.y) / (float)MAX_GRANULAR_GRID_DIMENSION);
+	m_gridOrigin = min;
+	m_columns = glm::clamp((int)(size.x / m_cellSize) + 1, 1, MAX_GRANULAR_GRID_DIMENSION);
+	m_rows = glm::clamp((int)(size.y / m_cellSize) + 1, 1, MAX_GRANULAR_GRID_DIMENSION);
+
+	int cellCount = m_columns * m_rows;
+	m_cellStart.assign(cellCount + 1, 0);
+	m_grainCell.resize(grainCount);
+	for (int i = 0; i < grainCount; i++)
+	{
+		int cell = (getCellRow(m_positionY[i]) * m_columns) + getCellColumn(m_positionX[i]);
+		m_grainCell[i] = cell;
+		m_cellStart[cell + 1]++;
+	}
+	for (int cell = 0; cell < cellCount; cell++)
+	{
+		m_cellStart[cell + 1] += m_cellStart[cell];
+	}
+	m_cellGrains.resize(grainCount);
+	std::vector<int> cellFill(m_cellStart.begin(), m_cellStart.end() - 1);
+	for (int i = 0; i < grainCount; i++)
+	{
+		m_cellGrains[cellFill[m_grainCell[i]]++] = i;
+	}
+
+	// Grain pairs in two passes, count then fill, so the list comes out in the same order on any number of threads
+	std::vector<int> contactStart(grainCount + 1, 0);
+	for (int pass = 0; pass < 2; pass++)
+	{
+		if (pass == 1)
+		{
+			for (int i = 0; i < grainCount; i++)
+			{
+				contactStart[i + 1] += contactStart[i];
+			}
+			m_contactFirst.resize(contactStart[grainCount]);
+			m_contactSecond.resize(contactStart[grainCount]);
+		}
+
+#pragma omp parallel for schedule(dynamic, 1024)
+		for (int i = 0; i < grainCount; i++)
+		{
+			int column = m_grainCell[i] % m_columns;
+			int row = m_grainCell[i] / m_columns;
+			int found = 0;
+
+			for (int neighbourRow = glm::max(row - 1, 0); neighbourRow <= glm::min(row + 1, m_rows - 1); neighbourRow++)
+			{
+				for (int neighbourColumn = glm::max(column - 1, 0); neighbourColumn <= glm::min(column + 1, m_columns - 1); neighbourColumn++)
+				{
+					int cell = (neighbourRow * m_columns) + neighbourColumn;
+					for (int entry = m_cellStart[cell]; entry < m_cellStart[cell + 1]; entry++)
+					{
+						// Each pair once, from its lower index
+						int j = m_cellGrains[entry];
+						if (j <= i)
+						{
+							continue;
+						}
+
+						float deltaX = m_positionX[j] - m_positionX[i];
+						float deltaY = m_positionY[j] - m_positionY[i];
+						float reach = m_radius[i] + m_radius[j] + skin;
+						if ((deltaX * deltaX) + (deltaY * deltaY) < reach * reach)
+						{
+							if (pass == 1)
+							{
+								m_contactFirst[contactStart[i] + found] = i;
+								m_contactSecond[contactStart[i] + found] = j;
+							}
+							found++;
+						}
+					}
+				}
+			}
+
+			if (pass == 0)
+			{
+				contactStart[i + 1] = found;
+			}
+		}
+	}
+
+	// Obstacles, the grains in the cells each one covers
+	for (int obstacle = 0; obstacle < obstacleCount; obstacle++)
+	{
+		int body = grainCount + obstacle;
+		glm::vec2 centre(m_positionX[body], m_positionY[body]);
+		glm::vec2 reach = glm::vec2(m_extentX[body], m_extentY[body]) + glm::vec2(m_radius[body] + maxRadius + skin);
+		int minColumn = getCellColumn(centre.x - reach.x);
+		int maxColumn = getCellColumn(centre.x + reach.x);
+		int minRow = getCellRow(centre.y - reach.y);
+		int maxRow = getCellRow(centre.y + reach.y);
+
+		for (int row = minRow; row <= maxRow; row++)
+		{
+			for (int column = minColumn; column <= maxColumn; column++)
+			{
+				int cell = (row * m_columns) + column;
+				for (int entry = m_cellStart[cell]; entry < m_cellStart[cell + 1]; entry++)
+				{
+					// Distance from the grain to the nearest point of the obstacle, a Sphere being a point with a radius
+					int grain = m_cellGrains[entry];
+					float deltaX = m_positionX[grain] - glm::clamp(m_positionX[grain], centre.x - m_extentX[body], centre.x + m_extentX[body]);
+					float deltaY = m_positionY[grain] - glm::clamp(m_positionY[grain], centre.y - m_extentY[body], centre.y + m_extentY[body]);
+					float grainReach = m_radius[grain] + m_radius[body] + skin;
+					if ((deltaX * deltaX) + (deltaY * deltaY) < grainReach * grainReach)
+					{
+						m_contactFirst.push_back(grain);
+						m_contactSecond.push_back(body);
+					}
+				}
+			}
+		}
+	}
+
+	// Planes
+	m_planeContactGrain.clear();
+	m_planeContactPlane.clear();
+	int planeCount = m_planes.size();
+	for (int plane = 0; plane < planeCount; plane++)
+	{
+		glm::vec2 normal = m_planes[plane]->getNormal();
+		float distance = m_planes[plane]->getDistanceToOrigin();
+		for (int i = 0; i < grainCount; i++)
+		{
+			float signedDistance = (m_positionX[i] * normal.x) + (m_positionY[i] * normal.y) - distance;
+			if (signedDistance < m_radius[i] + skin)
+			{
+				m_planeContactGrain.push_back(i);
+				m_planeContactPlane.push_back(plane);
+			}
+		}
+	}
+
+	// Per-thread force buffers
+#ifdef _OPENMP
+	m_threadCount = omp_get_max_threads();
+#endif
+	m_threadForceX.resize(m_threadCount * m_positionX.size());
+	m_threadForceY.resize(m_threadCount * m_positionX.size());
+}
+
+//============================================================================================================================================
+// Contact Forces
+
+// Compute Forces, every candidate contact into the calling thread's buffer, then a fixed-order sum per body
+void GranularSolver::computeForces()
+{
+	int grainCount = m_grains.size();
+	int bodyCount = m_positionX.size();
+	int contactCount = m_contactFirst.size();
+	int planeContactCount = m_planeContactGrain.size();
+	int bufferSize = m_threadForceX.size();
+
+#pragma omp parallel
+	{
+		int thread = 0;
+#ifdef _OPENMP
+		thread = omp_get_thread_num();
+#endif
+		float* forceX = m_threadForceX.data() + (thread * bodyCount);
+		float* forceY = m_threadForceY.data() + (thread * bodyCount);
+
+		// Every buffer is cleared, a thread that gets no work this time still has its buffer summed
+#pragma omp for schedule(static)
+		for (int i = 0; i < bufferSize; i++)
+		{
+			m_threadForceX[i] = 0.0f;
+			m_threadForceY[i] = 0.0f;
+		}
+
+		// Static scheduling gives every thread the same contacts each time
+#pragma omp for schedule(static)
+		for (int contact = 0; contact < contactCount; contact++)
+		{
+			int first = m_contactFirst[contact];
+			int second = m_contactSecond[contact];
+			float centreX = m_positionX[second];
+			float centreY = m_positionY[second];
+
+			// Nearest point on the other body, its centre for a Sphere
+			float nearestX = glm::clamp(m_positionX[first], centreX - m_extentX[second], centreX + m_extentX[second]);
+			float nearestY = glm::clamp(m_positionY[first], centreY - m_extentY[second], centreY + m_extentY[second]);
+			float deltaX = m_positionX[first] - nearestX;
+			float deltaY = m_positionY[first] - nearestY;
+			float distanceSquared = (deltaX * deltaX) + (deltaY * deltaY);
+			float reach = m_radius[first] + m_radius[second];
+
+			float normalX;
+			float normalY;
+			float overlap;
+			if (distanceSquared > 0.0f)
+			{
+				if (distanceSquared >= reach * reach)
+				{
+					continue;
+				}
+				float distance = std::sqrt(distanceSquared);
+				normalX = deltaX / distance;
+				normalY = deltaY / distance;
+				overlap = reach - distance;
+			}
+			else
+			{
+				// Grain centre inside an AABB (or on top of another grain), push out through the nearest face
+				float faceX = m_extentX[second] - std::abs(m_positionX[first] - centreX);
+				float faceY = m_extentY[second] - std::abs(m_positionY[first] - centreY);
+				bool alongX = faceX < faceY;
+				normalX = alongX ? ((m_positionX[first] >= centreX) ? 1.0f : -1.0f) : 0.0f;
+				normalY = alongX ? 0.0f : ((m_positionY[first] >= centreY) ? 1.0f : -1.0f);
+				overlap = reach + (alongX ? faceX : faceY);
+			}
+
+			// Obstacles have no inverse mass, the grain alone takes the contact
+			float inverseMassSum = m_inverseMass[first] + m_inverseMass[second];
+			float effectiveMass = 1.0f / inverseMassSum;
+			addContactForce(forceX, forceY, first, second, normalX, normalY, overlap,
+							m_velocityX[first] - m_velocityX[second], m_velocityY[first] - m_velocityY[second], effectiveMass);
+		}
+
+#pragma omp for schedule(static)
+		for (int contact = 0; contact < planeContactCount; contact++)
+		{
+			int grain = m_planeContactGrain[contact];
+			glm::vec2 normal = m_planes[m_planeContactPlane[contact]]->getNormal();
+			float signedDistance = (m_positionX[grain] * normal.x) + (m_positionY[grain] * normal.y) - m_planes[m_planeContactPlane[contact]]->getDistanceToOrigin();
+			float overlap = m_radius[grain] - signedDistance;
+			if (overlap > 0.0f)
+			{
+				addContactForce(forceX, forceY, grain, -1, normal.x, normal.y, overlap, m_velocityX[grain], m_velocityY[grain], m_mass[grain]);
+			}
+		}
+
+		// Sum the buffers in thread order, the same order every time
+#pragma omp for schedule(static)
+		for (int i = 0; i < bodyCount; i++)
+		{
+			float totalX = 0.0f;
+			float totalY = 0.0f;
+			for (int buffer = 0; buffer < m_threadCount; buffer++)
+			{
+				totalX += m_threadForceX[(buffer * bodyCount) + i];
+				totalY += m_threadForceY[(buffer * bodyCount) + i];
+			}
+
+			if (i < grainCount)
+			{
+				m_accelerationX[i] = (totalX * m_inverseMass[i]) + m_externalX[i];
+				m_accelerationY[i] = (totalY * m_inverseMass[i]) + m_externalY[i];
+			}
+			else
+			{
+				m_obstacleForceX[i - grainCount] += totalX;
+				m_obstacleForceY[i - grainCount] += totalY;
+			}
+		}
+	}
+}
+
+// Add Contact Force, spring-dashpot along the normal and Coulomb friction across it. body2 is -1 for a Plane
+void GranularSolver::addContactForce(float* forceX, float* forceY, int body1, int body2, float normalX, float normalY, float overlap, float relativeVelocityX, float relativeVelocityY, float effectiveMass)
+{
+	// Hertz contacts stiffen as they're pressed together, the damping follows the stiffness at this overlap
+	float stiffness = (m_contactModel == HERTZ_SPRING) ? (m_stiffness * std::sqrt(overlap)) : m_stiffness;
+	float damping = 2.0f * m_dampingRatio * std::sqrt(effectiveMass * stiffness);
+
+	float normalSpeed = (relativeVelocityX * normalX) + (relativeVelocityY * normalY);
+	// Never pull the bodies together
+	float normalForce = glm::max((stiffness * overlap) - (damping * normalSpeed), 0.0f);
+
+	// Friction opposes the sliding, up to the Coulomb limit. Below it the grains are close to stopped relative to each
+	// other within a couple of substeps, which stands in for static friction without storing contact history
+	float tangentX = relativeVelocityX - (normalSpeed * normalX);
+	float tangentY = relativeVelocityY - (normalSpeed * normalY);
+	float tangentSpeed = std::sqrt((tangentX * tangentX) + (tangentY * tangentY));
+	float frictionForce = 0.0f;
+	if (tangentSpeed > 0.0f)
+	{
+		frictionForce = glm::min(m_friction * normalForce, (0.5f * effectiveMass / m_substepTime) * tangentSpeed) / tangentSpeed;
+	}
+
+	float totalX = (normalForce * normalX) - (frictionForce * tangentX);
+	float totalY = (normalForce * normalY) - (frictionForce * tangentY);
+	forceX[body1] += totalX;
+	forceY[body1] += totalY;
+	if (body2 >= 0)
+	{
+		forceX[body2] -= totalX;
+		forceY[body2] -= totalY;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,132 @@
+#pragma once
+// Include .h files
+#include "PhysicsObject.h"
+
+// Other includes
+#include <vector>
+#include <glm\vec2.hpp>
+#include <glm\glm.hpp>
+
+// Typedefs
+
+//============================================================================================================================================
+// ContactModel ENUM
+
+enum ContactModel
+{
+	LINEAR_SPRING,	// Force grows with overlap
+	HERTZ_SPRING	// Force grows with overlap to the power of 1.5, stiffer the harder grains are pressed together
+};
+
+//============================================================================================================================================
+// GranularSolver CLASS
+
+// Discrete-element contacts for the scene's granular mode. Every dynamic Sphere is a grain: instead of the impulse in
+// Rigidbody::resolveCollision, touching grains push each other apart with a spring-dashpot normal force and a Coulomb
+// limited tangential friction force. Springs stiff enough for sand need far smaller steps than the scene's, so each
+// step is split into velocity Verlet substeps short enough to resolve a contact. Candidate contacts are found once per
+// step from a counting-sort grid with a skin margin, then every substep evaluates them in parallel into per-thread
+// force buffers that are summed in thread order, so a run repeats exactly for a given thread count.
+// Everything that isn't a grain is an obstacle. Static and kinematic obstacles are immovable, dynamic ones get the
+// grains' reaction as a force before they are integrated
+class GranularSolver
+{
+
+public:
+	GranularSolver();
+
+	void step(float timeStep, glm::vec2 gravity, const std::vector<PhysicsObject*>& actors, const std::vector<PhysicsObject*>& staticActors);
+
+	static bool isGrain(PhysicsObject* actor) { return actor->isDynamic() && actor->getShapeID() == SPHERE; }
+
+	//============================================================================================================================================
+	// Getters and Setters
+
+	void setContactModel(ContactModel model) { m_contactModel = model; }
+	ContactModel getContactModel() const { return m_contactModel; }
+
+	// Normal stiffness, force per unit of overlap for linear springs
+	void setStiffness(float stiffness) { m_stiffness = stiffness; }
+	float getStiffness() const { return m_stiffness; }
+
+	// Fraction of the normal approach speed a contact gives back, sets the dashpot damping
+	void setRestitution(float restitution) { m_restitution = restitution; }
+	float getRestitution() const { return m_restitution; }
+
+	void setFriction(float friction) { m_friction = friction; }
+	float getFriction() const { return m_friction; }
+
+	int getGrainCount() const { return m_grains.size(); }
+	int getContactCount() const { return m_contactFirst.size(); }
+	// Substeps taken by the last step, at most 200. Past that cap the substep is longer than the stiffness and lightest
+	// grain allow and contacts can blow up, which isSubstepCapped reports so the caller can shorten the scene step
+	int getSubstepCount() const { return m_substepCount; }
+	bool isSubstepCapped() const { return m_substepCapped; }
+
+protected:
+	void gatherBodies(const std::vector<PhysicsObject*>& actors, const std::vector<PhysicsObject*>& staticActors);
+	void findContacts(float skin);
+	void computeForces();
+	void addContactForce(float* forceX, float* forceY, int body1, int body2, float normalX, float normalY, float overlap, float relativeVelocityX, float relativeVelocityY, float effectiveMass);
+
+	int getCellColumn(float x) const;
+	int getCellRow(float y) const;
+
+	//============================================================================================================================================
+	// Settings
+
+	ContactModel m_contactModel;
+	float m_stiffness;
+	float m_restitution;
+	float m_friction;
+	float m_dampingRatio;		// Worked out from the restitution every step
+	float m_substepTime;
+	int m_substepCount;
+	bool m_substepCapped;		// The last step wanted more substeps than the cap
+
+	//============================================================================================================================================
+	// Bodies, grains first and then obstacles in one set of arrays
+
+	std::vector<Sphere*> m_grains;
+	std::vector<Rigidbody*> m_obstacles;
+	std::vector<Plane*> m_planes;
+	std::vector<float> m_positionX;
+	std::vector<float> m_positionY;
+	std::vector<float> m_velocityX;
+	std::vector<float> m_velocityY;
+	std::vector<float> m_accelerationX;		// From the contacts at the start of the substep
+	std::vector<float> m_accelerationY;
+	std::vector<float> m_externalX;			// Gravity plus whatever the force generators applied
+	std::vector<float> m_externalY;
+	std::vector<float> m_radius;
+	std::vector<float> m_extentX;			// Obstacle AABBs only, 0 for Spheres
+	std::vector<float> m_extentY;
+	std::vector<float> m_inverseMass;
+	std::vector<float> m_mass;
+	std::vector<float> m_obstacleForceX;	// Reaction on each obstacle summed over the substeps
+	std::vector<float> m_obstacleForceY;
+
+	//============================================================================================================================================
+	// Contacts
+
+	std::vector<int> m_contactFirst;		// Always a grain
+	std::vector<int> m_contactSecond;		// A grain or an obstacle
+	std::vector<int> m_planeContactGrain;
+	std::vector<int> m_planeContactPlane;
+
+	// One force buffer per thread, each the size of the body arrays
+	std::vector<float> m_threadForceX;
+	std::vector<float> m_threadForceY;
+	int m_threadCount;
+
+	//============================================================================================================================================
+	// Neighbour Grid
+
+	glm::vec2 m_gridOrigin;
+	float m_cellSize;
+	int m_columns;
+	int m_rows;
+	std::vector<int> m_cellStart;			// Start of each cell's grains, one extra entry at the end
+	std::vector<int> m_cellGrains;
+	std::vector<int> m_grainCell;
+};
\ No newline at end of file
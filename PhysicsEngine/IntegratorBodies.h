@@ -0,0 +1,146 @@
+#pragma once
+// Include .h files
+#include "PhysicsObject.h"
+#include "RigidBody.h"
+
+// Other includes
+#include <vector>
+#include <glm\vec2.hpp>
+#include <glm\glm.hpp>
+
+// Typedefs
+
+//============================================================================================================================================
+// IntegratorBodies CLASS
+
+// Flat arrays of the dynamic bodies an integrator moves, shared by BodyIntegrator and AdaptiveIntegrator so both read
+// and write the bodies the same way. Real is the type the state is carried in. Forces applied to a body before the
+// step are gathered with it as an acceleration, clearAccelerations then uses up what every actor holds
+template <class Real>
+class IntegratorBodies
+{
+
+protected:
+	IntegratorBodies();
+
+	void gatherBodies(const std::vector<PhysicsObject*>& bodies);
+	void scatterBodies(float time);
+	void clearAccelerations();
+
+	// Every actor, the generators work over these. Only valid during a step
+	const std::vector<PhysicsObject*>* m_actors;
+
+	std::vector<Rigidbody*> m_bodies;
+	std::vector<Rigidbody*> m_kinematicBodies;
+	std::vector<int> m_actorIndex;			// Where each body sits in the actors the generators see
+	std::vector<Real> m_positionX;
+	std::vector<Real> m_positionY;
+	std::vector<Real> m_velocityX;
+	std::vector<Real> m_velocityY;
+	std::vector<float> m_appliedAccelerationX;	// Forces applied before the step over mass, held for the whole step
+	std::vector<float> m_appliedAccelerationY;
+	std::vector<float> m_linearDrag;
+};
+
+//============================================================================================================================================
+// Constructors
+
+// Constructor
+template <class Real>
+IntegratorBodies<Real>::IntegratorBodies()
+{
+	m_actors = nullptr;
+}
+
+//============================================================================================================================================
+// Body Data
+
+// Gather Bodies, copies the dynamic bodies into the flat arrays along with whatever forces they hold
+template <class Real>
+void IntegratorBodies<Real>::gatherBodies(const std::vector<PhysicsObject*>& bodies)
+{
+	m_bodies.clear();
+	m_kinematicBodies.clear();
+	m_actorIndex.clear();
+	m_positionX.clear();
+	m_positionY.clear();
+	m_velocityX.clear();
+	m_velocityY.clear();
+	m_appliedAccelerationX.clear();
+	m_appliedAccelerationY.clear();
+	m_linearDrag.clear();
+
+	// Bodies are found in the actors so the generators can be told which ones they're working for
+	int actorIndex = 0;
+	int actorCount = m_actors->size();
+	for (auto pActor : bodies)
+	{
+		if (pActor->isStatic() || pActor->getShapeID() == PLANE)
+		{
+			continue;
+		}
+
+		Rigidbody* body = static_cast<Rigidbody*>(pActor);
+		if (body->isKinematic())
+		{
+			m_kinematicBodies.push_back(body);
+			continue;
+		}
+
+		// bodies is the actors or a subset in the same order
+		while (actorIndex < actorCount && (*m_actors)[actorIndex] != pActor)
+		{
+			actorIndex++;
+		}
+
+		glm::vec2 position = body->getPosition();
+		glm::vec2 velocity = body->getVelocity();
+		glm::vec2 applied = body->getAcceleration();
+		m_bodies.push_back(body);
+		m_actorIndex.push_back(actorIndex);
+		m_positionX.push_back(position.x);
+		m_positionY.push_back(position.y);
+		m_velocityX.push_back(velocity.x);
+		m_velocityY.push_back(velocity.y);
+		m_appliedAccelerationX.push_back(applied.x);
+		m_appliedAccelerationY.push_back(applied.y);
+		m_linearDrag.push_back(body->getLinearDrag());
+	}
+}
+
+// Scatter Bodies, writes the results back and lets slow bodies come to rest as Rigidbody::fixedUpdate does. Kinematic
+// bodies move on by their velocity over the time given
+template <class Real>
+void IntegratorBodies<Real>::scatterBodies(float time)
+{
+	int bodyCount = m_bodies.size();
+	for (int i = 0; i < bodyCount; i++)
+	{
+		Rigidbody* body = m_bodies[i];
+		glm::vec2 velocity((float)m_velocityX[i], (float)m_velocityY[i]);
+		if (glm::length(velocity) < body->getMinLinearDrag())
+		{
+			velocity = glm::vec2(0, 0);
+		}
+		body->setPosition(glm::vec2((float)m_positionX[i], (float)m_positionY[i]));
+		body->setVelocity(velocity);
+	}
+
+	for (auto pBody : m_kinematicBodies)
+	{
+		pBody->setPosition(pBody->getPosition() + (pBody->getVelocity() * time));
+	}
+}
+
+// Clear Accelerations, forces applied to any actor are used up by the pass that applied them
+template <class Real>
+void IntegratorBodies<Real>::clearAccelerations()
+{
+	for (auto pActor : *m_actors)
+	{
+		if (pActor->getShapeID() != PLANE)
+		{
+			static_cast<Rigidbody*>(pActor)->setAcceleration(glm::vec2(0, 0));
+		}
+	}
+}
\ No newline at end of file
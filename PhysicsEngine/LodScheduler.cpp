@@ -0,0 +1,241 @@
+// Include .h files
+#include "LodScheduler.h"
+#include "RigidBody.h"
+#include "ConstraintSolver.h"
+
+// Other includes
+#include <cfloat>
+#include <cmath>
+
+// Typedefs
+
+static const float DEFAULT_NEAR_DISTANCE = 50.0f;
+static const float DEFAULT_FAR_DISTANCE = 150.0f;
+static const float DEFAULT_HYSTERESIS = 5.0f;
+
+// Furthest a body may travel in one long step, as a fraction of its smallest half size
+static const float MAX_TRAVEL_FRACTION = 0.5f;
+
+//============================================================================================================================================
+// Constructors
+
+// Constructor
+LodScheduler::LodScheduler()
+{
+	m_nearDistance = DEFAULT_NEAR_DISTANCE;
+	m_farDistance = DEFAULT_FAR_DISTANCE;
+	m_hysteresis = DEFAULT_HYSTERESIS;
+	m_stepIndex = 0;
+	m_integrations = 0;
+	m_fullRateIntegrations = 0;
+	m_promotions = 0;
+	m_awakeCount = 0;
+	for (int tier = 0; tier < LOD_TIER_COUNT; tier++)
+	{
+		m_tierCounts[tier] = 0;
+	}
+}
+
+//============================================================================================================================================
+// Focus Points
+
+// Add Focus
+int LodScheduler::addFocus(glm::vec2 point)
+{
+	m_focusPoints.push_back(point);
+	return m_focusPoints.size() - 1;
+}
+
+//============================================================================================================================================
+// Scheduling
+
+// Step
+void LodScheduler::step(const std::vector<PhysicsObject*>& actors, glm::vec2 gravity, float timeStep, const ConstraintSolver& constraints)
+{
+	syncBodies(actors);
+	m_stepIndex++;
+
+	bool constrained = constraints.getConstraintCount() > 0;
+	int bodyCount = m_bodies.size();
+	m_awakeCount = 0;
+	for (int tier = 0; tier < LOD_TIER_COUNT; tier++)
+	{
+		m_tierCounts[tier] = 0;
+	}
+
+	for (int i = 0; i < bodyCount; i++)
+	{
+		Rigidbody* body = static_cast<Rigidbody*>(m_bodies[i]);
+		m_missedSteps[i]++;
+
+		int tier = (constrained && constraints.hasBody(body)) ? 0 : chooseTier(i, timeStep);
+		if (tier < m_tiers[i])
+		{
+			m_promotions++;
+		}
+		m_tiers[i] = tier;
+		m_contactTiers[i] = LOD_TIER_COUNT - 1;
+		m_tierCounts[tier]++;
+
+		// A tier steps on multiples of its period, a body just promoted to a faster tier is due at once
+		int period = 1 << tier;
+		bool due = (m_stepIndex % period) == 0 || m_missedSteps[i] > period;
+		m_awake[i] = due;
+		m_moved[i] = due || m_touched[i];
+		m_touched[i] = 0;
+		if (!due)
+		{
+			continue;
+		}
+
+		// Forces were applied on every missed step, the average acts over the whole long step
+		int missedSteps = m_missedSteps[i];
+		if (missedSteps > 1)
+		{
+			body->setAcceleration(body->getAcceleration() / (float)missedSteps);
+		}
+		body->fixedUpdate(gravity, timeStep * missedSteps);
+		m_missedSteps[i] = 0;
+		m_integrations++;
+		m_awakeCount++;
+	}
+	m_fullRateIntegrations += bodyCount;
+}
+
+// Promote Contacts
+void LodScheduler::promoteContacts(const std::vector<CollisionPair>& pairs)
+{
+	for (auto& pair : pairs)
+	{
+		auto found1 = m_bodyIndices.find(pair.first);
+		auto found2 = m_bodyIndices.find(pair.second);
+		if (found1 == m_bodyIndices.end() || found2 == m_bodyIndices.end())
+		{
+			continue;
+		}
+
+		// Both end up no slower than the faster of the two
+		int body1 = found1->second;
+		int body2 = found2->second;
+		char fastest = glm::min(m_tiers[body1], m_tiers[body2]);
+		m_contactTiers[body1] = glm::min(m_contactTiers[body1], fastest);
+		m_contactTiers[body2] = glm::min(m_contactTiers[body2], fastest);
+		m_touched[body1] = 1;
+		m_touched[body2] = 1;
+	}
+}
+
+// Reset
+void LodScheduler::reset()
+{
+	m_bodies.clear();
+	m_tiers.clear();
+	m_contactTiers.clear();
+	m_missedSteps.clear();
+	m_awake.clear();
+	m_moved.clear();
+	m_touched.clear();
+	m_bodyIndices.clear();
+}
+
+// Is Awake
+bool LodScheduler::isAwake(PhysicsObject* body) const
+{
+	auto found = m_bodyIndices.find(body);
+	return (found != m_bodyIndices.end()) && m_awake[found->second];
+}
+
+// Sync Bodies, keeps each body's state lined up with its index when actors are added or removed
+void LodScheduler::syncBodies(const std::vector<PhysicsObject*>& actors)
+{
+	int actorCount = actors.size();
+	bool changed = (actorCount != (int)m_bodies.size());
+	for (int i = 0; i < actorCount && !changed; i++)
+	{
+		changed = (actors[i] != m_bodies[i]);
+	}
+	if (!changed)
+	{
+		return;
+	}
+
+	// Bodies already known keep their tier and the steps they are owed, new ones start at full rate
+	std::vector<char> tiers(actorCount, 0);
+	std::vector<char> contactTiers(actorCount, 0);
+	std::vector<int> missedSteps(actorCount, 0);
+	for (int i = 0; i < actorCount; i++)
+	{
+		auto found = m_bodyIndices.find(actors[i]);
+		if (found != m_bodyIndices.end())
+		{
+			tiers[i] = m_tiers[found->second];
+			contactTiers[i] = m_contactTiers[found->second];
+			missedSteps[i] = m_missedSteps[found->second];
+		}
+	}
+
+	m_bodies = actors;
+	m_tiers.swap(tiers);
+	m_contactTiers.swap(contactTiers);
+	m_missedSteps.swap(missedSteps);
+	m_awake.assign(actorCount, 1);
+	m_moved.assign(actorCount, 1);
+	m_touched.assign(actorCount, 1);
+	m_bodyIndices.clear();
+	for (int i = 0; i < actorCount; i++)
+	{
+		m_bodyIndices[actors[i]] = i;
+	}
+}
+
+// Choose Tier
+int LodScheduler::chooseTier(int body, float timeStep) const
+{
+	Rigidbody* rigidbody = static_cast<Rigidbody*>(m_bodies[body]);
+
+	// Without a focus point there is nothing to be far from
+	if (m_focusPoints.empty())
+	{
+		return 0;
+	}
+	float distanceSquared = FLT_MAX;
+	for (auto& point : m_focusPoints)
+	{
+		glm::vec2 offset = rigidbody->getPosition() - point;
+		distanceSquared = glm::min(distanceSquared, glm::dot(offset, offset));
+	}
+	float distance = std::sqrt(distanceSquared);
+
+	// Slower only once well clear of the boundary, faster straight away
+	int tier = getDistanceTier(distance);
+	if (tier > m_tiers[body])
+	{
+		tier = glm::max((int)m_tiers[body], getDistanceTier(distance - m_hysteresis));
+	}
+	tier = glm::min(tier, (int)m_contactTiers[body]);
+
+	// Never so slow that one long step could carry the body through something its own size
+	glm::vec2 boundsMin;
+	glm::vec2 boundsMax;
+	if (tier > 0 && BroadPhase::getActorBounds(rigidbody, boundsMin, boundsMax))
+	{
+		glm::vec2 halfSize = (boundsMax - boundsMin) * 0.5f;
+		float maxTravel = glm::min(halfSize.x, halfSize.y) * MAX_TRAVEL_FRACTION;
+		float speed = glm::length(rigidbody->getVelocity());
+		while (tier > 0 && speed * timeStep * (float)(1 << tier) > maxTravel)
+		{
+			tier--;
+		}
+	}
+	return tier;
+}
+
+// Get Distance Tier
+int LodScheduler::getDistanceTier(float distance) const
+{
+	if (distance < m_nearDistance)
+	{
+		return 0;
+	}
+	return (distance < m_farDistance) ? 1 : 2;
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+#pragma once
+// Include .h files
+#include "PhysicsObject.h"
+#include "BroadPhase.h"
+
+// Other includes
+#include <vector>
+#include <unordered_map>
+#include <glm\vec2.hpp>
+#include <glm\glm.hpp>
+
+// Typedefs
+
+// Tier 0 steps every fixed step, tier 1 every 2nd and tier 2 every 4th
+static const int LOD_TIER_COUNT = 3;
+
+//============================================================================================================================================
+// LodScheduler CLASS
+
+// Steps bodies far from the points of interest (the camera, the players) less often. Each body is put in a rate tier by
+// its distance to the nearest focus point, and a tier only steps when the scene's step count is a multiple of its
+// period, so bodies in the same tier step together. A body keeps count of the steps it has missed and integrates all of
+// them when it is next due, with the forces applied in between averaged, so no body ever gains or loses time. Only the
+// bodies due this step go through the pair search and the plane pass, which is where most of the saving comes from.
+// Tiers are only ever slower than they are safe to be: a body moves to a slower tier once it is clear of the boundary
+// by the hysteresis, drops to a faster one straight away, never travels more than half its size in one long step, and
+// anything touching a body in a faster tier joins that tier for the next step. Constrained bodies always step.
+// Used for the semi-implicit Euler path in impulse mode, see PhysicsScene::setLodScheduling
+class LodScheduler
+{
+
+public:
+	LodScheduler();
+
+	// Integrates the bodies due this step and marks them awake, call once per fixed step
+	void step(const std::vector<PhysicsObject*>& actors, glm::vec2 gravity, float timeStep, const class ConstraintSolver& constraints);
+
+	// Bodies paired with a body in a faster tier join its tier next step
+	void promoteContacts(const std::vector<CollisionPair>& pairs);
+
+	// Forgets every body's tier, they all start again at full rate
+	void reset();
+
+	//============================================================================================================================================
+	// Focus Points
+
+	int addFocus(glm::vec2 point);
+	void setFocus(int focus, glm::vec2 point) { m_focusPoints[focus] = point; }
+	void clearFocus() { m_focusPoints.clear(); }
+
+	//============================================================================================================================================
+	// Getters and Setters
+
+	// Closer than near steps every step, closer than far every 2nd, the rest every 4th
+	void setTierDistances(float nearDistance, float farDistance) { m_nearDistance = nearDistance; m_farDistance = farDistance; }
+	float getNearDistance() const { return m_nearDistance; }
+	float getFarDistance() const { return m_farDistance; }
+
+	// How far past a boundary a body has to be before it moves to the slower tier
+	void setHysteresis(float hysteresis) { m_hysteresis = hysteresis; }
+	float getHysteresis() const { return m_hysteresis; }
+
+	// One per actor in the order they were passed to step, non-zero for bodies integrated this step
+	const std::vector<char>& getAwake() const { return m_awake; }
+	bool isAwake(PhysicsObject* body) const;	// False for static colliders and bodies the scheduler hasn't seen
+
+	// Bodies that may have moved since the last step, the awake ones and any a contact pushed
+	const std::vector<char>& getMoved() const { return m_moved; }
+
+	// Work done against what stepping every body every step would have done, since the scheduler was made
+	long long getIntegrationCount() const { return m_integrations; }
+	long long getFullRateIntegrationCount() const { return m_fullRateIntegrations; }
+	long long getPromotionCount() const { return m_promotions; }
+
+	// Bodies in each tier and bodies integrated on the last step
+	int getTierCount(int tier) const { return m_tierCounts[tier]; }
+	int getAwakeCount() const { return m_awakeCount; }
+
+protected:
+	void syncBodies(const std::vector<PhysicsObject*>& actors);
+	int chooseTier(int body, float timeStep) const;
+	int getDistanceTier(float distance) const;
+
+	std::vector<glm::vec2> m_focusPoints;
+	float m_nearDistance;
+	float m_farDistance;
+	float m_hysteresis;
+	long long m_stepIndex;
+
+	//============================================================================================================================================
+	// Bodies, same order as the actors
+
+	std::vector<PhysicsObject*> m_bodies;
+	std::vector<char> m_tiers;
+	std::vector<char> m_contactTiers;	// Fastest tier a contact asked for this step
+	std::vector<int> m_missedSteps;		// Steps since the body was last integrated
+	std::vector<char> m_awake;
+	std::vector<char> m_moved;
+	std::vector<char> m_touched;		// In a pair last step, so separation may have moved it
+	std::unordered_map<PhysicsObject*, int> m_bodyIndices;
+
+	long long m_integrations;
+	long long m_fullRateIntegrations;
+	long long m_promotions;
+	int m_tierCounts[LOD_TIER_COUNT];
+	int m_awakeCount;
+};
\ No newline at end of file
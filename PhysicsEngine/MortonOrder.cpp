@@ -0,0 +1,260 @@
+// Include .h files
+#include "MortonOrder.h"
+#include "BroadPhase.h"
+
+// Other includes
+#include <cmath>
+#include <omp.h>
+
+// Typedefs
+
+static const int DEFAULT_INTERVAL = 500;
+static const float DEFAULT_TOLERANCE = 2.0f;
+
+// REORDER_LOCALITY only measures the spacing every so often, it touches every body
+static const int LOCALITY_CHECK_INTERVAL = 16;
+
+// Radix sort a byte a pass over the 32 bit keys
+static const int RADIX_BITS = 8;
+static const int RADIX_SIZE = 1 << RADIX_BITS;
+static const int KEY_BITS = 32;
+
+// Smaller lists are sorted on one thread, starting the team costs more than it saves
+static const int PARALLEL_SORT_THRESHOLD = 8192;
+
+// Centres are quantized to this many steps a side, 16 bits each interleave into one 32 bit key
+static const float QUANTIZE_RANGE = 65535.0f;
+
+//============================================================================================================================================
+// Constructors
+
+// Constructor
+MortonOrder::MortonOrder()
+{
+	m_trigger = REORDER_NEVER;
+	m_interval = DEFAULT_INTERVAL;
+	m_tolerance = DEFAULT_TOLERANCE;
+	m_stepsSinceSort = 0;
+	m_sortCount = 0;
+	m_sortedSpacing = 0.0f;
+	m_lastSpacing = 0.0f;
+}
+
+//============================================================================================================================================
+// Reordering
+
+// Update
+bool MortonOrder::update(std::vector<PhysicsObject*>& actors)
+{
+	m_stepsSinceSort++;
+	switch (m_trigger)
+	{
+	case REORDER_INTERVAL:
+		if (m_stepsSinceSort < m_interval)
+		{
+			return false;
+		}
+		break;
+	case REORDER_LOCALITY:
+		if ((m_stepsSinceSort % LOCALITY_CHECK_INTERVAL) != 0)
+		{
+			return false;
+		}
+		// Nothing sorted yet counts as drifted, after that only a real loss of locality does
+		m_lastSpacing = measureSpacing(actors);
+		if (m_sortCount > 0 && m_lastSpacing <= m_sortedSpacing * m_tolerance)
+		{
+			return false;
+		}
+		break;
+	default:
+		return false;
+	}
+	return reorder(actors);
+}
+
+// Reorder
+bool MortonOrder::reorder(std::vector<PhysicsObject*>& actors)
+{
+	m_stepsSinceSort = 0;
+	m_sortCount++;
+
+	computeKeys(actors);
+	sortKeys();
+
+	// Permute the pointers, noting whether anything actually moved
+	int actorCount = actors.size();
+	bool changed = false;
+	m_sorted.resize(actorCount);
+	for (int i = 0; i < actorCount; i++)
+	{
+		m_sorted[i] = actors[m_indices[i]];
+		changed = changed || (m_indices[i] != i);
+	}
+	if (changed)
+	{
+		actors.swap(m_sorted);
+	}
+
+	m_sortedSpacing = measureSpacing(actors);
+	m_lastSpacing = m_sortedSpacing;
+	return changed;
+}
+
+// Measure Spacing
+float MortonOrder::measureSpacing(const std::vector<PhysicsObject*>& actors)
+{
+	double total = 0.0;
+	int count = 0;
+	glm::vec2 previous(0, 0);
+	bool first = true;
+	for (auto pActor : actors)
+	{
+		glm::vec2 boundsMin;
+		glm::vec2 boundsMax;
+		if (!BroadPhase::getActorBounds(pActor, boundsMin, boundsMax))
+		{
+			continue;
+		}
+
+		glm::vec2 centre = (boundsMin + boundsMax) * 0.5f;
+		if (!first)
+		{
+			total += glm::length(centre - previous);
+			count++;
+		}
+		previous = centre;
+		first = false;
+	}
+	return (count > 0) ? (float)(total / count) : 0.0f;
+}
+
+//============================================================================================================================================
+// Keys
+
+// Compute Keys, the Morton code of every body's centre inside the bounds of all the centres
+void MortonOrder::computeKeys(const std::vector<PhysicsObject*>& actors)
+{
+	int actorCount = actors.size();
+	m_keys.resize(actorCount);
+	m_indices.resize(actorCount);
+
+	// Centres first, the bounds have to be known before any of them can be quantized
+	std::vector<glm::vec2> centres(actorCount);
+	std::vector<char> valid(actorCount, 0);
+	glm::vec2 boundsMin(0, 0);
+	glm::vec2 boundsMax(0, 0);
+	bool first = true;
+	for (int i = 0; i < actorCount; i++)
+	{
+		glm::vec2 min;
+		glm::vec2 max;
+		if (!BroadPhase::getActorBounds(actors[i], min, max))
+		{
+			continue;
+		}
+
+		// Bodies that have blown up go to the end of the list rather than stretching the bounds
+		glm::vec2 centre = (min + max) * 0.5f;
+		if (!(std::isfinite(centre.x) && std::isfinite(centre.y)))
+		{
+			continue;
+		}
+
+		centres[i] = centre;
+		valid[i] = 1;
+		boundsMin = first ? centre : glm::min(boundsMin, centre);
+		boundsMax = first ? centre : glm::max(boundsMax, centre);
+		first = false;
+	}
+
+	// One scale for both axes keeps the cells square, so the Z-order curve doesn't favour one direction
+	glm::vec2 size = boundsMax - boundsMin;
+	float scale = QUANTIZE_RANGE / glm::max(glm::max(size.x, size.y), 0.0001f);
+	for (int i = 0; i < actorCount; i++)
+	{
+		m_indices[i] = i;
+		if (!valid[i])
+		{
+			m_keys[i] = 0xFFFFFFFFu;
+			continue;
+		}
+
+		glm::vec2 cell = glm::clamp((centres[i] - boundsMin) * scale, glm::vec2(0, 0), glm::vec2(QUANTIZE_RANGE, QUANTIZE_RANGE));
+		m_keys[i] = spreadBits((unsigned int)cell.x) | (spreadBits((unsigned int)cell.y) << 1);
+	}
+}
+
+// Spread Bits, puts a zero between each of the low 16 bits so two of them interleave
+unsigned int MortonOrder::spreadBits(unsigned int value)
+{
+	value &= 0x0000FFFFu;
+	value = (value | (value << 8)) & 0x00FF00FFu;
+	value = (value | (value << 4)) & 0x0F0F0F0Fu;
+	value = (value | (value << 2)) & 0x33333333u;
+	value = (value | (value << 1)) & 0x55555555u;
+	return value;
+}
+
+// Sort Keys, LSD radix sort of the keys and their indices. Each thread counts its own slice, the counts are turned into
+// offsets digit by digit and thread by thread, then each thread scatters its slice in order, so the sort stays stable
+void MortonOrder::sortKeys()
+{
+	int count = m_keys.size();
+	int maxThreads = omp_get_max_threads();
+	m_spareKeys.resize(count);
+	m_spareIndices.resize(count);
+	m_histograms.resize(maxThreads * RADIX_SIZE);
+
+	for (int shift = 0; shift < KEY_BITS; shift += RADIX_BITS)
+	{
+		const unsigned int* keys = m_keys.data();
+		const int* indices = m_indices.data();
+		unsigned int* sortedKeys = m_spareKeys.data();
+		int* sortedIndices = m_spareIndices.data();
+		int* histograms = m_histograms.data();
+
+#pragma omp parallel if (count >= PARALLEL_SORT_THRESHOLD)
+		{
+			int threadCount = omp_get_num_threads();
+			int thread = omp_get_thread_num();
+			int begin = (int)(((long long)count * thread) / threadCount);
+			int end = (int)(((long long)count * (thread + 1)) / threadCount);
+
+			int* histogram = histograms + (thread * RADIX_SIZE);
+			for (int digit = 0; digit < RADIX_SIZE; digit++)
+			{
+				histogram[digit] = 0;
+			}
+			for (int i = begin; i < end; i++)
+			{
+				histogram[(keys[i] >> shift) & (RADIX_SIZE - 1)]++;
+			}
+
+#pragma omp barrier
+#pragma omp single
+			{
+				int offset = 0;
+				for (int digit = 0; digit < RADIX_SIZE; digit++)
+				{
+					for (int other = 0; other < threadCount; other++)
+					{
+						int digitCount = histograms[(other * RADIX_SIZE) + digit];
+						histograms[(other * RADIX_SIZE) + digit] = offset;
+						offset += digitCount;
+					}
+				}
+			}
+
+			for (int i = begin; i < end; i++)
+			{
+				int slot = histogram[(keys[i] >> shift) & (RADIX_SIZE - 1)]++;
+				sortedKeys[slot] = keys[i];
+				sortedIndices[slot] = indices[i];
+			}
+		}
+
+		m_keys.swap(m_spareKeys);
+		m_indices.swap(m_spareIndices);
+	}
+}
\ No newline at end of file
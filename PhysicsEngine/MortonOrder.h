@@ -0,0 +1,86 @@
+#pragma once
+// Include .h files
+#include "PhysicsObject.h"
+
+// Other includes
+#include <vector>
+#include <glm\vec2.hpp>
+#include <glm\glm.hpp>
+
+// Typedefs
+
+//============================================================================================================================================
+// ReorderTrigger ENUM
+
+enum ReorderTrigger
+{
+	REORDER_NEVER,		// Bodies stay in the order they were added
+	REORDER_INTERVAL,	// Sort every set number of steps
+	REORDER_LOCALITY	// Sort once bodies next to each other in the list have drifted too far apart in space
+};
+
+//============================================================================================================================================
+// MortonOrder CLASS
+
+// Keeps the scene's bodies in Z-order so bodies close in space sit close in the actor list. The broadphase proxies, the
+// plane pass arrays and the pairs all follow the actor order, so once it matches space the grid's cell lists and the
+// pairs walk nearby memory instead of jumping across the whole body set. Each body's centre is quantized to 16 bits a
+// side and the bits interleaved into a 32 bit Morton code, then the list is sorted by a parallel LSD radix sort, a byte
+// a pass, with a histogram per thread so the scatter needs no locks and stays stable.
+// Only the pointers move. Bodies stay where they were allocated, so anything holding a PhysicsObject* is unaffected;
+// only per-index state (Verlet lists, adaptive step levels) is rebuilt. Locality is measured as the mean distance
+// between bodies next to each other in the list, against what it was just after the last sort
+class MortonOrder
+{
+
+public:
+	MortonOrder();
+
+	// Counts a step and sorts the actors if the trigger says so, returns true if the order changed
+	bool update(std::vector<PhysicsObject*>& actors);
+
+	// Sorts the actors into Z-order now, returns true if the order changed
+	bool reorder(std::vector<PhysicsObject*>& actors);
+
+	// Mean distance between each body and the next one in the list
+	static float measureSpacing(const std::vector<PhysicsObject*>& actors);
+
+	//============================================================================================================================================
+	// Getters and Setters
+
+	void setTrigger(ReorderTrigger trigger) { m_trigger = trigger; m_stepsSinceSort = 0; }
+	ReorderTrigger getTrigger() const { return m_trigger; }
+
+	// Steps between sorts for REORDER_INTERVAL
+	void setInterval(int interval) { m_interval = interval; }
+	int getInterval() const { return m_interval; }
+
+	// REORDER_LOCALITY sorts once the spacing grows past this multiple of the spacing just after the last sort
+	void setTolerance(float tolerance) { m_tolerance = tolerance; }
+	float getTolerance() const { return m_tolerance; }
+
+	float getSortedSpacing() const { return m_sortedSpacing; }
+	float getLastSpacing() const { return m_lastSpacing; }
+	int getSortCount() const { return m_sortCount; }
+
+protected:
+	void computeKeys(const std::vector<PhysicsObject*>& actors);
+	void sortKeys();
+	static unsigned int spreadBits(unsigned int value);
+
+	ReorderTrigger m_trigger;
+	int m_interval;
+	float m_tolerance;
+	int m_stepsSinceSort;
+	int m_sortCount;
+	float m_sortedSpacing;
+	float m_lastSpacing;
+
+	// Morton code and actor index for every body, sorted in place by ping-ponging with the spare pair
+	std::vector<unsigned int> m_keys;
+	std::vector<int> m_indices;
+	std::vector<unsigned int> m_spareKeys;
+	std::vector<int> m_spareIndices;
+	std::vector<int> m_histograms;	// One set of buckets per thread
+	std::vector<PhysicsObject*> m_sorted;
+};
\ No newline at end of file
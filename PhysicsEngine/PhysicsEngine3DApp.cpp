@@ -0,0 +1,150 @@
+// Include .h files
+#include "PhysicsEngine3DApp.h"
+#include "Input.h"
+#include "Sphere.h"
+#include "Plane.h"
+#include "AABB.h"
+
+// Other includes
+#include <Gizmos.h>
+#include <glm\ext.hpp>
+#include <glm\glm.hpp>
+
+// Typedefs
+typedef BasicSphere<float, 3> Sphere3D;
+typedef BasicAABB<float, 3> AABB3D;
+typedef BasicPlane<float, 3> Plane3D;
+
+// Half the width of the box the bodies are dropped into, its floor is at y = 0
+static const float BOX_HALF_SIZE = 10.0f;
+static const int BOX_BODY_COUNT = 400;
+
+//============================================================================================================================================
+// Constructors
+
+// Constructor
+PhysicsEngine3DApp::PhysicsEngine3DApp()
+{
+	m_physicsScene = nullptr;
+}
+
+// Deconstructor
+PhysicsEngine3DApp::~PhysicsEngine3DApp()
+{
+}
+
+//============================================================================================================================================
+// Startup and Shutdown
+
+// Startup
+bool PhysicsEngine3DApp::startup()
+{
+	setBackgroundColour(0.25f, 0.25f, 0.25f);
+
+	// Spheres are the bulk of the triangles, 8 by 8 segments each
+	aie::Gizmos::create(10000U, 65535U, 255U, 255U);
+
+	m_projectionMatrix = glm::perspective(glm::pi<float>() * 0.25f, getWindowWidth() / (float)getWindowHeight(), 0.1f, 1000.0f);
+
+	setupBoxDemo(BOX_BODY_COUNT);
+	return true;
+}
+
+// Shutdown
+void PhysicsEngine3DApp::shutdown()
+{
+	delete m_physicsScene;
+	aie::Gizmos::destroy();
+}
+
+//============================================================================================================================================
+// Demo Setup
+
+// Setup Box Demo, a grid of bodies dropped into an open topped box
+void PhysicsEngine3DApp::setupBoxDemo(int bodyCount)
+{
+	delete m_physicsScene;
+	m_physicsScene = new BasicPhysicsScene<float, 3>();
+	m_physicsScene->setGravity(glm::vec3(0, -10, 0));
+	m_physicsScene->setTimeStep(0.01f);
+
+	// Floor and four walls
+	glm::vec4 white(1, 1, 1, 1);
+	m_physicsScene->addActor(new Plane3D(glm::vec3(0, 1, 0), 0.0f, white));
+	m_physicsScene->addActor(new Plane3D(glm::vec3(1, 0, 0), -BOX_HALF_SIZE, white));
+	m_physicsScene->addActor(new Plane3D(glm::vec3(-1, 0, 0), -BOX_HALF_SIZE, white));
+	m_physicsScene->addActor(new Plane3D(glm::vec3(0, 0, 1), -BOX_HALF_SIZE, white));
+	m_physicsScene->addActor(new Plane3D(glm::vec3(0, 0, -1), -BOX_HALF_SIZE, white));
+
+	// Layers of 8 by 8, nudged sideways so the stack topples rather than balancing
+	for (int body = 0; body < bodyCount; body++)
+	{
+		int column = body % 8;
+		int row = (body / 8) % 8;
+		int layer = body / 64;
+		glm::vec3 position(-7.0f + column * 2.0f + layer * 0.1f, 2.0f + layer * 2.5f, -7.0f + row * 2.0f - layer * 0.1f);
+		glm::vec3 velocity((float)(row - 4), 0.0f, (float)(column - 4));
+		if ((column + row + layer) % 2 == 0)
+		{
+			m_physicsScene->addActor(new Sphere3D(position, velocity, glm::vec3(0), 1.0f, 0.8f, 0.6f, glm::vec4(1, 0, 0, 1)));
+		}
+		else
+		{
+			m_physicsScene->addActor(new AABB3D(position, velocity, glm::vec3(0), glm::vec3(0.7f, 0.5f, 0.7f), 1.0f, 0.6f, glm::vec4(0, 0.5f, 1, 1)));
+		}
+	}
+}
+
+//============================================================================================================================================
+// Update Function
+
+// Update
+void PhysicsEngine3DApp::update(float deltaTime)
+{
+	aie::Input* input = aie::Input::getInstance();
+
+	// Slowly circle the box
+	float time = getTime() * 0.2f;
+	m_viewMatrix = glm::lookAt(glm::vec3(glm::sin(time) * 30, 20, glm::cos(time) * 30), glm::vec3(0, 4, 0), glm::vec3(0, 1, 0));
+
+	aie::Gizmos::clear();
+
+	m_physicsScene->update(deltaTime);
+
+	// Outline of the floor
+	glm::vec4 white(1);
+	glm::vec3 corners[4] = { glm::vec3(-BOX_HALF_SIZE, 0, -BOX_HALF_SIZE), glm::vec3(BOX_HALF_SIZE, 0, -BOX_HALF_SIZE),
+							 glm::vec3(BOX_HALF_SIZE, 0, BOX_HALF_SIZE), glm::vec3(-BOX_HALF_SIZE, 0, BOX_HALF_SIZE) };
+	for (int i = 0; i < 4; i++)
+	{
+		aie::Gizmos::addLine(corners[i], corners[(i + 1) % 4], white);
+		aie::Gizmos::addLine(corners[i], corners[i] + glm::vec3(0, BOX_HALF_SIZE, 0), white);
+	}
+
+	// Bodies
+	m_physicsScene->updateGizmos();
+
+	if (input->wasKeyPressed(aie::INPUT_KEY_R))
+	{
+		setupBoxDemo(BOX_BODY_COUNT);
+	}
+
+	// exit the application
+	if (input->isKeyDown(aie::INPUT_KEY_ESCAPE))
+		quit();
+}
+
+//============================================================================================================================================
+// Draw Function
+
+// Draw
+void PhysicsEngine3DApp::draw()
+{
+	// wipe the screen to the background colour
+	clearScreen();
+
+	// update perspective in case window resized
+	m_projectionMatrix = glm::perspective(glm::pi<float>() * 0.25f, getWindowWidth() / (float)getWindowHeight(), 0.1f, 1000.0f);
+
+	aie::Gizmos::draw(m_projectionMatrix * m_viewMatrix);
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+// Include .h files
+#include "Application.h"
+#include "BasicPhysicsScene.h"
+
+// Other includes
+#include <glm\glm.hpp>
+
+// Typedefs
+
+//============================================================================================================================================
+// PhysicsEngine3DApp CLASS
+
+// The engine's core, BasicPhysicsScene and its bodies, run in 3D, a box of Spheres and AABBs under gravity drawn with 3D gizmos. Started
+// with --3d on the command line. R drops the bodies again
+class PhysicsEngine3DApp : public aie::Application {
+public:
+
+	PhysicsEngine3DApp();
+	virtual ~PhysicsEngine3DApp();
+
+	virtual bool startup();
+	virtual void shutdown();
+
+	virtual void update(float deltaTime);
+	virtual void draw();
+
+	void setupBoxDemo(int bodyCount);
+
+protected:
+
+	//============================================================================================================================================
+	// Physics Scene
+
+	BasicPhysicsScene<float, 3>* m_physicsScene;
+
+	//============================================================================================================================================
+	// Camera
+
+	glm::mat4 m_viewMatrix;
+	glm::mat4 m_projectionMatrix;
+};
\ No newline at end of file
@@ -6,6 +6,9 @@
 #include "Sphere.h"
 #include "Plane.h"
 #include "AABB.h"
+#include "BarnesHut.h"
+#include "TrajectoryPredictor.h"
+#include "SdfCollider.h"
 
 // Other includes
 #include <Gizmos.h>
@@ -20,6 +23,9 @@
 // Constructor
 PhysicsEngineApp::PhysicsEngineApp()
 {
+	m_pickedBody = nullptr;
+	m_eventScene = nullptr;
+	m_tiledWorld = nullptr;
 }
 
 // Deconstructor
@@ -69,6 +75,13 @@ bool PhysicsEngineApp::startup()
 	m_physicsScene->addActor(collAABB2);
 
 	//setupContinuousDemo(glm::vec2(-100, -50), 3.14 * 0.33, 25, -10);
+	//setupOrbitDemo(20000);
+	//setupFluidDemo();
+	//setupClothDemo(30, 20);
+	//setupGranularDemo(3000);
+	//setupGasDemo(2000);
+	//setupTiledWorldDemo(1000000);
+	//setupFunnelDemo(150);
 
 	return true;
 }
@@ -78,6 +91,13 @@ void PhysicsEngineApp::shutdown()
 {
 	delete m_font;
 	delete m_2dRenderer;
+	delete m_eventScene;
+	if (m_tiledWorld != nullptr)
+	{
+		// The demo builds its world again on startup, so its tile files aren't kept
+		m_tiledWorld->discardAll();
+		delete m_tiledWorld;
+	}
 	delete collSphere1;
 	delete collSphere2;
 	delete collSphere3;
@@ -101,16 +121,230 @@ void PhysicsEngineApp::setupContinuousDemo(glm::vec2 startPos, float inclination
 
 	glm::vec2 velocity = glm::vec2(sin(inclination), cos(inclination)) * speed;
 
-	float x;
-	float y;
-
+	// Every sample comes from the closed form in one call
+	std::vector<float> times;
 	while (t <= 5)
 	{
-		x = velocity.x * t;
-		y = velocity.y * t + (0.5 * gravity * t * t);
-		aie::Gizmos::add2DCircle(glm::vec2(x, y), radius, segments, colour);
+		times.push_back(t);
 		t += tStep;
 	}
+
+	TrajectoryPredictor predictor;
+	predictor.setGravity(glm::vec2(0, gravity));
+	predictor.addBody(startPos, velocity);
+	std::vector<glm::vec2> positions(times.size());
+	predictor.predictPositions(times.data(), times.size(), positions.data());
+
+	for (auto position : positions)
+	{
+		aie::Gizmos::add2DCircle(position, radius, segments, colour);
+	}
+}
+
+//============================================================================================================================================
+// Setup Orbit Demo
+
+// Setup Orbit Demo, a rotating disc of bodies held together by Barnes-Hut gravity
+void PhysicsEngineApp::setupOrbitDemo(int bodyCount)
+{
+	float discRadius = 40.0f;
+	float strength = 0.05f;
+	float totalMass = (float)bodyCount;
+
+	for (int i = 0; i < bodyCount; i++)
+	{
+		// Spread the bodies over the disc and start each one on a roughly circular orbit
+		float angle = glm::linearRand(0.0f, glm::two_pi<float>());
+		float radius = discRadius * std::sqrt(glm::linearRand(0.01f, 1.0f));
+		glm::vec2 direction(std::cos(angle), std::sin(angle));
+		float enclosedMass = totalMass * (radius * radius) / (discRadius * discRadius);
+		float orbitSpeed = std::sqrt(strength * enclosedMass / radius);
+
+		Sphere* body = new Sphere(direction * radius, glm::vec2(-direction.y, direction.x) * orbitSpeed, glm::vec2(0, 0), 1.0f, 0.2f, 1.0f, glm::vec4(1, 1, 0, 1));
+		// Stars pass straight through each other, only gravity links them
+		body->setCollisionFilter(0x0002, 0x0000);
+		m_physicsScene->addActor(body);
+	}
+
+	m_physicsScene->addForceGenerator(new BarnesHut(GRAVITATION, strength, 0.5f, 0.5f));
+}
+
+//============================================================================================================================================
+// Setup Fluid Demo
+
+// Setup Fluid Demo, a block of water dropped into the box the Planes make
+void PhysicsEngineApp::setupFluidDemo()
+{
+	m_physicsScene->setGravity(glm::vec2(0, -10));
+
+	FluidSystem* fluid = new FluidSystem(1.0f, 1.0f, 0.5f);
+	fluid->addBlock(glm::vec2(-39, -39), glm::vec2(0, -10), glm::vec2(0, 0));
+	m_physicsScene->addFluid(fluid);
+}
+
+//============================================================================================================================================
+// Setup Cloth Demo
+
+// Setup Cloth Demo, a sheet of small Spheres hung from kinematic pins and held together by XPBD constraints
+void PhysicsEngineApp::setupClothDemo(int columns, int rows)
+{
+	m_physicsScene->setGravity(glm::vec2(0, -10));
+
+	float spacing = 2.0f;
+	glm::vec2 topLeft(-(columns - 1) * spacing * 0.5f, 35.0f);
+	std::vector<Sphere*> points(columns * rows);
+
+	for (int row = 0; row < rows; row++)
+	{
+		for (int column = 0; column < columns; column++)
+		{
+			Sphere* point = new Sphere(topLeft + glm::vec2(column * spacing, -row * spacing), glm::vec2(0, 0), glm::vec2(0, 0), 0.1f, 0.5f, 0.5f, glm::vec4(0, 1, 0, 1));
+			// The cloth's own points never collide with each other
+			point->setCollisionFilter(0x0001, 0xFFFFFFFF, -1);
+			// Pin every fifth point along the top edge
+			if (row == 0 && column % 5 == 0)
+			{
+				point->setBodyType(KINEMATIC_BODY);
+			}
+			m_physicsScene->addActor(point);
+			points[(row * columns) + column] = point;
+		}
+	}
+
+	// Structural edges along rows and columns, soft shear across the diagonals
+	for (int row = 0; row < rows; row++)
+	{
+		for (int column = 0; column < columns; column++)
+		{
+			Sphere* point = points[(row * columns) + column];
+			if (column + 1 < columns)
+			{
+				m_physicsScene->addDistanceConstraint(point, points[(row * columns) + column + 1]);
+			}
+			if (row + 1 < rows)
+			{
+				m_physicsScene->addDistanceConstraint(point, points[((row + 1) * columns) + column]);
+			}
+			if (column + 1 < columns && row + 1 < rows)
+			{
+				m_physicsScene->addDistanceConstraint(point, points[((row + 1) * columns) + column + 1], 0.001f);
+			}
+		}
+	}
+
+	m_physicsScene->getConstraints().setColor(glm::vec4(0, 1, 0, 1));
+}
+
+//============================================================================================================================================
+// Setup Granular Demo
+
+// Setup Granular Demo, a column of sand grains poured into the box the Planes make
+void PhysicsEngineApp::setupGranularDemo(int grainCount)
+{
+	m_physicsScene->setGravity(glm::vec2(0, -10));
+	m_physicsScene->setSceneMode(GRANULAR_MODE);
+
+	int columns = 40;
+	for (int i = 0; i < grainCount; i++)
+	{
+		glm::vec2 position(-20.0f + (i % columns) * 1.0f, -30.0f + (i / columns) * 1.0f);
+		m_physicsScene->addActor(new Sphere(position, glm::vec2(0, 0), glm::vec2(0, 0), 1.0f, glm::linearRand(0.4f, 0.48f), 0.5f, glm::vec4(1, 0.8f, 0.4f, 1)));
+	}
+}
+
+//============================================================================================================================================
+// Setup Gas Demo
+
+// Setup Gas Demo, an ideal gas of hard spheres in a box run by the event-driven scene
+void PhysicsEngineApp::setupGasDemo(int moleculeCount)
+{
+	m_eventScene = new EventDrivenScene(glm::vec2(-40, -40), glm::vec2(40, 40));
+	m_eventScene->addActor(new Plane(glm::vec2(0, 1), -40.0f, glm::vec4(1, 0, 1, 1)));
+	m_eventScene->addActor(new Plane(glm::vec2(0, -1), -40.0f, glm::vec4(1, 0, 1, 1)));
+	m_eventScene->addActor(new Plane(glm::vec2(1, 0), -40.0f, glm::vec4(1, 0, 1, 1)));
+	m_eventScene->addActor(new Plane(glm::vec2(-1, 0), -40.0f, glm::vec4(1, 0, 1, 1)));
+
+	// Molecules on a loose lattice so none start overlapping, all with random velocities and perfectly elastic
+	int columns = (int)std::ceil(std::sqrt((float)moleculeCount));
+	float spacing = 78.0f / columns;
+	for (int i = 0; i < moleculeCount; i++)
+	{
+		glm::vec2 position(-39.0f + ((i % columns) + 0.5f) * spacing, -39.0f + ((i / columns) + 0.5f) * spacing);
+		m_eventScene->addActor(new Sphere(position, glm::circularRand(20.0f), glm::vec2(0, 0), 1.0f, spacing * 0.3f, 1.0f, glm::vec4(0, 1, 1, 1)));
+	}
+}
+
+//============================================================================================================================================
+// Setup Tiled World Demo
+
+// Setup Tiled World Demo, a field of bricks far bigger than the screen that only comes to life round the mouse
+void PhysicsEngineApp::setupTiledWorldDemo(int brickCount)
+{
+	m_tiledWorld = new TiledWorld(m_physicsScene, 20.0f, "tiled_demo");
+
+	// Rows of bricks drifting slowly, the rest of the field stays frozen in its tile files
+	int columns = (int)std::ceil(std::sqrt((float)brickCount));
+	for (int i = 0; i < brickCount; i++)
+	{
+		glm::vec2 position(-35.0f + (i % columns) * 3.0f, -35.0f + (i / columns) * 3.0f);
+		m_tiledWorld->addAABB(position, glm::circularRand(2.0f), glm::vec2(1.0f, 0.5f), 1.0f, 0.8f, glm::vec4(1, 0.5f, 0, 1));
+	}
+	m_tiledWorld->freezeAll();
+	m_tiledWorld->addRegion(glm::vec2(0, 0), 30.0f);
+}
+
+//============================================================================================================================================
+// Setup Funnel Demo
+
+// Setup Funnel Demo, bodies poured through a curved funnel onto a ledge, the level one SdfCollider baked from polylines
+void PhysicsEngineApp::setupFunnelDemo(int bodyCount)
+{
+	m_physicsScene->setGravity(glm::vec2(0, -10));
+
+	SdfCollider* level = new SdfCollider(glm::vec2(-40, -40), glm::vec2(80, 80), 0.5f, glm::vec4(1, 1, 1, 1));
+	for (int side = -1; side <= 1; side += 2)
+	{
+		std::vector<glm::vec2> wall;
+		for (int i = 0; i <= 32; i++)
+		{
+			float s = i / 32.0f;
+			wall.push_back(glm::vec2(side * (4.0f + (30.0f * s)), -5.0f + (30.0f * s * s)));
+		}
+		level->addPolyline(wall, false, 0.5f);
+	}
+	std::vector<glm::vec2> ledge = { glm::vec2(-15, -25), glm::vec2(15, -25), glm::vec2(10, -20), glm::vec2(-10, -20) };
+	level->addPolyline(ledge, true, 0.0f);
+	level->bakePolylines();
+	level->setMipLevels(3);
+	m_physicsScene->addActor(level);
+
+	// Rows above the rim, under the top Plane for up to about 150 bodies
+	int columns = 26;
+	for (int i = 0; i < bodyCount; i++)
+	{
+		glm::vec2 position(-30.0f + (i % columns) * 2.4f, 26.0f + (i / columns) * 2.4f);
+		glm::vec2 velocity(glm::linearRand(-5.0f, 5.0f), -10.0f);
+		if (i % 2 == 0)
+		{
+			m_physicsScene->addActor(new Sphere(position, velocity, glm::vec2(0, 0), 1.0f, 1.0f, 0.5f, glm::vec4(1, 1, 0, 1)));
+		}
+		else
+		{
+			m_physicsScene->addActor(new AABB(position, velocity, glm::vec2(0, 0), glm::vec2(1.0f, 0.75f), 1.0f, 0.5f, glm::vec4(0, 1, 1, 1)));
+		}
+	}
+}
+
+//============================================================================================================================================
+// Screen To World
+
+// Screen To World, matches the orthographic projection draw() uses
+glm::vec2 PhysicsEngineApp::screenToWorld(int screenX, int screenY)
+{
+	float aspectRatio = (float)getWindowWidth() / (float)getWindowHeight();
+	float x = ((float)screenX / (float)getWindowWidth()) * 200.0f - 100.0f;
+	float y = (((float)screenY / (float)getWindowHeight()) * 200.0f - 100.0f) / aspectRatio;
+	return glm::vec2(x, y);
 }
 
 //============================================================================================================================================
@@ -124,9 +358,50 @@ void PhysicsEngineApp::update(float deltaTime)
 
 	aie::Gizmos::clear();
 
+	// Page the tiled world in round the mouse before the scene steps it
+	if (m_tiledWorld != nullptr)
+	{
+		m_tiledWorld->setRegion(0, screenToWorld(input->getMouseX(), input->getMouseY()), 30.0f);
+		m_tiledWorld->update(deltaTime);
+	}
+
 	// Call physics scene functions
 	m_physicsScene->update(deltaTime);										// Update physics scene
 	m_physicsScene->updateGizmos();											// Update gizmos
+	if (m_eventScene != nullptr)
+	{
+		m_eventScene->update(deltaTime);									// Run the gas up to the frame time
+		m_eventScene->updateGizmos();
+	}
+
+	// Mouse picking, grab whatever dynamic body is under the cursor and drag it around
+	glm::vec2 mousePosition = screenToWorld(input->getMouseX(), input->getMouseY());
+	if (input->wasMouseButtonPressed(aie::INPUT_MOUSE_BUTTON_LEFT))
+	{
+		PhysicsObject* picked[8];
+		int pickedCount = m_physicsScene->getSceneQuery().overlapCircle(mousePosition, 0.0f, picked, 8);
+		for (int i = 0; i < pickedCount; i++)
+		{
+			if (picked[i]->isDynamic())
+			{
+				m_pickedBody = static_cast<Rigidbody*>(picked[i]);
+				m_pickOffset = m_pickedBody->getPosition() - mousePosition;
+				break;
+			}
+		}
+	}
+	if (input->wasMouseButtonReleased(aie::INPUT_MOUSE_BUTTON_LEFT))
+	{
+		m_pickedBody = nullptr;
+	}
+	if (m_pickedBody != nullptr && deltaTime > 0.0f)
+	{
+		// Carry the mouse's velocity so the body can be thrown when it's let go
+		glm::vec2 target = mousePosition + m_pickOffset;
+		m_pickedBody->setVelocity((target - m_pickedBody->getPosition()) / deltaTime);
+		m_pickedBody->setPosition(target);
+		aie::Gizmos::add2DCircle(mousePosition, 0.5f, 8, glm::vec4(1, 1, 1, 1));
+	}
 
 	// exit the application
 	if (input->isKeyDown(aie::INPUT_KEY_ESCAPE))
@@ -3,6 +3,8 @@
 #include "Application.h"
 #include "Renderer2D.h"
 #include "PhysicsScene.h"
+#include "EventDrivenScene.h"
+#include "TiledWorld.h"
 
 // Other includes
 #include <glm\glm.hpp>
@@ -25,8 +27,19 @@ public:
 	// Physics Scene
 
 	PhysicsScene* m_physicsScene;
+	EventDrivenScene* m_eventScene;	// Runs alongside the physics scene when a gas demo is set up, nullptr otherwise
+	TiledWorld* m_tiledWorld;		// Pages bodies in round the mouse when a tiled world demo is set up, nullptr otherwise
 
 	void setupContinuousDemo(glm::vec2 startPos, float inclination, float speed, float gravity);
+	void setupOrbitDemo(int bodyCount);
+	void setupFluidDemo();
+	void setupClothDemo(int columns, int rows);
+	void setupGranularDemo(int grainCount);
+	void setupGasDemo(int moleculeCount);
+	void setupTiledWorldDemo(int brickCount);
+	void setupFunnelDemo(int bodyCount);
+
+	glm::vec2 screenToWorld(int screenX, int screenY);
 
 protected:
 
@@ -39,13 +52,19 @@ protected:
 	//============================================================================================================================================
 	// Collision Objects
 
-	class Sphere* collSphere1;	// 1st Sphere object
-	class Sphere* collSphere2;	// 2nd Sphere object
-	class Sphere* collSphere3;	// 3rd Sphere object
-	class Plane*  collPlane1;	// 1st Plane object (Upper Plane)
-	class Plane*  collPlane2;	// 2nd Plane object (Bottom Plane)
-	class Plane*  collPlane3;	// 3st Plane object (Left Plane)
-	class Plane*  collPlane4;	// 4nd Plane object (Bottom Plane)
-	class AABB*   collAABB1;	// AABB object
-	class AABB*   collAABB2;	// AABB object
+	Sphere* collSphere1;	// 1st Sphere object
+	Sphere* collSphere2;	// 2nd Sphere object
+	Sphere* collSphere3;	// 3rd Sphere object
+	Plane*  collPlane1;	// 1st Plane object (Upper Plane)
+	Plane*  collPlane2;	// 2nd Plane object (Bottom Plane)
+	Plane*  collPlane3;	// 3st Plane object (Left Plane)
+	Plane*  collPlane4;	// 4nd Plane object (Bottom Plane)
+	AABB*   collAABB1;	// AABB object
+	AABB*   collAABB2;	// AABB object
+
+	//============================================================================================================================================
+	// Mouse Picking
+
+	Rigidbody* m_pickedBody;	// Body being dragged with the mouse, nullptr if none
+	glm::vec2 m_pickOffset;			// Where on the body it was grabbed, relative to its position
 };
\ No newline at end of file
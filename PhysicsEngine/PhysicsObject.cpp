@@ -10,21 +10,59 @@
 // Collision Functions
 
 // Is (the Object) Static
-bool PhysicsObject::isStatic()
+template <class Scalar, int Dimensions>
+bool BasicPhysicsObject<Scalar, Dimensions>::isStatic()
 {
-	// Check the Object's ShapeID, very fast but not fastest
-	if (getShapeID() == PLANE)
-	{
-		// If it's a Plane, return true
-		return true;
-	}
-	else
+	// The body type is set explicitly now instead of being inferred from the ShapeID,
+	// so static AABBs (and any other shape) can exist alongside Planes
+	return m_bodyType == STATIC_BODY;
+}
+
+// Is (the Object) Kinematic
+template <class Scalar, int Dimensions>
+bool BasicPhysicsObject<Scalar, Dimensions>::isKinematic()
+{
+	return m_bodyType == KINEMATIC_BODY;
+}
+
+// Is (the Object) Dynamic
+template <class Scalar, int Dimensions>
+bool BasicPhysicsObject<Scalar, Dimensions>::isDynamic()
+{
+	return m_bodyType == DYNAMIC_BODY;
+}
+
+//============================================================================================================================================
+// Collision Filtering
+
+// Set Collision Filter
+template <class Scalar, int Dimensions>
+void BasicPhysicsObject<Scalar, Dimensions>::setCollisionFilter(unsigned int category, unsigned int mask, int group)
+{
+	m_collisionCategory = category;
+	m_collisionMask = mask;
+	m_collisionGroup = group;
+}
+
+// Should Collide, the same rule as BroadPhase::shouldCollide
+template <class Scalar, int Dimensions>
+bool BasicPhysicsObject<Scalar, Dimensions>::shouldCollide(BasicPhysicsObject* other)
+{
+	// A shared group wins over the category bits
+	if (m_collisionGroup == other->m_collisionGroup && m_collisionGroup != 0)
 	{
-		// Otherwise, return false
-		return false;
+		return m_collisionGroup > 0;
 	}
 
-	// Alternative solution thanks to Matt, slower but safer
-	/* Rigidbody* rb = dynamic_cast<Rigidbody*>(this);
-	return rb == nullptr; */
-}
\ No newline at end of file
+	// Each side's category has to be in the other side's mask
+	return ((m_collisionCategory & other->m_collisionMask) != 0) && ((other->m_collisionCategory & m_collisionMask) != 0);
+}
+
+//============================================================================================================================================
+// Instantiations
+
+// float for the engine, double and Q32.32 fixed point for long runs and lockstep, and float in 3D
+template class BasicPhysicsObject<float, 2>;
+template class BasicPhysicsObject<double, 2>;
+template class BasicPhysicsObject<Fixed64, 2>;
+template class BasicPhysicsObject<float, 3>;
\ No newline at end of file
@@ -2,11 +2,25 @@
 // Include .h files
 
 // Other includes
+#include "ScalarVector.h"
 #include <glm\vec2.hpp>
 #include <glm\glm.hpp>
 
 // Typedefs
 
+// The core is written once over the scalar type and the number of dimensions. The 2D float engine is one instantiation
+// of it and every other system works in these names
+template <class Scalar, int Dimensions> class BasicPhysicsObject;
+template <class Scalar, int Dimensions> class BasicRigidbody;
+template <class Scalar, int Dimensions> class BasicSphere;
+template <class Scalar, int Dimensions> class BasicAABB;
+template <class Scalar, int Dimensions> class BasicPlane;
+typedef BasicPhysicsObject<float, 2> PhysicsObject;
+typedef BasicRigidbody<float, 2> Rigidbody;
+typedef BasicSphere<float, 2> Sphere;
+typedef BasicAABB<float, 2> AABB;
+typedef BasicPlane<float, 2> Plane;
+
 //============================================================================================================================================
 // ShapeType ENUM
 
@@ -15,26 +29,72 @@ enum ShapeType
 	PLANE,
 	SPHERE,
 	AABB_,
+	SDF,
 	SHAPE_COUNT
 };
 
-class PhysicsObject
+//============================================================================================================================================
+// BodyType ENUM
+
+enum BodyType
+{
+	STATIC_BODY,	// Never moves, never integrated and never paired with other static bodies
+	KINEMATIC_BODY,	// Moves with its own velocity, ignores gravity and collision impulses
+	DYNAMIC_BODY	// Fully simulated
+};
+
+//============================================================================================================================================
+// BasicPhysicsObject CLASS
+
+// Anything a scene holds, over the scalar type positions are kept in and the number of dimensions. PhysicsObject is the
+// float 2D one; double, Q32.32 fixed point and 3D bodies go into a BasicPhysicsScene of the same type
+template <class Scalar, int Dimensions>
+class BasicPhysicsObject
 {
 
+public:
+	typedef typename CoreVector<Scalar, Dimensions>::Type Vector;
+
 protected:
-	PhysicsObject(ShapeType a_shapeID) : m_shapeID(a_shapeID) {}
+	BasicPhysicsObject(ShapeType a_shapeID, BodyType a_bodyType = DYNAMIC_BODY)
+		: m_collisionCategory(0x0001), m_collisionMask(0xFFFFFFFF), m_collisionGroup(0), m_shapeID((unsigned char)a_shapeID), m_bodyType((unsigned char)a_bodyType) {}
 
 public:
-	PhysicsObject() {};
-	virtual void fixedUpdate(glm::vec2 gravity, float timeStep) = 0;
+	BasicPhysicsObject() {};
+	// Virtual so colliders that own memory, like SdfCollider, free it when the scene deletes them
+	virtual ~BasicPhysicsObject() {}
+	virtual void fixedUpdate(Vector gravity, Scalar timeStep) = 0;
 	virtual void debug() = 0;
 	virtual void makeGizmo() = 0;
 	virtual void resetPosition() {};
 
-	ShapeType getShapeID() { return m_shapeID; }
+	ShapeType getShapeID() { return (ShapeType)m_shapeID; }
+
+	// Set the body type before the object is added to a PhysicsScene, the scene sorts actors by it
+	BodyType getBodyType() { return (BodyType)m_bodyType; }
+	void setBodyType(BodyType bodyType) { m_bodyType = (unsigned char)bodyType; }
 
 	bool isStatic();
+	bool isKinematic();
+	bool isDynamic();
+
+	//============================================================================================================================================
+	// Collision Filtering
+
+	// Two objects collide when each one's category is in the other's mask. A shared non-zero group overrides
+	// that, positive groups always collide and negative groups never do
+	void setCollisionFilter(unsigned int category, unsigned int mask, int group = 0);
+	unsigned int getCollisionCategory() { return m_collisionCategory; }
+	unsigned int getCollisionMask() { return m_collisionMask; }
+	int getCollisionGroup() { return m_collisionGroup; }
+	bool shouldCollide(BasicPhysicsObject* other);
 
 protected:
-	ShapeType m_shapeID;
+	unsigned int m_collisionCategory;
+	unsigned int m_collisionMask;
+	int m_collisionGroup;
+
+	// Bytes rather than enums and after the filter, so the header is 24 bytes and a Sphere fits one cache line
+	unsigned char m_shapeID;
+	unsigned char m_bodyType;
 };
\ No newline at end of file
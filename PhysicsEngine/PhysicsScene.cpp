@@ -5,35 +5,49 @@
 #include "Sphere.h"
 #include "Plane.h"
 #include "AABB.h"
+#include "SdfCollider.h"
 
 // Other includes
 #include <iostream>
 #include <algorithm>
 #include <cassert>
-#include <list>
+#include <cfloat>
 #include <glm/glm.hpp>
 
 // Typedefs
 typedef bool(*fn)(PhysicsObject*, PhysicsObject*);
 
+// Number of bodies tested against a Plane in one go by the batched plane pass
+static const int PLANE_BATCH_WIDTH = 8;
+
 //============================================================================================================================================
 // Constructors
 
 // Constructor
-PhysicsScene::PhysicsScene()
+PhysicsScene::PhysicsScene() : m_sceneQuery(m_broadPhase, m_planes)
 {
-	// Set time step to 0.0f and gravity to 0, 0.0f
-	m_timeStep = 0.0f;
-	m_gravity = glm::vec2(0, 0.0f);
+	// Gravity, the time step and the actors are set up by BasicPhysicsScene
+	m_sceneMode = IMPULSE_MODE;
+	m_pairProvider = GRID_PAIRS;
+	m_integrator = SEMI_IMPLICIT_EULER;
+	m_adaptiveStepping = false;
+	m_lodScheduling = false;
+	m_lodStep = false;
+	m_stepCount = 0;
+	m_contactEvents = false;
 }
 
 // Deconstructor
 PhysicsScene::~PhysicsScene()
 {
-	// Delete all actors in the scene
-	for (auto& actor : m_actors)
+	// BasicPhysicsScene deletes the actors
+	for (auto& generator : m_forceGenerators)
+	{
+		delete generator;
+	}
+	for (auto& fluid : m_fluids)
 	{
-		delete actor;
+		delete fluid;
 	}
 }
 
@@ -43,91 +57,275 @@ PhysicsScene::~PhysicsScene()
 // Collision Function Array
 static fn collisionFunctionArray[] = 
 {
-	// Plane collides with Plane	// Plane collides with Sphere	// Plane collides with AABB
-	PhysicsScene::plane2Plane,		PhysicsScene::plane2Sphere,		PhysicsScene::plane2AABB,
-	// Sphere collides with Plane	// Sphere collides with Sphere	// Sphere collides with AABB
-	PhysicsScene::sphere2Plane,		PhysicsScene::sphere2Sphere,	PhysicsScene::sphere2AABB,
-	// AABB collides with Plane		// AABB collides with Sphere	// AABB collides with AABB
-	PhysicsScene::AABB2Plane,		PhysicsScene::AABB2Sphere,		PhysicsScene::AABB2AABB,
+	// Plane collides with Plane	// Plane collides with Sphere	// Plane collides with AABB	// Plane collides with SDF
+	PhysicsScene::plane2Plane,		PhysicsScene::plane2Sphere,		PhysicsScene::plane2AABB,	nullptr,
+	// Sphere collides with Plane	// Sphere collides with Sphere	// Sphere collides with AABB	// Sphere collides with SDF
+	PhysicsScene::sphere2Plane,		PhysicsScene::sphere2Sphere,	PhysicsScene::sphere2AABB,	PhysicsScene::sphere2SDF,
+	// AABB collides with Plane		// AABB collides with Sphere	// AABB collides with AABB	// AABB collides with SDF
+	PhysicsScene::AABB2Plane,		PhysicsScene::AABB2Sphere,		PhysicsScene::AABB2AABB,	PhysicsScene::AABB2SDF,
+	// SDF collides with Plane		// SDF collides with Sphere		// SDF collides with AABB	// SDF collides with SDF
+	nullptr,						PhysicsScene::SDF2Sphere,		PhysicsScene::SDF2AABB,		nullptr,
 };
 
 // Collision Check
 void PhysicsScene::checkForCollision()
 {
-	// Create actor count
-	int actorCount = m_actors.size();
-	// Check for collisions against all objects except this one
-	for (int outer = 0; outer < actorCount - 1; outer++)
+	// Broadphase: bin the moving bodies into the grid and collect the pairs that pass the filter and bounds tests
+	// In granular mode the grains find their own contacts, only the other bodies go through here
+	const std::vector<PhysicsObject*>& actors = getCollisionActors();
+	m_broadPhase.build(actors, m_staticActors, m_lodStep ? &m_lodScheduler.getMoved() : nullptr);
+	if (m_lodStep)
+	{
+		// Bodies that didn't move this step only pair with ones that did
+		m_broadPhase.findPairs(m_collisionPairs, m_lodScheduler.getAwake());
+	}
+	else if (m_pairProvider == VERLET_PAIRS)
+	{
+		// The grid is still rebuilt every step for the plane pass and scene queries, only the pair search is skipped
+		m_verletList.update(m_broadPhase);
+		m_verletList.findPairs(m_broadPhase, m_collisionPairs);
+	}
+	else
+	{
+		m_broadPhase.findPairs(m_collisionPairs);
+	}
+
+	// Narrowphase: only the surviving pairs reach the shape routines
+	for (auto& pair : m_collisionPairs)
 	{
-		for (int inner = outer + 1; inner < actorCount; inner++)
+		PhysicsObject* object1 = pair.first;
+		PhysicsObject* object2 = pair.second;
+		int shapeId1 = object1->getShapeID();
+		int shapeId2 = object2->getShapeID();
+
+		// using function pointers
+		int functionIdx = (shapeId1 * SHAPE_COUNT) + shapeId2;
+		fn collisionFunctionPtr = collisionFunctionArray[functionIdx];
+		if (collisionFunctionPtr != nullptr)
 		{
-			PhysicsObject* object1 = m_actors[outer];
-			PhysicsObject* object2 = m_actors[inner];
-			int shapeId1 = object1->getShapeID();
-			int shapeId2 = object2->getShapeID();
-
-			// using function pointers
-			int functionIdx = (shapeId1 * SHAPE_COUNT) + shapeId2;
-			fn collisionFunctionPtr = collisionFunctionArray[functionIdx];
-			if (collisionFunctionPtr != nullptr)
+			// Across a periodic edge the second body stands in at its nearest image for the shape routine, then goes
+			// back by the same shift so whatever separation it was given sticks
+			glm::vec2 imageOffset(0, 0);
+			if (m_broadPhase.isPeriodic())
 			{
-				// Check if a collision occured
-				collisionFunctionPtr(object1, object2);
+				Rigidbody* body1 = static_cast<Rigidbody*>(object1);
+				Rigidbody* body2 = static_cast<Rigidbody*>(object2);
+				imageOffset = m_broadPhase.getImageOffset(body1->getPosition(), body2->getPosition());
+				if (imageOffset != glm::vec2(0, 0))
+				{
+					body2->setPosition(body2->getPosition() + imageOffset);
+				}
+			}
+
+			// Check if a collision occured, the pairs that touch are kept for the contact events
+			bool touching = collisionFunctionPtr(object1, object2);
+			if (touching && m_contactEvents)
+			{
+				m_contacts.addContact(object1, object2);
+			}
+
+			if (imageOffset != glm::vec2(0, 0))
+			{
+				Rigidbody* body2 = static_cast<Rigidbody*>(object2);
+				body2->setPosition(body2->getPosition() - imageOffset);
 			}
 		}
 	}
+
+	// Anything touching a faster tier catches up with it next step
+	if (m_lodStep)
+	{
+		m_lodScheduler.promoteContacts(m_collisionPairs);
+	}
+
+	// Test every dynamic body against all the Planes in one batched pass
+	checkPlaneCollisions();
 }
 
-// Plane to Plane Collision
-bool PhysicsScene::plane2Plane(PhysicsObject *, PhysicsObject *)
+// Gather Body Data
+void PhysicsScene::gatherBodyData()
 {
-	// Return false, two static objects won't really collide anyway
-	return false;
+	// Pad the arrays to a whole number of batches so the plane pass never needs a scalar tail
+	const std::vector<PhysicsObject*>& actors = getCollisionActors();
+	int actorCount = actors.size();
+	int paddedCount = ((actorCount + PLANE_BATCH_WIDTH - 1) / PLANE_BATCH_WIDTH) * PLANE_BATCH_WIDTH;
+
+	m_bodyPositionX.assign(paddedCount, 0.0f);
+	m_bodyPositionY.assign(paddedCount, 0.0f);
+	m_bodyExtentX.assign(paddedCount, 0.0f);
+	m_bodyExtentY.assign(paddedCount, 0.0f);
+	// A radius of -FLT_MAX gives padding (and non-dynamic bodies) a reach no signed distance can get under
+	m_bodyRadius.assign(paddedCount, -FLT_MAX);
+
+	for (int i = 0; i < actorCount; i++)
+	{
+		PhysicsObject* pActor = actors[i];
+
+		// Kinematic bodies don't respond to Planes, leave them as padding, as do bodies that didn't move this step
+		if (!pActor->isDynamic() || (m_lodStep && !m_lodScheduler.getAwake()[i]))
+		{
+			continue;
+		}
+
+		// Spheres reach out by their radius, AABBs by their extents projected onto the plane normal
+		switch (pActor->getShapeID())
+		{
+		case SPHERE:
+		{
+			Sphere* sphere = static_cast<Sphere*>(pActor);
+			m_bodyPositionX[i] = sphere->getPosition().x;
+			m_bodyPositionY[i] = sphere->getPosition().y;
+			m_bodyRadius[i] = sphere->getRadius();
+			break;
+		}
+		case AABB_:
+		{
+			AABB* aabb = static_cast<AABB*>(pActor);
+			m_bodyPositionX[i] = aabb->getPosition().x;
+			m_bodyPositionY[i] = aabb->getPosition().y;
+			m_bodyExtentX[i] = aabb->getExtents().x;
+			m_bodyExtentY[i] = aabb->getExtents().y;
+			m_bodyRadius[i] = 0.0f;
+			break;
+		}
+		default:
+			break;
+		}
+	}
 }
 
-// Plane to Sphere Collision
-bool PhysicsScene::plane2Sphere(PhysicsObject* obj1, PhysicsObject* obj2)
+// Plane Collision Check
+void PhysicsScene::checkPlaneCollisions()
 {
-	// Run Sphere to Plane collission function in reverse
-	return sphere2Plane(obj2, obj1);
+	// Nothing to do without any Planes
+	if (m_planes.empty())
+	{
+		return;
+	}
+
+	gatherBodyData();
+
+	int planeCount = m_planes.size();
+	int paddedCount = m_bodyPositionX.size();
+
+	// Raw pointers so the inner loop stays simple enough for the compiler to vectorize
+	const float* positionX = m_bodyPositionX.data();
+	const float* positionY = m_bodyPositionY.data();
+	const float* extentX = m_bodyExtentX.data();
+	const float* extentY = m_bodyExtentY.data();
+	const float* radius = m_bodyRadius.data();
+
+	// Proxies line up with the collision actors, the broadphase built them this step
+	const std::vector<PhysicsObject*>& actors = getCollisionActors();
+	const std::vector<BroadPhaseProxy>& proxies = m_broadPhase.getProxies();
+
+	for (int plane = 0; plane < planeCount; plane++)
+	{
+		BroadPhaseProxy planeProxy = BroadPhase::makeProxy(m_planes[plane]);
+		float normalX = m_planeNormalX[plane];
+		float normalY = m_planeNormalY[plane];
+		float distance = m_planeDistance[plane];
+		float absNormalX = std::abs(normalX);
+		float absNormalY = std::abs(normalY);
+
+		for (int batch = 0; batch < paddedCount; batch += PLANE_BATCH_WIDTH)
+		{
+			// Signed distances for a whole batch at once, branch-free, collecting a bit per body that gets close enough
+			int hitMask = 0;
+			for (int lane = 0; lane < PLANE_BATCH_WIDTH; lane++)
+			{
+				int body = batch + lane;
+				float signedDistance = (positionX[body] * normalX) + (positionY[body] * normalY) - distance;
+				float reach = (absNormalX * extentX[body]) + (absNormalY * extentY[body]) + radius[body];
+				hitMask |= (signedDistance < reach) << lane;
+			}
+
+			// Most batches are nowhere near the Plane
+			if (hitMask == 0)
+			{
+				continue;
+			}
+
+			// Only the flagged bodies that pass the collision filter go through the full shape routine
+			for (int lane = 0; lane < PLANE_BATCH_WIDTH; lane++)
+			{
+				if ((hitMask & (1 << lane)) && BroadPhase::shouldCollide(proxies[batch + lane], planeProxy))
+				{
+					PhysicsObject* pActor = actors[batch + lane];
+					fn collisionFunctionPtr = collisionFunctionArray[(pActor->getShapeID() * SHAPE_COUNT) + PLANE];
+					if (collisionFunctionPtr != nullptr && collisionFunctionPtr(pActor, m_planes[plane]) && m_contactEvents)
+					{
+						m_contacts.addContact(pActor, m_planes[plane]);
+					}
+				}
+			}
+		}
+	}
 }
 
-// Plane to AABB Collision
-bool PhysicsScene::plane2AABB(PhysicsObject* obj1, PhysicsObject* obj2)
+// Wrap Positions
+void PhysicsScene::wrapPositions()
 {
-	// Run AABB to Plane collission function in reverse
-	return AABB2Plane(obj2, obj1);
+	for (auto pActor : m_actors)
+	{
+		if (pActor->getShapeID() == PLANE)
+		{
+			continue;
+		}
+
+		// Only touch bodies that are actually outside, setPosition does more work for AABBs
+		Rigidbody* body = static_cast<Rigidbody*>(pActor);
+		glm::vec2 position = body->getPosition();
+		glm::vec2 wrapped = m_broadPhase.wrapPosition(position);
+		if (wrapped != position)
+		{
+			body->setPosition(wrapped);
+		}
+	}
 }
 
-// Sphere to Plane Collision
-bool PhysicsScene::sphere2Plane(PhysicsObject* obj1, PhysicsObject* obj2)
+// Rebuild Plane Data
+void PhysicsScene::rebuildPlaneData()
 {
-	// Cast the Sphere to Obj1 and the Plane to Obj2
-	Sphere *sphere = dynamic_cast <Sphere*> (obj1);
-	Plane  *plane  = dynamic_cast <Plane*>  (obj2);
+	m_planes.clear();
+	m_planeNormalX.clear();
+	m_planeNormalY.clear();
+	m_planeDistance.clear();
 
-	// Check if both objects actually exist
-	if (sphere != nullptr && plane != nullptr)
+	for (auto pStatic : m_staticActors)
 	{
-		// Get the Plane's normal
-		glm::vec2 collisionNormal = plane->getNormal();
-		float sphereToPlane = glm::dot(sphere->getPosition(), plane->getNormal()) - plane->getDistanceToOrigin();
-
-		// If the sphere is behind the plane, we flip the normal
-		if (sphereToPlane < 0)
+		if (pStatic->getShapeID() == PLANE)
 		{
-			collisionNormal *= -1; sphereToPlane *= -1;
+			Plane* plane = static_cast<Plane*>(pStatic);
+			m_planes.push_back(plane);
+			m_planeNormalX.push_back(plane->getNormal().x);
+			m_planeNormalY.push_back(plane->getNormal().y);
+			m_planeDistance.push_back(plane->getDistanceToOrigin());
 		}
+	}
+}
 
-		// Get the intersection from the sphere to the plane
-		float intersection = sphere->getRadius() - sphereToPlane;
+// Sphere to SDF Collision
+bool PhysicsScene::sphere2SDF(PhysicsObject* obj1, PhysicsObject* obj2)
+{
+	// Cast the Sphere to Obj1 and the SDF to Obj2
+	Sphere      *sphere = dynamic_cast <Sphere*>      (obj1);
+	SdfCollider *sdf    = dynamic_cast <SdfCollider*> (obj2);
 
-		// Check if they're actually intersecting
-		if (intersection > 0)
+	// Check if both objects actually exist
+	if (sphere != nullptr && sdf != nullptr)
+	{
+		// One lookup gives how far the Sphere is in and the way out, however much geometry the field holds
+		float depth;
+		glm::vec2 collisionNormal;
+		if (sdf->penetrate(sphere->getPosition(), glm::vec2(0, 0), sphere->getRadius(), depth, collisionNormal))
 		{
-			// Call resolve collision function
-			separateCollision(sphere, plane, -collisionNormal, (sphere->getRadius() - intersection));
-			plane->resolveCollision(sphere, collisionNormal);
+			// The normal turns across a curved surface, so a Sphere already heading out isn't bounced back in
+			separateCollision(sphere, sdf, -collisionNormal, depth);
+			if (glm::dot(sphere->getVelocity(), collisionNormal) < 0.0f)
+			{
+				sdf->resolveCollision(sphere, collisionNormal);
+			}
 			return true;
 		}
 	}
@@ -135,295 +333,296 @@ bool PhysicsScene::sphere2Plane(PhysicsObject* obj1, PhysicsObject* obj2)
 	return false;
 }
 
-// Sphere to Sphere Collision
-bool PhysicsScene::sphere2Sphere(PhysicsObject* obj1, PhysicsObject* obj2)
+// AABB to SDF Collision
+bool PhysicsScene::AABB2SDF(PhysicsObject* obj1, PhysicsObject* obj2)
 {
-	// Cast Sphere 1 to Obj1 and Sphere 2 to Obj2
-	Sphere *sphere1 = dynamic_cast <Sphere*> (obj1);
-	Sphere *sphere2 = dynamic_cast <Sphere*> (obj2);
+	// Cast the AABB to Obj1 and the SDF to Obj2
+	AABB        *aabb = dynamic_cast <AABB*>        (obj1);
+	SdfCollider *sdf  = dynamic_cast <SdfCollider*> (obj2);
 
-	// Check if both Spheres exist
-	if (sphere1 != nullptr && sphere2 != nullptr)
+	// Check if both objects actually exist
+	if (aabb != nullptr && sdf != nullptr)
 	{
-		// Get the radii of both Spheres and combine them
-		float combinedRadii = (sphere1->getRadius() + sphere2->getRadius());
-		// Get the distance between both Spheres
-		float objectDistance = glm::distance(sphere1->getPosition(), sphere2->getPosition());
-
-		// A variable for the collision normal
-		glm::vec2 collisionNormal(glm::normalize(sphere1->getPosition() - sphere2->getPosition()));
-
-		// Check if the distance between both Spheres is less than their combined radii
-		if (objectDistance < combinedRadii)
+		// The AABB reaches its extents projected onto the normal, as it does against a Plane
+		float depth;
+		glm::vec2 collisionNormal;
+		if (sdf->penetrate(aabb->getPosition(), aabb->getExtents(), 0.0f, depth, collisionNormal))
 		{
-			// Call resolve collision function
-			separateCollision(sphere1, sphere2, -collisionNormal, (combinedRadii - objectDistance));
-			sphere1->resolveCollision(sphere2, collisionNormal);
+			separateCollision(aabb, sdf, -collisionNormal, depth);
+			if (glm::dot(aabb->getVelocity(), collisionNormal) < 0.0f)
+			{
+				sdf->resolveCollision(aabb, collisionNormal);
+			}
 			return true;
 		}
 	}
-
-	// Return false if either Sphere doesn't exist
+	// Return false if either object doesn't exist
 	return false;
 }
 
-// Sphere to AABB Collision
-bool PhysicsScene::sphere2AABB(PhysicsObject* obj1, PhysicsObject* obj2)
+// SDF to Sphere Collision
+bool PhysicsScene::SDF2Sphere(PhysicsObject* obj1, PhysicsObject* obj2)
 {
-	// Run AABB to Sphere collission function in reverse
-	return AABB2Sphere(obj2, obj1);
+	// Run Sphere to SDF collision function in reverse
+	return sphere2SDF(obj2, obj1);
 }
 
-// AABB to Plane Collision
-bool PhysicsScene::AABB2Plane(PhysicsObject* obj1, PhysicsObject* obj2)
+// SDF to AABB Collision
+bool PhysicsScene::SDF2AABB(PhysicsObject* obj1, PhysicsObject* obj2)
 {
-	// Cast the AABB to Obj1 and the Plane to Obj2
-	AABB  *aabb  = dynamic_cast <AABB*>  (obj1);
-	Plane *plane = dynamic_cast <Plane*> (obj2);
+	// Run AABB to SDF collision function in reverse
+	return AABB2SDF(obj2, obj1);
+}
 
-	// Check if both objects actually exist
-	if (aabb != nullptr && plane != nullptr)
-	{
-		// Get the Plane's normal
-		glm::vec2 collisionNormal = plane->getNormal();
+//============================================================================================================================================
+// Actor Functions
 
-		// Store the corners of the AABB into variables
-		glm::vec2 aabbTopLeftCorner  = aabb->m_min + glm::vec2(0, aabb->getExtents().y * 2);
-		glm::vec2 aabbTopRightCorner = aabb->m_max;
-		glm::vec2 aabbBotLeftCorner  = aabb->m_min;
-		glm::vec2 aabbBotRightCorner = aabb->m_min + glm::vec2(aabb->getExtents().x * 2, 0);
+// Add Actor
+void PhysicsScene::addActor(PhysicsObject* actor)
+{
+	BasicPhysicsScene::addActor(actor);
 
-		// Dot product the corners by the Plane's normal
-		float o1 = (glm::dot(aabbTopLeftCorner,  collisionNormal) - plane->getDistanceToOrigin());
-		float o2 = (glm::dot(aabbTopRightCorner, collisionNormal) - plane->getDistanceToOrigin());
-		float o3 = (glm::dot(aabbBotLeftCorner,  collisionNormal) - plane->getDistanceToOrigin());
-		float o4 = (glm::dot(aabbBotRightCorner, collisionNormal) - plane->getDistanceToOrigin());
+	// Planes also go into the flat half-space arrays
+	if (actor->getShapeID() == PLANE)
+	{
+		rebuildPlaneData();
+	}
+}
+
+// Remove Actor
+void PhysicsScene::removeActor(PhysicsObject* actor)
+{
+	BasicPhysicsScene::removeActor(actor);
+	m_constraints.removeBody(actor);
+	m_contacts.removeBodies(std::vector<PhysicsObject*>(1, actor));
 
-		// Variable for the lowest (furthest) overlap, set it to o1 by default
-		float lowestValue = o1;
+	if (actor->getShapeID() == PLANE)
+	{
+		rebuildPlaneData();
+	}
+}
 
-		// Checks to find the lowest overlap
-		if (!lowestValue)
-		{
-			// Checks to find which of the aformentioned variables is the lower (if there is one)
-			// Check if o2 is the lowest
-			if (o2 < lowestValue) { lowestValue = o2; }
-			// Check if o3 is the lowest
-			if (o3 < lowestValue) { lowestValue = o3; }
-			// Check if o4 is the lowest
-			if (o4 < lowestValue) { lowestValue = o4; }
-		}
+// Remove Actors
+void PhysicsScene::removeActors(const std::vector<PhysicsObject*>& actors)
+{
+	BasicPhysicsScene::removeActors(actors);
+	m_contacts.removeBodies(actors);
 
-		// Check if any of the corners are below the plane
-		if ((o1 < 0) || (o2 < 0) || (o3 < 0) || (o4 < 0))
-		{
-			// Call resolve collision function
-			separateCollision(aabb, plane, -collisionNormal, lowestValue);
-			plane->resolveCollision(aabb, collisionNormal);
-			return true;
-		}
+	bool removedPlane = false;
+	for (auto actor : actors)
+	{
+		m_constraints.removeBody(actor);
+		removedPlane = removedPlane || (actor->getShapeID() == PLANE);
+	}
+	if (removedPlane)
+	{
+		rebuildPlaneData();
 	}
-	// Return false if either object doesn't exist
-	return false;
 }
 
-// AABB to Sphere Collision
-bool PhysicsScene::AABB2Sphere(PhysicsObject* obj1, PhysicsObject* obj2)
+// Set History
+void PhysicsScene::setHistory(int capacity, int keyframeInterval)
 {
-	// Cast the AABB to Obj1 and the Sphere to Obj2
-	AABB   *aabb   = dynamic_cast <AABB*>   (obj1);
-	Sphere *sphere = dynamic_cast <Sphere*> (obj2);
+	m_history.setCapacity(capacity, keyframeInterval);
 
-	// Check if both objects exist
-	if (aabb != nullptr && sphere != nullptr)
+	// The state right now is the first that can be gone back to
+	if (capacity > 0)
 	{
-		//float clampX = glm::clamp(sphere->getPosition().x, aabb->m_minX, aabb->m_maxX);
-		//float clampY = glm::clamp(sphere->getPosition().y, aabb->m_minY, aabb->m_maxY);
+		m_history.record(m_stepCount, m_actors);
+	}
+}
 
-		// Get a clamped position with the AABB and the Sphere
-		glm::vec2 clampedPosition = glm::clamp(sphere->getPosition(), aabb->m_min, aabb->m_max);
+// Rewind
+bool PhysicsScene::rewind(int step)
+{
+	if (!m_history.restore(step, m_actors))
+	{
+		return false;
+	}
 
-		// A variable for the distance between the Sphere and the clamped position
-		float objectDistance = glm::length(sphere->getPosition() - clampedPosition);
+	// Contacts from the last step are stale. The Verlet lists are left alone, they measure how far the bodies are from
+	// where the lists were built and so only rebuild if the restored positions are further off than the skin allows
+	m_stepCount = step;
+	m_collisionPairs.clear();
+	m_contacts.reset();
+	return true;
+}
 
-		// A variable for the collision normal
-		glm::vec2 collisionNormal = glm::normalize(sphere->getPosition() - clampedPosition);
+// Release Actors
+void PhysicsScene::releaseActors()
+{
+	// Every constraint is between actors, so none are left
+	m_constraints.clearConstraints();
+	m_contacts.removeBodies(m_actors);
+	m_contacts.removeBodies(m_staticActors);
+	BasicPhysicsScene::releaseActors();
+	m_rigidActors.clear();
+	rebuildPlaneData();
+	m_verletList.invalidate();
+}
 
-		// A variable for the overlap
-		float overlap = (sphere->getRadius() - objectDistance);
+// Add Force Generator
+void PhysicsScene::addForceGenerator(ForceGenerator* generator)
+{
+	m_forceGenerators.push_back(generator);
+}
 
-		// Check if the objectDistance is less than the Sphere's radius
-		if (objectDistance < sphere->getRadius())
-		{
-			// Call resolve collision function
-			separateCollision(aabb, sphere, collisionNormal, overlap);
-			aabb->resolveCollision(sphere, collisionNormal);
-			return true;
-		}
-	}
+// Remove Force Generator
+void PhysicsScene::removeForceGenerator(ForceGenerator* generator)
+{
+	m_forceGenerators.erase(std::remove(std::begin(m_forceGenerators), std::end(m_forceGenerators), generator), std::end(m_forceGenerators));
+}
 
-	// Return false if either object doesn't exist
-	return false;
+// Add Fluid
+void PhysicsScene::addFluid(FluidSystem* fluid)
+{
+	m_fluids.push_back(fluid);
 }
 
-// AABB to AABB Collision
-bool PhysicsScene::AABB2AABB(PhysicsObject* obj1, PhysicsObject* obj2)
+// Remove Fluid
+void PhysicsScene::removeFluid(FluidSystem* fluid)
 {
-	//// Cast AABB 1 to Obj1 and AABB 2 to Obj2
-	AABB *aabb1 = dynamic_cast <AABB*> (obj1);
-	AABB *aabb2 = dynamic_cast <AABB*> (obj2);
+	m_fluids.erase(std::remove(std::begin(m_fluids), std::end(m_fluids), fluid), std::end(m_fluids));
+}
 
-	// Check if both AABBs actually exist
-	if (aabb1 != nullptr && aabb2 != nullptr)
-	{
-		// Check if the AABBs are colliding
-		if ((aabb1->m_max.x) >= (aabb2->m_min.x) && (aabb1->m_min.x) <= (aabb2->m_max.x) &&
-			(aabb1->m_min.y) <= (aabb2->m_max.y) && (aabb1->m_max.y) >= (aabb2->m_min.y))
-		{
-			// Get absolute values stored in variables to be used to obtain the collision normal
-			float a1 = (aabb1->m_max.x) - (aabb2->m_min.x); // Right
-			float a4 = (aabb1->m_max.y) - (aabb2->m_min.y); // Top
-			float a2 = (aabb2->m_max.x) - (aabb1->m_min.x); // Left
-			float a3 = (aabb2->m_max.y) - (aabb1->m_min.y); // Bottom
-
-			// Create the actual variable for the collision normal
-			glm::vec2 collisionNormal = glm::vec2(1, 0);
-
-			// Create a variable for the overlap, set it to the right by default
-			float overlap = a1;
-
-			// Checks to find which of the aformentioned variables is the lower (if there is one)
-			// Check if a2 is the lowest
-			if (std::abs(a2) < std::abs(overlap)) { collisionNormal = glm::vec2(-1, 0); overlap = a2; }
-			// Check if a3 is the lowest
-			if (std::abs(a3) < std::abs(overlap)) { collisionNormal = glm::vec2(0, -1); overlap = a3; }
-			// Check if a4 is the lowest
-			if (std::abs(a4) < std::abs(overlap)) { collisionNormal = glm::vec2(0, 1);  overlap = a4; }
-
-			// Call resolve collision function
-			separateCollision(aabb1, aabb2, collisionNormal, overlap);
-			aabb1->resolveCollision(aabb2, collisionNormal);
-		}
-	}
+//============================================================================================================================================
+// Update Functions
 
-	// Return false if either object doesn't exist
-	return false;
+// Update
+void PhysicsScene::update(float dt)
+{
+	// Events are for the steps this update takes
+	m_contacts.clearEvents();
+	BasicPhysicsScene::update(dt);
 }
 
-// Separate Collsion
-void PhysicsScene::separateCollision(PhysicsObject* obj1, PhysicsObject* obj2, glm::vec2 normal, float overlap)
+// Step, one fixed step
+void PhysicsScene::step()
 {
-	// Assign IsStatic result of each object to variables
-	bool firstIsStatic = obj1->isStatic();
-	bool secondIsStatic = obj2->isStatic();
+	// Bodies drift out of Z-order as they move, put them back before anything walks the list. The Verlet lists are
+	// stored by index so they have to be built again
+	if (m_mortonOrder.update(m_actors))
+	{
+		m_verletList.invalidate();
+	}
 
-	// If the first Object is static
-	if (firstIsStatic)
+	// Accumulate external forces before anything moves, the higher order integrators run their own force passes
+	// unless the grains need them
+	bool granular = (m_sceneMode == GRANULAR_MODE);
+	bool startForces = (m_integrator == SEMI_IMPLICIT_EULER && !m_adaptiveStepping) || granular;
+	if (startForces)
 	{
-		// Cast rigidbody to Object 1
-		Rigidbody *rigidBody = dynamic_cast<Rigidbody*>(obj1);
-		if (rigidBody)
+		for (auto pGenerator : m_forceGenerators)
 		{
-			// Set a variable with the current position
-			glm::vec2 currentPosition = rigidBody->getPosition();
-			// Set position of the Object
-			rigidBody->setPosition(currentPosition + (overlap * normal));
+			pGenerator->applyForces(m_actors, m_timeStep);
 		}
+		m_forceFields.applyForces(m_actors, m_timeStep);
 	}
-	// If the second Object is static
-	if (secondIsStatic)
+
+	// Granular mode moves the grains with contact forces, everything else integrates as normal
+	m_constraints.beginStep();
+	if (granular)
 	{
-		// Cast rigidbody to Object 2
-		Rigidbody *rigidBody = dynamic_cast<Rigidbody*>(obj2);
-		if (rigidBody)
+		m_granularSolver.step(m_timeStep, m_gravity, m_actors, m_staticActors);
+		m_rigidActors.clear();
+		for (auto pActor : m_actors)
 		{
-			// Set a variable with the current position
-			glm::vec2 currentPosition = rigidBody->getPosition();
-			// Set position of the Object
-			rigidBody->setPosition(currentPosition - (overlap * normal));
+			if (!GranularSolver::isGrain(pActor))
+			{
+				m_rigidActors.push_back(pActor);
+			}
 		}
 	}
-	// If both Objects are static
-	if (!firstIsStatic && !secondIsStatic)
+
+	// Static colliders are never integrated
+	m_lodStep = false;
+	if (m_adaptiveStepping)
+	{
+		ForceGenerator* fields = (m_forceFields.getFieldCount() > 0) ? &m_forceFields : nullptr;
+		m_adaptiveIntegrator.advance(m_timeStep, m_gravity, m_actors, getCollisionActors(), m_forceGenerators, fields);
+	}
+	else if (m_integrator == SEMI_IMPLICIT_EULER)
 	{
-		// Cast rigidbody1 to Object 1
-		Rigidbody *rigidBody1 = dynamic_cast<Rigidbody*>(obj1);
-		// Cast rigidbody2 to Object 2
-		Rigidbody *rigidBody2 = dynamic_cast<Rigidbody*>(obj2);
-		if (rigidBody1 && rigidBody2)
+		m_lodStep = m_lodScheduling && !granular;
+		if (m_lodStep)
 		{
-			// Set a variable with Object 1's and Object 2's current positions
-			glm::vec2 currentPosition1 = rigidBody1->getPosition();
-			glm::vec2 currentPosition2 = rigidBody2->getPosition();
-			// Set position of the Objects
-			rigidBody1->setPosition(currentPosition1 - ((overlap * normal) * 0.5f));
-			rigidBody2->setPosition(currentPosition2 + ((overlap * normal) * 0.5f));
+			m_lodScheduler.step(m_actors, m_gravity, m_timeStep, m_constraints);
+		}
+		else
+		{
+			for (auto pActor : getCollisionActors())
+			{
+				pActor->fixedUpdate(m_gravity, m_timeStep);
+			}
 		}
 	}
-}
+	else
+	{
+		integrateBodies(startForces);
+	}
 
-//============================================================================================================================================
-// Actor Functions
+	// Pull the integrated positions back onto the constraints
+	m_constraints.solve(m_timeStep);
 
-// Add Actor
-void PhysicsScene::addActor(PhysicsObject* actor)
-{
-	// Push the new Actor onto the m_actors stack
-	m_actors.push_back(actor);
-}
+	// Anything that left a periodic domain comes back in the other side
+	if (m_broadPhase.isPeriodic())
+	{
+		wrapPositions();
+	}
 
-// Remove Actor
-void PhysicsScene::removeActor(PhysicsObject* actor)
-{
-	// Remove specified actor from the stack
-	std::remove(std::begin(m_actors), std::end(m_actors), actor);
-}
+	// Fluids after the bodies have moved, so the coupling sees where they are now
+	for (auto pFluid : m_fluids)
+	{
+		pFluid->step(m_timeStep, m_gravity, m_actors, m_staticActors);
+	}
 
-//============================================================================================================================================
-// Update Functions
+	// Run collision check function
+	checkForCollision();
 
-// Update
-void PhysicsScene::update(float dt) {
-	static std::list<PhysicsObject*> dirty; 
-	
-	// Update physics at a fixed time step
-	static float accumulatedTime = 0.0f;
-	// Increment the accumulated time by delta time
-	accumulatedTime += dt;
-	
-	// Check if accumulated time is equal to or greater than the timestep
-	while (accumulatedTime >= m_timeStep)
+	// Count the step, then hand what touched and the state it ended in to the contact events and the history
+	m_stepCount++;
+	if (m_contactEvents)
 	{
-		for (auto pActor : m_actors)
-		{
-			pActor->fixedUpdate(m_gravity, m_timeStep);
-		}
-		// Subtract accumulated time from timestep
-		accumulatedTime -= m_timeStep; 
-		
-		// Run collision check function
-		checkForCollision();
+		m_contacts.endStep(m_stepCount, m_lodStep ? &m_lodScheduler : nullptr);
+	}
+	if (m_history.getCapacity() > 0)
+	{
+		m_history.record(m_stepCount, m_actors);
 	}
 }
 
-// Update Gizmos
-void PhysicsScene::updateGizmos()
+// Integrate Bodies, picks the policy once for the whole step
+void PhysicsScene::integrateBodies(bool startForces)
 {
-	for (auto pActor : m_actors)
+	ForceGenerator* fields = (m_forceFields.getFieldCount() > 0) ? &m_forceFields : nullptr;
+	const std::vector<PhysicsObject*>& bodies = getCollisionActors();
+
+	switch (m_integrator)
 	{
-		pActor->makeGizmo();
+	case VELOCITY_VERLET:
+		m_bodyIntegrator.step<VelocityVerletPolicy>(m_timeStep, m_gravity, m_actors, bodies, m_forceGenerators, fields, startForces);
+		break;
+	case LEAPFROG:
+		m_bodyIntegrator.step<LeapfrogPolicy>(m_timeStep, m_gravity, m_actors, bodies, m_forceGenerators, fields, startForces);
+		break;
+	case RUNGE_KUTTA_4:
+		m_bodyIntegrator.step<RungeKutta4Policy>(m_timeStep, m_gravity, m_actors, bodies, m_forceGenerators, fields, startForces);
+		break;
+	case YOSHIDA_4:
+		m_bodyIntegrator.step<Yoshida4Policy>(m_timeStep, m_gravity, m_actors, bodies, m_forceGenerators, fields, startForces);
+		break;
+	default:
+		break;
 	}
 }
 
-// Debugging
-void PhysicsScene::debugScene()
+// Update Gizmos
+void PhysicsScene::updateGizmos()
 {
-	// Set count to 0 for iteration
-	int count = 0;
-	for (auto pActor : m_actors)
+	BasicPhysicsScene::updateGizmos();
+	for (auto pFluid : m_fluids)
 	{
-		std::cout << count << " : ";
-		pActor->debug();
-		count++;
+		pFluid->makeGizmo();
 	}
+	m_constraints.makeGizmo();
 }
\ No newline at end of file
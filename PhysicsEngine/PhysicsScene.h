@@ -1,6 +1,20 @@
 #pragma once
 // Include .h files
-#include "PhysicsObject.h"
+#include "BasicPhysicsScene.h"
+#include "BroadPhase.h"
+#include "VerletList.h"
+#include "SceneQuery.h"
+#include "ForceGenerator.h"
+#include "ForceFields.h"
+#include "FluidSystem.h"
+#include "ConstraintSolver.h"
+#include "GranularSolver.h"
+#include "BodyIntegrator.h"
+#include "AdaptiveIntegrator.h"
+#include "LodScheduler.h"
+#include "MortonOrder.h"
+#include "SnapshotRing.h"
+#include "ContactStream.h"
 
 // Other includes
 #include <vector>
@@ -9,46 +23,192 @@
 
 // Typedefs
 
-class PhysicsScene
+//============================================================================================================================================
+// SceneMode ENUM
+
+enum SceneMode
+{
+	IMPULSE_MODE,	// Collisions are resolved with an instantaneous impulse
+	GRANULAR_MODE	// Dynamic Spheres are grains pushed apart by spring-dashpot contact forces, see GranularSolver. Grains
+					// skip the broadphase, so scene queries only see the other bodies
+};
+
+//============================================================================================================================================
+// PairProvider ENUM
+
+enum PairProvider
+{
+	GRID_PAIRS,		// Search the broadphase grid for pairs every step
+	VERLET_PAIRS	// Walk neighbour lists that are only rebuilt once bodies have moved far enough, see VerletList
+};
+
+//============================================================================================================================================
+// PhysicsScene CLASS
+
+// The float 2D scene the app runs. Actors, the collision routines and the fixed step loop come from BasicPhysicsScene;
+// the step here replaces its sort-and-sweep with the broadphase grid or Verlet lists, the batched plane pass and the
+// SDF colliders, and adds force generators, fields, integrators, constraints, grains, fluids, LOD, history and events.
+// The actors stay in the order they were added unless reordered, see MortonOrder
+class PhysicsScene : public BasicPhysicsScene<float, 2>
 {
 
 public:
 	PhysicsScene();
 	~PhysicsScene();
 
-	void addActor(PhysicsObject* actor);
-	void removeActor(PhysicsObject* actor);
-	void update(float dt);
-	void updateGizmos();
-	void debugScene();
+	void addActor(PhysicsObject* actor) override;
+	void removeActor(PhysicsObject* actor) override;
+	void removeActors(const std::vector<PhysicsObject*>& actors) override;
+	void releaseActors() override;
+
+	// Generators run every fixed step before integration, the scene deletes them like its actors
+	void addForceGenerator(ForceGenerator* generator);
+	void removeForceGenerator(ForceGenerator* generator);
+	int getForceGeneratorCount() const { return m_forceGenerators.size(); }
+
+	// Fields are evaluated together in one batched pass after the force generators
+	int addForceField(const ForceField& field) { return m_forceFields.addField(field); }
+	void removeForceField(int index) { m_forceFields.removeField(index); }
+	void clearForceFields() { m_forceFields.clearFields(); }
+	ForceFieldSystem& getForceFields() { return m_forceFields; }
+
+	// Fluids step after the rigid bodies move and push back on them, the scene deletes them like its actors
+	void addFluid(FluidSystem* fluid);
+	void removeFluid(FluidSystem* fluid);
+	int getFluidCount() const { return m_fluids.size(); }
+
+	// Constraints are solved after integration every step, removing an actor drops the constraints that use it
+	void addDistanceConstraint(Rigidbody* body1, Rigidbody* body2, float compliance = 0.0f, float restLength = -1.0f) { m_constraints.addDistanceConstraint(body1, body2, compliance, restLength); }
+	void addBendingConstraint(Rigidbody* body1, Rigidbody* body2, Rigidbody* body3, float compliance = 0.0f) { m_constraints.addBendingConstraint(body1, body2, body3, compliance); }
+	void addAreaConstraint(Rigidbody* body1, Rigidbody* body2, Rigidbody* body3, float compliance = 0.0f) { m_constraints.addAreaConstraint(body1, body2, body3, compliance); }
+	ConstraintSolver& getConstraints() { return m_constraints; }
+
+	void update(float dt) override;
+	void step() override;
+	int getStepCount() const { return m_stepCount; }
+	void updateGizmos() override;
+
+	// Higher order integrators take bigger steps for the same accuracy, each force pass reruns the generators and fields
+	void setIntegrator(IntegratorType integrator) { m_integrator = integrator; }
+	IntegratorType getIntegrator() const { return m_integrator; }
+	const BodyIntegrator& getBodyIntegrator() const { return m_bodyIntegrator; }
+
+	// Adaptive stepping overrides the integrator. The time step becomes the output interval: bodies take their own error
+	// controlled steps inside it and are all brought to its end, where collisions, constraints and fluids run as usual
+	void setAdaptiveStepping(bool adaptiveStepping) { m_adaptiveStepping = adaptiveStepping; }
+	bool getAdaptiveStepping() const { return m_adaptiveStepping; }
+
+	// Steps bodies far from the scheduler's focus points less often, see LodScheduler. Only the semi-implicit Euler
+	// integrator in impulse mode is scheduled, and the grid pair search stands in for the Verlet lists while it is on
+	void setLodScheduling(bool lodScheduling) { m_lodScheduling = lodScheduling; m_lodScheduler.reset(); }
+	bool getLodScheduling() const { return m_lodScheduling; }
+	LodScheduler& getLodScheduler() { return m_lodScheduler; }
+	int getCollisionPairCount() const { return m_collisionPairs.size(); }
+
+	// Sorts the actors into Z-order at the start of a step when the trigger fires, see MortonOrder. Actor pointers are
+	// untouched, only their order in the scene changes
+	void setReorderTrigger(ReorderTrigger trigger) { m_mortonOrder.setTrigger(trigger); }
+	ReorderTrigger getReorderTrigger() const { return m_mortonOrder.getTrigger(); }
+	MortonOrder& getMortonOrder() { return m_mortonOrder; }
+	AdaptiveIntegrator& getAdaptiveIntegrator() { return m_adaptiveIntegrator; }
 
-	void setGravity(const glm::vec2 gravity) { m_gravity = gravity; }
-	glm::vec2 getGravity() const { return m_gravity; }
+	// Keeps the bodies' state after each of the last capacity steps, see SnapshotRing. Rewinding puts the bodies back as
+	// they were after that step and makes it the current step, so stepping on re-simulates from there with whatever has
+	// been changed since. Only body state is rewound: force generators, fluids, constraints, grains, LOD tiers and
+	// adaptive step sizes carry on with what they have, so re-simulation is exact for plain impulse mode scenes
+	void setHistory(int capacity, int keyframeInterval = 16);
+	bool rewind(int step);
+	SnapshotRing& getHistory() { return m_history; }
 
-	void setTimeStep(const float timeStep) { m_timeStep = timeStep; }
-	float getTimeStep() const { return m_timeStep; }
+	void setSceneMode(SceneMode sceneMode) { m_sceneMode = sceneMode; }
+	SceneMode getSceneMode() const { return m_sceneMode; }
+	GranularSolver& getGranularSolver() { return m_granularSolver; }
+
+	BroadPhase& getBroadPhase() { return m_broadPhase; }
+
+	// A periodic domain wraps bodies round at its edges instead of fencing them in with Planes. Pairs are found and
+	// resolved through the minimum image; constraints, grains, fluids and scene queries don't see the wrap
+	void setPeriodicDomain(glm::vec2 min, glm::vec2 max) { m_broadPhase.setPeriodicDomain(min, max); m_verletList.invalidate(); }
+	void clearPeriodicDomain() { m_broadPhase.clearPeriodicDomain(); m_verletList.invalidate(); }
+	bool isPeriodic() const { return m_broadPhase.isPeriodic(); }
+
+	void setPairProvider(PairProvider pairProvider) { m_pairProvider = pairProvider; m_verletList.invalidate(); }
+	PairProvider getPairProvider() const { return m_pairProvider; }
+	VerletList& getVerletList() { return m_verletList; }
+
+	// Begin, persist and end events for the pairs touching each step, see ContactStream. Read them after update, they
+	// cover every step that update took. Removing an actor ends its pairs on the next step, and a rewind forgets them all
+	void setContactEvents(bool contactEvents) { m_contactEvents = contactEvents; m_contacts.reset(); }
+	bool getContactEvents() const { return m_contactEvents; }
+	ContactStream& getContactStream() { return m_contacts; }
+
+	// Raycasts, overlap and nearest-neighbour queries against the state from the last step
+	const SceneQuery& getSceneQuery() const { return m_sceneQuery; }
 
 	//============================================================================================================================================
 	// Collision
 
+	// The Plane, Sphere and AABB routines are BasicPhysicsScene's
 	void checkForCollision();
-	// Planes
-	static bool plane2Plane(PhysicsObject* obj1, PhysicsObject* obj2);
-	static bool plane2Sphere(PhysicsObject* obj1, PhysicsObject* obj2);
-	static bool plane2AABB(PhysicsObject* obj1, PhysicsObject* obj2);
-	// Spheres
-	static bool sphere2Plane(PhysicsObject* obj1, PhysicsObject* obj2);
-	static bool sphere2Sphere(PhysicsObject* obj1, PhysicsObject* obj2);
-	static bool sphere2AABB(PhysicsObject* obj1, PhysicsObject* obj2);
-	// AABBs
-	static bool AABB2Plane(PhysicsObject* obj1, PhysicsObject* obj2);
-	static bool AABB2Sphere(PhysicsObject* obj1, PhysicsObject* obj2);
-	static bool AABB2AABB(PhysicsObject* obj1, PhysicsObject* obj2);
-
-	static void separateCollision(PhysicsObject* obj1, PhysicsObject* obj2, glm::vec2 normal, float overlap);
+	static bool sphere2SDF(PhysicsObject* obj1, PhysicsObject* obj2);
+	static bool AABB2SDF(PhysicsObject* obj1, PhysicsObject* obj2);
+	// Signed distance fields, static so they never meet Planes or each other
+	static bool SDF2Sphere(PhysicsObject* obj1, PhysicsObject* obj2);
+	static bool SDF2AABB(PhysicsObject* obj1, PhysicsObject* obj2);
 
 protected:
-	glm::vec2 m_gravity;
-	float m_timeStep;
-	std::vector<PhysicsObject*> m_actors;
+	//============================================================================================================================================
+	// Static Geometry
+
+	void gatherBodyData();
+	void checkPlaneCollisions();
+	void wrapPositions();
+	void integrateBodies(bool startForces);
+	void rebuildPlaneData();
+
+	// Bodies the broadphase, narrowphase and plane pass see, everything but the grains in granular mode
+	const std::vector<PhysicsObject*>& getCollisionActors() const { return (m_sceneMode == GRANULAR_MODE) ? m_rigidActors : m_actors; }
+
+	std::vector<ForceGenerator*> m_forceGenerators;
+	ForceFieldSystem m_forceFields;
+	std::vector<FluidSystem*> m_fluids;
+	ConstraintSolver m_constraints;
+
+	IntegratorType m_integrator;
+	BodyIntegrator m_bodyIntegrator;
+	bool m_adaptiveStepping;
+	AdaptiveIntegrator m_adaptiveIntegrator;
+	bool m_lodScheduling;
+	bool m_lodStep;				// Scheduling applies to the step being taken
+	LodScheduler m_lodScheduler;
+	MortonOrder m_mortonOrder;
+	SnapshotRing m_history;
+	int m_stepCount;			// Fixed steps taken, or the step rewound to
+
+	SceneMode m_sceneMode;
+	GranularSolver m_granularSolver;
+	std::vector<PhysicsObject*> m_rigidActors;	// Non-grain actors, filled every step in granular mode
+
+	BroadPhase m_broadPhase;
+	std::vector<CollisionPair> m_collisionPairs;	// Pairs that passed the broadphase this step
+	PairProvider m_pairProvider;
+	VerletList m_verletList;
+
+	// Half-spaces of every static Plane as flat arrays
+	std::vector<Plane*> m_planes;
+	std::vector<float> m_planeNormalX;
+	std::vector<float> m_planeNormalY;
+	std::vector<float> m_planeDistance;
+
+	SceneQuery m_sceneQuery;	// Declared after the broadphase and Planes it reads
+
+	bool m_contactEvents;
+	ContactStream m_contacts;
+
+	// Per-step body data for the batched plane pass, padded to a whole number of batches
+	std::vector<float> m_bodyPositionX;
+	std::vector<float> m_bodyPositionY;
+	std::vector<float> m_bodyExtentX;
+	std::vector<float> m_bodyExtentY;
+	std::vector<float> m_bodyRadius;
 };
\ No newline at end of file
@@ -2,26 +2,49 @@
 #include "Plane.h"
 #include "PhysicsEngineApp.h"
 #include "RigidBody.h"
+#include "Fixed64.h"
 
 // Other includes
 #include <Gizmos.h>
 
 // Typedefs
 
+// Draw Plane, a long line along it in 2D. In 3D an infinite plane has no outline worth drawing, scenes draw their own
+// bounds
+static void drawPlane(const glm::vec2& normal, float distanceToOrigin)
+{
+	// Set the plane's length
+	float lineSegmentLength = 300;
+	// Set the center point
+	glm::vec2 centerPoint = normal * distanceToOrigin;
+
+	// easy to rotate normal through 90 degrees around z
+	glm::vec2 parallel(normal.y, -normal.x);
+	glm::vec4 colour(1, 1, 1, 1);
+	glm::vec2 start = centerPoint + (parallel * lineSegmentLength);
+	glm::vec2 end = centerPoint - (parallel * lineSegmentLength);
+	aie::Gizmos::add2DLine(start, end, colour);
+}
+static void drawPlane(const glm::vec3&, float)
+{
+}
+
 //============================================================================================================================================
 // Constructors
 
 // Constructor
-Plane::Plane() : PhysicsObject(ShapeType::PLANE)
+template <class Scalar, int Dimensions>
+BasicPlane<Scalar, Dimensions>::BasicPlane() : Object(ShapeType::PLANE, STATIC_BODY)
 {
 	// Set the distance from the plane's origin
-	m_distanceToOrigin = 0;
+	m_distanceToOrigin = Scalar(0);
 	// Set the plane's normal
-	m_normal = glm::vec2(0, 1);
+	m_normal = VectorMath<Scalar, Dimensions>::axis(1);
 }
 
-Plane::Plane(const glm::vec2 & normal, float distanceToOrigin, glm::vec4 color)
-	: PhysicsObject(ShapeType::PLANE)
+template <class Scalar, int Dimensions>
+BasicPlane<Scalar, Dimensions>::BasicPlane(const Vector & normal, Scalar distanceToOrigin, glm::vec4 color)
+	: Object(ShapeType::PLANE, STATIC_BODY)
 	, m_normal(normal)
 	, m_distanceToOrigin(distanceToOrigin)
 {
@@ -32,40 +55,48 @@ Plane::Plane(const glm::vec2 & normal, float distanceToOrigin, glm::vec4 color)
 // Gizmo Functions
 
 // Make Gizmo
-void Plane::makeGizmo()
+template <class Scalar, int Dimensions>
+void BasicPlane<Scalar, Dimensions>::makeGizmo()
 {
-	// Set the plane's length
-	float lineSegmentLength = 300;
-	// Set the center point
-	glm::vec2 centerPoint = m_normal * m_distanceToOrigin;
-	
-	// easy to rotate normal through 90 degrees around z
-	glm::vec2 parallel(m_normal.y, -m_normal.x);
-	glm::vec4 colour(1, 1, 1, 1);
-	glm::vec2 start = centerPoint + (parallel * lineSegmentLength);
-	glm::vec2 end = centerPoint - (parallel * lineSegmentLength);
-	aie::Gizmos::add2DLine(start, end, colour);
+	drawPlane(VectorMath<Scalar, Dimensions>::toFloat(m_normal), ScalarMath<Scalar>::toFloat(m_distanceToOrigin));
 }
 
 //============================================================================================================================================
 // Collision Functions
 
 // Resolve Collision
-void Plane::resolveCollision(Rigidbody* actor2, glm::vec2 cnor)
+template <class Scalar, int Dimensions>
+void BasicPlane<Scalar, Dimensions>::resolveCollision(Body* actor2, Vector cnor)
 {
+	typedef VectorMath<Scalar, Dimensions> VMath;
+
+	// Only dynamic bodies respond to impulses
+	if (!actor2->isDynamic())
+	{
+		return;
+	}
+
 	// Set the normal
-	glm::vec2 normal = m_normal;
+	Vector normal = m_normal;
 	// Get the relative velocity from the second actor
-	glm::vec2 relativeVelocity = actor2->getVelocity();
+	Vector relativeVelocity = actor2->getVelocity();
 
 	// Set elasticity
-	float elasticity = 1;
+	Scalar elasticity = Scalar(1);
 	// Set the impulse magnitude
-	float j = glm::dot(-(1 + elasticity) * (relativeVelocity), normal) / glm::dot(normal, normal * ((1 / actor2->getMass())));
+	Scalar j = VMath::dot(-(Scalar(1) + elasticity) * (relativeVelocity), normal) / VMath::dot(normal, normal * ((Scalar(1) / actor2->getMass())));
 
 	// Set force
-	glm::vec2 force = normal * j;
+	Vector force = normal * j;
 
 	// Apply velocity to the second actor
 	actor2->setVelocity(actor2->getVelocity() + force / actor2->getMass());
-}
\ No newline at end of file
+}
+
+//============================================================================================================================================
+// Instantiations
+
+template class BasicPlane<float, 2>;
+template class BasicPlane<double, 2>;
+template class BasicPlane<Fixed64, 2>;
+template class BasicPlane<float, 3>;
\ No newline at end of file
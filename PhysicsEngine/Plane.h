@@ -8,34 +8,38 @@
 
 // Typedefs
 
-class Plane : public PhysicsObject
+template <class Scalar, int Dimensions>
+class BasicPlane : public BasicPhysicsObject<Scalar, Dimensions>
 {
 
 public:
+	typedef BasicPhysicsObject<Scalar, Dimensions> Object;
+	typedef typename Object::Vector Vector;
+	typedef BasicRigidbody<Scalar, Dimensions> Body;
 
 	//============================================================================================================================================
 	// Constructors
 
-	Plane();
-	Plane(const glm::vec2& normal, float distanceToOrigin, glm::vec4 color);
-	//~Plane();
+	BasicPlane();
+	BasicPlane(const Vector& normal, Scalar distanceToOrigin, glm::vec4 color);
+	//~BasicPlane();
 
 	//============================================================================================================================================
 	// Getters And Setters
 
-	glm::vec2 getNormal() { return m_normal; }
-	float getDistanceToOrigin() { return m_distanceToOrigin; }
+	Vector getNormal() { return m_normal; }
+	Scalar getDistanceToOrigin() { return m_distanceToOrigin; }
 
 	//============================================================================================================================================
 	// Misc
 
-	virtual void fixedUpdate(glm::vec2 gravity, float dt) override {}
+	virtual void fixedUpdate(Vector gravity, Scalar dt) override {}
 	virtual void debug() override {}
 	virtual void makeGizmo();
-	void resolveCollision(Rigidbody* actor2, glm::vec2 cnor);
+	void resolveCollision(Body* actor2, Vector cnor);
 
 private:
-	glm::vec2 m_normal;
-	float m_distanceToOrigin;
+	Vector m_normal;
+	Scalar m_distanceToOrigin;
 
 };
\ No newline at end of file
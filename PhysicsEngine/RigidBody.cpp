@@ -1,5 +1,6 @@
 // Include .h files
 #include "RigidBody.h"
+#include "Fixed64.h"
 
 // Other includes
 
@@ -10,87 +11,231 @@
 // Constructors
 
 // Constructor
-Rigidbody::Rigidbody(ShapeType shapeID, glm::vec2 position, glm::vec2 velocity, glm::vec2 acceleration, float rotation, float mass, float elasticity) : PhysicsObject(shapeID)
+template <class Scalar, int Dimensions>
+BasicRigidbody<Scalar, Dimensions>::BasicRigidbody(ShapeType shapeID, Vector position, Vector velocity, Vector acceleration, float rotation, Scalar mass, float elasticity) : Object(shapeID)
 {
-	// Set ShapeID
-	m_shapeID = shapeID;
-	// Set Position, Velocity and Acceleration
+	// Set Position, Velocity, Acceleration and Mass
 	m_position = position;
 	m_velocity = velocity;
 	m_acceleration = acceleration;
-	// Set Rotation, Mass and Elasticity	
-	m_rotation = rotation;
 	m_mass = mass;
-	m_elasticity = elasticity;
-	// Set Linear and Angular Drag
-	m_linearDrag = 0.0f;
-	m_minLinearDrag = 0.1f;
-	m_angularDrag = 0.3f;
-	m_minAngularDrag = 0.01f;
+
+	// Set Elasticity and Drag, shared with every other body set up the same way
+	BodyMaterial material;
+	material.elasticity = elasticity;
+	material.charge = 0.0f;
+	material.linearDrag = 0.0f;
+	material.minLinearDrag = 0.1f;
+	material.angularDrag = 0.3f;
+	material.minAngularDrag = 0.01f;
+	m_material = MaterialTable::add(material);
+
+	// Set Rotation, white until the shape sets its colour
+	BodyRenderState renderState;
+	renderState.color = glm::vec4(1, 1, 1, 1);
+	renderState.rotation = rotation;
+	m_renderState = RenderStateTable::add(renderState);
+}
+
+// Copy Constructor, a copy shares the same table entries
+template <class Scalar, int Dimensions>
+BasicRigidbody<Scalar, Dimensions>::BasicRigidbody(const BasicRigidbody& other) : Object(other)
+{
+	m_position = other.m_position;
+	m_velocity = other.m_velocity;
+	m_acceleration = other.m_acceleration;
+	m_mass = other.m_mass;
+	m_material = other.m_material;
+	m_renderState = other.m_renderState;
+	MaterialTable::acquire(m_material);
+	RenderStateTable::acquire(m_renderState);
+}
+
+// Copy Assignment
+template <class Scalar, int Dimensions>
+BasicRigidbody<Scalar, Dimensions>& BasicRigidbody<Scalar, Dimensions>::operator=(const BasicRigidbody& other)
+{
+	// Acquired before releasing, so assigning a body to itself can't free its own entries
+	MaterialTable::acquire(other.m_material);
+	RenderStateTable::acquire(other.m_renderState);
+	MaterialTable::release(m_material);
+	RenderStateTable::release(m_renderState);
+
+	Object::operator=(other);
+	m_position = other.m_position;
+	m_velocity = other.m_velocity;
+	m_acceleration = other.m_acceleration;
+	m_mass = other.m_mass;
+	m_material = other.m_material;
+	m_renderState = other.m_renderState;
+	return *this;
+}
+
+// Destructor
+template <class Scalar, int Dimensions>
+BasicRigidbody<Scalar, Dimensions>::~BasicRigidbody()
+{
+	MaterialTable::release(m_material);
+	RenderStateTable::release(m_renderState);
 }
 
-void Rigidbody::fixedUpdate(glm::vec2 gravity, float timeStep)
+// Fixed Update, semi-implicit Euler
+template <class Scalar, int Dimensions>
+void BasicRigidbody<Scalar, Dimensions>::fixedUpdate(Vector gravity, Scalar timeStep)
 {
+	// Static bodies never move
+	if (this->isStatic())
+	{
+		return;
+	}
+
+	// Kinematic bodies follow their own velocity and ignore gravity and applied forces
+	if (this->isKinematic())
+	{
+		m_position += m_velocity * timeStep;
+		m_acceleration = VMath::zero();
+		return;
+	}
+
 	// F = m * a
 	// a = F / m
 	// v += a * t
 
+	const BodyMaterial& material = MaterialTable::get(m_material);
+
 	applyForce(gravity * m_mass);
 	m_velocity += m_acceleration * timeStep;
 
-	m_velocity -= m_velocity * m_linearDrag * timeStep;
+	m_velocity -= m_velocity * Math::fromFloat(material.linearDrag) * timeStep;
 
 	m_position += m_velocity * timeStep;
 
-	m_acceleration = glm::vec2(0, 0);
+	m_acceleration = VMath::zero();
 
-	if (length(m_velocity) < m_minLinearDrag)
+	if (VMath::length(m_velocity) < Math::fromFloat(material.minLinearDrag))
 	{
-		m_velocity = glm::vec2(0, 0);
-	}
-	if (abs(m_angularVelocity) < m_minAngularDrag)
-	{
-		m_angularVelocity = 0;
+		m_velocity = VMath::zero();
 	}
 }
 
 // Debugging
-void Rigidbody::debug()
+template <class Scalar, int Dimensions>
+void BasicRigidbody<Scalar, Dimensions>::debug()
 {
 	// Sorry nothing
 }
 
-void Rigidbody::applyForce(glm::vec2 force)
+// Apply Force
+template <class Scalar, int Dimensions>
+void BasicRigidbody<Scalar, Dimensions>::applyForce(Vector force)
 {
-	glm::vec2 acc = force / m_mass;
+	Vector acc = force / m_mass;
 	m_acceleration += acc;
 }
 
-void Rigidbody::applyForceToActor(Rigidbody* actor2, glm::vec2 force)
+// Apply Force To Actor
+template <class Scalar, int Dimensions>
+void BasicRigidbody<Scalar, Dimensions>::applyForceToActor(BasicRigidbody* actor2, Vector force)
 {
 	applyForce(force);
 	actor2->applyForce(-force);
 }
 
-void Rigidbody::setVelocity(glm::vec2 velocity)
+// Set Velocity
+template <class Scalar, int Dimensions>
+void BasicRigidbody<Scalar, Dimensions>::setVelocity(Vector velocity)
 {
 	m_velocity = velocity;
 }
 
-void Rigidbody::setPosition(glm::vec2 position)
+// Set Position
+template <class Scalar, int Dimensions>
+void BasicRigidbody<Scalar, Dimensions>::setPosition(Vector position)
 {
 	m_position = position;
 }
 
-void Rigidbody::resolveCollision(Rigidbody* actor2, glm::vec2 cnor)
+// Set Charge
+template <class Scalar, int Dimensions>
+void BasicRigidbody<Scalar, Dimensions>::setCharge(float charge)
 {
-		glm::vec2 normal = cnor;
-		glm::vec2 relativeVelocity = actor2->getVelocity() - m_velocity;
-		float elasticity = (m_elasticity + actor2->getElasticity()) / 2.0f;
-		float j = (-(1 + elasticity) * glm::dot((relativeVelocity), normal)) / (glm::dot(normal, normal) * ((1 / m_mass) + (1 / actor2->getMass())));
+	BodyMaterial material = MaterialTable::get(m_material);
+	material.charge = charge;
+	setMaterial(material);
+}
 
-		glm::vec2 force = normal * j;
+// Set Linear Drag
+template <class Scalar, int Dimensions>
+void BasicRigidbody<Scalar, Dimensions>::setLinearDrag(float linearDrag)
+{
+	BodyMaterial material = MaterialTable::get(m_material);
+	material.linearDrag = linearDrag;
+	setMaterial(material);
+}
 
-		setVelocity(getVelocity() - force / getMass());
-		actor2->setVelocity(actor2->getVelocity() + force / actor2->getMass());
+// Set Material, the old entry is given back once the new one is held so an unchanged material is never freed
+template <class Scalar, int Dimensions>
+void BasicRigidbody<Scalar, Dimensions>::setMaterial(const BodyMaterial& material)
+{
+	unsigned int oldMaterial = m_material;
+	m_material = MaterialTable::add(material);
+	MaterialTable::release(oldMaterial);
 }
+
+// Set Material Index
+template <class Scalar, int Dimensions>
+void BasicRigidbody<Scalar, Dimensions>::setMaterialIndex(unsigned int material)
+{
+	MaterialTable::acquire(material);
+	MaterialTable::release(m_material);
+	m_material = material;
+}
+
+// Set Color
+template <class Scalar, int Dimensions>
+void BasicRigidbody<Scalar, Dimensions>::setColor(glm::vec4 color)
+{
+	BodyRenderState renderState = RenderStateTable::get(m_renderState);
+	renderState.color = color;
+	unsigned int oldRenderState = m_renderState;
+	m_renderState = RenderStateTable::add(renderState);
+	RenderStateTable::release(oldRenderState);
+}
+
+// Resolve Collision
+template <class Scalar, int Dimensions>
+void BasicRigidbody<Scalar, Dimensions>::resolveCollision(BasicRigidbody* actor2, Vector cnor)
+{
+		// Static and kinematic bodies have zero inverse mass, so only the dynamic side takes the impulse
+		Scalar inverseMass1 = getInverseMass();
+		Scalar inverseMass2 = actor2->getInverseMass();
+		if ((inverseMass1 + inverseMass2) == Scalar(0))
+		{
+			return;
+		}
+
+		Vector normal = cnor;
+		Vector relativeVelocity = actor2->getVelocity() - m_velocity;
+		Scalar elasticity = (Math::fromFloat(getElasticity()) + Math::fromFloat(actor2->getElasticity())) / Scalar(2);
+		Scalar j = (-(Scalar(1) + elasticity) * VMath::dot((relativeVelocity), normal)) / (VMath::dot(normal, normal) * (inverseMass1 + inverseMass2));
+
+		Vector force = normal * j;
+
+		// The infinite mass side is left untouched, so static colliders are only ever read during a step
+		if (inverseMass1 != Scalar(0))
+		{
+			setVelocity(getVelocity() - force * inverseMass1);
+		}
+		if (inverseMass2 != Scalar(0))
+		{
+			actor2->setVelocity(actor2->getVelocity() + force * inverseMass2);
+		}
+}
+
+//============================================================================================================================================
+// Instantiations
+
+template class BasicRigidbody<float, 2>;
+template class BasicRigidbody<double, 2>;
+template class BasicRigidbody<Fixed64, 2>;
+template class BasicRigidbody<float, 3>;
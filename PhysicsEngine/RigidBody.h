@@ -1,69 +1,88 @@
 #pragma once
 // Include .h files
 #include "PhysicsObject.h"
+#include "BodyTables.h"
 
 // Other includes
 #include <glm\vec2.hpp>
+#include <glm\vec4.hpp>
 #include <glm\glm.hpp>
 
 // Typedefs
 
-class Rigidbody : public PhysicsObject
+//============================================================================================================================================
+// BasicRigidbody CLASS
+
+// A body that moves, Rigidbody in the 2D float engine. Materials and colours are kept as floats in the shared tables
+// whatever the scalar type, and converted where the step reads them
+template <class Scalar, int Dimensions>
+class BasicRigidbody : public BasicPhysicsObject<Scalar, Dimensions>
 {
 
 public:
-	Rigidbody(ShapeType shapeID, glm::vec2 position, glm::vec2 velocity, glm::vec2 acceleration, float rotation, float mass, float elasticity);
-	//~Rigidbody();
+	typedef BasicPhysicsObject<Scalar, Dimensions> Object;
+	typedef typename Object::Vector Vector;
+	typedef ScalarMath<Scalar> Math;
+	typedef VectorMath<Scalar, Dimensions> VMath;
+
+	BasicRigidbody(ShapeType shapeID, Vector position, Vector velocity, Vector acceleration, float rotation, Scalar mass, float elasticity);
+	BasicRigidbody(const BasicRigidbody& other);
+	BasicRigidbody& operator=(const BasicRigidbody& other);
+	virtual ~BasicRigidbody();
 		
-	virtual void fixedUpdate(glm::vec2 gravity, float timeStep);
+	virtual void fixedUpdate(Vector gravity, Scalar timeStep);
 	virtual void debug();
 
 	//============================================================================================================================================
 	// Apply Force
 
-	void applyForce(glm::vec2 force);
-	void applyForceToActor(Rigidbody* actor2, glm::vec2 force);
+	void applyForce(Vector force);
+	void applyForceToActor(BasicRigidbody* actor2, Vector force);
 
 	//============================================================================================================================================
 	// Collision
 
-	virtual bool checkCollision(PhysicsObject* pOther) = 0;
-	void resolveCollision(Rigidbody* actor2, glm::vec2 cnor);
+	virtual bool checkCollision(Object* pOther) = 0;
+	void resolveCollision(BasicRigidbody* actor2, Vector cnor);
 
 	//============================================================================================================================================
 	// Getters and Setters
 
-	glm::vec2 getPosition() { return m_position; }
-	glm::vec2 getVelocity() { return m_velocity; }
-	float getRotation()		{ return m_rotation; }
-	float getMass()			{ return m_mass; }
-	float getElasticity()	{ return m_elasticity; }
-
-	void setPosition(glm::vec2 position);
-	void setVelocity(glm::vec2 velocity);
+	Vector getPosition() { return m_position; }
+	Vector getVelocity() { return m_velocity; }
+	Vector getAcceleration() { return m_acceleration; }	// Forces applied since the last fixedUpdate, over mass
+	Scalar getMass()		{ return m_mass; }
+	Scalar getInverseMass()	{ return this->isDynamic() ? (Scalar(1) / m_mass) : Scalar(0); } // Static and kinematic bodies act as infinite mass
+	float getElasticity()	{ return MaterialTable::get(m_material).elasticity; }
+	float getCharge()		{ return MaterialTable::get(m_material).charge; }
+	float getLinearDrag()	{ return MaterialTable::get(m_material).linearDrag; }
+	float getMinLinearDrag() { return MaterialTable::get(m_material).minLinearDrag; }	// Slower than this and the body comes to rest
+	const BodyMaterial& getMaterial() { return MaterialTable::get(m_material); }
+	float getRotation()		{ return RenderStateTable::get(m_renderState).rotation; }
+	glm::vec4 getColor()	{ return RenderStateTable::get(m_renderState).color; }
+
+	virtual void setPosition(Vector position);
+	void setVelocity(Vector velocity);
+	void setAcceleration(Vector acceleration) { m_acceleration = acceleration; }
+	void setCharge(float charge);
+	void setLinearDrag(float linearDrag);
+	void setMaterial(const BodyMaterial& material);
+	unsigned int getMaterialIndex() { return m_material; }	// The entry in MaterialTable, for saving and restoring state
+	void setMaterialIndex(unsigned int material);		// Whoever saved the index has to hold a reference to it meanwhile
+	void setColor(glm::vec4 color);
 
 protected:
 	//============================================================================================================================================
-	// Position, Velocity, Acceleration
-
-	glm::vec2 m_position;
-	glm::vec2 m_velocity;
-	glm::vec2 m_acceleration;
-
-	//============================================================================================================================================
-	// Mass, Rotation, Elasticity
+	// Hot, read and written every step
 
-	float m_mass;
-	float m_rotation;
-	float m_elasticity;
+	Vector m_position;
+	Vector m_velocity;
+	Vector m_acceleration;
+	Scalar m_mass;
 
 	//============================================================================================================================================
-	// Linear and Angular Drag
-
-	float m_linearDrag;
-	float m_minLinearDrag;
-	float m_angularDrag;
-	float m_minAngularDrag;
+	// Warm and cold, shared entries in MaterialTable and RenderStateTable, each holding a reference
 
-	float m_angularVelocity;
+	unsigned int m_material;		// Elasticity, charge and drag
+	unsigned int m_renderState;		// Colour and rotation
 };
\ No newline at end of file
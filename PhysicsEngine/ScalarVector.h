@@ -0,0 +1,326 @@
+#pragma once
+// Include .h files
+#include "Fixed64.h"
+
+// Other includes
+#include <cmath>
+#include <cstring>
+#include <glm\vec2.hpp>
+#include <glm\vec3.hpp>
+#include <glm\glm.hpp>
+
+// Typedefs
+
+//============================================================================================================================================
+// ScalarMath STRUCT
+
+// The maths each scalar type brings with it. float and double go straight to the hardware, Fixed64 to its own integer
+// routines. bits gives the raw representation so runs can be compared bit for bit
+template <class Scalar>
+struct ScalarMath;
+
+template <>
+struct ScalarMath<float>
+{
+	static float sqrt(float value) { return std::sqrt(value); }
+	static float abs(float value) { return std::fabs(value); }
+	static float fromFloat(float value) { return value; }
+	static float toFloat(float value) { return value; }
+	static double toDouble(float value) { return value; }
+	static unsigned long long bits(float value) { unsigned int raw; std::memcpy(&raw, &value, sizeof(raw)); return raw; }
+	static const char* getName() { return "float"; }
+};
+
+template <>
+struct ScalarMath<double>
+{
+	static double sqrt(double value) { return std::sqrt(value); }
+	static double abs(double value) { return std::fabs(value); }
+	static double fromFloat(float value) { return value; }
+	static float toFloat(double value) { return (float)value; }
+	static double toDouble(double value) { return value; }
+	static unsigned long long bits(double value) { unsigned long long raw; std::memcpy(&raw, &value, sizeof(raw)); return raw; }
+	static const char* getName() { return "double"; }
+};
+
+template <>
+struct ScalarMath<Fixed64>
+{
+	static Fixed64 sqrt(Fixed64 value) { return Fixed64::sqrt(value); }
+	static Fixed64 abs(Fixed64 value) { return Fixed64::abs(value); }
+	static Fixed64 fromFloat(float value) { return Fixed64(value); }
+	static float toFloat(Fixed64 value) { return value.toFloat(); }
+	static double toDouble(Fixed64 value) { return value.toDouble(); }
+	static unsigned long long bits(Fixed64 value) { return (unsigned long long)value.getRaw(); }
+	static const char* getName() { return "Q32.32"; }
+};
+
+//============================================================================================================================================
+// GlmVector STRUCT
+
+// The glm float vector with the same number of dimensions, what scenes take positions in and hand them back as
+template <int Dimensions>
+struct GlmVector;
+
+template <>
+struct GlmVector<2>
+{
+	typedef glm::vec2 Type;
+};
+
+template <>
+struct GlmVector<3>
+{
+	typedef glm::vec3 Type;
+};
+
+//============================================================================================================================================
+// ScalarVector STRUCT
+
+// Small fixed size vector over any scalar type. glm's vectors insist on floating point for length, dot and normalize,
+// this one only needs the scalar to add, multiply and compare
+template <class Scalar, int Dimensions>
+struct ScalarVector
+{
+	Scalar components[Dimensions];
+
+	ScalarVector()
+	{
+		for (int axis = 0; axis < Dimensions; axis++)
+		{
+			components[axis] = Scalar(0);
+		}
+	}
+
+	ScalarVector(Scalar x, Scalar y)
+	{
+		static_assert(Dimensions >= 2, "ScalarVector(x, y) needs at least 2 dimensions");
+		for (int axis = 0; axis < Dimensions; axis++)
+		{
+			components[axis] = Scalar(0);
+		}
+		components[0] = x;
+		components[1] = y;
+	}
+
+	ScalarVector(Scalar x, Scalar y, Scalar z)
+	{
+		static_assert(Dimensions >= 3, "ScalarVector(x, y, z) needs at least 3 dimensions");
+		for (int axis = 0; axis < Dimensions; axis++)
+		{
+			components[axis] = Scalar(0);
+		}
+		components[0] = x;
+		components[1] = y;
+		components[2] = z;
+	}
+
+	Scalar& operator[](int axis) { return components[axis]; }
+	const Scalar& operator[](int axis) const { return components[axis]; }
+
+	ScalarVector operator+(const ScalarVector& other) const
+	{
+		ScalarVector result;
+		for (int axis = 0; axis < Dimensions; axis++)
+		{
+			result.components[axis] = components[axis] + other.components[axis];
+		}
+		return result;
+	}
+
+	ScalarVector operator-(const ScalarVector& other) const
+	{
+		ScalarVector result;
+		for (int axis = 0; axis < Dimensions; axis++)
+		{
+			result.components[axis] = components[axis] - other.components[axis];
+		}
+		return result;
+	}
+
+	ScalarVector operator-() const
+	{
+		ScalarVector result;
+		for (int axis = 0; axis < Dimensions; axis++)
+		{
+			result.components[axis] = -components[axis];
+		}
+		return result;
+	}
+
+	ScalarVector operator*(Scalar scale) const
+	{
+		ScalarVector result;
+		for (int axis = 0; axis < Dimensions; axis++)
+		{
+			result.components[axis] = components[axis] * scale;
+		}
+		return result;
+	}
+
+	ScalarVector operator/(Scalar scale) const
+	{
+		ScalarVector result;
+		for (int axis = 0; axis < Dimensions; axis++)
+		{
+			result.components[axis] = components[axis] / scale;
+		}
+		return result;
+	}
+
+	ScalarVector& operator+=(const ScalarVector& other) { *this = *this + other; return *this; }
+	ScalarVector& operator-=(const ScalarVector& other) { *this = *this - other; return *this; }
+
+	static Scalar dot(const ScalarVector& a, const ScalarVector& b)
+	{
+		Scalar result = Scalar(0);
+		for (int axis = 0; axis < Dimensions; axis++)
+		{
+			result += a.components[axis] * b.components[axis];
+		}
+		return result;
+	}
+
+	bool operator==(const ScalarVector& other) const
+	{
+		for (int axis = 0; axis < Dimensions; axis++)
+		{
+			if (components[axis] != other.components[axis])
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool operator!=(const ScalarVector& other) const { return !(*this == other); }
+};
+
+// Scale
+template <class Scalar, int Dimensions>
+ScalarVector<Scalar, Dimensions> operator*(Scalar scale, const ScalarVector<Scalar, Dimensions>& vector)
+{
+	return vector * scale;
+}
+
+//============================================================================================================================================
+// CoreVector STRUCT
+
+// The vector type bodies of each scalar type and dimension are stored in. float and double use glm's own vectors, so
+// the float 2D engine keeps taking and handing back glm::vec2; Fixed64 has no glm vector and uses ScalarVector
+template <class Scalar, int Dimensions>
+struct CoreVector
+{
+	typedef ScalarVector<Scalar, Dimensions> Type;
+};
+
+template <>
+struct CoreVector<float, 2>
+{
+	typedef glm::vec2 Type;
+};
+
+template <>
+struct CoreVector<float, 3>
+{
+	typedef glm::vec3 Type;
+};
+
+template <>
+struct CoreVector<double, 2>
+{
+	typedef glm::dvec2 Type;
+};
+
+template <>
+struct CoreVector<double, 3>
+{
+	typedef glm::dvec3 Type;
+};
+
+//============================================================================================================================================
+// VectorMath STRUCT
+
+// What the core needs from a vector, written once over the axes so it works the same on glm vectors and ScalarVector.
+// Each one does the same operations in the same order as the glm function of the same name, so float results don't
+// change bit for bit
+template <class Scalar, int Dimensions>
+struct VectorMath
+{
+	typedef typename CoreVector<Scalar, Dimensions>::Type Vector;
+	typedef typename GlmVector<Dimensions>::Type FloatVector;
+	typedef ScalarMath<Scalar> Math;
+
+	// Unit vector along an axis
+	static Vector axis(int axis, Scalar sign = Scalar(1))
+	{
+		Vector result = zero();
+		result[axis] = sign;
+		return result;
+	}
+
+	static Vector zero()
+	{
+		Vector result;
+		for (int axis = 0; axis < Dimensions; axis++)
+		{
+			result[axis] = Scalar(0);
+		}
+		return result;
+	}
+
+	static Scalar dot(const Vector& a, const Vector& b)
+	{
+		Scalar result = a[0] * b[0];
+		for (int axis = 1; axis < Dimensions; axis++)
+		{
+			result = result + (a[axis] * b[axis]);
+		}
+		return result;
+	}
+
+	static Scalar length(const Vector& value) { return Math::sqrt(dot(value, value)); }
+	static Scalar distance(const Vector& a, const Vector& b) { return length(b - a); }
+
+	static Vector abs(const Vector& value)
+	{
+		Vector result;
+		for (int axis = 0; axis < Dimensions; axis++)
+		{
+			result[axis] = Math::abs(value[axis]);
+		}
+		return result;
+	}
+
+	static Vector clamp(const Vector& value, const Vector& min, const Vector& max)
+	{
+		Vector result;
+		for (int axis = 0; axis < Dimensions; axis++)
+		{
+			Scalar raised = (value[axis] < min[axis]) ? min[axis] : value[axis];
+			result[axis] = (max[axis] < raised) ? max[axis] : raised;
+		}
+		return result;
+	}
+
+	// To and from glm's float vectors, for setting scenes up and drawing them
+	static Vector fromFloat(const FloatVector& value)
+	{
+		Vector result;
+		for (int axis = 0; axis < Dimensions; axis++)
+		{
+			result[axis] = Math::fromFloat(value[axis]);
+		}
+		return result;
+	}
+
+	static FloatVector toFloat(const Vector& value)
+	{
+		FloatVector result;
+		for (int axis = 0; axis < Dimensions; axis++)
+		{
+			result[axis] = Math::toFloat(value[axis]);
+		}
+		return result;
+	}
+};
\ No newline at end of file
@@ -0,0 +1,240 @@
+// Include .h files
+#include "SceneFork.h"
+
+// Other includes
+
+// Typedefs
+
+//============================================================================================================================================
+// Constructors
+
+// Constructor
+SceneFork::SceneFork()
+{
+	m_duration = 2.5f;
+	m_stepBudget = 300;
+	m_sampleInterval = 1;
+	m_busy = false;
+	m_started = false;
+	m_quit = false;
+	m_hasPaths = false;
+	m_forkCount = 0;
+	m_poolRebuilds = 0;
+}
+
+// Deconstructor
+SceneFork::~SceneFork()
+{
+	if (m_worker.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_quit = true;
+		}
+		m_wake.notify_one();
+		m_worker.join();
+	}
+
+	// The pools and the live scene own everything the fork points at
+	m_scene.releaseActors();
+}
+
+//============================================================================================================================================
+// Forking
+
+// Fork
+bool SceneFork::fork(PhysicsScene* scene)
+{
+	// The worker is idle from here until the job is started, so the fork can be written without holding the lock
+	if (isBusy())
+	{
+		return false;
+	}
+
+	m_scene.setGravity(scene->getGravity());
+	m_scene.setTimeStep(scene->getTimeStep());
+	m_scene.setIntegrator(scene->getIntegrator());
+	m_scene.setPairProvider(scene->getPairProvider());
+	m_scene.clearForceFields();
+	for (int i = 0; i < scene->getForceFields().getFieldCount(); i++)
+	{
+		m_scene.addForceField(scene->getForceFields().getField(i));
+	}
+	copyBodies(scene);
+
+	m_forkCount++;
+	m_workingPaths.bodies = m_sources;
+	m_workingPaths.forkNumber = m_forkCount;
+
+	// The worker only starts when something is first forked
+	if (!m_worker.joinable())
+	{
+		m_worker = std::thread(&SceneFork::runWorker, this);
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_busy = true;
+		m_started = true;
+	}
+	m_wake.notify_one();
+	return true;
+}
+
+// Take Paths
+bool SceneFork::takePaths(ForkPaths& paths)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (!m_hasPaths)
+	{
+		return false;
+	}
+	std::swap(paths, m_finishedPaths);
+	m_hasPaths = false;
+	return true;
+}
+
+// Is Busy
+bool SceneFork::isBusy() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_busy;
+}
+
+// Wait
+void SceneFork::wait()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_finished.wait(lock, [this] { return !m_busy; });
+}
+
+// Copy Bodies, over the pools in place while the live scene has the same bodies in the same order as last fork
+void SceneFork::copyBodies(PhysicsScene* scene)
+{
+	const std::vector<PhysicsObject*>& actors = scene->getActors();
+	if (actors != m_sources || scene->getStaticActors() != m_sharedStatics)
+	{
+		rebuildPools(scene);
+		return;
+	}
+
+	// Same address but a different shape is a body deleted and another made in its place
+	const std::vector<PhysicsObject*>& copies = m_scene.getActors();
+	int bodyCount = actors.size();
+	for (int i = 0; i < bodyCount; i++)
+	{
+		if (copies[i]->getShapeID() != actors[i]->getShapeID())
+		{
+			rebuildPools(scene);
+			return;
+		}
+
+		if (actors[i]->getShapeID() == SPHERE)
+		{
+			*static_cast<Sphere*>(copies[i]) = *static_cast<Sphere*>(actors[i]);
+		}
+		else
+		{
+			*static_cast<AABB*>(copies[i]) = *static_cast<AABB*>(actors[i]);
+		}
+	}
+}
+
+// Rebuild Pools, copies every body into pools sized to fit and points the fork at them and the live statics
+void SceneFork::rebuildPools(PhysicsScene* scene)
+{
+	m_scene.releaseActors();
+	m_spheres.clear();
+	m_boxes.clear();
+	m_sources.clear();
+	m_poolRebuilds++;
+
+	// Reserved up front so nothing moves once the fork holds pointers into the pools
+	int sphereCount = 0;
+	int boxCount = 0;
+	for (auto pActor : scene->getActors())
+	{
+		sphereCount += (pActor->getShapeID() == SPHERE) ? 1 : 0;
+		boxCount += (pActor->getShapeID() == AABB_) ? 1 : 0;
+	}
+	m_spheres.reserve(sphereCount);
+	m_boxes.reserve(boxCount);
+
+	for (auto pActor : scene->getActors())
+	{
+		if (pActor->getShapeID() == SPHERE)
+		{
+			m_spheres.push_back(*static_cast<Sphere*>(pActor));
+			m_scene.addActor(&m_spheres.back());
+			m_sources.push_back(pActor);
+		}
+		else if (pActor->getShapeID() == AABB_)
+		{
+			m_boxes.push_back(*static_cast<AABB*>(pActor));
+			m_scene.addActor(&m_boxes.back());
+			m_sources.push_back(pActor);
+		}
+	}
+
+	m_sharedStatics = scene->getStaticActors();
+	for (auto pStatic : m_sharedStatics)
+	{
+		m_scene.addActor(pStatic);
+	}
+}
+
+//============================================================================================================================================
+// Worker
+
+// Run Worker, waits for a fork, looks ahead and hands the paths over
+void SceneFork::runWorker()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true)
+	{
+		m_wake.wait(lock, [this] { return m_started || m_quit; });
+		if (m_quit)
+		{
+			return;
+		}
+		m_started = false;
+
+		lock.unlock();
+		lookAhead();
+		lock.lock();
+
+		std::swap(m_workingPaths, m_finishedPaths);
+		m_hasPaths = true;
+		m_busy = false;
+		m_finished.notify_all();
+	}
+}
+
+// Look Ahead, steps the fork and records every body's position each sample
+void SceneFork::lookAhead()
+{
+	float timeStep = m_scene.getTimeStep();
+	int stepCount = (timeStep > 0.0f) ? glm::min((int)((m_duration / timeStep) + 0.5f), m_stepBudget) : 0;
+	int sampleCount = stepCount / m_sampleInterval;
+	const std::vector<PhysicsObject*>& actors = m_scene.getActors();
+	int bodyCount = actors.size();
+
+	m_workingPaths.sampleCount = sampleCount;
+	m_workingPaths.sampleTime = timeStep * m_sampleInterval;
+	m_workingPaths.positions.resize(bodyCount * sampleCount);
+
+	for (int step = 0; step < stepCount; step++)
+	{
+		m_scene.update(timeStep);
+		if ((step + 1) % m_sampleInterval != 0)
+		{
+			continue;
+		}
+
+		int sample = ((step + 1) / m_sampleInterval) - 1;
+		glm::vec2* positions = m_workingPaths.positions.data();
+		for (int body = 0; body < bodyCount; body++)
+		{
+			positions[(body * sampleCount) + sample] = static_cast<Rigidbody*>(actors[body])->getPosition();
+		}
+	}
+}
\ No newline at end of file
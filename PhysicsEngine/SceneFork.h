@@ -0,0 +1,113 @@
+#pragma once
+// Include .h files
+#include "PhysicsScene.h"
+#include "Sphere.h"
+#include "AABB.h"
+
+// Other includes
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <glm\vec2.hpp>
+#include <glm\glm.hpp>
+
+// Typedefs
+
+//============================================================================================================================================
+// ForkPaths STRUCT
+
+// Where a fork's bodies went, one row per body
+struct ForkPaths
+{
+	ForkPaths() : sampleCount(0), sampleTime(0.0f), forkNumber(0) {}
+
+	std::vector<PhysicsObject*> bodies;	// The live bodies the rows belong to, for matching up only, they may be gone by now
+	std::vector<glm::vec2> positions;	// Body b at sample s is positions[(b * sampleCount) + s]
+	int sampleCount;
+	float sampleTime;					// Sample s is (s + 1) * sampleTime after the fork
+	int forkNumber;						// Which fork these came from, counting from 1
+};
+
+//============================================================================================================================================
+// SceneFork CLASS
+
+// Runs a copy of a live PhysicsScene forward on a worker thread for aiming previews and what-if overlays, leaving the live
+// scene alone. A fork copies only what a step writes: the moving bodies, into one pool per shape that is copied over in
+// place each fork while the live scene keeps the same bodies. Static colliders are shared rather than copied, as are
+// materials and colours through the body tables, since a step only ever reads them. Gravity, the time step, the
+// integrator, the pair provider and force fields come across each fork; force generators, fluids, constraints, grains,
+// LOD scheduling, adaptive stepping and periodic domains don't, and the fork steps plain impulse mode.
+// Forking is non-blocking: if the last job hasn't finished the fork is refused and the caller keeps the paths it has.
+// While a job runs the live scene can step as normal, but its static colliders mustn't be changed or deleted
+class SceneFork
+{
+
+public:
+	SceneFork();
+	~SceneFork();
+
+	//============================================================================================================================================
+	// Look Ahead
+
+	// How far ahead each fork looks, cut short by the step budget
+	void setDuration(float duration) { m_duration = duration; }
+	float getDuration() const { return m_duration; }
+
+	// The most fixed steps one job takes, so a small time step can't make a job run for frames
+	void setStepBudget(int stepBudget) { m_stepBudget = stepBudget; }
+	int getStepBudget() const { return m_stepBudget; }
+
+	// Positions are recorded every this many steps
+	void setSampleInterval(int sampleInterval) { m_sampleInterval = glm::max(sampleInterval, 1); }
+	int getSampleInterval() const { return m_sampleInterval; }
+
+	//============================================================================================================================================
+	// Forking
+
+	// Copies the live scene's state and starts stepping it on the worker. Returns false, copying nothing, while the last
+	// job is still running
+	bool fork(PhysicsScene* scene);
+
+	// Swaps in the newest finished paths, handing the old buffers back to be reused. Returns false if nothing has
+	// finished since the last call
+	bool takePaths(ForkPaths& paths);
+
+	bool isBusy() const;
+	void wait();	// Blocks until the job in flight has finished
+
+	int getForkCount() const { return m_forkCount; }
+	int getPoolRebuildCount() const { return m_poolRebuilds; }	// Forks that had to copy bodies into fresh pools
+
+protected:
+	void copyBodies(PhysicsScene* scene);
+	void rebuildPools(PhysicsScene* scene);
+	void runWorker();
+	void lookAhead();
+
+	float m_duration;
+	int m_stepBudget;
+	int m_sampleInterval;
+
+	// The fork, stepped only by the worker. Its actors point into the pools and the live scene's statics
+	PhysicsScene m_scene;
+	std::vector<Sphere> m_spheres;
+	std::vector<AABB> m_boxes;
+	std::vector<PhysicsObject*> m_sources;			// Live bodies copied last fork, in the fork's actor order
+	std::vector<PhysicsObject*> m_sharedStatics;	// Live statics the fork is using
+
+	std::thread m_worker;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_finished;
+	bool m_busy;
+	bool m_started;
+	bool m_quit;
+	bool m_hasPaths;
+
+	ForkPaths m_workingPaths;	// Written by the worker during a job
+	ForkPaths m_finishedPaths;	// The last job's, waiting to be taken
+
+	int m_forkCount;
+	int m_poolRebuilds;
+};
\ No newline at end of file
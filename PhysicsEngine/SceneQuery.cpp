@@ -0,0 +1,556 @@
+// Include .h files
+#include "SceneQuery.h"
+#include "Plane.h"
+#include "SdfCollider.h"
+
+// Other includes
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <utility>
+
+// Typedefs
+typedef std::pair<float, PhysicsObject*> NearestEntry;
+
+// Number of rays traversed together, they share one cell walk and every body fetched is tested against all of them
+static const int RAY_PACKET_WIDTH = 8;
+
+//============================================================================================================================================
+// Constructors
+
+// Constructor
+SceneQuery::SceneQuery(const BroadPhase& broadPhase, const std::vector<Plane*>& planes)
+	: m_broadPhase(broadPhase)
+	, m_planes(planes)
+{
+}
+
+//============================================================================================================================================
+// Shape Tests
+
+// Ray against a proxy's shape
+bool SceneQuery::rayProxy(const BroadPhaseProxy& proxy, glm::vec2 origin, glm::vec2 direction, float maxDistance, float& distance, glm::vec2& normal)
+{
+	if (proxy.actor->getShapeID() == SPHERE)
+	{
+		// The proxy bounds are the sphere's square, so the centre and radius come straight out of them
+		glm::vec2 centre = (proxy.min + proxy.max) * 0.5f;
+		float radius = (proxy.max.x - proxy.min.x) * 0.5f;
+		glm::vec2 offset = origin - centre;
+		float a = glm::dot(direction, direction);
+		float b = glm::dot(offset, direction);
+		float c = glm::dot(offset, offset) - (radius * radius);
+
+		// Starting inside counts as a hit straight away
+		if (c <= 0.0f)
+		{
+			distance = 0.0f;
+			normal = -glm::normalize(direction);
+			return true;
+		}
+
+		float discriminant = (b * b) - (a * c);
+		if (discriminant < 0.0f || b > 0.0f)
+		{
+			return false;
+		}
+
+		float t = (-b - std::sqrt(discriminant)) / a;
+		if (t > maxDistance)
+		{
+			return false;
+		}
+
+		distance = t;
+		normal = glm::normalize(origin + (direction * t) - centre);
+		return true;
+	}
+
+	// Distance fields march the ray to their surface
+	if (proxy.actor->getShapeID() == SDF)
+	{
+		return static_cast<SdfCollider*>(proxy.actor)->raycast(origin, direction, maxDistance, distance, normal);
+	}
+
+	// Slab test for AABBs
+	float tEnter = 0.0f;
+	float tExit = maxDistance;
+	glm::vec2 enterNormal = -glm::normalize(direction);
+	for (int axis = 0; axis < 2; axis++)
+	{
+		if (direction[axis] == 0.0f)
+		{
+			if (origin[axis] < proxy.min[axis] || origin[axis] > proxy.max[axis])
+			{
+				return false;
+			}
+			continue;
+		}
+
+		float t1 = (proxy.min[axis] - origin[axis]) / direction[axis];
+		float t2 = (proxy.max[axis] - origin[axis]) / direction[axis];
+		float sign = -1.0f;
+		if (t1 > t2)
+		{
+			std::swap(t1, t2);
+			sign = 1.0f;
+		}
+		if (t1 > tEnter)
+		{
+			tEnter = t1;
+			enterNormal = glm::vec2(0, 0);
+			enterNormal[axis] = sign;
+		}
+		tExit = glm::min(tExit, t2);
+		if (tEnter > tExit)
+		{
+			return false;
+		}
+	}
+
+	distance = tEnter;
+	normal = enterNormal;
+	return true;
+}
+
+// Distance from a point to a proxy's shape, 0 inside it
+float SceneQuery::proxyDistance(const BroadPhaseProxy& proxy, glm::vec2 point)
+{
+	if (proxy.actor->getShapeID() == SPHERE)
+	{
+		glm::vec2 centre = (proxy.min + proxy.max) * 0.5f;
+		float radius = (proxy.max.x - proxy.min.x) * 0.5f;
+		return glm::max(glm::length(point - centre) - radius, 0.0f);
+	}
+	if (proxy.actor->getShapeID() == SDF)
+	{
+		return glm::max(static_cast<SdfCollider*>(proxy.actor)->getDistance(point), 0.0f);
+	}
+
+	return glm::length(point - glm::clamp(point, proxy.min, proxy.max));
+}
+
+//============================================================================================================================================
+// Grid Traversal
+
+// Collect Ray Cells
+void SceneQuery::collectRayCells(glm::vec2 origin, glm::vec2 direction, float maxDistance, std::vector<int>& cells) const
+{
+	int columns = m_broadPhase.getColumns();
+	int rows = m_broadPhase.getRows();
+	float cellSize = m_broadPhase.getCellSize();
+	glm::vec2 gridMin = m_broadPhase.getGridOrigin();
+	glm::vec2 gridMax = gridMin + (glm::vec2((float)columns, (float)rows) * cellSize);
+
+	// Clip the ray to the grid first
+	float tEnter = 0.0f;
+	float tExit = maxDistance;
+	for (int axis = 0; axis < 2; axis++)
+	{
+		if (direction[axis] == 0.0f)
+		{
+			if (origin[axis] < gridMin[axis] || origin[axis] > gridMax[axis])
+			{
+				return;
+			}
+			continue;
+		}
+
+		float t1 = (gridMin[axis] - origin[axis]) / direction[axis];
+		float t2 = (gridMax[axis] - origin[axis]) / direction[axis];
+		tEnter = glm::max(tEnter, glm::min(t1, t2));
+		tExit = glm::min(tExit, glm::max(t1, t2));
+	}
+	if (tEnter > tExit)
+	{
+		return;
+	}
+
+	// Walk the cells the ray passes through one boundary at a time
+	glm::vec2 start = origin + (direction * tEnter);
+	int column = m_broadPhase.getCellColumn(start.x);
+	int row = m_broadPhase.getCellRow(start.y);
+	int stepX = (direction.x > 0.0f) ? 1 : -1;
+	int stepY = (direction.y > 0.0f) ? 1 : -1;
+	float nextX = (direction.x == 0.0f) ? FLT_MAX : (gridMin.x + ((column + (stepX > 0 ? 1 : 0)) * cellSize) - origin.x) / direction.x;
+	float nextY = (direction.y == 0.0f) ? FLT_MAX : (gridMin.y + ((row + (stepY > 0 ? 1 : 0)) * cellSize) - origin.y) / direction.y;
+	float deltaX = (direction.x == 0.0f) ? FLT_MAX : cellSize / std::abs(direction.x);
+	float deltaY = (direction.y == 0.0f) ? FLT_MAX : cellSize / std::abs(direction.y);
+
+	for (int step = 0; step <= columns + rows; step++)
+	{
+		cells.push_back((row * columns) + column);
+
+		if (nextX < nextY)
+		{
+			if (nextX > tExit) { break; }
+			column += stepX;
+			nextX += deltaX;
+		}
+		else
+		{
+			if (nextY > tExit) { break; }
+			row += stepY;
+			nextY += deltaY;
+		}
+
+		if (column < 0 || column >= columns || row < 0 || row >= rows)
+		{
+			break;
+		}
+	}
+}
+
+// Collect Box Cells
+void SceneQuery::collectBoxCells(glm::vec2 min, glm::vec2 max, std::vector<int>& cells) const
+{
+	int columns = m_broadPhase.getColumns();
+
+	// Bodies are binned by centre and are never bigger than a cell, so one extra ring of cells catches anything overlapping
+	int firstColumn = glm::max(m_broadPhase.getCellColumn(min.x) - 1, 0);
+	int lastColumn = glm::min(m_broadPhase.getCellColumn(max.x) + 1, columns - 1);
+	int firstRow = glm::max(m_broadPhase.getCellRow(min.y) - 1, 0);
+	int lastRow = glm::min(m_broadPhase.getCellRow(max.y) + 1, m_broadPhase.getRows() - 1);
+
+	for (int row = firstRow; row <= lastRow; row++)
+	{
+		for (int column = firstColumn; column <= lastColumn; column++)
+		{
+			cells.push_back((row * columns) + column);
+		}
+	}
+}
+
+//============================================================================================================================================
+// Raycasts
+
+// Raycast
+int SceneQuery::raycast(const QueryRay* rays, int rayCount, RaycastHit* hits, unsigned int queryMask) const
+{
+	const std::vector<BroadPhaseProxy>& proxies = m_broadPhase.getProxies();
+	const std::vector<int>& cellEntries = m_broadPhase.getCellEntries();
+	int columns = m_broadPhase.getColumns();
+	int rows = m_broadPhase.getRows();
+	std::vector<int> cells;
+	std::vector<int> packetCells;
+	int hitCount = 0;
+
+	for (int packetStart = 0; packetStart < rayCount; packetStart += RAY_PACKET_WIDTH)
+	{
+		int packetSize = glm::min(RAY_PACKET_WIDTH, rayCount - packetStart);
+		const QueryRay* packet = rays + packetStart;
+		RaycastHit* packetHits = hits + packetStart;
+
+		// Every ray starts out as a miss at its full length
+		for (int lane = 0; lane < packetSize; lane++)
+		{
+			packetHits[lane].actor = nullptr;
+			packetHits[lane].distance = packet[lane].maxDistance;
+			packetHits[lane].normal = glm::vec2(0, 0);
+			packetHits[lane].point = packet[lane].origin + (packet[lane].direction * packet[lane].maxDistance);
+		}
+
+		// The union of the cells the packet passes through, grown by one cell for bodies poking in from a neighbour
+		cells.clear();
+		for (int lane = 0; lane < packetSize; lane++)
+		{
+			collectRayCells(packet[lane].origin, packet[lane].direction, packet[lane].maxDistance, cells);
+		}
+		packetCells.clear();
+		for (int cell : cells)
+		{
+			int column = cell % columns;
+			int row = cell / columns;
+			for (int neighbourRow = glm::max(row - 1, 0); neighbourRow <= glm::min(row + 1, rows - 1); neighbourRow++)
+			{
+				for (int neighbourColumn = glm::max(column - 1, 0); neighbourColumn <= glm::min(column + 1, columns - 1); neighbourColumn++)
+				{
+					packetCells.push_back((neighbourRow * columns) + neighbourColumn);
+				}
+			}
+		}
+		std::sort(packetCells.begin(), packetCells.end());
+		packetCells.erase(std::unique(packetCells.begin(), packetCells.end()), packetCells.end());
+
+		// Each body is in exactly one cell, so fetching it once per packet and testing every ray in the packet
+		// against it visits it exactly once
+		for (int cell : packetCells)
+		{
+			for (int entry = m_broadPhase.getCellStart(cell); entry < m_broadPhase.getCellEnd(cell); entry++)
+			{
+				const BroadPhaseProxy& proxy = proxies[cellEntries[entry]];
+				if ((proxy.category & queryMask) == 0)
+				{
+					continue;
+				}
+
+				for (int lane = 0; lane < packetSize; lane++)
+				{
+					float distance;
+					glm::vec2 normal;
+					if (rayProxy(proxy, packet[lane].origin, packet[lane].direction, packetHits[lane].distance, distance, normal))
+					{
+						packetHits[lane].actor = proxy.actor;
+						packetHits[lane].distance = distance;
+						packetHits[lane].normal = normal;
+					}
+				}
+			}
+		}
+
+		// Static colliders aren't in the grid
+		for (auto& proxy : m_broadPhase.getStaticProxies())
+		{
+			if ((proxy.category & queryMask) == 0)
+			{
+				continue;
+			}
+
+			for (int lane = 0; lane < packetSize; lane++)
+			{
+				float distance;
+				glm::vec2 normal;
+				if (rayProxy(proxy, packet[lane].origin, packet[lane].direction, packetHits[lane].distance, distance, normal))
+				{
+					packetHits[lane].actor = proxy.actor;
+					packetHits[lane].distance = distance;
+					packetHits[lane].normal = normal;
+				}
+			}
+		}
+
+		// Planes, solved analytically
+		for (auto plane : m_planes)
+		{
+			if ((plane->getCollisionCategory() & queryMask) == 0)
+			{
+				continue;
+			}
+
+			glm::vec2 planeNormal = plane->getNormal();
+			for (int lane = 0; lane < packetSize; lane++)
+			{
+				float signedDistance = glm::dot(packet[lane].origin, planeNormal) - plane->getDistanceToOrigin();
+				float approach = glm::dot(packet[lane].direction, planeNormal);
+				if (approach == 0.0f)
+				{
+					continue;
+				}
+
+				float t = -signedDistance / approach;
+				if (t >= 0.0f && t < packetHits[lane].distance)
+				{
+					packetHits[lane].actor = plane;
+					packetHits[lane].distance = t;
+					packetHits[lane].normal = (signedDistance >= 0.0f) ? planeNormal : -planeNormal;
+				}
+			}
+		}
+
+		for (int lane = 0; lane < packetSize; lane++)
+		{
+			if (packetHits[lane].actor != nullptr)
+			{
+				packetHits[lane].point = packet[lane].origin + (packet[lane].direction * packetHits[lane].distance);
+				hitCount++;
+			}
+		}
+	}
+
+	return hitCount;
+}
+
+//============================================================================================================================================
+// Overlap Queries
+
+// Overlap AABB
+int SceneQuery::overlapAABB(glm::vec2 min, glm::vec2 max, PhysicsObject** results, int capacity, unsigned int queryMask) const
+{
+	const std::vector<BroadPhaseProxy>& proxies = m_broadPhase.getProxies();
+	const std::vector<int>& cellEntries = m_broadPhase.getCellEntries();
+	BroadPhaseProxy box;
+	box.min = min;
+	box.max = max;
+	int count = 0;
+
+	std::vector<int> cells;
+	collectBoxCells(min, max, cells);
+	for (int cell : cells)
+	{
+		for (int entry = m_broadPhase.getCellStart(cell); entry < m_broadPhase.getCellEnd(cell) && count < capacity; entry++)
+		{
+			const BroadPhaseProxy& proxy = proxies[cellEntries[entry]];
+			if ((proxy.category & queryMask) != 0 && BroadPhase::overlaps(proxy, box))
+			{
+				// Spheres need the exact test, the corners of their bounds are empty
+				if (proxy.actor->getShapeID() != SPHERE || proxyDistance(proxy, glm::clamp((proxy.min + proxy.max) * 0.5f, min, max)) <= 0.0f)
+				{
+					results[count++] = proxy.actor;
+				}
+			}
+		}
+	}
+
+	for (auto& proxy : m_broadPhase.getStaticProxies())
+	{
+		if (count < capacity && (proxy.category & queryMask) != 0 && BroadPhase::overlaps(proxy, box))
+		{
+			// Distance fields count if the box reaches into the solid, the way an AABB body would touch it
+			float depth;
+			glm::vec2 normal;
+			if (proxy.actor->getShapeID() == SDF)
+			{
+				if (static_cast<SdfCollider*>(proxy.actor)->penetrate((min + max) * 0.5f, (max - min) * 0.5f, 0.0f, depth, normal))
+				{
+					results[count++] = proxy.actor;
+				}
+			}
+			else if (proxy.actor->getShapeID() != SPHERE || proxyDistance(proxy, glm::clamp((proxy.min + proxy.max) * 0.5f, min, max)) <= 0.0f)
+			{
+				results[count++] = proxy.actor;
+			}
+		}
+	}
+
+	return count;
+}
+
+// Overlap Circle
+int SceneQuery::overlapCircle(glm::vec2 centre, float radius, PhysicsObject** results, int capacity, unsigned int queryMask) const
+{
+	const std::vector<BroadPhaseProxy>& proxies = m_broadPhase.getProxies();
+	const std::vector<int>& cellEntries = m_broadPhase.getCellEntries();
+	glm::vec2 extents(radius, radius);
+	int count = 0;
+
+	std::vector<int> cells;
+	collectBoxCells(centre - extents, centre + extents, cells);
+	for (int cell : cells)
+	{
+		for (int entry = m_broadPhase.getCellStart(cell); entry < m_broadPhase.getCellEnd(cell) && count < capacity; entry++)
+		{
+			const BroadPhaseProxy& proxy = proxies[cellEntries[entry]];
+			if ((proxy.category & queryMask) != 0 && proxyDistance(proxy, centre) <= radius)
+			{
+				results[count++] = proxy.actor;
+			}
+		}
+	}
+
+	for (auto& proxy : m_broadPhase.getStaticProxies())
+	{
+		if (count < capacity && (proxy.category & queryMask) != 0 && proxyDistance(proxy, centre) <= radius)
+		{
+			results[count++] = proxy.actor;
+		}
+	}
+
+	return count;
+}
+
+//============================================================================================================================================
+// Nearest Neighbours
+
+// Nearest
+int SceneQuery::nearest(glm::vec2 point, int k, PhysicsObject** results, float* distances, unsigned int queryMask) const
+{
+	if (k <= 0)
+	{
+		return 0;
+	}
+
+	const std::vector<BroadPhaseProxy>& proxies = m_broadPhase.getProxies();
+	const std::vector<int>& cellEntries = m_broadPhase.getCellEntries();
+	int columns = m_broadPhase.getColumns();
+	int rows = m_broadPhase.getRows();
+	float cellSize = m_broadPhase.getCellSize();
+	glm::vec2 gridMin = m_broadPhase.getGridOrigin();
+
+	// Max-heap of the best k so far, the worst of them sits on top
+	std::vector<NearestEntry> best;
+	auto consider = [&](const BroadPhaseProxy& proxy)
+	{
+		if ((proxy.category & queryMask) == 0)
+		{
+			return;
+		}
+
+		float distance = proxyDistance(proxy, point);
+		if ((int)best.size() < k)
+		{
+			best.push_back(NearestEntry(distance, proxy.actor));
+			std::push_heap(best.begin(), best.end());
+		}
+		else if (distance < best.front().first)
+		{
+			std::pop_heap(best.begin(), best.end());
+			best.back() = NearestEntry(distance, proxy.actor);
+			std::push_heap(best.begin(), best.end());
+		}
+	};
+
+	for (auto& proxy : m_broadPhase.getStaticProxies())
+	{
+		consider(proxy);
+	}
+
+	// Search outwards one ring of cells at a time from the point's cell
+	int centreColumn = m_broadPhase.getCellColumn(point.x);
+	int centreRow = m_broadPhase.getCellRow(point.y);
+	int maxRing = glm::max(columns, rows);
+	for (int ring = 0; ring <= maxRing; ring++)
+	{
+		for (int row = centreRow - ring; row <= centreRow + ring; row++)
+		{
+			if (row < 0 || row >= rows)
+			{
+				continue;
+			}
+
+			// Only the border of the block is new on this ring
+			int columnStep = (row == centreRow - ring || row == centreRow + ring) ? 1 : glm::max(ring * 2, 1);
+			for (int column = centreColumn - ring; column <= centreColumn + ring; column += columnStep)
+			{
+				if (column < 0 || column >= columns)
+				{
+					continue;
+				}
+
+				int cell = (row * columns) + column;
+				for (int entry = m_broadPhase.getCellStart(cell); entry < m_broadPhase.getCellEnd(cell); entry++)
+				{
+					consider(proxies[cellEntries[entry]]);
+				}
+			}
+		}
+
+		// Anything not searched yet has its centre outside this block and is at most half a cell across,
+		// so once the worst of the k is closer than that we're done
+		if ((int)best.size() == k)
+		{
+			glm::vec2 blockMin = gridMin + (glm::vec2((float)(centreColumn - ring), (float)(centreRow - ring)) * cellSize);
+			glm::vec2 blockMax = gridMin + (glm::vec2((float)(centreColumn + ring + 1), (float)(centreRow + ring + 1)) * cellSize);
+			glm::vec2 toMin = point - blockMin;
+			glm::vec2 toMax = blockMax - point;
+			float blockDistance = glm::min(glm::min(toMin.x, toMin.y), glm::min(toMax.x, toMax.y));
+			if (best.front().first <= blockDistance - (cellSize * 0.5f))
+			{
+				break;
+			}
+		}
+	}
+
+	// Nearest first
+	std::sort_heap(best.begin(), best.end());
+	int count = best.size();
+	for (int i = 0; i < count; i++)
+	{
+		results[i] = best[i].second;
+		if (distances != nullptr)
+		{
+			distances[i] = best[i].first;
+		}
+	}
+
+	return count;
+}
\ No newline at end of file
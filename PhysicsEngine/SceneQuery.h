@@ -0,0 +1,65 @@
+#pragma once
+// Include .h files
+#include "PhysicsObject.h"
+#include "BroadPhase.h"
+
+// Other includes
+#include <vector>
+#include <glm\vec2.hpp>
+#include <glm\glm.hpp>
+
+// Typedefs
+
+//============================================================================================================================================
+// QueryRay STRUCT
+
+struct QueryRay
+{
+	glm::vec2 origin;
+	glm::vec2 direction;	// Doesn't need to be normalised, hit distances are in units of its length
+	float maxDistance;
+};
+
+//============================================================================================================================================
+// RaycastHit STRUCT
+
+struct RaycastHit
+{
+	PhysicsObject* actor;	// nullptr if the ray hit nothing
+	glm::vec2 point;
+	glm::vec2 normal;
+	float distance;
+};
+
+//============================================================================================================================================
+// SceneQuery CLASS
+
+// Read-only queries against the broadphase grid the scene built on its last step. Every function only reads the
+// broadphase and Plane data and keeps its scratch space local, so any number of queries can run alongside rendering
+// (or each other), just not alongside PhysicsScene::update. Results go into buffers the caller owns
+class SceneQuery
+{
+
+public:
+	SceneQuery(const BroadPhase& broadPhase, const std::vector<Plane*>& planes);
+
+	// Casts a batch of rays, traversed in packets. Writes one hit per ray and returns how many rays hit something
+	int raycast(const QueryRay* rays, int rayCount, RaycastHit* hits, unsigned int queryMask = 0xFFFFFFFF) const;
+
+	// Bodies whose shape overlaps the box or circle, returns how many were written (never more than capacity)
+	int overlapAABB(glm::vec2 min, glm::vec2 max, PhysicsObject** results, int capacity, unsigned int queryMask = 0xFFFFFFFF) const;
+	int overlapCircle(glm::vec2 centre, float radius, PhysicsObject** results, int capacity, unsigned int queryMask = 0xFFFFFFFF) const;
+
+	// The k bodies with the closest surface to the point, nearest first. Returns how many were written
+	int nearest(glm::vec2 point, int k, PhysicsObject** results, float* distances, unsigned int queryMask = 0xFFFFFFFF) const;
+
+protected:
+	void collectRayCells(glm::vec2 origin, glm::vec2 direction, float maxDistance, std::vector<int>& cells) const;
+	void collectBoxCells(glm::vec2 min, glm::vec2 max, std::vector<int>& cells) const;
+
+	static bool rayProxy(const BroadPhaseProxy& proxy, glm::vec2 origin, glm::vec2 direction, float maxDistance, float& distance, glm::vec2& normal);
+	static float proxyDistance(const BroadPhaseProxy& proxy, glm::vec2 point);
+
+	const BroadPhase& m_broadPhase;
+	const std::vector<Plane*>& m_planes;
+};
\ No newline at end of file
@@ -0,0 +1,515 @@
+// Include .h files
+#include "SdfCollider.h"
+#include "Sphere.h"
+#include "AABB.h"
+
+// Other includes
+#include <Gizmos.h>
+#include <stb_image.h>
+#include <cmath>
+#include <cfloat>
+
+// Typedefs
+
+// Stands in for infinity in the distance transform, squares of real distances never get near it
+static const float TRANSFORM_FAR = 1.0e20f;
+
+// Ray marching gives up after this many steps, and counts as a hit within this fraction of a cell of the surface
+static const int MAX_RAY_STEPS = 128;
+static const float RAY_HIT_FRACTION = 0.01f;
+
+//============================================================================================================================================
+// Distance Transform
+
+// Squared distance transform of one line (Felzenszwalb and Huttenlocher): the lower envelope of the parabolas rooted at
+// each sample, found in one pass and read back in another. v and z are scratch space, n and n + 1 long
+static void transformLine(const float* f, int n, float* d, int* v, float* z)
+{
+	int k = 0;
+	v[0] = 0;
+	z[0] = -TRANSFORM_FAR;
+	z[1] = TRANSFORM_FAR;
+	for (int q = 1; q < n; q++)
+	{
+		float s = ((f[q] + (float)(q * q)) - (f[v[k]] + (float)(v[k] * v[k]))) / (float)((2 * q) - (2 * v[k]));
+		while (s <= z[k])
+		{
+			k--;
+			s = ((f[q] + (float)(q * q)) - (f[v[k]] + (float)(v[k] * v[k]))) / (float)((2 * q) - (2 * v[k]));
+		}
+		k++;
+		v[k] = q;
+		z[k] = s;
+		z[k + 1] = TRANSFORM_FAR;
+	}
+
+	k = 0;
+	for (int q = 0; q < n; q++)
+	{
+		while (z[k + 1] < (float)q)
+		{
+			k++;
+		}
+		d[q] = (float)((q - v[k]) * (q - v[k])) + f[v[k]];
+	}
+}
+
+// Squared distance transform of a grid, the rows and then the columns. Samples that are 0 going in are the ones
+// measured to, the rest should be TRANSFORM_FAR
+static void transformGrid(std::vector<float>& grid, int columns, int rows)
+{
+	int longest = glm::max(columns, rows);
+	std::vector<float> line(longest);
+	std::vector<float> result(longest);
+	std::vector<int> v(longest);
+	std::vector<float> z(longest + 1);
+
+	for (int row = 0; row < rows; row++)
+	{
+		transformLine(&grid[row * columns], columns, &result[0], &v[0], &z[0]);
+		std::copy(result.begin(), result.begin() + columns, grid.begin() + (row * columns));
+	}
+	for (int column = 0; column < columns; column++)
+	{
+		for (int row = 0; row < rows; row++)
+		{
+			line[row] = grid[(row * columns) + column];
+		}
+		transformLine(&line[0], rows, &result[0], &v[0], &z[0]);
+		for (int row = 0; row < rows; row++)
+		{
+			grid[(row * columns) + column] = result[row];
+		}
+	}
+}
+
+// Distance from a point to a line segment
+static float segmentDistance(glm::vec2 point, glm::vec2 start, glm::vec2 end)
+{
+	glm::vec2 along = end - start;
+	float lengthSquared = glm::dot(along, along);
+	float t = (lengthSquared > 0.0f) ? glm::clamp(glm::dot(point - start, along) / lengthSquared, 0.0f, 1.0f) : 0.0f;
+	return glm::length(point - (start + (along * t)));
+}
+
+// Get Cell, clamped onto the grid and safe for non-finite coordinates
+static int clampCell(float cell, int count)
+{
+	if (!(cell >= 0.0f)) { return 0; }
+	if (cell >= (float)count) { return count - 1; }
+	return (int)cell;
+}
+
+//============================================================================================================================================
+// Constructors
+
+// Constructor, the grid starts out empty
+SdfCollider::SdfCollider(glm::vec2 origin, glm::vec2 size, float cellSize, glm::vec4 color)
+	: Rigidbody(SDF, origin, glm::vec2(0, 0), glm::vec2(0, 0), 0, 1.0f, 1.0f)
+{
+	setBodyType(STATIC_BODY);
+	setColor(color);
+
+	m_cellSize = cellSize;
+	m_columns = glm::max((int)std::ceil(size.x / cellSize), 1) + 1;
+	m_rows = glm::max((int)std::ceil(size.y / cellSize), 1) + 1;
+	m_samples.assign(m_columns * m_rows, m_cellSize * (float)(m_columns + m_rows));
+	m_mipCount = 0;
+	m_loopCount = 0;
+}
+
+//============================================================================================================================================
+// Baking
+
+// Add Polyline
+void SdfCollider::addPolyline(const std::vector<glm::vec2>& points, bool closed, float radius)
+{
+	if (points.empty())
+	{
+		return;
+	}
+
+	// A single point is a dot of the given radius
+	int loop = (closed && points.size() >= 3) ? m_loopCount++ : -1;
+	int segmentCount = (loop >= 0) ? points.size() : glm::max((int)points.size() - 1, 1);
+	for (int i = 0; i < segmentCount; i++)
+	{
+		Segment segment;
+		segment.start = points[i];
+		segment.end = points[(i + 1) % points.size()];
+		segment.radius = radius;
+		segment.loop = loop;
+		m_segments.push_back(segment);
+	}
+}
+
+// Bake Polylines, every sample against every segment. It's only done at load, so the brute force is kept for being exact
+void SdfCollider::bakePolylines()
+{
+	float emptyDistance = m_cellSize * (float)(m_columns + m_rows);
+	int segmentCount = m_segments.size();
+	int loopCount = m_loopCount;
+
+#pragma omp parallel for schedule(dynamic, 4)
+	for (int row = 0; row < m_rows; row++)
+	{
+		std::vector<float> loopDistance(loopCount);
+		std::vector<float> loopRadius(loopCount);
+		std::vector<char> inside(loopCount);
+
+		for (int column = 0; column < m_columns; column++)
+		{
+			glm::vec2 point = glm::vec2(column, row) * m_cellSize + m_position;
+			float distance = emptyDistance;
+			std::fill(loopDistance.begin(), loopDistance.end(), FLT_MAX);
+			std::fill(inside.begin(), inside.end(), 0);
+
+			for (int i = 0; i < segmentCount; i++)
+			{
+				const Segment& segment = m_segments[i];
+				float toSegment = segmentDistance(point, segment.start, segment.end);
+				if (segment.loop < 0)
+				{
+					distance = glm::min(distance, toSegment - segment.radius);
+					continue;
+				}
+
+				// Closed polylines are inside where a ray out along +x crosses them an odd number of times
+				loopDistance[segment.loop] = glm::min(loopDistance[segment.loop], toSegment);
+				loopRadius[segment.loop] = segment.radius;
+				if ((segment.start.y > point.y) != (segment.end.y > point.y))
+				{
+					float crossing = segment.start.x + ((point.y - segment.start.y) * (segment.end.x - segment.start.x) / (segment.end.y - segment.start.y));
+					inside[segment.loop] ^= (point.x < crossing) ? 1 : 0;
+				}
+			}
+
+			for (int loop = 0; loop < loopCount; loop++)
+			{
+				float signedDistance = inside[loop] ? -loopDistance[loop] : loopDistance[loop];
+				distance = glm::min(distance, signedDistance - loopRadius[loop]);
+			}
+			m_samples[(row * m_columns) + column] = distance;
+		}
+	}
+
+	buildMips();
+	buildOutline();
+}
+
+// Bake Image
+bool SdfCollider::bakeImage(const char* filename, float threshold)
+{
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+	unsigned char* pixels = stbi_load(filename, &width, &height, &channels, 1);
+	if (pixels == nullptr)
+	{
+		return false;
+	}
+
+	// Images start at the top, the grid at the bottom
+	std::vector<unsigned char> mask(width * height);
+	for (int row = 0; row < height; row++)
+	{
+		std::copy(pixels + ((height - 1 - row) * width), pixels + ((height - row) * width), mask.begin() + (row * width));
+	}
+	stbi_image_free(pixels);
+
+	bakeMask(&mask[0], width, height, (unsigned char)glm::clamp(threshold * 255.0f, 0.0f, 255.0f));
+	return true;
+}
+
+// Bake Mask, exact Euclidean distances from a distance transform each way. The surface runs halfway between a solid
+// sample and an empty one, so half a cell comes off both
+void SdfCollider::bakeMask(const unsigned char* mask, int columns, int rows, unsigned char threshold)
+{
+	m_columns = glm::max(columns, 2);
+	m_rows = glm::max(rows, 2);
+	int sampleCount = m_columns * m_rows;
+
+	std::vector<float> toSolid(sampleCount, TRANSFORM_FAR);
+	std::vector<float> toEmpty(sampleCount, TRANSFORM_FAR);
+	for (int row = 0; row < rows; row++)
+	{
+		for (int column = 0; column < columns; column++)
+		{
+			bool solid = mask[(row * columns) + column] > threshold;
+			(solid ? toSolid : toEmpty)[(row * m_columns) + column] = 0.0f;
+		}
+	}
+	transformGrid(toSolid, m_columns, m_rows);
+	transformGrid(toEmpty, m_columns, m_rows);
+
+	float emptyDistance = m_cellSize * (float)(m_columns + m_rows);
+	m_samples.resize(sampleCount);
+	for (int i = 0; i < sampleCount; i++)
+	{
+		float distance = (toSolid[i] == 0.0f) ? -(std::sqrt(toEmpty[i]) - 0.5f) : (std::sqrt(toSolid[i]) - 0.5f);
+		m_samples[i] = glm::clamp(distance * m_cellSize, -emptyDistance, emptyDistance);
+	}
+
+	buildMips();
+	buildOutline();
+}
+
+// Set Mip Levels
+void SdfCollider::setMipLevels(int mipLevels)
+{
+	m_mipCount = glm::max(mipLevels, 0);
+	buildMips();
+}
+
+// Build Mips, the first level from the samples round each block's cells, every level after from the one below
+void SdfCollider::buildMips()
+{
+	m_mips.clear();
+	int columns = m_columns - 1;
+	int rows = m_rows - 1;
+
+	for (int level = 0; level < m_mipCount; level++)
+	{
+		MipLevel mip;
+		mip.columns = (columns + 1) / 2;
+		mip.rows = (rows + 1) / 2;
+		mip.minimum.resize(mip.columns * mip.rows);
+
+		for (int blockRow = 0; blockRow < mip.rows; blockRow++)
+		{
+			for (int blockColumn = 0; blockColumn < mip.columns; blockColumn++)
+			{
+				float minimum = FLT_MAX;
+				if (level == 0)
+				{
+					for (int row = blockRow * 2; row <= glm::min((blockRow * 2) + 2, m_rows - 1); row++)
+					{
+						for (int column = blockColumn * 2; column <= glm::min((blockColumn * 2) + 2, m_columns - 1); column++)
+						{
+							minimum = glm::min(minimum, getSample(column, row));
+						}
+					}
+				}
+				else
+				{
+					const MipLevel& below = m_mips[level - 1];
+					for (int row = blockRow * 2; row < glm::min((blockRow * 2) + 2, below.rows); row++)
+					{
+						for (int column = blockColumn * 2; column < glm::min((blockColumn * 2) + 2, below.columns); column++)
+						{
+							minimum = glm::min(minimum, below.minimum[(row * below.columns) + column]);
+						}
+					}
+				}
+				mip.minimum[(blockRow * mip.columns) + blockColumn] = minimum;
+			}
+		}
+
+		m_mips.push_back(mip);
+		columns = mip.columns;
+		rows = mip.rows;
+	}
+}
+
+// Build Outline, marching squares over the cells for the zero contour
+void SdfCollider::buildOutline()
+{
+	m_outline.clear();
+	for (int row = 0; row < m_rows - 1; row++)
+	{
+		for (int column = 0; column < m_columns - 1; column++)
+		{
+			// Corners anticlockwise from the bottom left, edge i runs from corner i to the next
+			float distances[4] = { getSample(column, row), getSample(column + 1, row), getSample(column + 1, row + 1), getSample(column, row + 1) };
+			glm::vec2 corners[4] = { glm::vec2(column, row), glm::vec2(column + 1, row), glm::vec2(column + 1, row + 1), glm::vec2(column, row + 1) };
+
+			glm::vec2 crossings[4];
+			int crossingCount = 0;
+			for (int edge = 0; edge < 4; edge++)
+			{
+				float d1 = distances[edge];
+				float d2 = distances[(edge + 1) % 4];
+				if ((d1 < 0.0f) != (d2 < 0.0f))
+				{
+					glm::vec2 crossing = corners[edge] + ((corners[(edge + 1) % 4] - corners[edge]) * (d1 / (d1 - d2)));
+					crossings[crossingCount++] = crossing * m_cellSize;
+				}
+			}
+
+			if (crossingCount == 2)
+			{
+				m_outline.push_back(crossings[0]);
+				m_outline.push_back(crossings[1]);
+			}
+			else if (crossingCount == 4)
+			{
+				// A saddle, the centre says which pair of opposite corners is joined through the middle
+				float centre = (distances[0] + distances[1] + distances[2] + distances[3]) * 0.25f;
+				int first = ((centre < 0.0f) == (distances[0] < 0.0f)) ? 0 : 3;
+				for (int line = 0; line < 2; line++)
+				{
+					m_outline.push_back(crossings[(first + (line * 2)) % 4]);
+					m_outline.push_back(crossings[(first + (line * 2) + 1) % 4]);
+				}
+			}
+		}
+	}
+}
+
+//============================================================================================================================================
+// Lookups
+
+// Get Distance
+float SdfCollider::getDistance(glm::vec2 point) const
+{
+	glm::vec2 gradient;
+	return sample(point, gradient);
+}
+
+// Get Gradient
+glm::vec2 SdfCollider::getGradient(glm::vec2 point) const
+{
+	glm::vec2 gradient;
+	sample(point, gradient);
+	return gradient;
+}
+
+// Sample, the distance and its gradient from the four samples round the point
+float SdfCollider::sample(glm::vec2 point, glm::vec2& gradient) const
+{
+	glm::vec2 local = (point - m_position) / m_cellSize;
+	glm::vec2 clamped(glm::clamp(local.x, 0.0f, (float)(m_columns - 1)), glm::clamp(local.y, 0.0f, (float)(m_rows - 1)));
+	int column = clampCell(clamped.x, m_columns - 1);
+	int row = clampCell(clamped.y, m_rows - 1);
+	float fractionX = clamped.x - (float)column;
+	float fractionY = clamped.y - (float)row;
+
+	const float* bottom = &m_samples[(row * m_columns) + column];
+	const float* top = bottom + m_columns;
+	float bottomDistance = bottom[0] + ((bottom[1] - bottom[0]) * fractionX);
+	float topDistance = top[0] + ((top[1] - top[0]) * fractionX);
+	float distance = bottomDistance + ((topDistance - bottomDistance) * fractionY);
+	gradient.x = ((bottom[1] - bottom[0]) + (((top[1] - top[0]) - (bottom[1] - bottom[0])) * fractionY)) / m_cellSize;
+	gradient.y = (topDistance - bottomDistance) / m_cellSize;
+
+	// Beyond the grid, the way out to the border and then along it to the surface are at right angles
+	glm::vec2 outside = (local - clamped) * m_cellSize;
+	if (outside.x != 0.0f || outside.y != 0.0f)
+	{
+		float border = glm::max(distance, 0.0f);
+		glm::vec2 along((outside.x != 0.0f) ? 0.0f : gradient.x, (outside.y != 0.0f) ? 0.0f : gradient.y);
+		distance = std::sqrt(glm::dot(outside, outside) + (border * border));
+		gradient = (outside + (along * border)) / distance;
+	}
+	return distance;
+}
+
+// Is Clear, from the finest level that covers the box in two blocks each way
+bool SdfCollider::isClear(glm::vec2 min, glm::vec2 max) const
+{
+	if (m_mips.empty())
+	{
+		return false;
+	}
+
+	int minColumn = clampCell((min.x - m_position.x) / m_cellSize, m_columns - 1);
+	int maxColumn = clampCell((max.x - m_position.x) / m_cellSize, m_columns - 1);
+	int minRow = clampCell((min.y - m_position.y) / m_cellSize, m_rows - 1);
+	int maxRow = clampCell((max.y - m_position.y) / m_cellSize, m_rows - 1);
+
+	int level = 0;
+	int lastLevel = m_mips.size() - 1;
+	while (level < lastLevel && (((maxColumn >> (level + 1)) - (minColumn >> (level + 1))) > 1 || ((maxRow >> (level + 1)) - (minRow >> (level + 1))) > 1))
+	{
+		level++;
+	}
+
+	const MipLevel& mip = m_mips[level];
+	for (int row = minRow >> (level + 1); row <= (maxRow >> (level + 1)); row++)
+	{
+		for (int column = minColumn >> (level + 1); column <= (maxColumn >> (level + 1)); column++)
+		{
+			if (mip.minimum[(row * mip.columns) + column] <= 0.0f)
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// Penetrate, how far the body's deepest point along the normal is past the surface
+bool SdfCollider::penetrate(glm::vec2 centre, glm::vec2 extents, float radius, float& depth, glm::vec2& normal) const
+{
+	glm::vec2 reach = extents + glm::vec2(radius, radius);
+	if (isClear(centre - reach, centre + reach))
+	{
+		return false;
+	}
+
+	glm::vec2 gradient;
+	float distance = sample(centre, gradient);
+	float gradientLength = glm::length(gradient);
+	normal = (gradientLength > 0.0f) ? (gradient / gradientLength) : glm::vec2(0, 1);
+	depth = (std::abs(normal.x) * extents.x) + (std::abs(normal.y) * extents.y) + radius - distance;
+	return depth > 0.0f;
+}
+
+// Raycast, stepping by the distance to the surface each time since nothing can be closer than that
+bool SdfCollider::raycast(glm::vec2 origin, glm::vec2 direction, float maxDistance, float& distance, glm::vec2& normal) const
+{
+	float speed = glm::length(direction);
+	if (speed == 0.0f)
+	{
+		return false;
+	}
+
+	float tolerance = m_cellSize * RAY_HIT_FRACTION;
+	float t = 0.0f;
+	for (int step = 0; step < MAX_RAY_STEPS && t <= maxDistance; step++)
+	{
+		glm::vec2 gradient;
+		float toSurface = sample(origin + (direction * t), gradient);
+		if (toSurface <= tolerance)
+		{
+			// Starting inside counts as a hit straight away
+			float gradientLength = glm::length(gradient);
+			distance = t;
+			normal = (gradientLength > 0.0f && t > 0.0f) ? (gradient / gradientLength) : (-direction / speed);
+			return true;
+		}
+		t += toSurface / speed;
+	}
+	return false;
+}
+
+//============================================================================================================================================
+// Misc
+
+// Make Gizmo
+void SdfCollider::makeGizmo()
+{
+	glm::vec4 color = getColor();
+	for (int i = 0; i + 1 < (int)m_outline.size(); i += 2)
+	{
+		aie::Gizmos::add2DLine(m_position + m_outline[i], m_position + m_outline[i + 1], color);
+	}
+}
+
+// Check Collision
+bool SdfCollider::checkCollision(PhysicsObject* pOther)
+{
+	float depth;
+	glm::vec2 normal;
+	if (pOther->getShapeID() == SPHERE)
+	{
+		Sphere* sphere = static_cast<Sphere*>(pOther);
+		return penetrate(sphere->getPosition(), glm::vec2(0, 0), sphere->getRadius(), depth, normal);
+	}
+	if (pOther->getShapeID() == AABB_)
+	{
+		AABB* aabb = static_cast<AABB*>(pOther);
+		return penetrate(aabb->getPosition(), aabb->getExtents(), 0.0f, depth, normal);
+	}
+	return false;
+}
\ No newline at end of file
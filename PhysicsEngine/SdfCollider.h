@@ -0,0 +1,119 @@
+#pragma once
+// Include .h files
+#include "RigidBody.h"
+
+// Other includes
+#include <vector>
+#include <glm\vec2.hpp>
+#include <glm\glm.hpp>
+
+// Typedefs
+
+//============================================================================================================================================
+// SdfCollider CLASS
+
+// A static collider for level geometry, backed by a baked grid of signed distances: negative inside the solid, positive
+// outside, sampled one cell size apart from the collider's position (its bottom left corner). Curved ramps, funnels and
+// whole level outlines become one collider, and a lookup is a bilinear blend of four samples however much geometry went
+// into the bake, so Sphere and AABB contacts cost the same against any level. Nothing beyond the grid is solid, the
+// distance there is measured to its border. The grid is baked from polylines or from an image, the slow part, done once
+// at load. Optional mip levels keep the smallest sample in each block of cells; they're small enough to stay in cache,
+// and a body whose blocks are all clear of the solid is rejected without touching the full grid. Like any static
+// collider it's shared by forks and never written during a step. Grains in granular mode don't collide with it
+class SdfCollider : public Rigidbody
+{
+
+public:
+
+	//============================================================================================================================================
+	// Constructors
+
+	SdfCollider(glm::vec2 origin, glm::vec2 size, float cellSize, glm::vec4 color);
+	//~SdfCollider();
+
+	//============================================================================================================================================
+	// Baking
+
+	// Closed polylines are solid inside, open ones are solid within their radius of the line, and every polyline added
+	// is unioned. Nothing changes until bakePolylines, which keeps the grid's size and fills in every sample
+	void addPolyline(const std::vector<glm::vec2>& points, bool closed, float radius);
+	void clearPolylines() { m_segments.clear(); m_loopCount = 0; }
+	void bakePolylines();
+
+	// Pixels brighter than the threshold (0 to 1) are solid. The grid takes the image's size, one sample per pixel with
+	// the first row at the bottom. Returns false, changing nothing, if the image can't be loaded
+	bool bakeImage(const char* filename, float threshold);
+	void bakeMask(const unsigned char* mask, int columns, int rows, unsigned char threshold);
+
+	// Mip levels for coarse rejection, level n covering blocks 2^n cells across. 0 turns them off, the default
+	void setMipLevels(int mipLevels);
+	int getMipLevels() const { return m_mipCount; }
+
+	//============================================================================================================================================
+	// Lookups
+
+	float getDistance(glm::vec2 point) const;
+	glm::vec2 getGradient(glm::vec2 point) const;	// Not normalised, it's only close to unit length near the surface
+	float sample(glm::vec2 point, glm::vec2& gradient) const;
+
+	// Whether the mip levels show nothing solid in the box, to the grid's resolution. Always false without mip levels
+	bool isClear(glm::vec2 min, glm::vec2 max) const;
+
+	// Whether a body reaches into the solid, and if so how far and which way out. The surface is taken as flat across
+	// the body, a Sphere passes its radius and no extents and an AABB its extents and no radius
+	bool penetrate(glm::vec2 centre, glm::vec2 extents, float radius, float& depth, glm::vec2& normal) const;
+
+	// Sphere traces a ray through the field. Distances are in units of the direction's length, as for SceneQuery
+	bool raycast(glm::vec2 origin, glm::vec2 direction, float maxDistance, float& distance, glm::vec2& normal) const;
+
+	//============================================================================================================================================
+	// Getters And Setters
+
+	int getColumns() const { return m_columns; }
+	int getRows() const { return m_rows; }
+	float getCellSize() const { return m_cellSize; }
+	glm::vec2 getMin() const { return m_position; }
+	glm::vec2 getMax() const { return m_position + glm::vec2(m_columns - 1, m_rows - 1) * m_cellSize; }
+	int getSegmentCount() const { return m_segments.size(); }
+
+	//============================================================================================================================================
+	// Misc
+
+	virtual void makeGizmo();
+	virtual bool checkCollision(PhysicsObject* pOther);
+
+protected:
+	// One piece of a polyline, with which closed polyline it belongs to (-1 for open ones) for the inside test
+	struct Segment
+	{
+		glm::vec2 start;
+		glm::vec2 end;
+		float radius;
+		int loop;
+	};
+
+	// The smallest sample in each block of a mip level
+	struct MipLevel
+	{
+		std::vector<float> minimum;
+		int columns;
+		int rows;
+	};
+
+	float getSample(int column, int row) const { return m_samples[(row * m_columns) + column]; }
+	void buildMips();
+	void buildOutline();
+
+	int m_columns;
+	int m_rows;
+	float m_cellSize;
+	std::vector<float> m_samples;	// Row by row from the bottom
+
+	std::vector<MipLevel> m_mips;
+	int m_mipCount;
+
+	std::vector<Segment> m_segments;
+	int m_loopCount;
+
+	std::vector<glm::vec2> m_outline;	// The surface as line pairs, relative to the position, for drawing
+};
\ No newline at end of file
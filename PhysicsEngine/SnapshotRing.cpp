@@ -0,0 +1,335 @@
+// Include .h files
+#include "SnapshotRing.h"
+#include "RigidBody.h"
+
+// Other includes
+#include <cstring>
+
+// Typedefs
+
+// Position, velocity and acceleration as floats, then the material index, per body
+static const int BODY_WORDS = 7;
+
+// Most a delta can take per body: the changed field mask, two bytes of lengths and every field whole
+static const int MAX_DELTA_BODY_BYTES = 1 + 2 + (BODY_WORDS * 4);
+
+//============================================================================================================================================
+// Constructors
+
+// Constructor
+SnapshotRing::SnapshotRing()
+{
+	m_keyframeInterval = 16;
+	m_newest = -1;
+	m_keyframe = -1;
+}
+
+// Destructor
+SnapshotRing::~SnapshotRing()
+{
+	releaseMaterials();
+}
+
+//============================================================================================================================================
+// History
+
+// Set Capacity
+void SnapshotRing::setCapacity(int capacity, int keyframeInterval)
+{
+	m_slots.resize(glm::max(capacity, 0));
+	m_keyframeInterval = glm::max(keyframeInterval, 1);
+	clear();
+}
+
+// Clear
+void SnapshotRing::clear()
+{
+	for (auto& slot : m_slots)
+	{
+		slot.step = -1;
+		slot.keyframe = -1;
+		slot.data.clear();
+	}
+	m_newest = -1;
+	m_keyframe = -1;
+	m_bodies.clear();
+	releaseMaterials();
+}
+
+// Record
+void SnapshotRing::record(int step, const std::vector<PhysicsObject*>& bodies)
+{
+	if (m_slots.empty())
+	{
+		return;
+	}
+
+	// Deltas only make sense against the same bodies in the same order, and steps have to follow on
+	if (step != m_newest + 1 || bodies != m_bodies)
+	{
+		clear();
+		m_bodies = bodies;
+		reserveBuffers();
+	}
+	gatherWords(bodies);
+
+	// A keyframe is due every interval, and always when there isn't one to take a delta against
+	Snapshot& slot = getSlot(step);
+	slot.step = step;
+	if (m_keyframe < 0 || step - m_keyframe >= m_keyframeInterval)
+	{
+		m_keyframe = step;
+		m_keyWords = m_words;
+		slot.data.resize(m_words.size() * sizeof(unsigned int));
+		std::memcpy(slot.data.data(), m_words.data(), slot.data.size());
+	}
+	else
+	{
+		encodeDelta(slot.data);
+	}
+	slot.keyframe = m_keyframe;
+	m_newest = step;
+}
+
+// Reserve Buffers, sizes every slot for the largest snapshot the bodies can make so recording and restoring never
+// allocate, which would otherwise land on whichever step first fills a slot past its old size
+void SnapshotRing::reserveBuffers()
+{
+	int bodyCount = m_bodies.size();
+	m_words.reserve(bodyCount * BODY_WORDS);
+	m_keyWords.reserve(bodyCount * BODY_WORDS);
+	for (auto& slot : m_slots)
+	{
+		slot.data.reserve(bodyCount * MAX_DELTA_BODY_BYTES);
+	}
+}
+
+// Can Restore, the step and its keyframe both have to be in the ring still
+bool SnapshotRing::canRestore(int step) const
+{
+	if (m_slots.empty() || step < 0 || step > m_newest || m_newest - step >= (int)m_slots.size())
+	{
+		return false;
+	}
+	const Snapshot& slot = getSlot(step);
+	return slot.step == step && slot.keyframe >= 0 && m_newest - slot.keyframe < (int)m_slots.size() &&
+		getSlot(slot.keyframe).step == slot.keyframe;
+}
+
+// Restore
+bool SnapshotRing::restore(int step, const std::vector<PhysicsObject*>& bodies)
+{
+	if (bodies != m_bodies || !canRestore(step))
+	{
+		return false;
+	}
+
+	// The keyframe is kept whole, anything after it is a delta on top
+	const Snapshot& slot = getSlot(step);
+	const Snapshot& keyframe = getSlot(slot.keyframe);
+	m_keyWords.resize(keyframe.data.size() / sizeof(unsigned int));
+	std::memcpy(m_keyWords.data(), keyframe.data.data(), keyframe.data.size());
+	if (slot.step == slot.keyframe)
+	{
+		m_words = m_keyWords;
+	}
+	else
+	{
+		decodeDelta(slot.data, m_words);
+	}
+
+	int bodyCount = bodies.size();
+	for (int body = 0; body < bodyCount; body++)
+	{
+		const unsigned int* words = &m_words[body * BODY_WORDS];
+		float values[BODY_WORDS - 1];
+		std::memcpy(values, words, sizeof(values));
+
+		// setPosition keeps AABB bounds in step
+		Rigidbody* pBody = static_cast<Rigidbody*>(bodies[body]);
+		pBody->setPosition(glm::vec2(values[0], values[1]));
+		pBody->setVelocity(glm::vec2(values[2], values[3]));
+		pBody->setAcceleration(glm::vec2(values[4], values[5]));
+		pBody->setMaterialIndex(words[BODY_WORDS - 1]);
+	}
+
+	// Newer steps are the history being replaced, new deltas go against this step's keyframe
+	m_newest = step;
+	m_keyframe = slot.keyframe;
+	return true;
+}
+
+// Get Oldest Step
+int SnapshotRing::getOldestStep() const
+{
+	if (m_newest < 0)
+	{
+		return -1;
+	}
+	for (int step = glm::max(m_newest - (int)m_slots.size() + 1, 0); step <= m_newest; step++)
+	{
+		if (canRestore(step))
+		{
+			return step;
+		}
+	}
+	return -1;
+}
+
+// Get Encoded Bytes
+int SnapshotRing::getEncodedBytes() const
+{
+	int bytes = 0;
+	for (auto& slot : m_slots)
+	{
+		bytes += (slot.step >= 0) ? slot.data.size() : 0;
+	}
+	return bytes;
+}
+
+// Get Raw Bytes
+int SnapshotRing::getRawBytes() const
+{
+	int snapshots = 0;
+	for (auto& slot : m_slots)
+	{
+		snapshots += (slot.step >= 0) ? 1 : 0;
+	}
+	return snapshots * m_bodies.size() * BODY_WORDS * sizeof(unsigned int);
+}
+
+//============================================================================================================================================
+// Encoding
+
+// Gather Words, every body's state as raw bits
+void SnapshotRing::gatherWords(const std::vector<PhysicsObject*>& bodies)
+{
+	int bodyCount = bodies.size();
+	m_words.resize(bodyCount * BODY_WORDS);
+	for (int body = 0; body < bodyCount; body++)
+	{
+		Rigidbody* pBody = static_cast<Rigidbody*>(bodies[body]);
+		float values[BODY_WORDS - 1] =
+		{
+			pBody->getPosition().x, pBody->getPosition().y, pBody->getVelocity().x, pBody->getVelocity().y,
+			pBody->getAcceleration().x, pBody->getAcceleration().y
+		};
+		unsigned int* words = &m_words[body * BODY_WORDS];
+		std::memcpy(words, values, sizeof(values));
+		words[BODY_WORDS - 1] = pBody->getMaterialIndex();
+		holdMaterial(pBody->getMaterialIndex());
+	}
+}
+
+// Hold Material, takes a reference the first time the history sees a material
+void SnapshotRing::holdMaterial(unsigned int material)
+{
+	// A flag per index, grown as higher indices turn up
+	if (material >= m_holding.size())
+	{
+		m_holding.resize(material + 1, false);
+	}
+	if (!m_holding[material])
+	{
+		m_holding[material] = true;
+		m_heldMaterials.push_back(material);
+		MaterialTable::acquire(material);
+	}
+}
+
+// Release Materials
+void SnapshotRing::releaseMaterials()
+{
+	for (unsigned int material : m_heldMaterials)
+	{
+		m_holding[material] = false;
+		MaterialTable::release(material);
+	}
+	m_heldMaterials.clear();
+}
+
+// Encode Delta, per body a mask of the fields that differ from the keyframe, then if any do a 2 bit byte count for each
+// and the low bytes of its XOR with the keyframe
+void SnapshotRing::encodeDelta(std::vector<unsigned char>& data) const
+{
+	int bodyCount = m_words.size() / BODY_WORDS;
+	data.resize(bodyCount * MAX_DELTA_BODY_BYTES);
+	unsigned char* out = data.data();
+
+	for (int body = 0; body < bodyCount; body++)
+	{
+		const unsigned int* words = &m_words[body * BODY_WORDS];
+		const unsigned int* keyWords = &m_keyWords[body * BODY_WORDS];
+		unsigned char* mask = out++;
+		*mask = 0;
+
+		unsigned int lengths = 0;
+		int changed = 0;
+		unsigned char* lengthBytes = out;
+		out += 2;
+		for (int word = 0; word < BODY_WORDS; word++)
+		{
+			unsigned int difference = words[word] ^ keyWords[word];
+			if (difference == 0)
+			{
+				continue;
+			}
+
+			int byteCount = (difference > 0xFFFFFF) ? 4 : (difference > 0xFFFF) ? 3 : (difference > 0xFF) ? 2 : 1;
+			for (int i = 0; i < byteCount; i++)
+			{
+				*out++ = (unsigned char)(difference >> (i * 8));
+			}
+			*mask |= 1 << word;
+			lengths |= (byteCount - 1) << (changed * 2);
+			changed++;
+		}
+
+		// A body that hasn't changed since the keyframe is just its mask
+		if (changed == 0)
+		{
+			out = lengthBytes;
+			continue;
+		}
+		lengthBytes[0] = (unsigned char)lengths;
+		lengthBytes[1] = (unsigned char)(lengths >> 8);
+	}
+	data.resize(out - data.data());
+}
+
+// Decode Delta, the keyframe words with a delta's changes applied
+void SnapshotRing::decodeDelta(const std::vector<unsigned char>& data, std::vector<unsigned int>& words) const
+{
+	words = m_keyWords;
+	int bodyCount = words.size() / BODY_WORDS;
+	const unsigned char* in = data.data();
+
+	for (int body = 0; body < bodyCount; body++)
+	{
+		unsigned char mask = *in++;
+		if (mask == 0)
+		{
+			continue;
+		}
+
+		unsigned int lengths = in[0] | (in[1] << 8);
+		in += 2;
+		int changed = 0;
+		for (int word = 0; word < BODY_WORDS; word++)
+		{
+			if ((mask & (1 << word)) == 0)
+			{
+				continue;
+			}
+
+			int byteCount = ((lengths >> (changed * 2)) & 3) + 1;
+			unsigned int difference = 0;
+			for (int i = 0; i < byteCount; i++)
+			{
+				difference |= (unsigned int)(*in++) << (i * 8);
+			}
+			words[(body * BODY_WORDS) + word] ^= difference;
+			changed++;
+		}
+	}
+}
\ No newline at end of file
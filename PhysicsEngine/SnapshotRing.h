@@ -0,0 +1,82 @@
+#pragma once
+// Include .h files
+#include "PhysicsObject.h"
+
+// Other includes
+#include <vector>
+#include <glm\vec2.hpp>
+#include <glm\glm.hpp>
+
+// Typedefs
+
+//============================================================================================================================================
+// SnapshotRing CLASS
+
+// The last few hundred steps of a scene's bodies, for rewinding and for rollback. Each step's snapshot is the position,
+// velocity, accumulated acceleration and material of every body. Every keyframe interval a snapshot is kept whole, and
+// the steps in between are stored as a delta against it: per body a byte of which fields changed, then each changed
+// field XORed with the keyframe and trimmed to its low bytes, since a body's state drifts slowly and the high bytes of
+// the XOR stay zero. Bodies at rest cost one byte a step. The ring holds a fixed number of steps, reusing each slot's
+// buffer, so memory is bounded by the capacity. A delta can only be restored while its keyframe is still in the ring,
+// so at least capacity - interval of the most recent steps can always be restored. A change to the body list (adding,
+// removing or reordering) starts the history again. See PhysicsScene::setHistory
+class SnapshotRing
+{
+
+public:
+	SnapshotRing();
+	~SnapshotRing();
+
+	// Steps kept and how often a whole snapshot is taken, clears the history. A capacity of 0 keeps nothing
+	void setCapacity(int capacity, int keyframeInterval);
+	int getCapacity() const { return m_slots.size(); }
+	int getKeyframeInterval() const { return m_keyframeInterval; }
+	void clear();
+
+	// Stores the bodies' state as it is after the given step. Steps are expected one after another, a gap starts again
+	void record(int step, const std::vector<PhysicsObject*>& bodies);
+
+	// Puts the bodies back as they were after the given step and forgets every newer step, so stepping on from there
+	// records the new history. Returns false, changing nothing, if the step can't be restored
+	bool restore(int step, const std::vector<PhysicsObject*>& bodies);
+	bool canRestore(int step) const;
+
+	// Range of steps that can be restored, both -1 when there are none
+	int getOldestStep() const;
+	int getNewestStep() const { return m_newest; }
+
+	// Bytes the stored snapshots take up, and what they would take stored whole
+	int getEncodedBytes() const;
+	int getRawBytes() const;
+
+protected:
+	// One step's snapshot, whole for a keyframe and a delta against the keyframe otherwise
+	struct Snapshot
+	{
+		int step;
+		int keyframe;
+		std::vector<unsigned char> data;
+	};
+
+	Snapshot& getSlot(int step) { return m_slots[step % m_slots.size()]; }
+	const Snapshot& getSlot(int step) const { return m_slots[step % m_slots.size()]; }
+	void reserveBuffers();
+	void gatherWords(const std::vector<PhysicsObject*>& bodies);
+	void encodeDelta(std::vector<unsigned char>& data) const;
+	void decodeDelta(const std::vector<unsigned char>& data, std::vector<unsigned int>& words) const;
+	void holdMaterial(unsigned int material);
+	void releaseMaterials();
+
+	std::vector<Snapshot> m_slots;
+	int m_keyframeInterval;
+	int m_newest;		// Last step recorded, -1 when empty
+	int m_keyframe;		// Step of the keyframe new deltas are taken against
+
+	std::vector<PhysicsObject*> m_bodies;	// The body list the history belongs to
+	std::vector<unsigned int> m_words;		// State being recorded or restored, as raw bits
+	std::vector<unsigned int> m_keyWords;	// The current keyframe's state
+
+	// Materials the history refers to, held in MaterialTable until it's cleared so a restored index is never reused
+	std::vector<unsigned int> m_heldMaterials;
+	std::vector<bool> m_holding;
+};
\ No newline at end of file
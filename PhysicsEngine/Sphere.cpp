@@ -1,23 +1,37 @@
 #include "Sphere.h"
+#include "Fixed64.h"
 #include <Gizmos.h>
 
-Sphere::Sphere(glm::vec2 position, glm::vec2 velocity, glm::vec2 acceleration, float mass, float radius, float elasticity, glm::vec4 color) : Rigidbody(SPHERE, position, velocity, acceleration, 0, mass, elasticity)
+// Draw Sphere, a circle in 2D and a sphere in 3D
+static void drawSphere(const glm::vec2& centre, float radius, const glm::vec4& colour)
+{
+	aie::Gizmos::add2DCircle(centre, radius, 12, colour);
+}
+static void drawSphere(const glm::vec3& centre, float radius, const glm::vec4& colour)
+{
+	aie::Gizmos::addSphere(centre, radius, 8, 8, colour);
+}
+
+template <class Scalar, int Dimensions>
+BasicSphere<Scalar, Dimensions>::BasicSphere(Vector position, Vector velocity, Vector acceleration, Scalar mass, Scalar radius, float elasticity, glm::vec4 color) : Body(SPHERE, position, velocity, acceleration, 0, mass, elasticity)
 {
 	m_radius = radius;
-	m_color = color;
+	this->setColor(color);
 }
 
-void Sphere::makeGizmo()
+template <class Scalar, int Dimensions>
+void BasicSphere<Scalar, Dimensions>::makeGizmo()
 {
-	aie::Gizmos::add2DCircle(m_position, m_radius, 12, m_color);
+	drawSphere(Body::VMath::toFloat(this->m_position), Body::Math::toFloat(m_radius), this->getColor());
 }
 
-bool Sphere::checkCollision(PhysicsObject * pOther)
+template <class Scalar, int Dimensions>
+bool BasicSphere<Scalar, Dimensions>::checkCollision(Object * pOther)
 {
-	Sphere* otherSphere = dynamic_cast<Sphere*>(pOther);
+	BasicSphere* otherSphere = dynamic_cast<BasicSphere*>(pOther);
 	if (otherSphere != nullptr)
 	{
-		float distance = glm::distance(getPosition(), otherSphere->getPosition());
+		Scalar distance = Body::VMath::distance(this->getPosition(), otherSphere->getPosition());
 
 		if (distance < (getRadius() + otherSphere->getRadius()))
 		{
@@ -32,4 +46,9 @@ bool Sphere::checkCollision(PhysicsObject * pOther)
 	{
 		return 0;
 	}
-}
\ No newline at end of file
+}
+
+template class BasicSphere<float, 2>;
+template class BasicSphere<double, 2>;
+template class BasicSphere<Fixed64, 2>;
+template class BasicSphere<float, 3>;
\ No newline at end of file
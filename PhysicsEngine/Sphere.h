@@ -7,31 +7,33 @@
 
 // Typedefs
 
-class Sphere : public Rigidbody 
+template <class Scalar, int Dimensions>
+class BasicSphere : public BasicRigidbody<Scalar, Dimensions>
 {
 
 public:
+	typedef BasicRigidbody<Scalar, Dimensions> Body;
+	typedef typename Body::Object Object;
+	typedef typename Body::Vector Vector;
 
 	//============================================================================================================================================
 	// Constructors
 
-	Sphere(glm::vec2 position, glm::vec2 velocity, glm::vec2 acceleration, float mass, float radius, float elasticity, glm::vec4 color);
-	//~Sphere();
+	BasicSphere(Vector position, Vector velocity, Vector acceleration, Scalar mass, Scalar radius, float elasticity, glm::vec4 color);
+	//~BasicSphere();
 
 	//============================================================================================================================================
 	// Getters And Setters
 
-	float getRadius() { return m_radius; }
-	glm::vec4 getColor() { return m_color; }
+	Scalar getRadius() { return m_radius; }
 
 	//============================================================================================================================================
 	// Misc
 
 	virtual void makeGizmo();
-	virtual bool checkCollision(PhysicsObject* pOther);
+	virtual bool checkCollision(Object* pOther);
 
 protected:
-	float m_radius;
-	glm::vec4 m_color;
+	Scalar m_radius;
 
 };
\ No newline at end of file
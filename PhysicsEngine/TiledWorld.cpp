@@ -0,0 +1,684 @@
+// Include .h files
+#include "TiledWorld.h"
+#include "PhysicsScene.h"
+#include "RigidBody.h"
+#include "Sphere.h"
+#include "AABB.h"
+
+// Other includes
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+
+// Typedefs
+
+// Records for frozen tiles are held back until there are this many, so building a world isn't a file open per body
+static const long long MAX_PENDING_RECORDS = 65536;
+static const float DEFAULT_FREEZE_DELAY = 1.0f;
+
+//============================================================================================================================================
+// Constructors
+
+// Constructor
+TiledWorld::TiledWorld(PhysicsScene* scene, float tileSize, const char* filePrefix)
+{
+	m_scene = scene;
+	m_tileSize = tileSize;
+	m_filePrefix = filePrefix;
+	m_freezeDelay = DEFAULT_FREEZE_DELAY;
+	m_pendingCount = 0;
+	m_tileLoads = 0;
+	m_tileSaves = 0;
+	m_handOffs = 0;
+	m_fileErrors = 0;
+}
+
+// Deconstructor
+TiledWorld::~TiledWorld()
+{
+	freezeAll();
+}
+
+//============================================================================================================================================
+// Body Functions
+
+// Add Sphere
+void TiledWorld::addSphere(glm::vec2 position, glm::vec2 velocity, float mass, float radius, float elasticity, glm::vec4 color, BodyType bodyType)
+{
+	TileBodyRecord record = {};
+	record.shape = SPHERE;
+	record.bodyType = bodyType;
+	record.positionX = position.x;
+	record.positionY = position.y;
+	record.velocityX = velocity.x;
+	record.velocityY = velocity.y;
+	record.mass = mass;
+	record.elasticity = elasticity;
+	record.radius = radius;
+	record.color[0] = color.r;
+	record.color[1] = color.g;
+	record.color[2] = color.b;
+	record.color[3] = color.a;
+	record.collisionCategory = 0x0001;
+	record.collisionMask = 0xFFFFFFFF;
+	addBody(record);
+}
+
+// Add AABB
+void TiledWorld::addAABB(glm::vec2 position, glm::vec2 velocity, glm::vec2 extents, float mass, float elasticity, glm::vec4 color, BodyType bodyType)
+{
+	TileBodyRecord record = {};
+	record.shape = AABB_;
+	record.bodyType = bodyType;
+	record.positionX = position.x;
+	record.positionY = position.y;
+	record.velocityX = velocity.x;
+	record.velocityY = velocity.y;
+	record.mass = mass;
+	record.elasticity = elasticity;
+	record.extentX = extents.x;
+	record.extentY = extents.y;
+	record.color[0] = color.r;
+	record.color[1] = color.g;
+	record.color[2] = color.b;
+	record.color[3] = color.a;
+	record.collisionCategory = 0x0001;
+	record.collisionMask = 0xFFFFFFFF;
+	addBody(record);
+}
+
+// Add Body
+void TiledWorld::addBody(const TileBodyRecord& record)
+{
+	Tile& tile = getTile(getTileKey(glm::vec2(record.positionX, record.positionY)));
+
+	// Frozen tiles just queue the record for their file
+	if (tile.state == TILE_FROZEN)
+	{
+		tile.pending.push_back(record);
+		m_pendingCount++;
+		if (m_pendingCount >= MAX_PENDING_RECORDS)
+		{
+			flushAllPending();
+		}
+		return;
+	}
+
+	BodyType bodyType = (BodyType)record.bodyType;
+	Rigidbody* body = makeBody(record);
+	body->setBodyType((tile.state == TILE_ACTIVE) ? bodyType : STATIC_BODY);
+	tile.bodies.push_back(body);
+	tile.bodyTypes.push_back(bodyType);
+	m_scene->addActor(body);
+}
+
+//============================================================================================================================================
+// Region Functions
+
+// Add Region
+int TiledWorld::addRegion(glm::vec2 centre, float radius)
+{
+	m_regionCentres.push_back(centre);
+	m_regionRadii.push_back(radius);
+	return m_regionCentres.size() - 1;
+}
+
+// Set Region
+void TiledWorld::setRegion(int region, glm::vec2 centre, float radius)
+{
+	m_regionCentres[region] = centre;
+	m_regionRadii[region] = radius;
+}
+
+//============================================================================================================================================
+// Update Functions
+
+// Update
+void TiledWorld::update(float dt)
+{
+	handOffBodies();
+	updateTileStates(dt);
+}
+
+// Hand Off Bodies, moves bodies that left their tile over to the tile they are in now
+void TiledWorld::handOffBodies()
+{
+	m_sceneBatch.clear();
+	m_readdBatch.clear();
+	m_deleteBatch.clear();
+
+	for (long long key : m_loadedTiles)
+	{
+		Tile& tile = m_tiles[key];
+		if (tile.state != TILE_ACTIVE)
+		{
+			continue;
+		}
+
+		for (int i = (int)tile.bodies.size() - 1; i >= 0; i--)
+		{
+			// Static bodies never leave
+			BodyType bodyType = tile.bodyTypes[i];
+			if (bodyType == STATIC_BODY)
+			{
+				continue;
+			}
+			Rigidbody* body = tile.bodies[i];
+			long long destinationKey = getTileKey(body->getPosition());
+			if (destinationKey == key)
+			{
+				continue;
+			}
+
+			tile.bodies[i] = tile.bodies.back();
+			tile.bodyTypes[i] = tile.bodyTypes.back();
+			tile.bodies.pop_back();
+			tile.bodyTypes.pop_back();
+			m_handOffs++;
+
+			// Active tiles take it as it is, halo tiles stop it where it is and frozen tiles write it out
+			Tile& destination = getTile(destinationKey);
+			if (destination.state == TILE_ACTIVE)
+			{
+				destination.bodies.push_back(body);
+				destination.bodyTypes.push_back(bodyType);
+			}
+			else if (destination.state == TILE_HALO)
+			{
+				destination.bodies.push_back(body);
+				destination.bodyTypes.push_back(bodyType);
+				m_sceneBatch.push_back(body);
+				m_readdBatch.push_back(body);
+			}
+			else
+			{
+				destination.pending.push_back(makeRecord(body, bodyType));
+				m_pendingCount++;
+				m_sceneBatch.push_back(body);
+				m_deleteBatch.push_back(body);
+			}
+		}
+	}
+
+	m_scene->removeActors(m_sceneBatch);
+	for (auto body : m_readdBatch)
+	{
+		body->setBodyType(STATIC_BODY);
+		m_scene->addActor(body);
+	}
+	for (auto body : m_deleteBatch)
+	{
+		delete body;
+	}
+}
+
+// Update Tile States, loads tiles that came into range and freezes ones that have been out of range long enough
+void TiledWorld::updateTileStates(float dt)
+{
+	// Tiles touching a region are active
+	m_wantedStates.clear();
+	int regionCount = m_regionCentres.size();
+	for (int region = 0; region < regionCount; region++)
+	{
+		glm::vec2 centre = m_regionCentres[region];
+		float radius = m_regionRadii[region];
+		int minX = (int)std::floor((centre.x - radius) / m_tileSize);
+		int maxX = (int)std::floor((centre.x + radius) / m_tileSize);
+		int minY = (int)std::floor((centre.y - radius) / m_tileSize);
+		int maxY = (int)std::floor((centre.y + radius) / m_tileSize);
+		for (int x = minX; x <= maxX; x++)
+		{
+			for (int y = minY; y <= maxY; y++)
+			{
+				glm::vec2 tileMin(x * m_tileSize, y * m_tileSize);
+				glm::vec2 closest = glm::clamp(centre, tileMin, tileMin + glm::vec2(m_tileSize));
+				glm::vec2 offset = closest - centre;
+				if (glm::dot(offset, offset) <= radius * radius)
+				{
+					m_wantedStates[getTileKey(x, y)] = TILE_ACTIVE;
+				}
+			}
+		}
+	}
+
+	// The ring round them is halo
+	m_keys.clear();
+	for (auto& wanted : m_wantedStates)
+	{
+		m_keys.push_back(wanted.first);
+	}
+	for (long long key : m_keys)
+	{
+		int x = (int)(unsigned int)((unsigned long long)key >> 32);
+		int y = (int)(unsigned int)key;
+		for (int offsetX = -1; offsetX <= 1; offsetX++)
+		{
+			for (int offsetY = -1; offsetY <= 1; offsetY++)
+			{
+				// emplace leaves active tiles as they are
+				m_wantedStates.emplace(getTileKey(x + offsetX, y + offsetY), TILE_HALO);
+			}
+		}
+	}
+
+	// Load straight away
+	for (auto& wanted : m_wantedStates)
+	{
+		Tile& tile = getTile(wanted.first);
+		if (wanted.second > tile.state)
+		{
+			setTileState(tile, wanted.second);
+		}
+	}
+
+	// Freeze only once a tile has wanted to for the delay, copied since freezing takes tiles off the loaded list
+	m_keys = m_loadedTiles;
+	for (long long key : m_keys)
+	{
+		Tile& tile = m_tiles[key];
+		auto found = m_wantedStates.find(key);
+		TileState wanted = (found != m_wantedStates.end()) ? found->second : TILE_FROZEN;
+		if (wanted >= tile.state)
+		{
+			tile.idleTime = 0.0f;
+			continue;
+		}
+
+		tile.idleTime += dt;
+		if (tile.idleTime >= m_freezeDelay)
+		{
+			setTileState(tile, wanted);
+		}
+	}
+}
+
+//============================================================================================================================================
+// Tile Functions
+
+// Get Tile Key
+long long TiledWorld::getTileKey(glm::vec2 position) const
+{
+	return getTileKey((int)std::floor(position.x / m_tileSize), (int)std::floor(position.y / m_tileSize));
+}
+
+// Get Tile, made frozen and empty the first time it's asked for
+TiledWorld::Tile& TiledWorld::getTile(long long key)
+{
+	auto found = m_tiles.find(key);
+	if (found != m_tiles.end())
+	{
+		return found->second;
+	}
+
+	Tile& tile = m_tiles[key];
+	tile.x = (int)(unsigned int)((unsigned long long)key >> 32);
+	tile.y = (int)(unsigned int)key;
+	tile.state = TILE_FROZEN;
+	tile.idleTime = 0.0f;
+	tile.storedCount = 0;
+	return tile;
+}
+
+// Set Tile State
+void TiledWorld::setTileState(Tile& tile, TileState state)
+{
+	if (tile.state == state)
+	{
+		return;
+	}
+
+	// A tile whose file can't be written or read stays as it is, and is tried again on the next update
+	if (state == TILE_FROZEN)
+	{
+		freezeTile(tile);
+	}
+	else if (tile.state == TILE_FROZEN)
+	{
+		loadTile(tile, state);
+	}
+	else
+	{
+		// Between active and halo the bodies stay in the scene and only change type
+		setHaloBodies(tile, state == TILE_HALO);
+		tile.state = state;
+		tile.idleTime = 0.0f;
+	}
+}
+
+// Load Tile, reads the tile's file and puts its bodies in the scene. Returns false, leaving the tile frozen with its file
+// and pending records untouched, if the file can't be read, so a later freeze can't write over bodies it never loaded
+bool TiledWorld::loadTile(Tile& tile, TileState state)
+{
+	m_records.clear();
+
+	// No file just means nothing was ever stored there
+	char fileName[512];
+	getFileName(tile, fileName, sizeof(fileName));
+	FILE* file = std::fopen(fileName, "rb");
+	if (file != nullptr)
+	{
+		std::fseek(file, 0, SEEK_END);
+		long size = std::ftell(file);
+		std::fseek(file, 0, SEEK_SET);
+		int count = (int)(size / (long)sizeof(TileBodyRecord));
+		m_records.resize(count);
+		// A size that isn't a whole number of records means a write was cut short
+		bool readAll = (size >= 0) && ((size % (long)sizeof(TileBodyRecord)) == 0) && (count == 0 || std::fread(m_records.data(), sizeof(TileBodyRecord), count, file) == (size_t)count);
+		std::fclose(file);
+		if (!readAll)
+		{
+			m_fileErrors++;
+			m_records.clear();
+			return false;
+		}
+	}
+	else if (tile.storedCount > 0)
+	{
+		m_fileErrors++;
+		return false;
+	}
+
+	// Along with anything not written yet
+	m_records.insert(m_records.end(), tile.pending.begin(), tile.pending.end());
+	m_pendingCount -= tile.pending.size();
+	std::vector<TileBodyRecord>().swap(tile.pending);
+
+	for (const TileBodyRecord& record : m_records)
+	{
+		BodyType bodyType = (BodyType)record.bodyType;
+		Rigidbody* body = makeBody(record);
+		body->setBodyType((state == TILE_ACTIVE) ? bodyType : STATIC_BODY);
+		tile.bodies.push_back(body);
+		tile.bodyTypes.push_back(bodyType);
+		m_scene->addActor(body);
+	}
+
+	tile.state = state;
+	tile.idleTime = 0.0f;
+	m_loadedTiles.push_back(getTileKey(tile.x, tile.y));
+	m_tileLoads++;
+	return true;
+}
+
+// Freeze Tile, writes the tile's bodies to its file and deletes them. The records go to a temporary file that only
+// replaces the tile's file once it's all written. Returns false, leaving the tile loaded and its old file as it was, if
+// the write fails, so the bodies are never deleted without a copy on disk
+bool TiledWorld::freezeTile(Tile& tile)
+{
+	m_records.clear();
+	int bodyCount = tile.bodies.size();
+	for (int i = 0; i < bodyCount; i++)
+	{
+		m_records.push_back(makeRecord(tile.bodies[i], tile.bodyTypes[i]));
+	}
+
+	// Empty tiles don't keep a file
+	char fileName[512];
+	getFileName(tile, fileName, sizeof(fileName));
+	if (bodyCount > 0)
+	{
+		std::string tempName = std::string(fileName) + ".tmp";
+		FILE* file = std::fopen(tempName.c_str(), "wb");
+		bool written = (file != nullptr) && (std::fwrite(m_records.data(), sizeof(TileBodyRecord), bodyCount, file) == (size_t)bodyCount);
+		if (file != nullptr)
+		{
+			written = (std::fclose(file) == 0) && written;
+		}
+
+		// rename won't replace a file everywhere, so the old one goes first
+		if (written)
+		{
+			std::remove(fileName);
+			written = (std::rename(tempName.c_str(), fileName) == 0);
+		}
+		if (!written)
+		{
+			m_fileErrors++;
+			std::remove(tempName.c_str());
+			return false;
+		}
+	}
+	else
+	{
+		// Including one left by an earlier world
+		std::remove(fileName);
+	}
+
+	m_sceneBatch.assign(tile.bodies.begin(), tile.bodies.end());
+	m_scene->removeActors(m_sceneBatch);
+	for (auto body : tile.bodies)
+	{
+		delete body;
+	}
+	std::vector<Rigidbody*>().swap(tile.bodies);
+	std::vector<BodyType>().swap(tile.bodyTypes);
+
+	tile.storedCount = bodyCount;
+	tile.state = TILE_FROZEN;
+	tile.idleTime = 0.0f;
+	m_loadedTiles.erase(std::remove(m_loadedTiles.begin(), m_loadedTiles.end(), getTileKey(tile.x, tile.y)), m_loadedTiles.end());
+	m_tileSaves++;
+	return true;
+}
+
+// Set Halo Bodies, makes the tile's moving bodies static or gives them their own type back
+void TiledWorld::setHaloBodies(Tile& tile, bool halo)
+{
+	// The scene sorts actors by type when they are added, so they have to come out and go back in
+	m_sceneBatch.clear();
+	int bodyCount = tile.bodies.size();
+	for (int i = 0; i < bodyCount; i++)
+	{
+		if (tile.bodyTypes[i] != STATIC_BODY)
+		{
+			m_sceneBatch.push_back(tile.bodies[i]);
+		}
+	}
+	m_scene->removeActors(m_sceneBatch);
+
+	for (int i = 0; i < bodyCount; i++)
+	{
+		if (tile.bodyTypes[i] != STATIC_BODY)
+		{
+			tile.bodies[i]->setBodyType(halo ? STATIC_BODY : tile.bodyTypes[i]);
+			m_scene->addActor(tile.bodies[i]);
+		}
+	}
+}
+
+// Flush Pending, appends a frozen tile's waiting records to its file
+void TiledWorld::flushPending(Tile& tile)
+{
+	if (tile.pending.empty())
+	{
+		return;
+	}
+
+	char fileName[512];
+	getFileName(tile, fileName, sizeof(fileName));
+	FILE* file = std::fopen(fileName, "ab");
+	int count = tile.pending.size();
+	if (file == nullptr || std::fwrite(tile.pending.data(), sizeof(TileBodyRecord), count, file) != (size_t)count)
+	{
+		// Kept for the next flush rather than lost
+		m_fileErrors++;
+		if (file != nullptr)
+		{
+			std::fclose(file);
+		}
+		return;
+	}
+	std::fclose(file);
+
+	tile.storedCount += count;
+	m_pendingCount -= count;
+	std::vector<TileBodyRecord>().swap(tile.pending);
+}
+
+// Flush All Pending
+void TiledWorld::flushAllPending()
+{
+	for (auto& entry : m_tiles)
+	{
+		flushPending(entry.second);
+	}
+}
+
+// Freeze All
+void TiledWorld::freezeAll()
+{
+	m_keys = m_loadedTiles;
+	for (long long key : m_keys)
+	{
+		freezeTile(m_tiles[key]);
+	}
+	flushAllPending();
+}
+
+// Discard All
+void TiledWorld::discardAll()
+{
+	char fileName[512];
+	for (auto& entry : m_tiles)
+	{
+		Tile& tile = entry.second;
+		if (tile.state != TILE_FROZEN)
+		{
+			m_sceneBatch.assign(tile.bodies.begin(), tile.bodies.end());
+			m_scene->removeActors(m_sceneBatch);
+			for (auto body : tile.bodies)
+			{
+				delete body;
+			}
+		}
+		getFileName(tile, fileName, sizeof(fileName));
+		std::remove(fileName);
+	}
+
+	m_tiles.clear();
+	m_loadedTiles.clear();
+	m_pendingCount = 0;
+}
+
+//============================================================================================================================================
+// Body Records
+
+// Make Body
+Rigidbody* TiledWorld::makeBody(const TileBodyRecord& record)
+{
+	glm::vec2 position(record.positionX, record.positionY);
+	glm::vec2 velocity(record.velocityX, record.velocityY);
+	glm::vec4 color(record.color[0], record.color[1], record.color[2], record.color[3]);
+
+	Rigidbody* body = nullptr;
+	if (record.shape == SPHERE)
+	{
+		body = new Sphere(position, velocity, glm::vec2(0, 0), record.mass, record.radius, record.elasticity, color);
+	}
+	else
+	{
+		body = new AABB(position, velocity, glm::vec2(0, 0), glm::vec2(record.extentX, record.extentY), record.mass, record.elasticity, color);
+	}
+	body->setBodyType((BodyType)record.bodyType);
+	body->setLinearDrag(record.linearDrag);
+	body->setCharge(record.charge);
+	body->setCollisionFilter(record.collisionCategory, record.collisionMask, record.collisionGroup);
+	return body;
+}
+
+// Make Record
+TileBodyRecord TiledWorld::makeRecord(Rigidbody* body, BodyType bodyType)
+{
+	TileBodyRecord record = {};
+	record.shape = body->getShapeID();
+	record.bodyType = bodyType;
+	record.positionX = body->getPosition().x;
+	record.positionY = body->getPosition().y;
+	record.velocityX = body->getVelocity().x;
+	record.velocityY = body->getVelocity().y;
+	record.mass = body->getMass();
+	record.elasticity = body->getElasticity();
+	record.linearDrag = body->getLinearDrag();
+	record.charge = body->getCharge();
+	record.collisionCategory = body->getCollisionCategory();
+	record.collisionMask = body->getCollisionMask();
+	record.collisionGroup = body->getCollisionGroup();
+
+	glm::vec4 color;
+	if (record.shape == SPHERE)
+	{
+		Sphere* sphere = static_cast<Sphere*>(body);
+		record.radius = sphere->getRadius();
+		color = sphere->getColor();
+	}
+	else
+	{
+		AABB* aabb = static_cast<AABB*>(body);
+		record.extentX = aabb->getExtents().x;
+		record.extentY = aabb->getExtents().y;
+		color = aabb->getColor();
+	}
+	record.color[0] = color.r;
+	record.color[1] = color.g;
+	record.color[2] = color.b;
+	record.color[3] = color.a;
+	return record;
+}
+
+// Get File Name
+void TiledWorld::getFileName(const Tile& tile, char* fileName, int size) const
+{
+	std::snprintf(fileName, size, "%s_%d_%d.tile", m_filePrefix.c_str(), tile.x, tile.y);
+}
+
+//============================================================================================================================================
+// Getters
+
+// Get Tile State
+TileState TiledWorld::getTileState(glm::vec2 position) const
+{
+	auto found = m_tiles.find(getTileKey(position));
+	return (found != m_tiles.end()) ? found->second.state : TILE_FROZEN;
+}
+
+// Get Active Tile Count
+int TiledWorld::getActiveTileCount() const
+{
+	int count = 0;
+	for (long long key : m_loadedTiles)
+	{
+		count += (m_tiles.at(key).state == TILE_ACTIVE) ? 1 : 0;
+	}
+	return count;
+}
+
+// Get Halo Tile Count
+int TiledWorld::getHaloTileCount() const
+{
+	return m_loadedTiles.size() - getActiveTileCount();
+}
+
+// Get Resident Body Count
+int TiledWorld::getResidentBodyCount() const
+{
+	int count = 0;
+	for (long long key : m_loadedTiles)
+	{
+		count += m_tiles.at(key).bodies.size();
+	}
+	return count;
+}
+
+// Get Stored Body Count
+long long TiledWorld::getStoredBodyCount() const
+{
+	long long count = 0;
+	for (auto& entry : m_tiles)
+	{
+		if (entry.second.state == TILE_FROZEN)
+		{
+			count += entry.second.storedCount + entry.second.pending.size();
+		}
+	}
+	return count;
+}
\ No newline at end of file
@@ -0,0 +1,166 @@
+#pragma once
+// Include .h files
+#include "PhysicsObject.h"
+
+// Other includes
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <glm\vec2.hpp>
+#include <glm\vec4.hpp>
+#include <glm\glm.hpp>
+
+// Typedefs
+
+//============================================================================================================================================
+// TileState ENUM
+
+enum TileState
+{
+	TILE_FROZEN,	// Bodies only exist in the tile's file, nothing is in the scene
+	TILE_HALO,		// Bodies are in the scene as static colliders, so active bodies next to them have something to hit
+	TILE_ACTIVE		// Bodies are in the scene as they were made and simulated as normal
+};
+
+//============================================================================================================================================
+// TileBodyRecord STRUCT
+
+// Everything needed to make a Sphere or AABB again, written to tile files as is
+struct TileBodyRecord
+{
+	int shape;					// SPHERE or AABB_
+	int bodyType;
+	float positionX;
+	float positionY;
+	float velocityX;
+	float velocityY;
+	float mass;
+	float elasticity;
+	float linearDrag;
+	float charge;
+	float radius;				// Spheres only
+	float extentX;				// AABBs only
+	float extentY;
+	float color[4];
+	unsigned int collisionCategory;
+	unsigned int collisionMask;
+	int collisionGroup;
+};
+
+//============================================================================================================================================
+// TiledWorld CLASS
+
+// Splits a world far bigger than the scene could step into square tiles of Spheres and AABBs, and only keeps the tiles
+// round a few active regions (the camera, the players) in the PhysicsScene. Tiles that come into range are read from
+// their files and made active, the ring of tiles round them is loaded as static colliders, and tiles that have been out
+// of range for the freeze delay are written back and their bodies deleted. A body that moves out of its tile is handed
+// to the tile it moved into: kept going if that tile is active, made static if it is halo, and written to its file if
+// it is frozen. Memory and step time follow the number of tiles in range, not the size of the world.
+// Planes, joints, fluids and constrained bodies should be added to the scene directly, tiles only hold free bodies.
+// Call update before PhysicsScene::update, and delete the world before the scene since the scene deletes its actors
+class TiledWorld
+{
+
+public:
+	// Tile files are named filePrefix_x_y.tile, the prefix can include a directory that already exists. Files left by an
+	// earlier world with the same prefix are picked up as their tiles load, which is how a saved world is opened again
+	TiledWorld(class PhysicsScene* scene, float tileSize, const char* filePrefix);
+	~TiledWorld();
+
+	// Bodies for a frozen tile go straight to its file without being made, so a world can be built far bigger than memory
+	void addSphere(glm::vec2 position, glm::vec2 velocity, float mass, float radius, float elasticity, glm::vec4 color, BodyType bodyType = DYNAMIC_BODY);
+	void addAABB(glm::vec2 position, glm::vec2 velocity, glm::vec2 extents, float mass, float elasticity, glm::vec4 color, BodyType bodyType = DYNAMIC_BODY);
+	void addBody(const TileBodyRecord& record);
+
+	// Tiles overlapping a region's circle are active, returns the region's index
+	int addRegion(glm::vec2 centre, float radius);
+	void setRegion(int region, glm::vec2 centre, float radius);
+	void clearRegions() { m_regionCentres.clear(); m_regionRadii.clear(); }
+
+	// Hands off bodies that changed tile, then loads and freezes tiles to match the regions
+	void update(float dt);
+
+	// Writes every loaded tile back to its file and takes its bodies out of the scene. A tile whose file can't be written
+	// stays loaded, its bodies left to the scene, and counts as a file error
+	void freezeAll();
+
+	// Deletes every body and tile file, leaving an empty world
+	void discardAll();
+
+	//============================================================================================================================================
+	// Getters and Setters
+
+	float getTileSize() const { return m_tileSize; }
+
+	// How long a tile stays loaded once out of range, so a region moving back and forth over a border doesn't thrash it
+	void setFreezeDelay(float freezeDelay) { m_freezeDelay = freezeDelay; }
+	float getFreezeDelay() const { return m_freezeDelay; }
+
+	TileState getTileState(glm::vec2 position) const;
+	int getActiveTileCount() const;
+	int getHaloTileCount() const;
+	int getResidentBodyCount() const;			// Bodies in the scene
+	long long getStoredBodyCount() const;		// Bodies only in files or waiting to be written
+
+	// Counters since the world was made
+	long long getTileLoadCount() const { return m_tileLoads; }
+	long long getTileSaveCount() const { return m_tileSaves; }
+	long long getHandOffCount() const { return m_handOffs; }
+	long long getFileErrorCount() const { return m_fileErrors; }	// Tiles that couldn't be saved or loaded, left as they were
+
+protected:
+	struct Tile
+	{
+		int x;
+		int y;
+		TileState state;
+		float idleTime;						// Time spent wanting a lower state than it has
+		long long storedCount;				// Records in the tile's file
+		std::vector<Rigidbody*> bodies;
+		std::vector<BodyType> bodyTypes;	// What each body really is, halo tiles make them all static
+		std::vector<TileBodyRecord> pending;	// Records for a frozen tile not written yet
+	};
+
+	static long long getTileKey(int x, int y) { return (long long)(((unsigned long long)(unsigned int)x << 32) | (unsigned int)y); }
+	long long getTileKey(glm::vec2 position) const;
+	Tile& getTile(long long key);
+
+	void handOffBodies();
+	void updateTileStates(float dt);
+	void setTileState(Tile& tile, TileState state);
+	bool loadTile(Tile& tile, TileState state);
+	bool freezeTile(Tile& tile);
+	void setHaloBodies(Tile& tile, bool halo);
+	void flushPending(Tile& tile);
+	void flushAllPending();
+
+	Rigidbody* makeBody(const TileBodyRecord& record);
+	static TileBodyRecord makeRecord(Rigidbody* body, BodyType bodyType);
+	void getFileName(const Tile& tile, char* fileName, int size) const;
+
+	class PhysicsScene* m_scene;
+	float m_tileSize;
+	std::string m_filePrefix;
+	float m_freezeDelay;
+
+	std::vector<glm::vec2> m_regionCentres;
+	std::vector<float> m_regionRadii;
+
+	// Every tile that has had a body or been in range, loaded or not
+	std::unordered_map<long long, Tile> m_tiles;
+	std::vector<long long> m_loadedTiles;
+	std::unordered_map<long long, TileState> m_wantedStates;	// Rebuilt every update from the regions
+	long long m_pendingCount;
+
+	long long m_tileLoads;
+	long long m_tileSaves;
+	long long m_handOffs;
+	long long m_fileErrors;
+
+	// Reused while moving bodies in and out of the scene
+	std::vector<PhysicsObject*> m_sceneBatch;
+	std::vector<TileBodyRecord> m_records;
+	std::vector<PhysicsObject*> m_readdBatch;
+	std::vector<Rigidbody*> m_deleteBatch;
+	std::vector<long long> m_keys;
+};
\ No newline at end of file
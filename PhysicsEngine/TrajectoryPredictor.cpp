@@ -0,0 +1,289 @@
+// Include .h files
+#include "TrajectoryPredictor.h"
+#include "PhysicsScene.h"
+#include "RigidBody.h"
+#include "Sphere.h"
+#include "AABB.h"
+#include "Plane.h"
+
+// Other includes
+#include <cmath>
+
+// Typedefs
+
+// Below this the drag free form is used, the drag form loses everything to cancellation as drag goes to zero
+static const float MIN_LINEAR_DRAG = 0.0001f;
+
+// Regula falsi steps when refining a Plane hit with drag, it converges long before this
+static const int MAX_HIT_ITERATIONS = 32;
+static const double HIT_TOLERANCE = 1.0e-7;
+
+//============================================================================================================================================
+// Signed Distance
+
+// Signed distance of a body's reach from a Plane along its path, a + b t + c t^2 without drag and
+// a + b D(t) + c (t - D(t)) with it, where D(t) = (1 - e^-kt) / k is the distance a unit launch speed covers
+struct PlanePath
+{
+	double a;
+	double b;
+	double c;
+	double drag;
+
+	// Distance at time t
+	double evaluate(double t) const
+	{
+		if (drag == 0.0)
+		{
+			return a + (b * t) + (c * t * t);
+		}
+		double decay = -std::expm1(-drag * t) / drag;
+		return a + (b * decay) + (c * (t - decay));
+	}
+
+	// The one time the distance stops getting closer or further, -1 if it never turns after launch
+	double getTurningPoint() const
+	{
+		if (drag == 0.0)
+		{
+			double turn = (c != 0.0) ? (-b / (2.0 * c)) : -1.0;
+			return (turn > 0.0) ? turn : -1.0;
+		}
+
+		// Rate is c + (b - c) e^-kt, which is zero once e^-kt falls to c / (c - b)
+		double ratio = (b != c) ? (c / (c - b)) : -1.0;
+		return (ratio > 0.0 && ratio < 1.0) ? (-std::log(ratio) / drag) : -1.0;
+	}
+};
+
+//============================================================================================================================================
+// Constructors
+
+// Constructor
+TrajectoryPredictor::TrajectoryPredictor()
+{
+	m_gravity = glm::vec2(0, 0);
+}
+
+//============================================================================================================================================
+// Scene
+
+// Set Scene
+void TrajectoryPredictor::setScene(PhysicsScene* scene)
+{
+	m_gravity = scene->getGravity();
+	clearPlanes();
+	for (auto pStatic : scene->getStaticActors())
+	{
+		if (pStatic->getShapeID() == PLANE)
+		{
+			Plane* plane = static_cast<Plane*>(pStatic);
+			addPlane(plane->getNormal(), plane->getDistanceToOrigin());
+		}
+	}
+}
+
+// Add Plane
+int TrajectoryPredictor::addPlane(glm::vec2 normal, float distanceToOrigin)
+{
+	m_planeNormalX.push_back(normal.x);
+	m_planeNormalY.push_back(normal.y);
+	m_planeDistance.push_back(distanceToOrigin);
+	return m_planeNormalX.size() - 1;
+}
+
+// Clear Planes
+void TrajectoryPredictor::clearPlanes()
+{
+	m_planeNormalX.clear();
+	m_planeNormalY.clear();
+	m_planeDistance.clear();
+}
+
+//============================================================================================================================================
+// Bodies
+
+// Add Body
+int TrajectoryPredictor::addBody(glm::vec2 position, glm::vec2 velocity, float linearDrag, float radius, glm::vec2 extents)
+{
+	m_positionX.push_back(position.x);
+	m_positionY.push_back(position.y);
+	m_velocityX.push_back(velocity.x);
+	m_velocityY.push_back(velocity.y);
+	m_linearDrag.push_back((linearDrag < MIN_LINEAR_DRAG) ? 0.0f : linearDrag);
+	m_radius.push_back(radius);
+	m_extentX.push_back(extents.x);
+	m_extentY.push_back(extents.y);
+	return m_positionX.size() - 1;
+}
+
+// Add Body, from a scene body
+int TrajectoryPredictor::addBody(Rigidbody* body)
+{
+	float radius = (body->getShapeID() == SPHERE) ? static_cast<Sphere*>(body)->getRadius() : 0.0f;
+	glm::vec2 extents = (body->getShapeID() == AABB_) ? static_cast<AABB*>(body)->getExtents() : glm::vec2(0, 0);
+	return addBody(body->getPosition(), body->getVelocity(), body->getLinearDrag(), radius, extents);
+}
+
+// Clear Bodies
+void TrajectoryPredictor::clearBodies()
+{
+	m_positionX.clear();
+	m_positionY.clear();
+	m_velocityX.clear();
+	m_velocityY.clear();
+	m_linearDrag.clear();
+	m_radius.clear();
+	m_extentX.clear();
+	m_extentY.clear();
+}
+
+//============================================================================================================================================
+// Prediction
+
+// Predict Positions
+void TrajectoryPredictor::predictPositions(const float* times, int timeCount, glm::vec2* positions) const
+{
+	int bodyCount = getBodyCount();
+	for (int body = 0; body < bodyCount; body++)
+	{
+		float positionX = m_positionX[body];
+		float positionY = m_positionY[body];
+		float velocityX = m_velocityX[body];
+		float velocityY = m_velocityY[body];
+		float* output = &positions[body * timeCount].x;
+
+		// One form per body so the loop over the sample times has no branches in it
+		if (m_linearDrag[body] == 0.0f)
+		{
+			float halfGravityX = m_gravity.x * 0.5f;
+			float halfGravityY = m_gravity.y * 0.5f;
+			for (int sample = 0; sample < timeCount; sample++)
+			{
+				float t = times[sample];
+				output[(sample * 2)] = positionX + (velocityX * t) + (halfGravityX * t * t);
+				output[(sample * 2) + 1] = positionY + (velocityY * t) + (halfGravityY * t * t);
+			}
+			continue;
+		}
+
+		// Doubles keep the terminal velocity term from swamping the small difference it is multiplied by
+		double drag = m_linearDrag[body];
+		double terminalX = m_gravity.x / drag;
+		double terminalY = m_gravity.y / drag;
+		for (int sample = 0; sample < timeCount; sample++)
+		{
+			double t = times[sample];
+			double decay = -std::expm1(-drag * t) / drag;
+			output[(sample * 2)] = (float)(positionX + (velocityX * decay) + (terminalX * (t - decay)));
+			output[(sample * 2) + 1] = (float)(positionY + (velocityY * decay) + (terminalY * (t - decay)));
+		}
+	}
+}
+
+// Predict Plane Hits
+void TrajectoryPredictor::predictPlaneHits(float horizon, float* hitTimes, int* hitPlanes) const
+{
+	int bodyCount = getBodyCount();
+	int planeCount = getPlaneCount();
+	for (int body = 0; body < bodyCount; body++)
+	{
+		hitTimes[body] = -1.0f;
+		hitPlanes[body] = -1;
+
+		// Each Plane can only make the hit earlier, so later Planes search up to the best hit so far
+		float searchHorizon = horizon;
+		for (int plane = 0; plane < planeCount; plane++)
+		{
+			float hitTime = findPlaneHit(body, plane, searchHorizon);
+			if (hitTime >= 0.0f)
+			{
+				hitTimes[body] = hitTime;
+				hitPlanes[body] = plane;
+				searchHorizon = hitTime;
+			}
+		}
+	}
+}
+
+// Find Plane Hit, the first time in [0, horizon] the body's reach gets to the Plane, -1 if it doesn't
+float TrajectoryPredictor::findPlaneHit(int body, int plane, float horizon) const
+{
+	float normalX = m_planeNormalX[plane];
+	float normalY = m_planeNormalY[plane];
+
+	// Spheres reach out by their radius, AABBs by their extents projected onto the normal
+	float reach = (std::abs(normalX) * m_extentX[body]) + (std::abs(normalY) * m_extentY[body]) + m_radius[body];
+
+	PlanePath path;
+	path.drag = m_linearDrag[body];
+	path.a = (m_positionX[body] * normalX) + (m_positionY[body] * normalY) - m_planeDistance[plane] - reach;
+	double normalVelocity = (m_velocityX[body] * normalX) + (m_velocityY[body] * normalY);
+	double normalGravity = (m_gravity.x * normalX) + (m_gravity.y * normalY);
+	path.b = normalVelocity;
+	path.c = (path.drag == 0.0) ? (normalGravity * 0.5) : (normalGravity / path.drag);
+
+	// Already touching
+	if (path.a <= 0.0)
+	{
+		return 0.0f;
+	}
+
+	// The path splits into at most two pieces that only move one way. The first piece to end at or past the Plane
+	// holds the hit, and only that one crossing is in it
+	double start = 0.0;
+	double end = horizon;
+	double turn = path.getTurningPoint();
+	if (turn > 0.0 && turn < horizon && path.evaluate(turn) <= 0.0)
+	{
+		end = turn;
+	}
+	else if (turn > 0.0 && turn < horizon)
+	{
+		start = turn;
+	}
+	double startDistance = path.evaluate(start);
+	double endDistance = path.evaluate(end);
+	if (endDistance > 0.0 || startDistance <= 0.0)
+	{
+		return -1.0f;
+	}
+
+	// Without drag the crossing is a root of the quadratic, taken in the form that doesn't cancel
+	if (path.drag == 0.0)
+	{
+		if (path.c == 0.0)
+		{
+			return (float)(-path.a / path.b);
+		}
+		double discriminant = glm::max((path.b * path.b) - (4.0 * path.c * path.a), 0.0);
+		double q = -0.5 * (path.b + ((path.b < 0.0) ? -std::sqrt(discriminant) : std::sqrt(discriminant)));
+		double root1 = q / path.c;
+		double root2 = (q != 0.0) ? (path.a / q) : root1;
+		double root = (root1 >= start && root1 <= end) ? root1 : root2;
+		return (float)glm::clamp(root, start, end);
+	}
+
+	// With drag, regula falsi on the bracket, halving the stale end's distance (Illinois) so it can't stall
+	int staleSide = 0;
+	for (int iteration = 0; iteration < MAX_HIT_ITERATIONS && (end - start) > HIT_TOLERANCE * horizon; iteration++)
+	{
+		double t = end - (endDistance * (end - start) / (endDistance - startDistance));
+		double distance = path.evaluate(t);
+		if (distance <= 0.0)
+		{
+			end = t;
+			endDistance = distance;
+			startDistance *= (staleSide == -1) ? 0.5 : 1.0;
+			staleSide = -1;
+		}
+		else
+		{
+			start = t;
+			startDistance = distance;
+			endDistance *= (staleSide == 1) ? 0.5 : 1.0;
+			staleSide = 1;
+		}
+	}
+	return (float)end;
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+// Include .h files
+#include "PhysicsObject.h"
+
+// Other includes
+#include <vector>
+#include <glm\vec2.hpp>
+#include <glm\glm.hpp>
+
+// Typedefs
+
+//============================================================================================================================================
+// TrajectoryPredictor CLASS
+
+// Predicts where ballistic bodies will be without stepping anything. Under constant gravity g and linear drag k the
+// velocity relaxes towards the terminal velocity g / k, so position has a closed form at any time:
+//     x(t) = x0 + (g / k) t + (v0 - g / k) (1 - e^-kt) / k, and x0 + v0 t + g t^2 / 2 without drag
+// Launch states are kept as flat arrays and every body is evaluated at every sample time in one pass, so thousands of
+// aiming previews cost a few exponentials each and never touch the scene. The same closed form gives each body's
+// signed distance to a Plane, which has at most one turning point, so the first time its bounds reach a Plane is found
+// exactly without drag and to float precision with it. The closed form is the exact path; PhysicsScene's fixed steps
+// drift from it by the usual first order error, and forces other than gravity and drag aren't predicted
+class TrajectoryPredictor
+{
+
+public:
+	TrajectoryPredictor();
+
+	//============================================================================================================================================
+	// Scene
+
+	// Takes the scene's gravity and every Plane in it, the scene is only read
+	void setScene(class PhysicsScene* scene);
+
+	void setGravity(glm::vec2 gravity) { m_gravity = gravity; }
+	glm::vec2 getGravity() const { return m_gravity; }
+
+	// Planes are numbered in the order they were added, setScene adds the scene's in its order
+	int addPlane(glm::vec2 normal, float distanceToOrigin);
+	void clearPlanes();
+	int getPlaneCount() const { return m_planeNormalX.size(); }
+
+	//============================================================================================================================================
+	// Bodies
+
+	// A launch state, its reach against Planes is a radius for Spheres and half extents for AABBs. Returns its index
+	int addBody(glm::vec2 position, glm::vec2 velocity, float linearDrag = 0.0f, float radius = 0.0f, glm::vec2 extents = glm::vec2(0, 0));
+
+	// A scene body's current state, drag and bounds
+	int addBody(Rigidbody* body);
+
+	void clearBodies();
+	int getBodyCount() const { return m_positionX.size(); }
+
+	//============================================================================================================================================
+	// Prediction
+
+	// Every body at every sample time, written body by body: body b at time s goes to positions[(b * timeCount) + s]
+	void predictPositions(const float* times, int timeCount, glm::vec2* positions) const;
+
+	// The first time within the horizon each body's bounds reach any Plane, and which Plane. Bodies that are already
+	// touching one hit it at time 0, bodies that miss every Plane get -1 for both
+	void predictPlaneHits(float horizon, float* hitTimes, int* hitPlanes) const;
+
+protected:
+	float findPlaneHit(int body, int plane, float horizon) const;
+
+	glm::vec2 m_gravity;
+
+	std::vector<float> m_planeNormalX;
+	std::vector<float> m_planeNormalY;
+	std::vector<float> m_planeDistance;
+
+	// Launch states, one entry per body
+	std::vector<float> m_positionX;
+	std::vector<float> m_positionY;
+	std::vector<float> m_velocityX;
+	std::vector<float> m_velocityY;
+	std::vector<float> m_linearDrag;
+	std::vector<float> m_radius;
+	std::vector<float> m_extentX;
+	std::vector<float> m_extentY;
+};
\ No newline at end of file
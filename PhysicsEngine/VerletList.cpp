@@ -0,0 +1,186 @@
+// Include .h files
+#include "VerletList.h"
+
+// Other includes
+#include <cmath>
+#include <algorithm>
+
+// Typedefs
+
+//============================================================================================================================================
+// Constructors
+
+// Constructor
+VerletList::VerletList(float skin)
+{
+	m_skin = skin;
+	m_valid = false;
+	m_rebuildCount = 0;
+	m_maxDisplacement = 0.0f;
+	m_buildStaticCount = 0;
+	m_neighbourStart.push_back(0);
+	m_staticNeighbourStart.push_back(0);
+}
+
+//============================================================================================================================================
+// Pair Functions
+
+// Update
+bool VerletList::update(const BroadPhase& broadPhase)
+{
+	const std::vector<BroadPhaseProxy>& proxies = broadPhase.getProxies();
+	int proxyCount = proxies.size();
+
+	// A different set of bodies, or different statics, means the indices no longer line up
+	bool stale = !m_valid || proxyCount != (int)m_buildActors.size() || (int)broadPhase.getStaticProxies().size() != m_buildStaticCount;
+
+	// Largest squared reach of any body's bounds past where they were at the build, plain loop so it stays cheap. An edge
+	// can have moved as far as the centre did plus however much the bounds have grown on that axis
+	bool periodic = broadPhase.isPeriodic();
+	glm::vec2 domainSize = broadPhase.getDomainSize();
+	float maxDisplacementSquared = 0.0f;
+	for (int i = 0; i < proxyCount && !stale; i++)
+	{
+		stale = (proxies[i].actor != m_buildActors[i]);
+		float deltaX = ((proxies[i].min.x + proxies[i].max.x) * 0.5f) - m_buildPositionX[i];
+		float deltaY = ((proxies[i].min.y + proxies[i].max.y) * 0.5f) - m_buildPositionY[i];
+		if (periodic)
+		{
+			// A body that wrapped round the domain has only moved as far as its nearest image
+			deltaX -= domainSize.x * std::floor((deltaX / domainSize.x) + 0.5f);
+			deltaY -= domainSize.y * std::floor((deltaY / domainSize.y) + 0.5f);
+		}
+		deltaX = std::abs(deltaX) + glm::max(((proxies[i].max.x - proxies[i].min.x) * 0.5f) - m_buildExtentX[i], 0.0f);
+		deltaY = std::abs(deltaY) + glm::max(((proxies[i].max.y - proxies[i].min.y) * 0.5f) - m_buildExtentY[i], 0.0f);
+		maxDisplacementSquared = glm::max(maxDisplacementSquared, (deltaX * deltaX) + (deltaY * deltaY));
+	}
+	m_maxDisplacement = std::sqrt(maxDisplacementSquared);
+
+	// Two bodies each moving half the skin towards each other could just have closed the gap
+	if (stale || !(m_maxDisplacement <= m_skin * 0.5f))
+	{
+		rebuild(broadPhase);
+		return true;
+	}
+	return false;
+}
+
+// Rebuild, searches the broadphase grid out to the skin distance
+void VerletList::rebuild(const BroadPhase& broadPhase)
+{
+	const std::vector<BroadPhaseProxy>& proxies = broadPhase.getProxies();
+	const std::vector<BroadPhaseProxy>& staticProxies = broadPhase.getStaticProxies();
+	const std::vector<int>& cellEntries = broadPhase.getCellEntries();
+	int proxyCount = proxies.size();
+	int staticCount = staticProxies.size();
+	int columns = broadPhase.getColumns();
+
+	// Cells are at least the largest body, the skin may reach into the cells beyond the usual 3x3
+	int reach = 1 + (int)std::ceil(m_skin / broadPhase.getCellSize());
+
+	m_neighbourStart.resize(proxyCount + 1);
+	m_neighbourStart[0] = 0;
+	m_neighbours.clear();
+	m_staticNeighbourStart.resize(proxyCount + 1);
+	m_staticNeighbourStart[0] = 0;
+	m_staticNeighbours.clear();
+	m_buildPositionX.resize(proxyCount);
+	m_buildPositionY.resize(proxyCount);
+	m_buildExtentX.resize(proxyCount);
+	m_buildExtentY.resize(proxyCount);
+	m_buildActors.resize(proxyCount);
+
+	for (int i = 0; i < proxyCount; i++)
+	{
+		const BroadPhaseProxy& proxy1 = proxies[i];
+		glm::vec2 centre = (proxy1.min + proxy1.max) * 0.5f;
+		glm::vec2 wrappedCentre = broadPhase.wrapPosition(centre);
+		broadPhase.getNeighbourColumns(broadPhase.getCellColumn(wrappedCentre.x), reach, m_neighbourColumns);
+		broadPhase.getNeighbourRows(broadPhase.getCellRow(wrappedCentre.y), reach, m_neighbourRows);
+
+		for (int neighbourRow : m_neighbourRows)
+		{
+			for (int neighbourColumn : m_neighbourColumns)
+			{
+				int cell = (neighbourRow * columns) + neighbourColumn;
+				for (int entry = broadPhase.getCellStart(cell); entry < broadPhase.getCellEnd(cell); entry++)
+				{
+					// Same filter as BroadPhase::findPairs, with the bounds test widened by the skin
+					int j = cellEntries[entry];
+					const BroadPhaseProxy& proxy2 = proxies[j];
+					if (j > i && (proxy1.dynamic || proxy2.dynamic) && BroadPhase::shouldCollide(proxy1, proxy2) && withinSkin(broadPhase, proxy1, proxy2, m_skin))
+					{
+						m_neighbours.push_back(j);
+					}
+				}
+			}
+		}
+		// In index order as BroadPhase::findPairs gives them, so the pairs don't depend on where the grid lies
+		std::sort(m_neighbours.begin() + m_neighbourStart[i], m_neighbours.end());
+		m_neighbourStart[i + 1] = m_neighbours.size();
+
+		for (int s = 0; s < staticCount; s++)
+		{
+			if (proxy1.dynamic && BroadPhase::shouldCollide(proxy1, staticProxies[s]) && withinSkin(broadPhase, proxy1, staticProxies[s], m_skin))
+			{
+				m_staticNeighbours.push_back(s);
+			}
+		}
+		m_staticNeighbourStart[i + 1] = m_staticNeighbours.size();
+
+		m_buildPositionX[i] = centre.x;
+		m_buildPositionY[i] = centre.y;
+		m_buildExtentX[i] = (proxy1.max.x - proxy1.min.x) * 0.5f;
+		m_buildExtentY[i] = (proxy1.max.y - proxy1.min.y) * 0.5f;
+		m_buildActors[i] = proxy1.actor;
+	}
+
+	m_buildStaticCount = staticCount;
+	m_valid = true;
+	m_rebuildCount++;
+}
+
+// Find Pairs, walks the stored lists and keeps the neighbours whose bounds overlap now
+void VerletList::findPairs(const BroadPhase& broadPhase, std::vector<CollisionPair>& pairs) const
+{
+	pairs.clear();
+
+	const std::vector<BroadPhaseProxy>& proxies = broadPhase.getProxies();
+	const std::vector<BroadPhaseProxy>& staticProxies = broadPhase.getStaticProxies();
+	int proxyCount = proxies.size();
+
+	for (int i = 0; i < proxyCount; i++)
+	{
+		for (int entry = m_neighbourStart[i]; entry < m_neighbourStart[i + 1]; entry++)
+		{
+			const BroadPhaseProxy& proxy2 = proxies[m_neighbours[entry]];
+			if (broadPhase.overlapsInDomain(proxies[i], proxy2))
+			{
+				CollisionPair pair = { proxies[i].actor, proxy2.actor };
+				pairs.push_back(pair);
+			}
+		}
+	}
+
+	// Moving bodies against static colliders come after, as they do from the grid
+	for (int i = 0; i < proxyCount; i++)
+	{
+		for (int entry = m_staticNeighbourStart[i]; entry < m_staticNeighbourStart[i + 1]; entry++)
+		{
+			const BroadPhaseProxy& staticProxy = staticProxies[m_staticNeighbours[entry]];
+			if (broadPhase.overlapsInDomain(proxies[i], staticProxy))
+			{
+				CollisionPair pair = { proxies[i].actor, staticProxy.actor };
+				pairs.push_back(pair);
+			}
+		}
+	}
+}
+
+// Within Skin, true if the gap between the two bounds is smaller than the skin, through the minimum image if periodic
+bool VerletList::withinSkin(const BroadPhase& broadPhase, const BroadPhaseProxy& proxy1, const BroadPhaseProxy& proxy2, float skin)
+{
+	glm::vec2 offset = broadPhase.getImageOffset((proxy1.min + proxy1.max) * 0.5f, (proxy2.min + proxy2.max) * 0.5f);
+	return proxy1.min.x <= proxy2.max.x + offset.x + skin && proxy2.min.x + offset.x <= proxy1.max.x + skin &&
+		   proxy1.min.y <= proxy2.max.y + offset.y + skin && proxy2.min.y + offset.y <= proxy1.max.y + skin;
+}
\ No newline at end of file
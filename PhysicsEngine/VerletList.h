@@ -0,0 +1,76 @@
+#pragma once
+// Include .h files
+#include "BroadPhase.h"
+
+// Other includes
+#include <vector>
+#include <glm\vec2.hpp>
+#include <glm\glm.hpp>
+
+// Typedefs
+
+//============================================================================================================================================
+// VerletList CLASS
+
+// Pair provider for dense scenes where neighbours rarely change. Each moving body keeps a list of every body whose
+// bounds come within the skin distance of its own, so the lists stay complete until some body's bounds have reached
+// more than half the skin past where they were when the lists were built, by moving or by growing. Each step only the
+// largest such reach is worked out; until it crosses that line the pairs come from walking the stored lists instead of
+// searching the grid. Lists are stored CSR style, one flat array of neighbours with a start offset per body
+class VerletList
+{
+
+public:
+	VerletList(float skin = 1.0f);
+
+	// Rebuilds the lists from the broadphase grid if they might have gone stale, returns true if it did
+	bool update(const BroadPhase& broadPhase);
+	void findPairs(const BroadPhase& broadPhase, std::vector<CollisionPair>& pairs) const;
+
+	// Forces a rebuild on the next update, needed after changing a body's collision filter or body type
+	void invalidate() { m_valid = false; }
+
+	//============================================================================================================================================
+	// Getters and Setters
+
+	// Bigger skins rebuild less often but walk longer lists
+	void setSkin(float skin) { m_skin = skin; m_valid = false; }
+	float getSkin() const { return m_skin; }
+
+	int getRebuildCount() const { return m_rebuildCount; }
+	int getNeighbourCount() const { return m_neighbours.size() + m_staticNeighbours.size(); }
+	float getMaxDisplacement() const { return m_maxDisplacement; }	// Furthest any bounds have reached since the build
+
+	// Neighbours of proxy i run from getNeighbourStart(i) to getNeighbourStart(i + 1) in getNeighbours()
+	int getNeighbourStart(int proxy) const { return m_neighbourStart[proxy]; }
+	const std::vector<int>& getNeighbours() const { return m_neighbours; }
+
+protected:
+	void rebuild(const BroadPhase& broadPhase);
+	static bool withinSkin(const BroadPhase& broadPhase, const BroadPhaseProxy& proxy1, const BroadPhaseProxy& proxy2, float skin);
+
+	float m_skin;
+	bool m_valid;
+	int m_rebuildCount;
+	float m_maxDisplacement;
+
+	// Moving neighbours with a higher index, so each pair is stored once
+	std::vector<int> m_neighbourStart;
+	std::vector<int> m_neighbours;
+
+	// Static colliders near each moving body
+	std::vector<int> m_staticNeighbourStart;
+	std::vector<int> m_staticNeighbours;
+
+	// Where each body was, how big its bounds were, and which body it was, when the lists were built
+	std::vector<float> m_buildPositionX;
+	std::vector<float> m_buildPositionY;
+	std::vector<float> m_buildExtentX;
+	std::vector<float> m_buildExtentY;
+	std::vector<PhysicsObject*> m_buildActors;
+	int m_buildStaticCount;
+
+	// Scratch for rebuild
+	std::vector<int> m_neighbourColumns;
+	std::vector<int> m_neighbourRows;
+};
\ No newline at end of file
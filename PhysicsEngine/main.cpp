@@ -1,9 +1,24 @@
 #include "PhysicsEngineApp.h"
+#include "PhysicsEngine3DApp.h"
+#include "Benchmarks.h"
 
-int main() {
+#include <cstring>
+
+int main(int argc, char* argv[]) {
+
+	// headless benchmarks, optionally just the one named after the flag
+	if (argc > 1 && std::strcmp(argv[1], "--benchmark") == 0)
+	{
+		runBenchmarks((argc > 2) ? argv[2] : nullptr);
+		return 0;
+	}
 	
-	// allocation
-	auto app = new PhysicsEngineApp();
+	// allocation, the 3D demo when asked for
+	aie::Application* app = nullptr;
+	if (argc > 1 && std::strcmp(argv[1], "--3d") == 0)
+		app = new PhysicsEngine3DApp();
+	else
+		app = new PhysicsEngineApp();
 
 	// initialise and loop
 	app->run("AIE", 1280, 720, false);